@@ -23,9 +23,39 @@ void read_CLA(int argc, char** argv, CLAInfo* info){
     info->graph_flag[0] = 0;  // memory graph off
     info->graph_flag[1] = 0;  // CPU graph off
     info->graph_flag[2] = 0;  // cores graph off
+    info->graph_flag[3] = 0;  // NUMA view off
+    info->graph_flag[4] = 0;  // interrupt view off
+    info->mode = MODE_LOCAL;
+    snprintf(info->socket_path, sizeof(info->socket_path), "%s", DEFAULT_SOCKET_PATH);
+    info->client_queue = 64;
+    info->shm_enabled = 0;
+    snprintf(info->shm_name, sizeof(info->shm_name), "%s", DEFAULT_SHM_NAME);
+    info->adaptive = 0;
+    info->adapt_min_us = 0;
+    info->adapt_max_us = 0;
+    info->start_ns = 0;
+    info->self_stats = 0;
+    info->proc_root[0] = '\0';
+    info->engine = ENGINE_PROCESSES;
+    info->batch_io = BATCH_IO_OFF;
+    info->alert_count = 0;
+    info->anomaly_k = 0.0f;
+    info->record_path[0] = '\0';
+    info->vmstat = 0;
+    info->flight_spec = NULL;
+    info->pin_cpu = -1;
+    info->fifo_priority = 0;
+    info->nice_value = SAMPLER_NICE_UNSET;
+    info->mlock = 0;
+    info->aggregate_spec = NULL;
+    info->aggregate_late_ms = -1;
+    info->pid = -1;
+    info->hw_cache_spec = NULL;
     
     for (int i = 1; i < argc; i++){
         int parsed;
+        int parsed2;
+        float parsed_k;
         if (strcmp(argv[i], "--memory") == 0){
             info->graph_flag[0] = 1;
             continue;
@@ -38,6 +68,18 @@ void read_CLA(int argc, char** argv, CLAInfo* info){
             info->graph_flag[2] = 1;
             continue;
         }
+        else if (strcmp(argv[i], "--numa") == 0){
+            info->graph_flag[3] = 1;
+            continue;
+        }
+        else if (strcmp(argv[i], "--irq") == 0){
+            info->graph_flag[4] = 1;
+            continue;
+        }
+        else if (strcmp(argv[i], "--vmstat") == 0){
+            info->vmstat = 1;
+            continue;
+        }
         else if ((sscanf(argv[i], "--samples=%d",&parsed) == 1) && parsed > 0){
             info->samples = parsed;
             continue;
@@ -46,6 +88,133 @@ void read_CLA(int argc, char** argv, CLAInfo* info){
             info->tdelay = parsed;
             continue;
         }
+        else if (strcmp(argv[i], "--daemon") == 0){
+            info->mode = MODE_DAEMON;
+            continue;
+        }
+        else if (strcmp(argv[i], "--attach") == 0){
+            info->mode = MODE_ATTACH;
+            continue;
+        }
+        else if (strncmp(argv[i], "--socket=", 9) == 0 && argv[i][9] != '\0'){
+            snprintf(info->socket_path, sizeof(info->socket_path), "%s", argv[i] + 9);
+            continue;
+        }
+        else if ((sscanf(argv[i], "--client-queue=%d",&parsed) == 1) && parsed > 0){
+            info->client_queue = parsed;
+            continue;
+        }
+        else if (strcmp(argv[i], "--shm") == 0){
+            info->shm_enabled = 1;
+            continue;
+        }
+        else if (strncmp(argv[i], "--shm=", 6) == 0 && argv[i][6] == '/'){
+            info->shm_enabled = 1;
+            snprintf(info->shm_name, sizeof(info->shm_name), "%s", argv[i] + 6);
+            continue;
+        }
+        else if (strcmp(argv[i], "--adaptive") == 0){
+            info->adaptive = 1;
+            continue;
+        }
+        else if (sscanf(argv[i], "--adaptive=%d,%d", &parsed, &parsed2) == 2 && parsed > 0 && parsed2 >= parsed){
+            info->adaptive = 1;
+            info->adapt_min_us = parsed;
+            info->adapt_max_us = parsed2;
+            continue;
+        }
+        else if (strcmp(argv[i], "--self-stats") == 0){
+            info->self_stats = 1;
+            continue;
+        }
+        else if (strncmp(argv[i], "--proc-root=", 12) == 0 && argv[i][12] != '\0'){
+            snprintf(info->proc_root, sizeof(info->proc_root), "%s", argv[i] + 12);
+            continue;
+        }
+        else if (strcmp(argv[i], "--engine=threads") == 0){
+            info->engine = ENGINE_THREADS;
+            continue;
+        }
+        else if (strcmp(argv[i], "--engine=processes") == 0){
+            info->engine = ENGINE_PROCESSES;
+            continue;
+        }
+        else if (strcmp(argv[i], "--batch-io=uring") == 0){
+            info->batch_io = BATCH_IO_URING;
+            continue;
+        }
+        else if (strcmp(argv[i], "--batch-io") == 0 || strcmp(argv[i], "--batch-io=pread") == 0){
+            info->batch_io = BATCH_IO_PREAD;
+            continue;
+        }
+        else if (strncmp(argv[i], "--alert=", 8) == 0 && argv[i][8] != '\0' && info->alert_count < ALERT_MAX_RULES){
+            info->alert_specs[info->alert_count++] = argv[i] + 8;
+            continue;
+        }
+        else if (strncmp(argv[i], "--record=", 9) == 0 && argv[i][9] != '\0'){
+            snprintf(info->record_path, sizeof(info->record_path), "%s", argv[i] + 9);
+            continue;
+        }
+        else if (strncmp(argv[i], "--dump-record=", 14) == 0 && argv[i][14] != '\0'){
+            info->mode = MODE_DUMP_RECORD;
+            snprintf(info->record_path, sizeof(info->record_path), "%s", argv[i] + 14);
+            continue;
+        }
+        else if (strncmp(argv[i], "--flight-recorder=", 18) == 0 && argv[i][18] != '\0'){
+            info->flight_spec = argv[i] + 18;
+            continue;
+        }
+        else if (strncmp(argv[i], "--dump-flight=", 14) == 0 && argv[i][14] != '\0'){
+            info->mode = MODE_DUMP_FLIGHT;
+            info->flight_spec = argv[i] + 14;
+            continue;
+        }
+        else if (strncmp(argv[i], "--aggregate=", 12) == 0 && argv[i][12] != '\0'){
+            info->mode = MODE_AGGREGATE;
+            info->aggregate_spec = argv[i] + 12;
+            continue;
+        }
+        else if ((sscanf(argv[i], "--aggregate-late=%d", &parsed) == 1) && parsed >= 0){
+            info->aggregate_late_ms = parsed;
+            continue;
+        }
+        else if (strncmp(argv[i], "--hw-cache=", 11) == 0 && argv[i][11] != '\0'){
+            info->hw_cache_spec = argv[i] + 11;
+            continue;
+        }
+        else if ((sscanf(argv[i], "--pid=%d", &parsed) == 1) && parsed > 0){
+            info->mode = MODE_PID;
+            info->pid = parsed;
+            continue;
+        }
+        else if ((sscanf(argv[i], "--pin-cpu=%d", &parsed) == 1) && parsed >= 0){
+            info->pin_cpu = parsed;
+            continue;
+        }
+        else if (strcmp(argv[i], "--sched-fifo") == 0){
+            info->fifo_priority = SAMPLER_FIFO_DEFAULT;
+            continue;
+        }
+        else if ((sscanf(argv[i], "--sched-fifo=%d", &parsed) == 1) && parsed >= 1 && parsed <= 99){
+            info->fifo_priority = parsed;
+            continue;
+        }
+        else if ((sscanf(argv[i], "--nice=%d", &parsed) == 1) && parsed >= -20 && parsed <= 19){
+            info->nice_value = parsed;
+            continue;
+        }
+        else if (strcmp(argv[i], "--mlock") == 0){
+            info->mlock = 1;
+            continue;
+        }
+        else if (strcmp(argv[i], "--anomaly") == 0){
+            info->anomaly_k = ANOMALY_DEFAULT_K;
+            continue;
+        }
+        else if (sscanf(argv[i], "--anomaly=%f", &parsed_k) == 1 && parsed_k > 0){
+            info->anomaly_k = parsed_k;
+            continue;
+        }
         else if (i == 1 && isdigit_cla(argv[i])){
             info->samples = atoi(argv[i]);
             continue;
@@ -62,10 +231,65 @@ void read_CLA(int argc, char** argv, CLAInfo* info){
         }
     }
 
-    //default case 
-    if (info->graph_flag[0] == 0 && info->graph_flag[1] == 0 && info->graph_flag[2] == 0){
+    // default adaptive bounds: a quarter to four times --tdelay
+    if (info->adaptive && info->adapt_min_us == 0){
+        info->adapt_min_us = (info->tdelay / 4 > 0) ? info->tdelay / 4 : 1;
+        info->adapt_max_us = info->tdelay * 4;
+    }
+
+    // the batched tick loop runs as a worker of the threads engine
+    if (info->batch_io != BATCH_IO_OFF) info->engine = ENGINE_THREADS;
+
+    // the daemon polls its producers' pipes, worker threads are only wired into the local pipeline
+    if (info->engine == ENGINE_THREADS && info->mode != MODE_LOCAL){
+        printf("--engine=threads only applies to local mode, using processes\n");
+        info->engine = ENGINE_PROCESSES;
+        info->batch_io = BATCH_IO_OFF;
+    }
+
+    // a viewer does not sample
+    if ((info->mode == MODE_ATTACH || info->mode == MODE_AGGREGATE) && (info->pin_cpu >= 0 || info->fifo_priority > 0 || \
+        info->nice_value != SAMPLER_NICE_UNSET || info->mlock)){
+        printf("--pin-cpu, --sched-fifo, --nice and --mlock apply to the sampling process, ignoring them\n");
+        info->pin_cpu = -1;
+        info->fifo_priority = 0;
+        info->nice_value = SAMPLER_NICE_UNSET;
+        info->mlock = 0;
+    }
+
+    // daemon and viewers only carry machine-wide samples
+    if (info->graph_flag[3] && info->mode != MODE_LOCAL){
+        printf("--numa only applies to local mode, ignoring it\n");
+        info->graph_flag[3] = 0;
+    }
+    if (info->graph_flag[4] && info->mode != MODE_LOCAL){
+        printf("--irq only applies to local mode, ignoring it\n");
+        info->graph_flag[4] = 0;
+    }
+
+    //default case: the NUMA and interrupt views are only shown when asked for
+    if (info->graph_flag[0] == 0 && info->graph_flag[1] == 0 && info->graph_flag[2] == 0 && info->graph_flag[3] == 0 && \
+        info->graph_flag[4] == 0){
         info->graph_flag[0] = 1;
         info->graph_flag[1] = 1;
         info->graph_flag[2] = 1;
     } 
-}
+
+    // a fleet has no single set of cores, --aggregate merges the memory and CPU charts only;
+    // --pid charts the process's memory and CPU, its threads take the place of the cores panel
+    if ((info->mode == MODE_AGGREGATE || info->mode == MODE_PID) && info->graph_flag[2]){
+        info->graph_flag[2] = 0;
+        if (info->graph_flag[0] == 0 && info->graph_flag[1] == 0){
+            printf("--cores is not shown with %s, showing memory and CPU\n", \
+                   (info->mode == MODE_PID) ? "--pid" : "--aggregate");
+            info->graph_flag[0] = 1;
+            info->graph_flag[1] = 1;
+        }
+    }
+
+    // the rates are read by the memory producer and shown with its chart
+    if (info->vmstat && info->graph_flag[0] == 0){
+        printf("--vmstat is shown with the memory chart, ignoring it\n");
+        info->vmstat = 0;
+    }
+}
\ No newline at end of file
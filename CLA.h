@@ -3,6 +3,9 @@
 #include <string.h>
 #include <ctype.h>
 
+#include "alertEngine.h"
+#include "anomaly.h"
+
 #ifndef CLA_HEADER
 #define CLA_HEADER
 
@@ -11,17 +14,120 @@ This module provides a utility function for parsing command-line arguments and
 configuring runtime parameters such as graph type, number of samples, and delay between updates.
 */
 
+#define DEFAULT_SOCKET_PATH "/tmp/myMonitoringTool.sock"
+#define DEFAULT_SHM_NAME "/myMonitoringTool"
+#define SAMPLER_NICE_UNSET 100 // outside the -20..19 nice range
+#define SAMPLER_FIFO_DEFAULT 10
+
+typedef enum {
+    MODE_LOCAL = 0,
+    MODE_DAEMON = 1,
+    MODE_ATTACH = 2,
+    MODE_DUMP_RECORD = 3,
+    MODE_DUMP_FLIGHT = 4,
+    MODE_AGGREGATE = 5,
+    MODE_PID = 6
+}RunMode;
+///_|> descry: How the tool runs
+///_|> members:
+///_|>     - MODE_LOCAL: sample and render in this terminal (default)
+///_|>     - MODE_DAEMON: sample once and publish to viewers over a Unix domain socket (--daemon)
+///_|>     - MODE_ATTACH: thin viewer that renders samples received from a daemon (--attach)
+///_|>     - MODE_DUMP_RECORD: decode a recording made with --record and print it as CSV (--dump-record=FILE)
+///_|>     - MODE_DUMP_FLIGHT: print a time window of a --flight-recorder file as CSV (--dump-flight=FILE[,FROM[,TO]])
+///_|>     - MODE_AGGREGATE: merge the streams of many daemons and recordings into one fleet view (--aggregate=SRC,...)
+///_|>     - MODE_PID: follow one process and its threads at a high rate (--pid=N)
+
+typedef enum {
+    ENGINE_PROCESSES = 0,
+    ENGINE_THREADS = 1
+}ProducerEngine;
+///_|> descry: How the local producers run (--engine=)
+///_|> members:
+///_|>     - ENGINE_PROCESSES: one forked child per collector, samples sent over pipes (default)
+///_|>     - ENGINE_THREADS: one worker thread per collector, samples handed over in-memory queues
+
+typedef enum {
+    BATCH_IO_OFF = 0,
+    BATCH_IO_URING = 1,
+    BATCH_IO_PREAD = 2
+}BatchIoMode;
+///_|> descry: How the tick sampler of --batch-io reads its sources
+///_|> members:
+///_|>     - BATCH_IO_OFF: every collector reads its own files (default)
+///_|>     - BATCH_IO_URING: one io_uring submission per tick, pread when io_uring is unavailable (--batch-io=uring)
+///_|>     - BATCH_IO_PREAD: one pread per source and tick (--batch-io, --batch-io=pread)
+
 typedef struct {
-    int graph_flag[3];
+    int graph_flag[5];
     int samples;
     int tdelay;
+    int mode;
+    char socket_path[108];
+    int client_queue;
+    int shm_enabled;
+    char shm_name[64];
+    int adaptive;
+    int adapt_min_us;
+    int adapt_max_us;
+    long long start_ns;
+    int self_stats;
+    char proc_root[256];
+    int engine;
+    int batch_io;
+    const char* alert_specs[ALERT_MAX_RULES];
+    int alert_count;
+    float anomaly_k;
+    char record_path[256];
+    int vmstat;
+    const char* flight_spec;
+    int pin_cpu;
+    int fifo_priority;
+    int nice_value;
+    int mlock;
+    const char* aggregate_spec;
+    int aggregate_late_ms;
+    int pid;
+    const char* hw_cache_spec;
 }CLAInfo;
 ///_|> descry: Stores the runtime configuration parsed from command-line input
 ///_|> members:
-///_|>     - graph_flag: array of 3 integers, each indicating whether a specific graph
-///_|>                    is enabled (0: memory, 1: CPU, 2: cores), type int[3]
+///_|>     - graph_flag: array of 5 integers, each indicating whether a specific graph
+///_|>                    is enabled (0: memory, 1: CPU, 2: cores, 3: per-node NUMA view,
+///_|>                    4: interrupt hot spots), type int[5]
 ///_|>     - samples: number of samples to collect and show, type int
 ///_|>     - tdelay: delay between samples in microseconds, type int
+///_|>     - mode: one of RunMode, type int
+///_|>     - socket_path: Unix domain socket used by --daemon / --attach, type char[108]
+///_|>     - client_queue: number of samples queued per viewer before old ones are dropped, type int
+///_|>     - shm_enabled: whether samples are published to a shared-memory snapshot (--shm), type int
+///_|>     - shm_name: POSIX shared-memory name of the snapshot, type char[64]
+///_|>     - adaptive: whether producers adapt their interval to signal variance (--adaptive), type int
+///_|>     - adapt_min_us: shortest adaptive interval in microseconds, type int
+///_|>     - adapt_max_us: longest adaptive interval in microseconds, type int
+///_|>     - start_ns: monotonic time the run started, shared by producers and consumer to place
+///_|>                 non-uniformly spaced samples on the time axis, type long long
+///_|>     - self_stats: whether the tool reports its own overhead and stage latencies (--self-stats), type int
+///_|>     - proc_root: directory read instead of "/" for procfs/sysfs, empty for the real system, type char[256]
+///_|>     - engine: one of ProducerEngine, type int
+///_|>     - batch_io: one of BatchIoMode, type int
+///_|>     - alert_specs / alert_count: --alert=RULE texts (pointing into argv), parsed by alertEngine, type const char*[] / int
+///_|>     - anomaly_k: flag samples beyond this many EWMA standard deviations (--anomaly[=K]), 0 when off, type float
+///_|>     - record_path: compressed recording written by --record=FILE, or read by --dump-record=FILE, type char[256]
+///_|>     - vmstat: whether the memory producer also reports paging and reclaim rates from /proc/vmstat (--vmstat), type int
+///_|>     - flight_spec: FILE,SIZE of --flight-recorder, or FILE[,FROM[,TO]] of --dump-flight (pointing into argv),
+///_|>                    NULL when neither is given, type const char*
+///_|>     - pin_cpu: CPU the samplers are pinned to (--pin-cpu=N), -1 when off, type int
+///_|>     - fifo_priority: SCHED_FIFO priority of the samplers (--sched-fifo[=PRIO]), 0 when off, type int
+///_|>     - nice_value: nice value of the samplers (--nice=N), SAMPLER_NICE_UNSET when off, type int
+///_|>     - mlock: whether the tool locks its memory with mlockall (--mlock), type int
+///_|>     - aggregate_spec: comma-separated daemon sockets and recordings of --aggregate (pointing into argv),
+///_|>                       NULL when not given, type const char*
+///_|>     - aggregate_late_ms: how long a fleet bucket waits for a silent source (--aggregate-late=MS), -1 for
+///_|>                          two buckets, type int
+///_|>     - pid: process followed by --pid=N, -1 when not given, type int
+///_|>     - hw_cache_spec: cache file of the static hardware facts, or "off" (--hw-cache=, pointing into argv),
+///_|>                      NULL for the default file, type const char*
 
 void read_CLA(int argc, char** argv, CLAInfo* info);
 
@@ -0,0 +1,49 @@
+#include "adaptiveSampler.h"
+
+#define EWMA_ALPHA 0.3f      // weight of the newest delta
+#define VOLATILE_DELTA 0.02f // > 2% of full scale per sample: sample faster
+#define FLAT_DELTA 0.005f    // < 0.5% of full scale per sample: sample slower
+
+void adaptive_init(AdaptiveSampler* sampler, int min_us, int max_us, int start_us){
+    ///_|> descry: initializes an adaptive schedule
+    ///_|> sampler: pointer to the schedule to initialize, type AdaptiveSampler*
+    ///_|> min_us: shortest allowed interval in microseconds, type int
+    ///_|> max_us: longest allowed interval in microseconds, type int
+    ///_|> start_us: first interval in microseconds, clamped to [min_us, max_us], type int
+    ///_|> returning: this function does not return anything
+    sampler->min_us = min_us;
+    sampler->max_us = max_us;
+    if (start_us < min_us) start_us = min_us;
+    if (start_us > max_us) start_us = max_us;
+    sampler->interval_us = start_us;
+    sampler->ewma_delta = 0;
+    sampler->last_value = 0;
+    sampler->has_last = 0;
+}
+
+int adaptive_next_interval(AdaptiveSampler* sampler, float value, float full_scale){
+    ///_|> descry: feeds one sample into the schedule and computes the next sleep interval
+    ///_|> sampler: pointer to the schedule, type AdaptiveSampler*
+    ///_|> value: newest sample value, type float
+    ///_|> full_scale: value range used to normalize deltas (100 for CPU %, total GB for memory), type float
+    ///_|> returning: returns the interval to sleep before the next sample in microseconds, type int
+    if (!sampler->has_last || full_scale <= 0){
+        sampler->last_value = value;
+        sampler->has_last = 1;
+        return sampler->interval_us;
+    }
+    float delta = fabsf(value - sampler->last_value) / full_scale;
+    sampler->last_value = value;
+    sampler->ewma_delta = EWMA_ALPHA * delta + (1.0f - EWMA_ALPHA) * sampler->ewma_delta;
+
+    long next = sampler->interval_us;
+    if (sampler->ewma_delta > VOLATILE_DELTA){
+        next = next / 2;
+    }else if (sampler->ewma_delta < FLAT_DELTA){
+        next = next + next / 4 + 1;
+    }
+    if (next < sampler->min_us) next = sampler->min_us;
+    if (next > sampler->max_us) next = sampler->max_us;
+    sampler->interval_us = (int)next;
+    return sampler->interval_us;
+}
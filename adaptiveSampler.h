@@ -0,0 +1,36 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#ifndef ADAPTIVE_SAMPLER_HEADER
+#define ADAPTIVE_SAMPLER_HEADER
+
+/*
+This module implements the adaptive sampling scheduler used by the CPU and memory producers (--adaptive).
+It keeps an exponentially weighted average of the recent absolute deltas of a signal, normalized by 
+the signal's full scale. When the signal is volatile the interval is halved; when it is flat the interval 
+grows by a quarter. The interval always stays within the configured [min, max] bounds.
+*/
+
+typedef struct {
+    int min_us;
+    int max_us;
+    int interval_us;
+    float ewma_delta;
+    float last_value;
+    int has_last;
+}AdaptiveSampler;
+///_|> descry: State of one adaptive sampling schedule
+///_|> members:
+///_|>     - min_us: shortest allowed interval in microseconds, type int
+///_|>     - max_us: longest allowed interval in microseconds, type int
+///_|>     - interval_us: interval to sleep before the next sample, type int
+///_|>     - ewma_delta: smoothed absolute delta as a fraction of full scale, type float
+///_|>     - last_value: previous sample value, type float
+///_|>     - has_last: whether last_value is valid, type int
+
+void adaptive_init(AdaptiveSampler* sampler, int min_us, int max_us, int start_us);
+
+int adaptive_next_interval(AdaptiveSampler* sampler, float value, float full_scale);
+
+#endif
@@ -0,0 +1,439 @@
+#define _DEFAULT_SOURCE
+#include "aggregator.h"
+#include "timeTool.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+static long long head_ts(const aggMerger* merger, int source){
+    ///_|> descry: timestamp of the oldest queued sample of a source, the key of the heap
+    const aggSource* src = &merger->sources[source];
+    return src->queue[src->head].ts_ns;
+}
+
+static void heap_swap(aggMerger* merger, int a, int b){
+    int tmp = merger->heap[a];
+    merger->heap[a] = merger->heap[b];
+    merger->heap[b] = tmp;
+}
+
+static void sift_up(aggMerger* merger, int pos){
+    ///_|> descry: moves a heap entry towards the root until its parent is not newer
+    ///_|> merger: merger owning the heap, type aggMerger*
+    ///_|> pos: position of the entry, type int
+    ///_|> returning: this function does not return anything
+    while (pos > 0){
+        int parent = (pos - 1) / 2;
+        if (head_ts(merger, merger->heap[parent]) <= head_ts(merger, merger->heap[pos])) break;
+        heap_swap(merger, parent, pos);
+        pos = parent;
+    }
+}
+
+static void sift_down(aggMerger* merger, int pos){
+    ///_|> descry: moves a heap entry towards the leaves until no child is older
+    ///_|> merger: merger owning the heap, type aggMerger*
+    ///_|> pos: position of the entry, type int
+    ///_|> returning: this function does not return anything
+    while (true){
+        int oldest = pos;
+        int left = 2 * pos + 1;
+        int right = left + 1;
+        if (left < merger->heap_len && head_ts(merger, merger->heap[left]) < head_ts(merger, merger->heap[oldest])){
+            oldest = left;
+        }
+        if (right < merger->heap_len && head_ts(merger, merger->heap[right]) < head_ts(merger, merger->heap[oldest])){
+            oldest = right;
+        }
+        if (oldest == pos) break;
+        heap_swap(merger, oldest, pos);
+        pos = oldest;
+    }
+}
+
+static void pop_oldest(aggMerger* merger, int* source, aggSample* sample){
+    ///_|> descry: takes the oldest queued sample of all sources off the heap
+    ///_|> merger: merger with a non-empty heap, type aggMerger*
+    ///_|> source / sample: receive the source index and its sample, type int* / aggSample*
+    ///_|> returning: this function does not return anything
+    int s = merger->heap[0];
+    aggSource* src = &merger->sources[s];
+    *source = s;
+    *sample = src->queue[src->head];
+    src->head = (src->head + 1) % AGG_QUEUE_LEN;
+    src->len--;
+    // the source stays at the root with its next sample as key, or leaves the heap
+    if (src->len == 0) merger->heap[0] = merger->heap[--merger->heap_len];
+    sift_down(merger, 0);
+}
+
+static long long bucket_floor(long long ts_ns, long long bucket_ns){
+    ///_|> descry: start of the bucket holding a timestamp; buckets are aligned to multiples of their width
+    long long rem = ts_ns % bucket_ns;
+    return ts_ns - ((rem < 0) ? rem + bucket_ns : rem);
+}
+
+static float percentile_of(float* values, int count, double percentile){
+    ///_|> descry: nearest-rank percentile of a few values; sorts them in place
+    ///_|> values / count: the values, at least one, type float* / int
+    ///_|> percentile: percentile between 0 and 100, type double
+    ///_|> returning: returns the smallest value that at least percentile % of the values do not exceed
+    for (int i = 1; i < count; i++){
+        float v = values[i];
+        int j = i;
+        for (; j > 0 && values[j - 1] > v; j--) values[j] = values[j - 1];
+        values[j] = v;
+    }
+    int rank = (int)(percentile / 100.0 * count + 0.999999);
+    if (rank < 1) rank = 1;
+    return values[rank - 1];
+}
+
+static int close_bucket(aggMerger* merger, aggBucket* out){
+    ///_|> descry: computes the fleet-wide values of the open bucket from the newest sample of every source in it
+    ///_|> merger: merger whose open bucket is complete, type aggMerger*
+    ///_|> out: receives the values, type aggBucket*
+    ///_|> returning: returns the number of reporting sources
+    float cpu[AGG_MAX_SOURCES];
+    float mem[AGG_MAX_SOURCES];
+    memset(out, 0, sizeof(aggBucket));
+    out->start_ns = merger->start_ns;
+    out->bucket_ns = merger->bucket_ns;
+    out->sources = merger->count;
+    int n = 0;
+    for (int s = 0; s < merger->count; s++){
+        aggSource* src = &merger->sources[s];
+        if (!src->in_bucket) continue;
+        src->in_bucket = false;
+        cpu[n] = src->current.cpu;
+        mem[n] = src->current.mem_used;
+        out->cpu_sum += cpu[n];
+        out->mem_used_sum += mem[n];
+        out->mem_total_sum += src->current.mem_total;
+        if (n == 0 || cpu[n] > out->cpu_max) out->cpu_max = cpu[n];
+        if (n == 0 || mem[n] > out->mem_used_max) out->mem_used_max = mem[n];
+        n++;
+    }
+    out->reporting = n;
+    if (n > 0){
+        out->cpu_mean = out->cpu_sum / n;
+        out->cpu_pct = percentile_of(cpu, n, AGG_PERCENTILE);
+        out->mem_used_pct = percentile_of(mem, n, AGG_PERCENTILE);
+    }
+    return n;
+}
+
+void agg_merger_init(aggMerger* merger, int count, long long bucket_ns, long long late_ns){
+    ///_|> descry: prepares a merger for count sources that are fed with agg_merger_push, all live
+    ///_|> merger: merger to initialize in place, type aggMerger*
+    ///_|> count: number of sources, at most AGG_MAX_SOURCES, type int
+    ///_|> bucket_ns: width of a time bucket in ns, type long long
+    ///_|> late_ns: how long a bucket waits for a live source that has sent nothing for it, type long long
+    ///_|> returning: this function does not return anything
+    memset(merger, 0, sizeof(aggMerger));
+    merger->count = (count < AGG_MAX_SOURCES) ? count : AGG_MAX_SOURCES;
+    merger->bucket_ns = (bucket_ns > 0) ? bucket_ns : 1;
+    merger->late_ns = (late_ns > 0) ? late_ns : 0;
+    for (int s = 0; s < AGG_MAX_SOURCES; s++){
+        merger->sources[s].fd = -1;
+        merger->sources[s].state = AGG_SOURCE_LIVE;
+    }
+}
+
+int agg_merger_push(aggMerger* merger, int source, const aggSample* sample){
+    ///_|> descry: queues one sample of a source; samples of one source are expected in timestamp order
+    ///_|> merger: initialized merger, type aggMerger*
+    ///_|> source: index of the source, type int
+    ///_|> sample: the sample, type const aggSample*
+    ///_|> returning: returns 0 on success, -1 if the source's queue is full (merge first)
+    aggSource* src = &merger->sources[source];
+    if (src->len == AGG_QUEUE_LEN) return -1;
+    src->queue[(src->head + src->len) % AGG_QUEUE_LEN] = *sample;
+    src->len++;
+    if (src->len == 1){
+        merger->heap[merger->heap_len] = source;
+        sift_up(merger, merger->heap_len++);
+    }
+    return 0;
+}
+
+void agg_merger_source_done(aggMerger* merger, int source){
+    ///_|> descry: marks a source as ended; its queued samples are still merged, but buckets no longer wait for it
+    ///_|> merger: initialized merger, type aggMerger*
+    ///_|> source: index of the source, type int
+    ///_|> returning: this function does not return anything
+    merger->sources[source].state = AGG_SOURCE_DONE;
+}
+
+int agg_merger_next(aggMerger* merger, long long now_wall, aggBucket* out){
+    ///_|> descry: merges the queued samples in timestamp order and closes the open bucket when every live
+    ///_|>         source has moved past it or the lateness has passed; a live recording with nothing queued
+    ///_|>         keeps it open regardless of the lateness; buckets nobody reported are skipped
+    ///_|> merger: initialized merger, type aggMerger*
+    ///_|> now_wall: current wall-clock time in ns, against which the lateness is measured, type long long
+    ///_|> out: receives the closed bucket, type aggBucket*
+    ///_|> returning: returns 1 if a bucket was closed, 0 if the open one is still waiting for samples,
+    ///_|>            -1 when every source is done and everything has been reported
+    if (!merger->started){
+        if (merger->heap_len == 0){
+            for (int s = 0; s < merger->count; s++){
+                if (merger->sources[s].state != AGG_SOURCE_DONE) return 0;
+            }
+            return -1;
+        }
+        merger->start_ns = bucket_floor(head_ts(merger, merger->heap[0]), merger->bucket_ns);
+        merger->started = true;
+    }
+    while (true){
+        long long end = merger->start_ns + merger->bucket_ns;
+        bool any_in_bucket = false;
+        while (merger->heap_len > 0 && head_ts(merger, merger->heap[0]) < end){
+            int s;
+            aggSample sample;
+            pop_oldest(merger, &s, &sample);
+            aggSource* src = &merger->sources[s];
+            // the bucket of this sample has already been reported without it
+            if (sample.ts_ns < merger->start_ns){
+                src->late++;
+                continue;
+            }
+            src->current = sample;
+            src->in_bucket = true;
+            src->merged++;
+        }
+        bool all_done = true;
+        bool waiting = false;
+        for (int s = 0; s < merger->count; s++){
+            aggSource* src = &merger->sources[s];
+            any_in_bucket = any_in_bucket || src->in_bucket;
+            if (src->state != AGG_SOURCE_DONE) all_done = false;
+            // a live source with nothing queued may still send a sample for this bucket; a recording that
+            // has not ended has its samples on disk, so it is read again rather than timed out
+            if (src->state == AGG_SOURCE_LIVE && src->len == 0 && (src->is_file || now_wall < end + merger->late_ns)){
+                waiting = true;
+            }
+        }
+        if (!any_in_bucket && merger->heap_len == 0) return all_done ? -1 : 0;
+        if (waiting) return 0;
+        if (!any_in_bucket){
+            // nobody reported this bucket: go straight to the bucket of the next sample
+            merger->start_ns = bucket_floor(head_ts(merger, merger->heap[0]), merger->bucket_ns);
+            continue;
+        }
+        close_bucket(merger, out);
+        merger->start_ns = end;
+        merger->buckets++;
+        return 1;
+    }
+}
+
+static void connect_source(aggSource* src){
+    ///_|> descry: tries to connect a daemon source; on failure it stays missing until the next attempt
+    ///_|> src: source with a socket path, type aggSource*
+    ///_|> returning: this function does not return anything
+    src->retry_ns = now_mono_ns() + AGG_RETRY_NS;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) return;
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    // aggregator_open keeps socket paths within sun_path
+    memcpy(addr.sun_path, src->path, strlen(src->path) + 1);
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1 || fcntl(fd, F_SETFL, O_NONBLOCK) == -1){
+        close(fd);
+        src->state = AGG_SOURCE_MISSING;
+        return;
+    }
+    src->fd = fd;
+    src->partial_len = 0;
+    src->state = AGG_SOURCE_LIVE;
+}
+
+static void end_source(aggMerger* merger, int source){
+    ///_|> descry: closes a source whose stream or recording ended
+    aggSource* src = &merger->sources[source];
+    if (src->fd != -1) close(src->fd);
+    if (src->file != NULL) fclose(src->file);
+    src->fd = -1;
+    src->file = NULL;
+    agg_merger_source_done(merger, source);
+}
+
+static void read_recording(aggMerger* merger, int source){
+    ///_|> descry: queues samples of a recording until the queue is full, decoding one block at a time
+    ///_|> merger: merger owning the source, type aggMerger*
+    ///_|> source: index of a live file source, type int
+    ///_|> returning: this function does not return anything
+    aggSource* src = &merger->sources[source];
+    while (src->len < AGG_QUEUE_LEN){
+        if (src->point_pos == src->point_count){
+            tsBlockHeader header;
+            int got = ts_read_block(src->file, &header, merger->stream);
+            int count = (got == 1) ? ts_decode_block(&header, merger->stream, src->points) : got;
+            if (count <= 0){
+                if (count == -1) fprintf(stderr, "%s: malformed block, source ends here\n", src->path);
+                end_source(merger, source);
+                return;
+            }
+            src->point_count = count;
+            src->point_pos = 0;
+        }
+        const tsPoint* point = &src->points[src->point_pos++];
+        aggSample sample = {point->ts_us * 1000, point->values[TS_CPU], point->values[TS_MEM_USED], \
+                            point->values[TS_MEM_TOTAL]};
+        agg_merger_push(merger, source, &sample);
+    }
+}
+
+static void read_stream(aggMerger* merger, int source){
+    ///_|> descry: queues the utilization records a daemon source has sent, until the socket is drained or
+    ///_|>         the queue is full; other record types are skipped
+    ///_|> merger: merger owning the source, type aggMerger*
+    ///_|> source: index of a live socket source, type int
+    ///_|> returning: this function does not return anything
+    aggSource* src = &merger->sources[source];
+    while (src->len < AGG_QUEUE_LEN){
+        ssize_t got = read(src->fd, (char*)&src->partial + src->partial_len, sizeof(StreamRecord) - src->partial_len);
+        if (got == -1 && errno == EINTR) continue;
+        if (got == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        if (got <= 0){
+            end_source(merger, source); // the daemon stopped
+            return;
+        }
+        src->partial_len += got;
+        if (src->partial_len < sizeof(StreamRecord)) continue;
+        src->partial_len = 0;
+        if (src->partial.type != STREAM_UTILIZ) continue;
+        const UtilizInfo* info = &src->partial.data.utiliz;
+        aggSample sample = {src->partial.wall_ns, info->cpu_utiliz, info->mem_utiliz.used_memory, \
+                            info->mem_utiliz.total_memory};
+        agg_merger_push(merger, source, &sample);
+    }
+}
+
+int aggregator_open(aggMerger* merger, const char* spec, long long bucket_ns, long long late_ns){
+    ///_|> descry: opens the sources of --aggregate: recordings by file name, anything else as a daemon socket
+    ///_|>         (a socket that cannot be connected yet is missing and retried)
+    ///_|> merger: merger to initialize in place, type aggMerger*
+    ///_|> spec: comma-separated list of sockets and recordings, type const char*
+    ///_|> bucket_ns / late_ns: bucket width and lateness, as for agg_merger_init, type long long
+    ///_|> returning: returns the number of sources, -1 if the list is empty or too long, or a recording
+    ///_|>            cannot be opened
+    agg_merger_init(merger, 0, bucket_ns, late_ns);
+    for (const char* p = spec; p != NULL && *p != '\0'; ){
+        const char* comma = strchr(p, ',');
+        size_t len = (comma != NULL) ? (size_t)(comma - p) : strlen(p);
+        if (len > 0){
+            if (merger->count == AGG_MAX_SOURCES || len >= sizeof(merger->sources[0].path)){
+                fprintf(stderr, "--aggregate takes up to %d sources of up to %zu characters\n", AGG_MAX_SOURCES, \
+                        sizeof(merger->sources[0].path) - 1);
+                aggregator_close(merger);
+                return -1;
+            }
+            aggSource* src = &merger->sources[merger->count++];
+            memcpy(src->path, p, len);
+            src->path[len] = '\0';
+            struct stat st;
+            src->is_file = (stat(src->path, &st) == 0 && S_ISREG(st.st_mode));
+            if (src->is_file){
+                if (merger->stream == NULL) merger->stream = (unsigned char*)malloc(TS_BLOCK_BYTES);
+                src->points = (tsPoint*)malloc(sizeof(tsPoint) * TS_BLOCK_SAMPLES);
+                src->file = fopen(src->path, "rb");
+                if (merger->stream == NULL || src->points == NULL || src->file == NULL){
+                    perror(src->path);
+                    aggregator_close(merger);
+                    return -1;
+                }
+            }else if (len >= sizeof(((struct sockaddr_un*)0)->sun_path)){
+                fprintf(stderr, "%s: socket path too long\n", src->path);
+                aggregator_close(merger);
+                return -1;
+            }else{
+                connect_source(src);
+                if (src->state == AGG_SOURCE_MISSING) fprintf(stderr, "%s: no daemon yet, retrying\n", src->path);
+            }
+        }
+        p = (comma != NULL) ? comma + 1 : NULL;
+    }
+    if (merger->count == 0){
+        fprintf(stderr, "--aggregate needs at least one source\n");
+        return -1;
+    }
+    return merger->count;
+}
+
+int aggregator_next(aggMerger* merger, aggBucket* out, int timeout_ms){
+    ///_|> descry: reads the sources and merges until a bucket closes, the timeout expires or a signal arrives;
+    ///_|>         sleeps in poll() until a socket is readable, the open bucket's lateness passes or a missing
+    ///_|>         source is due for another connection attempt
+    ///_|> merger: merger opened by aggregator_open, type aggMerger*
+    ///_|> out: receives the closed bucket, type aggBucket*
+    ///_|> timeout_ms: longest wait for a bucket in milliseconds, type int
+    ///_|> returning: returns 1 if a bucket was closed, 0 on timeout or signal, -1 when every source has ended
+    long long deadline = now_mono_ns() + timeout_ms * 1000000LL;
+    while (true){
+        long long now = now_mono_ns();
+        for (int s = 0; s < merger->count; s++){
+            aggSource* src = &merger->sources[s];
+            if (src->is_file && src->state == AGG_SOURCE_LIVE) read_recording(merger, s);
+            if (!src->is_file && src->state == AGG_SOURCE_MISSING && now >= src->retry_ns) connect_source(src);
+        }
+        int got = agg_merger_next(merger, now_wall_ns(), out);
+        if (got != 0) return got;
+        // a recording the merge has drained holds the bucket open until its next samples are queued
+        bool refill = false;
+        for (int s = 0; s < merger->count; s++){
+            aggSource* src = &merger->sources[s];
+            if (src->is_file && src->state == AGG_SOURCE_LIVE && src->len == 0) refill = true;
+        }
+        if (refill) continue;
+
+        // sleep until the next event: a record, the end of the open bucket's lateness, a retry, the timeout
+        long long wait_ns = deadline - now;
+        long long close_ns = merger->start_ns + merger->bucket_ns + merger->late_ns - now_wall_ns();
+        if (merger->started && close_ns > 0 && close_ns < wait_ns) wait_ns = close_ns;
+        struct pollfd fds[AGG_MAX_SOURCES];
+        int index[AGG_MAX_SOURCES];
+        int nfds = 0;
+        for (int s = 0; s < merger->count; s++){
+            aggSource* src = &merger->sources[s];
+            if (!src->is_file && src->state == AGG_SOURCE_MISSING && src->retry_ns - now < wait_ns){
+                wait_ns = src->retry_ns - now;
+            }
+            // a full queue is not read, the daemon drops that viewer's oldest samples instead
+            if (src->fd != -1 && src->len < AGG_QUEUE_LEN){
+                fds[nfds].fd = src->fd;
+                fds[nfds].events = POLLIN;
+                index[nfds++] = s;
+            }
+        }
+        if (wait_ns < 0) wait_ns = 0;
+        int ready = poll(fds, nfds, (int)((wait_ns + 999999) / 1000000));
+        if (ready == -1 && errno == EINTR) return 0;
+        for (int i = 0; i < nfds && ready > 0; i++){
+            if (fds[i].revents != 0) read_stream(merger, index[i]);
+        }
+        if (ready <= 0 && now_mono_ns() >= deadline) return 0;
+    }
+}
+
+void aggregator_close(aggMerger* merger){
+    ///_|> descry: closes every source and frees the read buffers
+    ///_|> merger: merger opened by aggregator_open, type aggMerger*
+    ///_|> returning: this function does not return anything
+    for (int s = 0; s < merger->count; s++){
+        aggSource* src = &merger->sources[s];
+        if (src->fd != -1) close(src->fd);
+        if (src->file != NULL) fclose(src->file);
+        free(src->points);
+        src->fd = -1;
+        src->file = NULL;
+        src->points = NULL;
+    }
+    free(merger->stream);
+    merger->stream = NULL;
+}
@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "streamProtocol.h"
+#include "tsCompress.h"
+
+#ifndef AGGREGATOR_HEADER
+#define AGGREGATOR_HEADER
+
+/*
+This module merges the sample streams of many monitors into one fleet view (--aggregate=SRC,...).
+A source is a daemon socket (--daemon on another container or host, forwarded to a local Unix socket)
+or a recording made with --record. Every source keeps a short queue of samples, and a binary min-heap
+of the sources keyed by their oldest queued timestamp performs the k-way merge: samples leave the
+heap in timestamp order and fall into fixed time buckets of --tdelay, in which each source counts
+with its newest sample. A bucket is closed and reported (sum, mean, max and percentile across the
+sources) once every source has moved past it, or when the lateness (--aggregate-late, two buckets
+by default) has passed for the daemon sources that have not: a late or missing daemon never stalls
+the merge, and its samples for buckets already reported are counted as late and dropped. A recording
+whose queue the merge has drained is not late but unread, so it holds the bucket until it is read
+again or ends, however old its samples are.
+Daemon sockets that cannot be connected are retried every AGG_RETRY_NS; a source is done when its
+daemon closes the stream or its recording ends.
+The merge itself (agg_merger_push / agg_merger_next) does no I/O, so it can be fed by any source.
+*/
+
+#define AGG_MAX_SOURCES 64
+#define AGG_QUEUE_LEN 256 // samples buffered per source while slower sources are waited for
+#define AGG_PERCENTILE 90.0
+#define AGG_RETRY_NS 1000000000LL // between connection attempts to a missing daemon socket
+
+typedef enum {
+    AGG_SOURCE_MISSING = 0,
+    AGG_SOURCE_LIVE = 1,
+    AGG_SOURCE_DONE = 2
+}AggSourceState;
+///_|> descry: State of one source
+///_|> members:
+///_|>     - AGG_SOURCE_MISSING: daemon socket not connected (yet), retried; never holds a bucket back
+///_|>     - AGG_SOURCE_LIVE: connected socket, holds a bucket back up to the lateness, or open recording,
+///_|>                        holds it back until the recording is read past it
+///_|>     - AGG_SOURCE_DONE: stream closed or recording ended, its queued samples are still merged
+
+typedef struct {
+    long long ts_ns;
+    float cpu;
+    float mem_used;
+    float mem_total;
+}aggSample;
+///_|> descry: One sample of one source
+///_|> members:
+///_|>     - ts_ns: wall-clock time the sample was taken in ns, type long long
+///_|>     - cpu: CPU utilization in percent, type float
+///_|>     - mem_used / mem_total: memory in GB, type float
+
+typedef struct {
+    char path[256];
+    bool is_file;
+    int state;
+    int fd;
+    FILE* file;
+    StreamRecord partial;
+    size_t partial_len;
+    tsPoint* points;
+    int point_count;
+    int point_pos;
+    long long retry_ns;
+    aggSample queue[AGG_QUEUE_LEN];
+    int head;
+    int len;
+    aggSample current;
+    bool in_bucket;
+    unsigned long long merged;
+    unsigned long long late;
+}aggSource;
+///_|> descry: One merged stream
+///_|> members:
+///_|>     - path: daemon socket or recording, type char[256]
+///_|>     - is_file: whether path is a recording, type bool
+///_|>     - state: one of AggSourceState, type int
+///_|>     - fd: non-blocking socket of a daemon source, -1 otherwise, type int
+///_|>     - file: open recording of a file source, NULL otherwise, type FILE*
+///_|>     - partial / partial_len: record being received and its bytes so far, type StreamRecord / size_t
+///_|>     - points / point_count / point_pos: decoded block of a recording and the next sample to queue,
+///_|>                                         type tsPoint* / int / int
+///_|>     - retry_ns: monotonic time of the next connection attempt while missing, type long long
+///_|>     - queue / head / len: ring of samples not merged yet, oldest at head, type aggSample[] / int / int
+///_|>     - current / in_bucket: newest sample of the open bucket and whether there is one, type aggSample / bool
+///_|>     - merged / late: samples merged into a bucket and dropped as late, type unsigned long long
+
+typedef struct {
+    long long start_ns;
+    long long bucket_ns;
+    int reporting;
+    int sources;
+    float cpu_sum;
+    float cpu_mean;
+    float cpu_max;
+    float cpu_pct;
+    float mem_used_sum;
+    float mem_total_sum;
+    float mem_used_max;
+    float mem_used_pct;
+}aggBucket;
+///_|> descry: Fleet-wide values of one closed time bucket
+///_|> members:
+///_|>     - start_ns / bucket_ns: wall-clock start and width of the bucket in ns, type long long
+///_|>     - reporting / sources: sources with a sample in the bucket, and all sources, type int
+///_|>     - cpu_sum / cpu_mean / cpu_max / cpu_pct: CPU utilization across the reporting sources, the
+///_|>                                              percentile being AGG_PERCENTILE, type float
+///_|>     - mem_used_sum / mem_total_sum: used and total memory of the reporting sources in GB, type float
+///_|>     - mem_used_max / mem_used_pct: used memory of the busiest source and its percentile, type float
+
+typedef struct {
+    aggSource sources[AGG_MAX_SOURCES];
+    int count;
+    int heap[AGG_MAX_SOURCES];
+    int heap_len;
+    long long bucket_ns;
+    long long late_ns;
+    long long start_ns;
+    bool started;
+    unsigned long long buckets;
+    unsigned char* stream;
+}aggMerger;
+///_|> descry: Sources and merge state of --aggregate
+///_|> members:
+///_|>     - sources / count: the sources in command-line order, type aggSource[] / int
+///_|>     - heap / heap_len: indices of the sources with queued samples, min-heap on their oldest timestamp,
+///_|>                        type int[] / int
+///_|>     - bucket_ns / late_ns: bucket width and how long a bucket waits for a silent source, type long long
+///_|>     - start_ns / started: start of the open bucket, set by the first merged sample, type long long / bool
+///_|>     - buckets: buckets reported so far, type unsigned long long
+///_|>     - stream: read buffer for recording blocks, NULL until a file source is opened, type unsigned char*
+
+void agg_merger_init(aggMerger* merger, int count, long long bucket_ns, long long late_ns);
+
+int agg_merger_push(aggMerger* merger, int source, const aggSample* sample);
+
+void agg_merger_source_done(aggMerger* merger, int source);
+
+int agg_merger_next(aggMerger* merger, long long now_wall, aggBucket* out);
+
+int aggregator_open(aggMerger* merger, const char* spec, long long bucket_ns, long long late_ns);
+
+int aggregator_next(aggMerger* merger, aggBucket* out, int timeout_ms);
+
+void aggregator_close(aggMerger* merger);
+
+#endif
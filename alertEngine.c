@@ -0,0 +1,228 @@
+#define _POSIX_C_SOURCE 200809L
+#include "alertEngine.h"
+#include "timeTool.h"
+#include <spawn.h>
+#include <time.h>
+#include <sys/wait.h>
+
+extern char** environ;
+
+static AlertRule rules[ALERT_MAX_RULES];
+static int rule_count = 0;
+static int any_fired = 0;
+///_|> descry: internal state: the parsed rules and whether any of them fired during this run
+
+static int parse_level(const char* text, const char** end, alertLevel* level){
+    ///_|> descry: parses a threshold written as a number or as "FRACTION*total"
+    ///_|> text: text to parse, type const char*
+    ///_|> end: receives the position after the threshold, type const char**
+    ///_|> level: receives the threshold, type alertLevel*
+    ///_|> returning: returns 0 on success, -1 if no number was found
+    char* after;
+    level->value = strtod(text, &after);
+    if (after == text) return -1;
+    level->of_total = (strncmp(after, "*total", 6) == 0);
+    if (level->of_total) after += 6;
+    *end = after;
+    return 0;
+}
+
+static int parse_duration(const char* text, const char** end, long long* ns){
+    ///_|> descry: parses a duration such as "5s", "500ms" or "2m" (plain numbers are seconds)
+    ///_|> text: text to parse, type const char*
+    ///_|> end: receives the position after the duration, type const char**
+    ///_|> ns: receives the duration in nanoseconds, type long long*
+    ///_|> returning: returns 0 on success, -1 if no number was found
+    char* after;
+    double value = strtod(text, &after);
+    if (after == text || value < 0) return -1;
+    double scale = 1e9;
+    if (strncmp(after, "ms", 2) == 0){
+        scale = 1e6;
+        after += 2;
+    }else if (*after == 's'){
+        after++;
+    }else if (*after == 'm'){
+        scale = 60e9;
+        after++;
+    }
+    *ns = (long long)(value * scale);
+    *end = after;
+    return 0;
+}
+
+int alert_add_rule(const char* spec){
+    ///_|> descry: parses a rule (see the module comment) and adds it to the rule set
+    ///_|> spec: rule text as given to --alert=, type const char*
+    ///_|> returning: returns 0 on success, -1 on a syntax error or when ALERT_MAX_RULES is reached
+    if (rule_count == ALERT_MAX_RULES){
+        fprintf(stderr, "too many --alert rules (max %d)\n", ALERT_MAX_RULES);
+        return -1;
+    }
+    AlertRule rule;
+    memset(&rule, 0, sizeof(AlertRule));
+    rule.last_fired_ns = -1;
+    for (int i = 0; i < ALERT_MAX_HOOKS; i++) rule.hook_pids[i] = -1;
+
+    const char* op = strpbrk(spec, "<>");
+    if (op == NULL) return -1;
+    size_t metric_len = (size_t)(op - spec);
+    if (metric_len == 3 && strncmp(spec, "cpu", 3) == 0) rule.metric = ALERT_METRIC_CPU;
+    else if (metric_len == 8 && strncmp(spec, "mem_used", 8) == 0) rule.metric = ALERT_METRIC_MEM_USED;
+    else return -1;
+    rule.above = (*op == '>');
+    const char* p;
+    if (parse_level(op + 1, &p, &rule.threshold) == -1) return -1;
+    if (rule.threshold.of_total && rule.metric != ALERT_METRIC_MEM_USED) return -1;
+    rule.clear = rule.threshold;
+    snprintf(rule.name, sizeof(rule.name), "%.*s", (int)(p - spec), spec);
+
+    // options: ":key=value" pairs, hook= takes the rest of the spec (commands may contain ':')
+    while (*p == ':'){
+        p++;
+        if (strncmp(p, "hook=", 5) == 0){
+            snprintf(rule.hook, sizeof(rule.hook), "%s", p + 5);
+            p += strlen(p);
+        }else if (strncmp(p, "for=", 4) == 0){
+            if (parse_duration(p + 4, &p, &rule.for_ns) == -1) return -1;
+        }else if (strncmp(p, "cooldown=", 9) == 0){
+            if (parse_duration(p + 9, &p, &rule.cooldown_ns) == -1) return -1;
+        }else if (strncmp(p, "clear=", 6) == 0){
+            if (parse_level(p + 6, &p, &rule.clear) == -1) return -1;
+        }else{
+            return -1;
+        }
+    }
+    if (*p != '\0') return -1;
+    rules[rule_count++] = rule;
+    return 0;
+}
+
+int alert_rule_count(){
+    ///_|> descry: reports how many rules are loaded
+    ///_|> returning: returns the number of rules
+    return rule_count;
+}
+
+static void reap_rule_hooks(AlertRule* rule){
+    ///_|> descry: collects finished hook processes of a rule without waiting
+    ///_|> rule: rule whose hooks are checked, type AlertRule*
+    ///_|> returning: this function does not return anything
+    for (int i = 0; i < ALERT_MAX_HOOKS; i++){
+        if (rule->hook_pids[i] != -1 && waitpid(rule->hook_pids[i], NULL, WNOHANG) != 0){
+            rule->hook_pids[i] = -1;
+        }
+    }
+}
+
+static void run_hook(AlertRule* rule, const char* state, double value){
+    ///_|> descry: spawns the rule's hook as sh -c CMD with $1=rule, $2=state, $3=value, without waiting;
+    ///_|>         it gets its own process group so Ctrl+C stays with the monitor
+    ///_|> rule: rule that changed state, type AlertRule*
+    ///_|> state: "FIRING" or "RESOLVED", type const char*
+    ///_|> value: sample value that caused the transition, type double
+    ///_|> returning: this function does not return anything
+    reap_rule_hooks(rule);
+    int slot = -1;
+    for (int i = 0; i < ALERT_MAX_HOOKS && slot == -1; i++){
+        if (rule->hook_pids[i] == -1) slot = i;
+    }
+    if (slot == -1){
+        fprintf(stderr, "alert hook for %s skipped: %d hooks still running\n", rule->name, ALERT_MAX_HOOKS);
+        return;
+    }
+    char value_text[32];
+    snprintf(value_text, sizeof(value_text), "%.2f", value);
+    char* argv[] = {"sh", "-c", rule->hook, "alert-hook", rule->name, (char*)state, value_text, NULL};
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attr, 0);
+    pid_t pid;
+    int err = posix_spawn(&pid, "/bin/sh", NULL, &attr, argv, environ);
+    posix_spawnattr_destroy(&attr);
+    if (err != 0){
+        fprintf(stderr, "alert hook for %s failed to start: %s\n", rule->name, strerror(err));
+        return;
+    }
+    rule->hook_pids[slot] = pid;
+}
+
+static void report_transition(AlertRule* rule, const char* state, double value, long long timestamp_ns){
+    ///_|> descry: prints a timestamped event for a state change and runs the hook
+    ///_|> rule: rule that changed state, type AlertRule*
+    ///_|> state: "FIRING" or "RESOLVED", type const char*
+    ///_|> value: sample value that caused the transition, type double
+    ///_|> timestamp_ns: monotonic time of that sample, type long long
+    ///_|> returning: this function does not return anything
+    long long wall_ns = now_wall_ns() - (now_mono_ns() - timestamp_ns);
+    time_t seconds = (time_t)(wall_ns / 1000000000LL);
+    struct tm utc;
+    gmtime_r(&seconds, &utc);
+    char stamp[32];
+    strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", &utc);
+    fprintf(stderr, "%s.%03lldZ ALERT %s %s value=%.2f\n", stamp, (wall_ns / 1000000LL) % 1000, state, rule->name, value);
+    if (rule->hook[0] != '\0') run_hook(rule, state, value);
+}
+
+static double level_value(const alertLevel* level, float total_memory){
+    ///_|> descry: resolves a threshold for the current sample
+    ///_|> level: threshold, type const alertLevel*
+    ///_|> total_memory: total memory of the sample in GB, type float
+    ///_|> returning: returns the threshold in the metric's unit
+    return level->of_total ? level->value * total_memory : level->value;
+}
+
+void alert_evaluate(float cpu_utiliz, float used_memory, float total_memory, long long timestamp_ns){
+    ///_|> descry: advances every rule's state machine by one sample, O(1) per rule
+    ///_|> cpu_utiliz: CPU utilization in percent, negative when the CPU graph is off, type float
+    ///_|> used_memory / total_memory: memory in GB, negative when the memory graph is off, type float
+    ///_|> timestamp_ns: monotonic time of the sample, type long long
+    ///_|> returning: this function does not return anything
+    for (int i = 0; i < rule_count; i++){
+        AlertRule* rule = &rules[i];
+        if (rule->hook[0] != '\0') reap_rule_hooks(rule);
+        double value = (rule->metric == ALERT_METRIC_CPU) ? cpu_utiliz : used_memory;
+        if (value < 0) continue; // metric not sampled in this run
+        double threshold = level_value(&rule->threshold, total_memory);
+        bool active = rule->above ? value > threshold : value < threshold;
+
+        if (rule->state == ALERT_FIRING){
+            double clear = level_value(&rule->clear, total_memory);
+            bool cleared = rule->above ? value <= clear : value >= clear;
+            if (cleared){
+                rule->state = ALERT_IDLE;
+                report_transition(rule, "RESOLVED", value, timestamp_ns);
+            }
+            continue;
+        }
+        if (!active){
+            rule->state = ALERT_IDLE;
+            continue;
+        }
+        if (rule->state == ALERT_IDLE){
+            rule->state = ALERT_PENDING;
+            rule->pending_since_ns = timestamp_ns;
+        }
+        bool held = timestamp_ns - rule->pending_since_ns >= rule->for_ns;
+        bool cooled = rule->last_fired_ns < 0 || timestamp_ns - rule->last_fired_ns >= rule->cooldown_ns;
+        if (held && cooled){
+            rule->state = ALERT_FIRING;
+            rule->last_fired_ns = timestamp_ns;
+            any_fired = 1;
+            report_transition(rule, "FIRING", value, timestamp_ns);
+        }
+    }
+}
+
+int alert_any_fired(){
+    ///_|> descry: checks whether any rule fired during this run
+    ///_|> returning: returns 1 if a rule fired, otherwise 0
+    return any_fired;
+}
+
+void alert_reap_hooks(){
+    ///_|> descry: collects finished hook processes of every rule without waiting (running ones are left alone)
+    ///_|> returning: this function does not return anything
+    for (int i = 0; i < rule_count; i++) reap_rule_hooks(&rules[i]);
+}
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+#ifndef ALERT_ENGINE_HEADER
+#define ALERT_ENGINE_HEADER
+
+/*
+This module evaluates threshold rules over the utilization stream in the consumer (--alert=RULE).
+A rule is  METRIC OP THRESHOLD[:for=DUR][:clear=VALUE][:cooldown=DUR][:hook=CMD]  e.g.
+  cpu>90:for=5s:clear=80:cooldown=30s      mem_used>0.95*total:hook=notify-send "$1 $2"
+METRIC is cpu (percent) or mem_used (GB); thresholds may be written as a fraction of total memory.
+Each rule is a small state machine (idle -> pending -> firing -> idle) updated in O(1) per sample
+from the sample's timestamp, so "for" needs no history. clear gives hysteresis, cooldown suppresses
+re-firing. Transitions are printed to stderr with a UTC timestamp, and the optional hook runs as
+sh -c CMD with $1=rule, $2=FIRING|RESOLVED, $3=value, spawned without waiting for it.
+Like selfStats, the rules live in module-level state of the consumer process.
+*/
+
+#define ALERT_MAX_RULES 8
+#define ALERT_SPEC_LEN 256
+#define ALERT_MAX_HOOKS 4  // hooks of one rule still running at a time, further ones are skipped
+#define ALERT_EXIT_FIRED 2 // exit status of a run during which any rule fired
+
+typedef enum {
+    ALERT_METRIC_CPU = 0,
+    ALERT_METRIC_MEM_USED = 1
+}AlertMetric;
+///_|> descry: Value a rule watches
+///_|> members:
+///_|>     - ALERT_METRIC_CPU: CPU utilization in percent
+///_|>     - ALERT_METRIC_MEM_USED: used memory in GB
+
+typedef enum {
+    ALERT_IDLE = 0,
+    ALERT_PENDING = 1,
+    ALERT_FIRING = 2
+}AlertState;
+///_|> descry: State of one rule
+///_|> members:
+///_|>     - ALERT_IDLE: condition not met (or cleared)
+///_|>     - ALERT_PENDING: condition met since pending_since_ns, waiting for "for" (or for the cooldown)
+///_|>     - ALERT_FIRING: fired, stays until the value crosses the clear level
+
+typedef struct {
+    double value;
+    bool of_total;
+}alertLevel;
+///_|> descry: A threshold, absolute or as a fraction of total memory
+///_|> members:
+///_|>     - value: threshold, or the fraction when of_total is set, type double
+///_|>     - of_total: whether value multiplies the sample's total memory ("0.95*total"), type bool
+
+typedef struct {
+    char name[64];
+    int metric;
+    bool above;
+    alertLevel threshold;
+    alertLevel clear;
+    long long for_ns;
+    long long cooldown_ns;
+    char hook[ALERT_SPEC_LEN];
+    int state;
+    long long pending_since_ns;
+    long long last_fired_ns;
+    pid_t hook_pids[ALERT_MAX_HOOKS];
+}AlertRule;
+///_|> descry: One parsed rule and its state
+///_|> members:
+///_|>     - name: the condition part of the spec (e.g. "cpu>90"), used in events, type char[64]
+///_|>     - metric: one of AlertMetric, type int
+///_|>     - above: true for '>', false for '<', type bool
+///_|>     - threshold / clear: firing level and clearing level (defaults to threshold), type alertLevel
+///_|>     - for_ns: how long the condition must hold before firing, type long long
+///_|>     - cooldown_ns: minimum time between two firings, type long long
+///_|>     - hook: command run on every transition, empty for none, type char[]
+///_|>     - state / pending_since_ns / last_fired_ns: state machine, type int / long long / long long
+///_|>     - hook_pids: hook processes not yet reaped, -1 for a free slot, type pid_t[]
+
+int alert_add_rule(const char* spec);
+
+int alert_rule_count();
+
+void alert_evaluate(float cpu_utiliz, float used_memory, float total_memory, long long timestamp_ns);
+
+int alert_any_fired();
+
+void alert_reap_hooks();
+
+#endif
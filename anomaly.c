@@ -0,0 +1,36 @@
+#include "anomaly.h"
+
+void anomaly_init(AnomalyDetector* detector, float k, float min_stddev){
+    ///_|> descry: resets a detector
+    ///_|> detector: detector to initialize, type AnomalyDetector*
+    ///_|> k: threshold in standard deviations, type float
+    ///_|> min_stddev: smallest standard deviation the test assumes, in the metric's unit, type float
+    ///_|> returning: this function does not return anything
+    detector->mean = 0.0f;
+    detector->var = 0.0f;
+    detector->k = k;
+    detector->min_var = min_stddev * min_stddev;
+    detector->count = 0;
+}
+
+int anomaly_update(AnomalyDetector* detector, float value){
+    ///_|> descry: tests a sample against the baseline, then folds it into the EWMA mean and variance
+    ///_|> detector: detector of the metric, type AnomalyDetector*
+    ///_|> value: newest sample, type float
+    ///_|> returning: returns 1 if the sample lies more than k standard deviations from the mean, 0 otherwise
+    if (detector->count == 0){
+        detector->mean = value;
+        detector->count = 1;
+        return 0;
+    }
+    float diff = value - detector->mean;
+    float var = (detector->var > detector->min_var) ? detector->var : detector->min_var;
+    int anomalous = (detector->count >= ANOMALY_WARMUP && diff * diff > detector->k * detector->k * var);
+
+    // incremental EWMA: the variance update uses the deviation from the old mean
+    float incr = ANOMALY_ALPHA * diff;
+    detector->mean += incr;
+    detector->var = (1.0f - ANOMALY_ALPHA) * (detector->var + diff * incr);
+    if (detector->count < ANOMALY_WARMUP) detector->count++;
+    return anomalous;
+}
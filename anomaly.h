@@ -0,0 +1,52 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#ifndef ANOMALY_HEADER
+#define ANOMALY_HEADER
+
+/*
+This module flags anomalous samples of a metric online (--anomaly[=K]). A detector keeps an
+exponentially weighted mean and variance of the series; a sample more than K standard deviations
+away from the mean seen so far is anomalous. Each update is O(1) and the whole state is five
+numbers, so the consumer (or daemon) can keep one detector per metric for the whole run.
+Flagged samples are drawn with ANOMALY_GLYPH on the charts and carried in UtilizInfo.anomaly,
+which the daemon publishes to its viewers.
+*/
+
+#define ANOMALY_DEFAULT_K 3.0f
+#define ANOMALY_ALPHA 0.1f        // weight of the newest sample, roughly a 20-sample memory
+#define ANOMALY_WARMUP 8          // samples seen before anything can be flagged
+#define ANOMALY_CPU_MIN_STDDEV 1.0f   // percent; a flat series must still move this much to be flagged
+#define ANOMALY_MEM_MIN_STDDEV 0.01f  // GB
+#define ANOMALY_GLYPH '!'
+
+typedef enum {
+    ANOMALY_NONE = 0,
+    ANOMALY_CPU = 1,
+    ANOMALY_MEM = 2
+}AnomalyFlag;
+///_|> descry: Bits of UtilizInfo.anomaly
+///_|> members:
+///_|>     - ANOMALY_CPU: the CPU reading of the sample is anomalous
+///_|>     - ANOMALY_MEM: the used-memory reading of the sample is anomalous
+
+typedef struct {
+    float mean;
+    float var;
+    float k;
+    float min_var;
+    unsigned int count;
+}AnomalyDetector;
+///_|> descry: EWMA state of one metric
+///_|> members:
+///_|>     - mean / var: exponentially weighted mean and variance of the samples so far, type float
+///_|>     - k: number of standard deviations beyond which a sample is anomalous, type float
+///_|>     - min_var: floor of the variance used for the test, so tiny wiggles of a flat series pass, type float
+///_|>     - count: samples seen, saturating at ANOMALY_WARMUP, type unsigned int
+
+void anomaly_init(AnomalyDetector* detector, float k, float min_stddev);
+
+int anomaly_update(AnomalyDetector* detector, float value);
+
+#endif
@@ -0,0 +1,51 @@
+#define _DEFAULT_SOURCE
+#include "arena.h"
+#include <pthread.h>
+#include <sys/mman.h>
+
+static char* arena_base = NULL;
+static size_t arena_offset = 0;
+static pthread_once_t arena_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t arena_lock = PTHREAD_MUTEX_INITIALIZER;
+///_|> descry: internal state of the process arena: mapping base and bump offset, the one-time mapping and
+///_|>         the lock of the offset (--engine=threads workers set up their collectors concurrently)
+
+static void arena_map(){
+    ///_|> descry: reserves the arena mapping, run once per process through arena_once
+    ///_|> returning: this function does not return anything
+    void* mapped = mmap(NULL, ARENA_RESERVE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mapped == MAP_FAILED){
+        perror("mmap for process arena failed");
+        return;
+    }
+    arena_base = (char*)mapped;
+}
+
+void* arena_alloc(size_t size){
+    ///_|> descry: hands out a 64-byte aligned, zero-filled block from the process arena; safe to call from
+    ///_|>         several threads
+    ///_|> size: number of bytes needed, type size_t
+    ///_|> returning: returns the block, or NULL if the arena cannot be mapped or is exhausted
+    pthread_once(&arena_once, arena_map);
+    if (arena_base == NULL) return NULL;
+    size_t aligned = (size + 63) & ~(size_t)63; // cache-line aligned blocks
+    pthread_mutex_lock(&arena_lock);
+    if (arena_offset + aligned > ARENA_RESERVE){
+        pthread_mutex_unlock(&arena_lock);
+        fprintf(stderr, "process arena exhausted (%zu bytes requested)\n", size);
+        return NULL;
+    }
+    void* block = arena_base + arena_offset;
+    arena_offset += aligned;
+    pthread_mutex_unlock(&arena_lock);
+    return block;
+}
+
+size_t arena_used(){
+    ///_|> descry: reports how much of the process arena has been handed out
+    ///_|> returning: returns the number of bytes allocated so far
+    pthread_mutex_lock(&arena_lock);
+    size_t used = arena_offset;
+    pthread_mutex_unlock(&arena_lock);
+    return used;
+}
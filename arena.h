@@ -0,0 +1,23 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef ARENA_HEADER
+#define ARENA_HEADER
+
+/*
+This module provides the per-process arena used by the allocation-free collector APIs (fill_*).
+It is one anonymous mapping reserved on first use; memory is handed out with a bump pointer and 
+never freed, so collectors take their variable-sized buffers once at start-up and the steady-state 
+sampling loop never touches the heap. A forked producer inherits its own copy of the arena.
+The mapping is made once (pthread_once) and the offset is bumped under a lock, so the worker threads of
+--engine=threads can set up their collectors at the same time; this is start-up only, never per sample.
+*/
+
+#define ARENA_RESERVE (64UL * 1024 * 1024) // address space only, pages are touched on use
+
+void* arena_alloc(size_t size);
+
+size_t arena_used();
+
+#endif
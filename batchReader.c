@@ -0,0 +1,308 @@
+#define _DEFAULT_SOURCE
+#include "batchReader.h"
+#include "arena.h"
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+// glibc has no io_uring wrappers, the three syscalls are issued directly
+static int uring_setup(unsigned entries, struct io_uring_params* params){
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int uring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags){
+    return (int)syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int uring_register(int ring_fd, unsigned opcode, void* arg, unsigned nr_args){
+    return (int)syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args);
+}
+
+static void close_ring(BatchReader* reader){
+    ///_|> descry: unmaps and closes the io_uring instance and switches the reader to pread
+    ///_|> reader: batch reader, type BatchReader*
+    ///_|> returning: this function does not return anything
+    if (reader->sqes != NULL) munmap(reader->sqes, reader->sqes_size);
+    if (reader->cq_map != NULL && reader->cq_map != reader->sq_map) munmap(reader->cq_map, reader->cq_map_size);
+    if (reader->sq_map != NULL) munmap(reader->sq_map, reader->sq_map_size);
+    if (reader->ring_fd != -1) close(reader->ring_fd);
+    reader->sqes = NULL;
+    reader->cq_map = NULL;
+    reader->sq_map = NULL;
+    reader->ring_fd = -1;
+    reader->registered = false;
+    reader->backend = BATCH_BACKEND_PREAD;
+}
+
+static int open_ring(BatchReader* reader){
+    ///_|> descry: creates an io_uring instance sized for BATCH_MAX_SOURCES and maps its rings
+    ///_|> reader: batch reader, type BatchReader*
+    ///_|> returning: returns 0 on success, -1 if io_uring is unavailable
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    reader->ring_fd = uring_setup(BATCH_MAX_SOURCES, &params);
+    if (reader->ring_fd == -1) return -1;
+
+    reader->sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    reader->cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP){
+        if (reader->cq_map_size > reader->sq_map_size) reader->sq_map_size = reader->cq_map_size;
+    }
+    reader->sq_map = mmap(NULL, reader->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, \
+                          reader->ring_fd, IORING_OFF_SQ_RING);
+    if (reader->sq_map == MAP_FAILED){
+        reader->sq_map = NULL;
+        close_ring(reader);
+        return -1;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP){
+        reader->cq_map = reader->sq_map;
+    }else{
+        reader->cq_map = mmap(NULL, reader->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, \
+                              reader->ring_fd, IORING_OFF_CQ_RING);
+        if (reader->cq_map == MAP_FAILED){
+            reader->cq_map = NULL;
+            close_ring(reader);
+            return -1;
+        }
+    }
+    reader->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    reader->sqes = mmap(NULL, reader->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, \
+                        reader->ring_fd, IORING_OFF_SQES);
+    if (reader->sqes == MAP_FAILED){
+        reader->sqes = NULL;
+        close_ring(reader);
+        return -1;
+    }
+    char* sq = (char*)reader->sq_map;
+    char* cq = (char*)reader->cq_map;
+    reader->sq_head = (unsigned*)(sq + params.sq_off.head);
+    reader->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+    reader->sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+    reader->sq_array = (unsigned*)(sq + params.sq_off.array);
+    reader->cq_head = (unsigned*)(cq + params.cq_off.head);
+    reader->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+    reader->cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+    reader->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    return 0;
+}
+
+void batch_reader_init(BatchReader* reader, int want_uring){
+    ///_|> descry: initializes an empty batch reader, with io_uring when wanted and available
+    ///_|> reader: batch reader to initialize, type BatchReader*
+    ///_|> want_uring: non-zero to try the io_uring backend, type int
+    ///_|> returning: this function does not return anything; check reader->backend for the outcome
+    memset(reader, 0, sizeof(BatchReader));
+    reader->ring_fd = -1;
+    reader->backend = BATCH_BACKEND_PREAD;
+    if (want_uring && open_ring(reader) == 0){
+        reader->backend = BATCH_BACKEND_URING;
+    }
+}
+
+int batch_reader_add(BatchReader* reader, procFile* file, size_t size){
+    ///_|> descry: registers a source read every tick, with a size-byte buffer from the process arena
+    ///_|> reader: batch reader, type BatchReader*
+    ///_|> file: cached procfs/sysfs file, type procFile*
+    ///_|> size: buffer size, the source is read up to size-1 bytes, type size_t
+    ///_|> returning: returns the source index used with batch_reader_text, or -1 on failure
+    if (reader->count == BATCH_MAX_SOURCES){
+        fprintf(stderr, "batch reader is full (%d sources)\n", BATCH_MAX_SOURCES);
+        return -1;
+    }
+    if (proc_file_fd(file) == -1){
+        perror(file->abs_path);
+        return -1;
+    }
+    char* buf = arena_alloc(size);
+    if (buf == NULL) return -1;
+    batchSource* source = &reader->sources[reader->count];
+    source->file = file;
+    source->buf = buf;
+    source->size = size;
+    source->len = -1;
+    reader->registered = false; // the fixed file and buffer tables are rebuilt on the next tick
+    return reader->count++;
+}
+
+static int register_sources(BatchReader* reader){
+    ///_|> descry: (re-)registers every source's fd and buffer with the ring
+    ///_|> reader: batch reader using the io_uring backend, type BatchReader*
+    ///_|> returning: returns 0 on success, -1 if registration failed
+    uring_register(reader->ring_fd, IORING_UNREGISTER_FILES, NULL, 0);
+    uring_register(reader->ring_fd, IORING_UNREGISTER_BUFFERS, NULL, 0);
+    struct iovec iov[BATCH_MAX_SOURCES];
+    for (int i = 0; i < reader->count; i++){
+        iov[i].iov_base = reader->sources[i].buf;
+        iov[i].iov_len = reader->sources[i].size;
+    }
+    if (uring_register(reader->ring_fd, IORING_REGISTER_FILES, reader->registered_fds, reader->count) == -1){
+        return -1;
+    }
+    if (uring_register(reader->ring_fd, IORING_REGISTER_BUFFERS, iov, reader->count) == -1){
+        return -1;
+    }
+    reader->registered = true;
+    return 0;
+}
+
+static int reap_completions(BatchReader* reader){
+    ///_|> descry: takes every completion off the completion ring and records its source's result
+    ///_|> reader: batch reader using the io_uring backend, type BatchReader*
+    ///_|> returning: returns the number of completions reaped
+    int reaped = 0;
+    unsigned head = *reader->cq_head;
+    unsigned cq_tail = __atomic_load_n(reader->cq_tail, __ATOMIC_ACQUIRE);
+    while (head != cq_tail){
+        struct io_uring_cqe* cqe = &reader->cqes[head & *reader->cq_mask];
+        batchSource* source = &reader->sources[cqe->user_data];
+        source->len = (cqe->res >= 0) ? cqe->res : -1;
+        if (cqe->res >= 0) source->buf[cqe->res] = '\0';
+        head++;
+        reaped++;
+    }
+    __atomic_store_n(reader->cq_head, head, __ATOMIC_RELEASE);
+    return reaped;
+}
+
+static int drain_ring(BatchReader* reader, int in_flight){
+    ///_|> descry: waits for reads already submitted to complete, so that their buffers can be reused
+    ///_|> reader: batch reader using the io_uring backend, type BatchReader*
+    ///_|> in_flight: reads submitted and not reaped yet, type int
+    ///_|> returning: returns 0 once all of them have completed, -1 if the ring cannot be waited on
+    while (in_flight > 0){
+        reader->syscalls++;
+        if (uring_enter(reader->ring_fd, 0, (unsigned)in_flight, IORING_ENTER_GETEVENTS) == -1){
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        in_flight -= reap_completions(reader);
+    }
+    return 0;
+}
+
+static int replace_buffers(BatchReader* reader){
+    ///_|> descry: moves every source to a new arena buffer, leaving the old ones to reads the ring may still
+    ///_|>         complete; the arena never frees, so the old buffers stay valid
+    ///_|> reader: batch reader, type BatchReader*
+    ///_|> returning: returns 0 on success, -1 if the arena is exhausted
+    char* bufs[BATCH_MAX_SOURCES];
+    for (int i = 0; i < reader->count; i++){
+        bufs[i] = arena_alloc(reader->sources[i].size);
+        if (bufs[i] == NULL) return -1;
+    }
+    for (int i = 0; i < reader->count; i++) reader->sources[i].buf = bufs[i];
+    return 0;
+}
+
+static int read_all_uring(BatchReader* reader){
+    ///_|> descry: one tick on the io_uring backend: queues a READ_FIXED per source, submits and waits
+    ///_|>         for all of them with a single io_uring_enter, then reaps the completions
+    ///_|> reader: batch reader using the io_uring backend, type BatchReader*
+    ///_|> returning: returns the number of sources read, or -1 if the ring failed; after a failure no
+    ///_|>            read of the ring is left writing into the sources' buffers
+    unsigned tail = *reader->sq_tail;
+    unsigned mask = *reader->sq_mask;
+    for (int i = 0; i < reader->count; i++){
+        struct io_uring_sqe* sqe = &reader->sqes[i];
+        memset(sqe, 0, sizeof(struct io_uring_sqe));
+        sqe->opcode = IORING_OP_READ_FIXED;
+        sqe->flags = IOSQE_FIXED_FILE;
+        sqe->fd = i; // index into the registered file table
+        sqe->addr = (unsigned long long)(unsigned long)reader->sources[i].buf;
+        sqe->len = (unsigned)(reader->sources[i].size - 1);
+        sqe->off = 0;
+        sqe->buf_index = (unsigned short)i;
+        sqe->user_data = (unsigned long long)i;
+        reader->sq_array[(tail + i) & mask] = (unsigned)i;
+        reader->sources[i].len = -1;
+    }
+    __atomic_store_n(reader->sq_tail, tail + reader->count, __ATOMIC_RELEASE);
+
+    int submitted = 0;
+    int completed = 0;
+    while (completed < reader->count){
+        reader->syscalls++;
+        int ret = uring_enter(reader->ring_fd, reader->count - submitted, reader->count - completed, \
+                              IORING_ENTER_GETEVENTS);
+        if (ret == -1){
+            if (errno == EINTR) continue;
+            int err = errno;
+            // reads submitted earlier in this tick still target the registered buffers; the pread fallback
+            // may only reuse them once those reads have completed
+            if (drain_ring(reader, submitted - completed) == -1 && replace_buffers(reader) == -1){
+                fprintf(stderr, "io_uring reads cannot be waited for and the arena is full, batch reads stop\n");
+                reader->count = 0;
+            }
+            errno = err;
+            return -1;
+        }
+        submitted += ret;
+        completed += reap_completions(reader);
+    }
+    return completed;
+}
+
+int batch_reader_read_all(BatchReader* reader){
+    ///_|> descry: reads every registered source once (one tick); each buffer is NUL-terminated afterwards
+    ///_|> reader: batch reader, type BatchReader*
+    ///_|> returning: returns the number of sources read successfully, -1 if no source could be read
+    // a source reopens after a --proc-root change; its new fd must be registered again
+    for (int i = 0; i < reader->count; i++){
+        int fd = proc_file_fd(reader->sources[i].file);
+        if (fd != reader->registered_fds[i]){
+            reader->registered_fds[i] = fd;
+            reader->registered = false;
+        }
+    }
+    if (reader->backend == BATCH_BACKEND_URING){
+        if (!reader->registered && register_sources(reader) == -1){
+            perror("io_uring registration failed, falling back to pread");
+            close_ring(reader);
+        }
+    }
+    if (reader->backend == BATCH_BACKEND_URING){
+        int done = read_all_uring(reader);
+        if (done != -1) return done;
+        perror("io_uring_enter failed, falling back to pread");
+        close_ring(reader);
+    }
+    int done = 0;
+    for (int i = 0; i < reader->count; i++){
+        batchSource* source = &reader->sources[i];
+        reader->syscalls++;
+        source->len = (reader->registered_fds[i] == -1) ? -1 : \
+                      pread(reader->registered_fds[i], source->buf, source->size - 1, 0);
+        if (source->len >= 0){
+            source->buf[source->len] = '\0';
+            done++;
+        }
+    }
+    return (done == 0 && reader->count > 0) ? -1 : done;
+}
+
+const char* batch_reader_text(BatchReader* reader, int index){
+    ///_|> descry: gives the contents a source had in the last tick
+    ///_|> reader: batch reader, type BatchReader*
+    ///_|> index: source index returned by batch_reader_add, type int
+    ///_|> returning: returns the NUL-terminated contents, or NULL if the source could not be read
+    if (index < 0 || index >= reader->count || reader->sources[index].len < 0) return NULL;
+    return reader->sources[index].buf;
+}
+
+const char* batch_reader_backend_name(BatchReader* reader){
+    ///_|> descry: names the backend in use, for reports
+    ///_|> reader: batch reader, type BatchReader*
+    ///_|> returning: returns "io_uring" or "pread"
+    return (reader->backend == BATCH_BACKEND_URING) ? "io_uring" : "pread";
+}
+
+void batch_reader_close(BatchReader* reader){
+    ///_|> descry: releases the ring; source files stay cached in their procFile and buffers in the arena
+    ///_|> reader: batch reader, type BatchReader*
+    ///_|> returning: this function does not return anything
+    close_ring(reader);
+    reader->count = 0;
+}
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <sys/types.h>
+#include <linux/io_uring.h>
+
+#include "procRoot.h"
+
+#ifndef BATCH_READER_HEADER
+#define BATCH_READER_HEADER
+
+/*
+This module reads every registered procfs/sysfs source of a sampling tick in one batch (--batch-io).
+With the io_uring backend the sources' fds and buffers are registered with the kernel once, and a
+tick is a single io_uring_enter() submitting one READ_FIXED per source and waiting for all of them;
+the parsers then run on the filled buffers. When io_uring is unavailable (old kernel, seccomp,
+kernel.io_uring_disabled) the same calls fall back to one pread per source.
+Buffers come from the process arena; the ring is driven through raw syscalls, no liburing needed.
+*/
+
+#define BATCH_MAX_SOURCES 64
+
+typedef enum {
+    BATCH_BACKEND_PREAD = 0,
+    BATCH_BACKEND_URING = 1
+}BatchBackend;
+///_|> descry: How a BatchReader performs its reads
+///_|> members:
+///_|>     - BATCH_BACKEND_PREAD: one pread() per source and tick
+///_|>     - BATCH_BACKEND_URING: one io_uring_enter() per tick for all sources
+
+typedef struct {
+    procFile* file;
+    char* buf;
+    size_t size;
+    ssize_t len;
+}batchSource;
+///_|> descry: One source read every tick
+///_|> members:
+///_|>     - file: cached procfs/sysfs file, type procFile*
+///_|>     - buf: arena buffer receiving the NUL-terminated contents, type char*
+///_|>     - size: size of buf (at most size-1 bytes are read), type size_t
+///_|>     - len: bytes read in the last tick, -1 if that read failed, type ssize_t
+
+typedef struct {
+    int backend;
+    int count;
+    batchSource sources[BATCH_MAX_SOURCES];
+    int registered_fds[BATCH_MAX_SOURCES];
+    bool registered;
+    int ring_fd;
+    void* sq_map;
+    size_t sq_map_size;
+    void* cq_map;
+    size_t cq_map_size;
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_cqe* cqes;
+    unsigned long long syscalls;
+}BatchReader;
+///_|> descry: Sources of a tick plus the io_uring state used to read them
+///_|> members:
+///_|>     - backend: one of BatchBackend, type int
+///_|>     - count / sources: registered sources, type int / batchSource[]
+///_|>     - registered_fds / registered: fds registered with the ring, re-registered when a source reopens,
+///_|>                                    type int[] / bool
+///_|>     - ring_fd: io_uring instance, -1 with the pread backend, type int
+///_|>     - sq_map / cq_map / sqes (+ sizes): mmapped submission ring, completion ring and SQE array
+///_|>     - sq_* / cq_* / cqes: pointers into the mapped rings, type unsigned* / struct io_uring_cqe*
+///_|>     - syscalls: read-side syscalls issued so far (pread or io_uring_enter), type unsigned long long
+
+void batch_reader_init(BatchReader* reader, int want_uring);
+
+int batch_reader_add(BatchReader* reader, procFile* file, size_t size);
+
+int batch_reader_read_all(BatchReader* reader);
+
+const char* batch_reader_text(BatchReader* reader, int index);
+
+const char* batch_reader_backend_name(BatchReader* reader);
+
+void batch_reader_close(BatchReader* reader);
+
+#endif
@@ -0,0 +1,118 @@
+#define _POSIX_C_SOURCE 200809L
+#include "benchTool.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include "timeTool.h"
+
+#define DEFAULT_MIN_NS 200000000LL // time each benchmark for at least 0.2 s
+
+// glibc entry points behind the interposed allocator
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+
+static unsigned long long alloc_count = 0;
+static unsigned long long alloc_bytes = 0;
+static int saved_stdout = -1;
+
+void* malloc(size_t size){
+    alloc_count++;
+    alloc_bytes += size;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size){
+    alloc_count++;
+    alloc_bytes += count * size;
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size){
+    alloc_count++;
+    alloc_bytes += size;
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr){
+    __libc_free(ptr);
+}
+
+unsigned long long bench_alloc_count(){
+    ///_|> descry: returns the number of heap allocations made by the process so far
+    ///_|> returning: returns the allocation counter, type unsigned long long
+    return alloc_count;
+}
+
+BenchResult bench_measure(BenchFn fn, void* arg, long long min_ns){
+    ///_|> descry: calls fn in growing batches until min_ns of run time is reached
+    ///_|> fn: function under test, type BenchFn
+    ///_|> arg: argument passed to every call, type void*
+    ///_|> min_ns: minimum total run time in nanoseconds, type long long
+    ///_|> returning: returns the measured BenchResult
+    fn(arg); // warm up caches and lazily opened files
+    unsigned long long batch = 1;
+    unsigned long long iters = 0;
+    unsigned long long allocs_before = alloc_count;
+    unsigned long long bytes_before = alloc_bytes;
+    long long start = now_mono_ns();
+    long long elapsed = 0;
+    while (elapsed < min_ns){
+        for (unsigned long long i = 0; i < batch; i++) fn(arg);
+        iters += batch;
+        if (batch < (1ULL << 20)) batch *= 2;
+        elapsed = now_mono_ns() - start;
+    }
+    BenchResult result;
+    result.iters = iters;
+    result.ns_per_op = (double)elapsed / iters;
+    result.allocs_per_op = (double)(alloc_count - allocs_before) / iters;
+    result.bytes_per_op = (double)(alloc_bytes - bytes_before) / iters;
+    return result;
+}
+
+void bench_report(const char* name, const char* params_json, BenchResult* result){
+    ///_|> descry: prints one benchmark result as a JSON object on its own line
+    ///_|> name: benchmark name, type const char*
+    ///_|> params_json: extra "key":value pairs without braces, or NULL, type const char*
+    ///_|> result: measured result, type BenchResult*
+    ///_|> returning: this function does not return anything
+    const char* label = getenv("BENCH_LABEL");
+    printf("{\"bench\":\"%s\"", name);
+    if (label != NULL && label[0] != '\0') printf(",\"label\":\"%s\"", label);
+    if (params_json != NULL && params_json[0] != '\0') printf(",%s", params_json);
+    printf(",\"iters\":%llu,\"ns_per_op\":%.1f,\"allocs_per_op\":%.2f,\"bytes_per_op\":%.1f}\n", \
+           result->iters, result->ns_per_op, result->allocs_per_op, result->bytes_per_op);
+    fflush(stdout);
+}
+
+void bench_run(const char* name, const char* params_json, BenchFn fn, void* arg){
+    ///_|> descry: measures fn with the default minimum run time and reports the result
+    ///_|> name: benchmark name, type const char*
+    ///_|> params_json: extra "key":value pairs without braces, or NULL, type const char*
+    ///_|> fn: function under test, type BenchFn
+    ///_|> arg: argument passed to every call, type void*
+    ///_|> returning: this function does not return anything
+    BenchResult result = bench_measure(fn, arg, DEFAULT_MIN_NS);
+    bench_report(name, params_json, &result);
+}
+
+void bench_silence_stdout(){
+    ///_|> descry: redirects stdout to /dev/null so renderers can be timed without a terminal
+    ///_|> returning: this function does not return anything
+    fflush(stdout);
+    saved_stdout = dup(STDOUT_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    dup2(null_fd, STDOUT_FILENO);
+    close(null_fd);
+}
+
+void bench_restore_stdout(){
+    ///_|> descry: undoes bench_silence_stdout
+    ///_|> returning: this function does not return anything
+    fflush(stdout);
+    if (saved_stdout == -1) return;
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+    saved_stdout = -1;
+}
@@ -0,0 +1,43 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef BENCH_TOOL_HEADER
+#define BENCH_TOOL_HEADER
+
+/*
+Shared harness of the microbenchmarks (make bench). It times a function until a minimum run time
+is reached, counts heap allocations made meanwhile (malloc/calloc/realloc are interposed in
+benchTool.c, so allocations inside libc such as fopen's buffer are counted too), and prints one
+JSON object per benchmark: ns/op, allocs/op and bytes/op. Set BENCH_LABEL (e.g. a commit id)
+to tag every line so runs of different commits can be compared.
+*/
+
+typedef void (*BenchFn)(void* arg);
+
+typedef struct {
+    unsigned long long iters;
+    double ns_per_op;
+    double allocs_per_op;
+    double bytes_per_op;
+}BenchResult;
+///_|> descry: Result of one benchmark run
+///_|> members:
+///_|>     - iters: number of calls timed, type unsigned long long
+///_|>     - ns_per_op: average wall time per call in nanoseconds, type double
+///_|>     - allocs_per_op: average heap allocations per call, type double
+///_|>     - bytes_per_op: average bytes allocated per call, type double
+
+BenchResult bench_measure(BenchFn fn, void* arg, long long min_ns);
+
+void bench_report(const char* name, const char* params_json, BenchResult* result);
+
+void bench_run(const char* name, const char* params_json, BenchFn fn, void* arg);
+
+unsigned long long bench_alloc_count();
+
+void bench_silence_stdout();
+
+void bench_restore_stdout();
+
+#endif
@@ -0,0 +1,290 @@
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#include "benchTool.h"
+#include "aggregator.h"
+#include "timeTool.h"
+
+/*
+The --aggregate merge, first on its own: k sources (4 to 64) each report one sample per bucket at
+their own offset, and the heap merges them bucket by bucket; every bucket must hold all k sources.
+Then end to end with local stand-in producers, each a forked child publishing StreamRecords on a
+Unix socket like a daemon: two on time, one whose samples arrive after the lateness, a socket nobody
+listens on, and a recording made with the --record format. Reported are the buckets closed and how
+long after its end a bucket was closed; the run fails if the missing or late source held the merge
+back, if the late samples were not dropped, or if the on-time sources are missing from the buckets.
+Before that, an old recording with more samples in one bucket than a source queue holds must close
+that bucket once, with its newest sample and none dropped as late.
+*/
+
+#define MERGE_ROUNDS 256
+#define SCENARIO_SAMPLES 30
+#define SCENARIO_BUCKET_NS 50000000LL
+#define SCENARIO_LATE_NS 100000000LL
+#define STANDIN_LAG_NS 300000000LL // how late the late stand-in's samples arrive, beyond the lateness
+#define CLOSE_SLACK_NS 150000000LL // scheduling slack allowed on top of the lateness
+#define DENSE_SAMPLES (AGG_QUEUE_LEN + 44) // one bucket of a recording, more than a source queue holds
+#define DENSE_STEP_NS 1000000LL
+#define DENSE_BUCKET_NS 1000000000LL
+
+typedef struct {
+    aggMerger* merger;
+    int sources;
+    long long offsets[AGG_MAX_SOURCES];
+    long long next_bucket;
+    int failures;
+}mergeRun;
+///_|> descry: State of the merge-only benchmark, continued across iterations
+///_|> members:
+///_|>     - merger: merger fed directly with agg_merger_push, type aggMerger*
+///_|>     - sources: number of sources, type int
+///_|>     - offsets: position of every source's sample within its bucket, type long long[]
+///_|>     - next_bucket: index of the next bucket to feed, type long long
+///_|>     - failures: buckets that did not hold every source or had the wrong sum, type int
+
+static void bench_merge_rounds(void* arg){
+    mergeRun* run = (mergeRun*)arg;
+    aggBucket bucket;
+    float expected_sum = (float)(run->sources * (run->sources - 1) / 2);
+    for (int r = 0; r < MERGE_ROUNDS; r++, run->next_bucket++){
+        long long start = run->next_bucket * SCENARIO_BUCKET_NS;
+        for (int s = 0; s < run->sources; s++){
+            aggSample sample = {start + run->offsets[s], (float)s, 1.0f, 2.0f};
+            agg_merger_push(run->merger, s, &sample);
+        }
+        // the previous bucket closes once every source has a sample in this one
+        while (agg_merger_next(run->merger, 0, &bucket) == 1){
+            if (bucket.reporting != run->sources || bucket.cpu_sum != expected_sum) run->failures++;
+        }
+    }
+}
+
+static int bench_merge(aggMerger* merger, int sources){
+    ///_|> descry: times MERGE_ROUNDS buckets of the heap merge with the given number of sources
+    ///_|> merger: scratch merger, type aggMerger*
+    ///_|> sources: number of sources, type int
+    ///_|> returning: returns 0 on success, -1 if a bucket was wrong
+    mergeRun run;
+    memset(&run, 0, sizeof(mergeRun));
+    run.merger = merger;
+    run.sources = sources;
+    run.next_bucket = 1000;
+    for (int s = 0; s < sources; s++) run.offsets[s] = (SCENARIO_BUCKET_NS - 1) * ((s * 7919) % sources) / sources;
+    agg_merger_init(merger, sources, SCENARIO_BUCKET_NS, SCENARIO_LATE_NS);
+    char params[96];
+    snprintf(params, sizeof(params), "\"sources\":%d,\"samples\":%d", sources, MERGE_ROUNDS * sources);
+    bench_run("aggregate/merge", params, bench_merge_rounds, &run);
+    if (run.failures > 0){
+        fprintf(stderr, "merge of %d sources: %d wrong buckets\n", sources, run.failures);
+        return -1;
+    }
+    return 0;
+}
+
+static int listen_socket(const char* path){
+    ///_|> descry: creates the listening Unix socket of a stand-in producer
+    ///_|> path: socket path, replaced if it exists, type const char*
+    ///_|> returning: returns the listening fd, -1 on failure
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) return -1;
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+    unlink(path);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1 || listen(fd, 1) == -1){
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void run_standin(int listen_fd, long long lag_ns, float cpu){
+    ///_|> descry: body of a stand-in producer: publishes SCENARIO_SAMPLES utilization records, one per bucket
+    ///_|> listen_fd: listening socket, type int
+    ///_|> lag_ns: how long before sending a sample was taken, type long long
+    ///_|> cpu: CPU utilization reported, type float
+    ///_|> returning: this function does not return, the child exits
+    signal(SIGPIPE, SIG_IGN);
+    int fd = accept(listen_fd, NULL, NULL);
+    if (fd == -1) _exit(1);
+    for (int i = 0; i < SCENARIO_SAMPLES; i++){
+        StreamRecord rec;
+        memset(&rec, 0, sizeof(StreamRecord));
+        rec.type = STREAM_UTILIZ;
+        rec.seq = (unsigned int)i;
+        rec.wall_ns = now_wall_ns() - lag_ns;
+        rec.data.utiliz.cpu_utiliz = cpu;
+        rec.data.utiliz.mem_utiliz.used_memory = 1.0f;
+        rec.data.utiliz.mem_utiliz.total_memory = 4.0f;
+        if (write(fd, &rec, sizeof(StreamRecord)) != (ssize_t)sizeof(StreamRecord)) _exit(1);
+        usleep(SCENARIO_BUCKET_NS / 1000);
+    }
+    close(fd);
+    _exit(0);
+}
+
+static int write_recording(const char* path, long long first_ns, int samples, long long step_ns, float cpu_step){
+    ///_|> descry: writes a recording of evenly spaced samples from first_ns on, as --record would
+    ///_|> path: file to create, type const char*
+    ///_|> first_ns: wall-clock time of the first sample, type long long
+    ///_|> samples / step_ns: number of samples and time between them, type int / long long
+    ///_|> cpu_step: CPU utilization added per sample to the first sample's 30 %, type float
+    ///_|> returning: returns 0 on success, -1 on failure
+    static tsEncoder enc;
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) return -1;
+    ts_encoder_reset(&enc);
+    for (int i = 0; i < samples; i++){
+        tsPoint point = {(first_ns + i * step_ns) / 1000, {30.0f + cpu_step * i, 2.0f, 8.0f}};
+        ts_encoder_add(&enc, &point);
+    }
+    int status = ts_encoder_write(&enc, file);
+    fclose(file);
+    return status;
+}
+
+static int compare_ll(const void* a, const void* b){
+    long long x = *(const long long*)a;
+    long long y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+static int bench_standins(aggMerger* merger){
+    ///_|> descry: merges two on-time stand-ins, a late one, a missing socket and a recording end to end
+    ///_|> merger: scratch merger, type aggMerger*
+    ///_|> returning: returns 0 on success, -1 if the merge stalled or merged the wrong samples
+    char paths[5][108];
+    for (int i = 0; i < 5; i++) snprintf(paths[i], sizeof(paths[i]), "/tmp/bench_aggregate_%d_%d", (int)getpid(), i);
+    pid_t children[3];
+    for (int i = 0; i < 3; i++){
+        int fd = listen_socket(paths[i]);
+        if (fd == -1 || (children[i] = fork()) == -1){
+            perror("stand-in producer");
+            return -1;
+        }
+        if (children[i] == 0) run_standin(fd, (i == 2) ? STANDIN_LAG_NS : 0, 10.0f * (i + 1));
+        close(fd);
+    }
+    unlink(paths[3]); // the missing source: nobody listens there
+    if (write_recording(paths[4], now_wall_ns(), SCENARIO_SAMPLES, SCENARIO_BUCKET_NS, 0.0f) == -1){
+        perror("recording");
+        return -1;
+    }
+    char spec[600];
+    snprintf(spec, sizeof(spec), "%s,%s,%s,%s,%s", paths[0], paths[1], paths[2], paths[3], paths[4]);
+    int opened = aggregator_open(merger, spec, SCENARIO_BUCKET_NS, SCENARIO_LATE_NS);
+
+    long long delays[4 * SCENARIO_SAMPLES];
+    int buckets = 0;
+    int on_time_reports = 0;
+    long long give_up = now_mono_ns() + 10 * SCENARIO_SAMPLES * SCENARIO_BUCKET_NS;
+    while (opened > 0 && now_mono_ns() < give_up && buckets < 4 * SCENARIO_SAMPLES){
+        aggBucket bucket;
+        int got = aggregator_next(merger, &bucket, 100);
+        if (got == 1){
+            delays[buckets++] = now_wall_ns() - (bucket.start_ns + bucket.bucket_ns);
+            // the on-time stand-ins report 10 and 20 % CPU, the recording 30 %
+            if (bucket.reporting >= 3) on_time_reports++;
+            continue;
+        }
+        // the missing socket never ends, so the run is over once everything else has
+        bool others_done = true;
+        for (int s = 0; s < 5; s++){
+            if (s != 3 && merger->sources[s].state != AGG_SOURCE_DONE) others_done = false;
+        }
+        if (others_done && merger->heap_len == 0) break;
+    }
+    unsigned long long late = (opened > 0) ? merger->sources[2].late : 0;
+    unsigned long long merged_late = (opened > 0) ? merger->sources[2].merged : 0;
+    if (opened > 0) aggregator_close(merger);
+    for (int i = 0; i < 3; i++) waitpid(children[i], NULL, 0);
+    for (int i = 0; i < 5; i++) unlink(paths[i]);
+    if (buckets == 0){
+        fprintf(stderr, "aggregate: no bucket closed, the merge stalled\n");
+        return -1;
+    }
+
+    qsort(delays, buckets, sizeof(long long), compare_ll);
+    BenchResult result;
+    memset(&result, 0, sizeof(BenchResult));
+    result.iters = buckets;
+    result.ns_per_op = (double)delays[buckets / 2];
+    bench_report("aggregate/close_delay_p50", "\"sources\":5,\"missing\":1,\"late\":1", &result);
+    result.ns_per_op = (double)delays[buckets - 1];
+    bench_report("aggregate/close_delay_max", "\"sources\":5,\"missing\":1,\"late\":1", &result);
+    fprintf(stderr, "aggregate: %d buckets, %d with the on-time sources, %llu late samples dropped, %llu merged\n", \
+            buckets, on_time_reports, late, merged_late);
+
+    int status = 0;
+    if (buckets < SCENARIO_SAMPLES * 2 / 3 || on_time_reports < buckets * 2 / 3){
+        fprintf(stderr, "aggregate: %d buckets, %d with the on-time sources\n", buckets, on_time_reports);
+        status = -1;
+    }
+    if (delays[buckets - 1] > SCENARIO_LATE_NS + SCENARIO_BUCKET_NS + CLOSE_SLACK_NS){
+        fprintf(stderr, "aggregate: a bucket closed %.0f ms after its end\n", delays[buckets - 1] / 1e6);
+        status = -1;
+    }
+    if (late == 0){
+        fprintf(stderr, "aggregate: the late source's samples were not dropped\n");
+        status = -1;
+    }
+    return status;
+}
+
+static int check_full_bucket_recording(aggMerger* merger){
+    ///_|> descry: merges an old recording with more samples in one bucket than a source queue holds; the
+    ///_|>         bucket must wait for the rest of them instead of timing out after the first AGG_QUEUE_LEN
+    ///_|> merger: scratch merger, type aggMerger*
+    ///_|> returning: returns 0 on success, -1 if the bucket closed early or samples were dropped as late
+    char path[108];
+    snprintf(path, sizeof(path), "/tmp/bench_aggregate_%d_full", (int)getpid());
+    // a minute old, so every bucket is past its lateness when it is merged
+    long long first_ns = (now_wall_ns() - 60000000000LL) / DENSE_BUCKET_NS * DENSE_BUCKET_NS;
+    if (write_recording(path, first_ns, DENSE_SAMPLES, DENSE_STEP_NS, 1.0f) == -1){
+        perror("recording");
+        return -1;
+    }
+    int status = -1;
+    if (aggregator_open(merger, path, DENSE_BUCKET_NS, SCENARIO_LATE_NS) == 1){
+        aggBucket first;
+        aggBucket bucket;
+        int buckets = 0;
+        int got;
+        while ((got = aggregator_next(merger, &bucket, 100)) != -1){
+            if (got == 1 && buckets++ == 0) first = bucket;
+        }
+        aggSource* src = &merger->sources[0];
+        float newest = 30.0f + (DENSE_SAMPLES - 1);
+        if (buckets != 1 || first.cpu_max != newest || src->late != 0 || src->merged != DENSE_SAMPLES){
+            fprintf(stderr, "aggregate: %d samples in one bucket gave %d buckets, cpu %.0f instead of %.0f, "
+                    "%llu late\n", DENSE_SAMPLES, buckets, (buckets > 0) ? first.cpu_max : 0.0f, newest, src->late);
+        }else{
+            status = 0;
+        }
+        aggregator_close(merger);
+    }
+    unlink(path);
+    return status;
+}
+
+int main(){
+    aggMerger* merger = (aggMerger*)malloc(sizeof(aggMerger));
+    if (merger == NULL) return 1;
+    int status = 0;
+    static const int source_counts[] = {4, 16, 64};
+    for (int i = 0; i < 3 && status == 0; i++){
+        if (bench_merge(merger, source_counts[i]) == -1) status = 1;
+    }
+    if (status == 0 && check_full_bucket_recording(merger) == -1) status = 1;
+    if (status == 0 && bench_standins(merger) == -1) status = 1;
+    free(merger);
+    return status;
+}
@@ -0,0 +1,97 @@
+#define _XOPEN_SOURCE 700
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "benchTool.h"
+#include "procfsGenerator.h"
+#include "procRoot.h"
+#include "batchReader.h"
+
+/*
+Compares the two batchReader backends per tick: latency (ns_per_op) and read-side syscalls per
+tick. Sources are proc/stat, proc/meminfo and then per-core scaling_cur_freq files of a generated
+64-CPU tree, for 2 .. 64 sources; a last run reads the real /proc/stat and /proc/meminfo, where
+procfs renders the files on every read.
+*/
+
+#define FIXTURE_CPUS 64
+#define MIN_NS 100000000LL
+
+static char source_paths[BATCH_MAX_SOURCES][96];
+static procFile source_files[BATCH_MAX_SOURCES];
+
+static void bench_read_all(void* arg){
+    batch_reader_read_all((BatchReader*)arg);
+}
+
+static int bench_backend(int want_uring, int nsources, const char* root_label){
+    ///_|> descry: measures one backend reading the first nsources sources and reports it
+    ///_|> want_uring: non-zero for the io_uring backend, type int
+    ///_|> nsources: number of sources registered, type int
+    ///_|> root_label: "fixture" or "real", used in the report, type const char*
+    ///_|> returning: returns 0 on success, -1 if a source could not be added or io_uring was refused
+    BatchReader reader;
+    batch_reader_init(&reader, want_uring);
+    if (want_uring && reader.backend != BATCH_BACKEND_URING){
+        fprintf(stderr, "io_uring unavailable, skipping its runs\n");
+        return -1;
+    }
+    for (int i = 0; i < nsources; i++){
+        proc_file_close(&source_files[i]);
+        if (batch_reader_add(&reader, &source_files[i], 4096) == -1){
+            batch_reader_close(&reader);
+            return -1;
+        }
+    }
+    batch_reader_read_all(&reader); // registers fds and buffers outside the timed loop
+    unsigned long long syscalls_before = reader.syscalls;
+    BenchResult result = bench_measure(bench_read_all, &reader, MIN_NS);
+    // bench_measure makes one untimed warm-up call, count syscalls over every call made
+    unsigned long long calls = result.iters + 1;
+    char name[64];
+    char params[160];
+    snprintf(name, sizeof(name), "batch/%s/tick", batch_reader_backend_name(&reader));
+    snprintf(params, sizeof(params), "\"root\":\"%s\",\"sources\":%d,\"syscalls_per_tick\":%.2f", root_label, \
+             nsources, (double)(reader.syscalls - syscalls_before) / calls);
+    bench_report(name, params, &result);
+    batch_reader_close(&reader);
+    return 0;
+}
+
+int main(){
+    char root[] = "/tmp/myMonitoringTool-batch-XXXXXX";
+    if (mkdtemp(root) == NULL){
+        perror("mkdtemp");
+        return 1;
+    }
+    if (generate_procfs_fixture(root, FIXTURE_CPUS, 2) == -1){
+        fprintf(stderr, "failed to generate fixture\n");
+        return 1;
+    }
+    snprintf(source_paths[0], sizeof(source_paths[0]), "/proc/stat");
+    snprintf(source_paths[1], sizeof(source_paths[1]), "/proc/meminfo");
+    for (int i = 2; i < BATCH_MAX_SOURCES; i++){
+        snprintf(source_paths[i], sizeof(source_paths[i]), "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_cur_freq", i - 2);
+    }
+    for (int i = 0; i < BATCH_MAX_SOURCES; i++){
+        procFile file = PROC_FILE_INIT(source_paths[i]);
+        source_files[i] = file;
+    }
+
+    set_proc_root(root);
+    int uring_ok = 1;
+    for (int n = 2; n <= BATCH_MAX_SOURCES; n *= 2){
+        bench_backend(0, n, "fixture");
+        if (uring_ok && bench_backend(1, n, "fixture") == -1) uring_ok = 0;
+    }
+    // procfs proper: contents are generated by the kernel on each read
+    set_proc_root(NULL);
+    bench_backend(0, 2, "real");
+    if (uring_ok) bench_backend(1, 2, "real");
+
+    for (int i = 0; i < BATCH_MAX_SOURCES; i++) proc_file_close(&source_files[i]);
+    remove_fixture_tree(root);
+    return 0;
+}
@@ -0,0 +1,246 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "benchTool.h"
+#include "procRoot.h"
+#include "cpu.h"
+#include "core.h"
+#include "memory.h"
+#include "numa.h"
+#include "interrupts.h"
+#include "vmstat.h"
+
+/*
+Microbenchmarks of the collectors and renderers. All collectors read the fixture tree given as
+the first argument (default bench/fixtures/procfs) through --proc-root, so numbers do not depend on
+the load of the machine running them. Renderers write to /dev/null.
+The fill_* variants are the allocation-free hot path of the producers; after the benchmarks the 
+steady-state sampling loop is replayed under the malloc counter and the run fails if it allocates.
+*/
+
+#define CHART_WIDTH 100
+#define STEADY_STATE_SAMPLES 10000
+
+static numaCollector numa_collector;
+///_|> descry: NUMA collector of the fixture root, set up once like a producer does
+
+static irqCollector irq_collector;
+///_|> descry: interrupt collector of the fixture root, set up once like a producer does
+
+static vmstatCollector vmstat_collector;
+///_|> descry: vmstat collector of the fixture root, its table built once like a producer does
+
+static const vmstatSlot* vmstat_keys[VMSTAT_MAX_KEYS];
+static int vmstat_key_count = 0;
+///_|> descry: the selected names as a plain list, for the linear-search baseline
+
+static void bench_get_cpuInfo(void* arg){
+    (void)arg;
+    free(get_cpuInfo());
+}
+
+static void bench_get_MemoryInfo(void* arg){
+    (void)arg;
+    free(get_MemoryInfo());
+}
+
+static void bench_get_cores_num(void* arg){
+    (void)arg;
+    get_cores_num();
+}
+
+static void bench_get_max_freq(void* arg){
+    (void)arg;
+    get_max_freq();
+}
+
+static void bench_fill_cpuInfo(void* arg){
+    fill_cpuInfo((cpuInfo*)arg);
+}
+
+static void bench_fill_MemoryInfo(void* arg){
+    fill_MemoryInfo((MemoryInfo*)arg);
+}
+
+static void bench_fill_coreinfo(void* arg){
+    fill_coreinfo((coreInfo*)arg);
+}
+
+static void bench_numa_collector_sample(void* arg){
+    numa_collector_sample(&numa_collector, (numaSample*)arg);
+}
+
+static void bench_irq_collector_sample(void* arg){
+    irq_collector_sample(&irq_collector, (irqSample*)arg);
+}
+
+static int count_lines(const char* text){
+    int lines = 0;
+    for (const char* p = strchr(text, '\n'); p != NULL; p = strchr(p + 1, '\n')) lines++;
+    return lines;
+}
+
+static void bench_parse_vmstat(void* arg){
+    vmstatCounters counters;
+    parse_vmstat(&vmstat_collector.table, (const char*)arg, &counters);
+}
+
+static void bench_parse_vmstat_linear(void* arg){
+    // baseline: compare every line with every selected name
+    vmstatCounters counters;
+    memset(&counters, 0, sizeof(counters));
+    for (const char* line = (const char*)arg; *line != '\0'; ){
+        const char* space = strchr(line, ' ');
+        if (space == NULL) break;
+        int len = (int)(space - line);
+        for (int k = 0; k < vmstat_key_count; k++){
+            if (vmstat_keys[k]->key_len == len && strncmp(vmstat_keys[k]->key, line, len) == 0){
+                counters.value[vmstat_keys[k]->group] += strtoull(space + 1, NULL, 10);
+                break;
+            }
+        }
+        const char* end = strchr(space, '\n');
+        if (end == NULL) break;
+        line = end + 1;
+    }
+}
+
+static void bench_vmstat_table_build(void* arg){
+    vmstatTable table;
+    vmstat_table_build(&table, (const char*)arg);
+}
+
+static void bench_fill_vmstatCounters(void* arg){
+    fill_vmstatCounters(&vmstat_collector, (vmstatCounters*)arg);
+}
+
+static int check_steady_state_allocs(){
+    ///_|> descry: replays the producers' per-sample work (cpu, memory, vmstat, NUMA nodes and interrupts) and counts
+    ///_|>         heap allocations
+    ///_|> returning: returns 0 if the loop did not allocate, -1 otherwise
+    cpuInfo before, after, curr;
+    cpuDelta delta = {&before, &after};
+    MemoryInfo mem;
+    numaSample numa;
+    irqSample irq;
+    schedInfo sched;
+    vmstatCounters vm_before, vm_after;
+    vmstatInfo vm;
+    fill_cpuInfo(&after); // warm-up: opens descriptors, takes arena buffers
+    fill_MemoryInfo(&mem);
+    fill_vmstatCounters(&vmstat_collector, &vm_after);
+    unsigned long long allocs_before = bench_alloc_count();
+    volatile float sink = 0;
+    for (int i = 0; i < STEADY_STATE_SAMPLES; i++){
+        fill_cpuInfo(&curr);
+        advance_delta(&delta, &curr);
+        sink += calcu_cpu_utiliz(&delta);
+        calcu_sched_info(&delta, 1000000000LL, &sched);
+        sink += sched.ctxt_rate;
+        fill_MemoryInfo(&mem);
+        sink += mem.used_memory;
+        vm_before = vm_after;
+        fill_vmstatCounters(&vmstat_collector, &vm_after);
+        calcu_vmstat_rates(&vm_before, &vm_after, 1000000000LL, &vm);
+        sink += vm.rate[VMSTAT_PGFAULT];
+        numa_collector_sample(&numa_collector, &numa);
+        sink += numa.nodes[0].used_memory;
+        irq_collector_sample(&irq_collector, &irq);
+        sink += irq.total_rate;
+    }
+    (void)sink;
+    unsigned long long allocs = bench_alloc_count() - allocs_before;
+    printf("{\"check\":\"steady_state_allocs\",\"samples\":%d,\"allocs\":%llu,\"pass\":%s}\n", \
+           STEADY_STATE_SAMPLES, allocs, allocs == 0 ? "true" : "false");
+    return allocs == 0 ? 0 : -1;
+}
+
+static void bench_calcu_cpu_utiliz(void* arg){
+    volatile float utiliz = calcu_cpu_utiliz((cpuDelta*)arg);
+    (void)utiliz;
+}
+
+static const schedInfo chart_sched = {41250, 12.5, 3870, 3, 1, {0.52, 0.58, 0.59}};
+
+static void bench_draw_cpu_chart(void* arg){
+    draw_cpu_chart((float*)arg, NULL, CHART_WIDTH, CHART_WIDTH, &chart_sched);
+}
+
+static const vmstatInfo chart_vm = {{182340, 12, 0, 0, 5120, 256, 4800, 240, 3, 1, 0}};
+
+static void bench_draw_memory_chart(void* arg){
+    draw_memory_chart((float*)arg, NULL, CHART_WIDTH, CHART_WIDTH, 64.0, &chart_vm);
+}
+
+int main(int argc, char** argv){
+    const char* root = (argc > 1) ? argv[1] : "bench/fixtures/procfs";
+    set_proc_root(root);
+    char params[320];
+    snprintf(params, sizeof(params), "\"root\":\"%s\"", root);
+
+    if (get_cores_num() < 0 || get_max_freq() < 0 || numa_collector_init(&numa_collector) == -1 || \
+        irq_collector_init(&irq_collector) == -1 || vmstat_collector_init(&vmstat_collector) == -1){
+        fprintf(stderr, "fixture root %s is incomplete\n", root);
+        return 1;
+    }
+
+    bench_run("get_cpuInfo", params, bench_get_cpuInfo, NULL);
+    bench_run("get_MemoryInfo", params, bench_get_MemoryInfo, NULL);
+    bench_run("get_cores_num", params, bench_get_cores_num, NULL);
+    bench_run("get_max_freq", params, bench_get_max_freq, NULL);
+
+    cpuInfo cpu_out;
+    MemoryInfo mem_out;
+    coreInfo core_out;
+    bench_run("fill_cpuInfo", params, bench_fill_cpuInfo, &cpu_out);
+    bench_run("fill_MemoryInfo", params, bench_fill_MemoryInfo, &mem_out);
+    bench_run("fill_coreinfo", params, bench_fill_coreinfo, &core_out);
+    numaSample numa_out;
+    bench_run("numa_collector_sample", params, bench_numa_collector_sample, &numa_out);
+    irqSample irq_out;
+    bench_run("irq_collector_sample", params, bench_irq_collector_sample, &irq_out);
+    vmstatCounters vmstat_out;
+    bench_run("fill_vmstatCounters", params, bench_fill_vmstatCounters, &vmstat_out);
+
+    // parse cost alone, on the text of the last read; the linear search is the baseline of the hash table
+    char vmstat_params[400];
+    snprintf(vmstat_params, sizeof(vmstat_params), "%s,\"lines\":%d,\"selected\":%d", params, \
+             count_lines(vmstat_collector.buf), vmstat_collector.table.key_count);
+    for (unsigned int i = 0; i <= vmstat_collector.table.mask; i++){
+        if (vmstat_collector.table.slots[i].key_len > 0) vmstat_keys[vmstat_key_count++] = &vmstat_collector.table.slots[i];
+    }
+    bench_run("parse_vmstat", vmstat_params, bench_parse_vmstat, vmstat_collector.buf);
+    bench_run("parse_vmstat_linear", vmstat_params, bench_parse_vmstat_linear, vmstat_collector.buf);
+    bench_run("vmstat_table_build", vmstat_params, bench_vmstat_table_build, vmstat_collector.buf);
+
+    cpuInfo before = {.total_time = 1000000, .idle_time = 800000};
+    cpuInfo after = {.total_time = 1004000, .idle_time = 801000};
+    cpuDelta delta = {&before, &after};
+    bench_run("calcu_cpu_utiliz", NULL, bench_calcu_cpu_utiliz, &delta);
+
+    float cpu_samples[CHART_WIDTH];
+    float memory_samples[CHART_WIDTH];
+    for (int i = 0; i < CHART_WIDTH; i++){
+        cpu_samples[i] = (float)((i * 37) % 101);
+        memory_samples[i] = (float)((i * 13) % 64);
+    }
+    char chart_params[64];
+    snprintf(chart_params, sizeof(chart_params), "\"width\":%d", CHART_WIDTH);
+    BenchResult result;
+    bench_silence_stdout();
+    result = bench_measure(bench_draw_cpu_chart, cpu_samples, 200000000LL);
+    bench_restore_stdout();
+    bench_report("draw_cpu_chart", chart_params, &result);
+    bench_silence_stdout();
+    result = bench_measure(bench_draw_memory_chart, memory_samples, 200000000LL);
+    bench_restore_stdout();
+    bench_report("draw_memory_chart", chart_params, &result);
+
+    if (check_steady_state_allocs() == -1){
+        fprintf(stderr, "steady-state sampling loop allocated on the heap\n");
+        return 1;
+    }
+    return 0;
+}
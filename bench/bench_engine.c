@@ -0,0 +1,168 @@
+#define _XOPEN_SOURCE 700
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "benchTool.h"
+#include "procRoot.h"
+#include "CLA.h"
+#include "sysInfoProducer.h"
+#include "threadEngine.h"
+#include "selfStats.h"
+
+/*
+Compares the two producer engines (--engine=processes / --engine=threads) on the memory + CPU
+pipeline, reading the fixture tree so the numbers do not depend on the machine's load:
+- startup: one complete 1-sample run (spawn, first sample, teardown) and, derived from the same
+  runs, the time from spawning to the first sample reaching the consumer;
+- per sample: a long run at the shortest interval, reporting CPU time of all processes/threads
+  and the producer-to-consumer hop latency per sample.
+Allocations are counted in this process only, so forked producers do not show up in allocs_per_op.
+*/
+
+#define STEADY_SAMPLES 2000
+
+typedef struct {
+    int engine;
+    CLAInfo cla;
+    long long first_sample_ns;
+    long long hop_ns;
+    unsigned long long runs;
+}EngineRun;
+///_|> descry: One engine under test and the latencies accumulated over its runs
+///_|> members:
+///_|>     - engine: one of ProducerEngine, type int
+///_|>     - cla: configuration of every run (memory + CPU, fixed interval), type CLAInfo
+///_|>     - first_sample_ns: summed time from spawning to the first sample, type long long
+///_|>     - hop_ns: summed sample age when the consumer received it, type long long
+///_|>     - runs: number of runs accumulated, type unsigned long long
+
+static int run_processes(EngineRun* run){
+    ///_|> descry: one run of the process engine: forks the coordinator like main and drains its pipe
+    ///_|> run: engine under test, type EngineRun*
+    ///_|> returning: returns the number of samples received, -1 on failure
+    int utiliz_fd[2];
+    if (pipe(utiliz_fd) == -1) return -1;
+    long long spawned = now_mono_ns();
+    fflush(stdout); // the children exit() and would flush a copy of pending output
+    pid_t pid = fork();
+    if (pid == 0){
+        close(utiliz_fd[0]);
+        fetch_utilization_with_pipe(&run->cla, utiliz_fd[1]);
+    }
+    close(utiliz_fd[1]);
+    if (pid < 0){
+        close(utiliz_fd[0]);
+        return -1;
+    }
+    UtilizInfo info;
+    int received = 0;
+    while (read_full(utiliz_fd[0], &info, sizeof(UtilizInfo)) == (ssize_t)sizeof(UtilizInfo)){
+        long long now = now_mono_ns();
+        if (received == 0) run->first_sample_ns += now - spawned;
+        run->hop_ns += now - info.timestamp_ns;
+        received++;
+    }
+    close(utiliz_fd[0]);
+    waitpid(pid, NULL, 0);
+    return received;
+}
+
+static int run_threads(EngineRun* run){
+    ///_|> descry: one run of the thread engine: starts the workers and drains their queues
+    ///_|> run: engine under test, type EngineRun*
+    ///_|> returning: returns the number of samples received, -1 on failure
+    static ThreadEngine engine;
+    long long spawned = now_mono_ns();
+    if (thread_engine_start(&engine, &run->cla) == -1) return -1;
+    UtilizInfo info;
+    int received = 0;
+    while (thread_engine_next_utiliz(&engine, &info) > 0){
+        long long now = now_mono_ns();
+        if (received == 0) run->first_sample_ns += now - spawned;
+        run->hop_ns += now - info.timestamp_ns;
+        received++;
+    }
+    thread_engine_stop(&engine);
+    return received;
+}
+
+static void bench_one_sample_run(void* arg){
+    EngineRun* run = (EngineRun*)arg;
+    if (run->engine == ENGINE_THREADS) run_threads(run);
+    else run_processes(run);
+    run->runs++;
+}
+
+static long long process_tree_cpu_ns(){
+    ///_|> descry: CPU time of this process plus every reaped child, in nanoseconds
+    ///_|> returning: returns user+system time of RUSAGE_SELF and RUSAGE_CHILDREN
+    struct rusage self_usage, children_usage;
+    getrusage(RUSAGE_SELF, &self_usage);
+    getrusage(RUSAGE_CHILDREN, &children_usage);
+    return (rusage_cpu_us(&self_usage) + rusage_cpu_us(&children_usage)) * 1000LL;
+}
+
+static int bench_engine(int engine, const char* kind){
+    ///_|> descry: runs the startup and per-sample benchmarks of one engine and reports them
+    ///_|> engine: one of ProducerEngine, type int
+    ///_|> kind: engine name used in the report, type const char*
+    ///_|> returning: returns 0 on success, -1 if a run lost samples
+    EngineRun run;
+    memset(&run, 0, sizeof(EngineRun));
+    run.engine = engine;
+    run.cla.graph_flag[0] = 1;
+    run.cla.graph_flag[1] = 1;
+    run.cla.samples = 1;
+    run.cla.tdelay = 1;
+    run.cla.engine = engine;
+    char name[64];
+    char params[64];
+    snprintf(params, sizeof(params), "\"engine\":\"%s\"", kind);
+
+    BenchResult result = bench_measure(bench_one_sample_run, &run, 300000000LL);
+    snprintf(name, sizeof(name), "engine/%s/one_sample_run", kind);
+    bench_report(name, params, &result);
+    BenchResult first;
+    memset(&first, 0, sizeof(BenchResult));
+    first.iters = run.runs;
+    first.ns_per_op = (double)run.first_sample_ns / run.runs;
+    snprintf(name, sizeof(name), "engine/%s/first_sample", kind);
+    bench_report(name, params, &first);
+
+    run.cla.samples = STEADY_SAMPLES;
+    run.hop_ns = 0;
+    long long cpu_before = process_tree_cpu_ns();
+    unsigned long long allocs_before = bench_alloc_count();
+    int received = (engine == ENGINE_THREADS) ? run_threads(&run) : run_processes(&run);
+    long long cpu_used = process_tree_cpu_ns() - cpu_before;
+    if (received != STEADY_SAMPLES){
+        fprintf(stderr, "%s engine delivered %d of %d samples\n", kind, received, STEADY_SAMPLES);
+        return -1;
+    }
+    BenchResult per_sample;
+    memset(&per_sample, 0, sizeof(BenchResult));
+    per_sample.iters = received;
+    per_sample.ns_per_op = (double)cpu_used / received;
+    per_sample.allocs_per_op = (double)(bench_alloc_count() - allocs_before) / received;
+    snprintf(name, sizeof(name), "engine/%s/cpu_per_sample", kind);
+    bench_report(name, params, &per_sample);
+    BenchResult hop;
+    memset(&hop, 0, sizeof(BenchResult));
+    hop.iters = received;
+    hop.ns_per_op = (double)run.hop_ns / received;
+    snprintf(name, sizeof(name), "engine/%s/hop_latency", kind);
+    bench_report(name, params, &hop);
+    return 0;
+}
+
+int main(int argc, char** argv){
+    const char* root = (argc > 1) ? argv[1] : "bench/fixtures/procfs";
+    set_proc_root(root);
+    if (bench_engine(ENGINE_PROCESSES, "processes") == -1) return 1;
+    if (bench_engine(ENGINE_THREADS, "threads") == -1) return 1;
+    return 0;
+}
@@ -0,0 +1,160 @@
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "benchTool.h"
+#include "procfsGenerator.h"
+#include "pidTrack.h"
+#include "procRoot.h"
+
+/*
+One --pid tick on a fixture process with 2000 threads (a large JVM): the collector with its thread
+descriptors cached, against the same reads done the way a tick would without the cache, listing
+/proc/N/task and opening, reading and closing every thread's stat file. The cached tick must not
+allocate or list the directory again. Then the thread set changes under the collector: a thread
+exits while another starts (same count, found by the failed read), and a thread starts (found by
+the count in /proc/N/stat); each must rebuild the table once, keeping the other descriptors.
+*/
+
+#define FIXTURE_PID 4242
+#define FIXTURE_THREADS 2000
+
+typedef struct {
+    char root[64];
+    char task_dir[320];
+    char buf[PID_STAT_BUF];
+    unsigned long long sum;
+}uncachedRun;
+///_|> descry: State of the uncached tick
+///_|> members:
+///_|>     - root / task_dir: fixture root and the process's task directory below it, type char[]
+///_|>     - buf: read buffer, type char[]
+///_|>     - sum: bytes read, keeps the reads alive, type unsigned long long
+
+static void bench_cached_tick(void* arg){
+    pidSample sample;
+    pid_collector_sample((pidCollector*)arg, &sample);
+}
+
+static void bench_uncached_tick(void* arg){
+    uncachedRun* run = (uncachedRun*)arg;
+    DIR* dir = opendir(run->task_dir);
+    if (dir == NULL) return;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL){
+        if (entry->d_name[0] == '.') continue;
+        char path[600];
+        snprintf(path, sizeof(path), "%s/%s/stat", run->task_dir, entry->d_name);
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd == -1) continue;
+        ssize_t got = read(fd, run->buf, sizeof(run->buf) - 1);
+        if (got > 0) run->sum += (unsigned long long)got;
+        close(fd);
+    }
+    closedir(dir);
+}
+
+static int has_thread(const pidCollector* collector, int tid){
+    for (int i = 0; i < collector->thread_count; i++){
+        if (collector->threads[i].tid == tid) return 1;
+    }
+    return 0;
+}
+
+static int check_thread_changes(pidCollector* collector, const char* root){
+    ///_|> descry: changes the fixture's thread set twice and checks that each change rebuilds the table once
+    ///_|> collector: collector tracking the fixture process, type pidCollector*
+    ///_|> root: fixture root, type const char*
+    ///_|> returning: returns 0 on success, -1 on a missed or repeated rebuild
+    pidSample sample;
+    char path[400];
+    int gone = FIXTURE_PID + FIXTURE_THREADS - 1;
+    int born = FIXTURE_PID + FIXTURE_THREADS;
+    unsigned long long relists = collector->relists;
+
+    // one thread exits and another starts within an interval: the count in /proc/N/stat does not move
+    snprintf(path, sizeof(path), "%s/proc/%d/task/%d/stat", root, FIXTURE_PID, gone);
+    // on procfs the open stat file of an exited thread fails with ESRCH, emptying it stands in for that
+    if (truncate(path, 0) == -1) return -1;
+    unlink(path);
+    snprintf(path, sizeof(path), "%s/proc/%d/task/%d", root, FIXTURE_PID, gone);
+    rmdir(path);
+    if (write_process_stat(root, FIXTURE_PID, born, "C2 CompilerThre", 10, FIXTURE_THREADS) == -1) return -1;
+    pid_collector_sample(collector, &sample);
+    pid_collector_sample(collector, &sample);
+    if (collector->relists != relists + 1 || has_thread(collector, gone) || !has_thread(collector, born) || \
+        collector->thread_count != FIXTURE_THREADS){
+        fprintf(stderr, "pidtrack: exit + start of a thread: %llu rebuilds, %d threads\n", \
+                collector->relists - relists, collector->thread_count);
+        return -1;
+    }
+
+    // one thread starts: found by the count
+    if (write_process_stat(root, FIXTURE_PID, born + 1, "VM Periodic Tas", 10, FIXTURE_THREADS + 1) == -1 || \
+        write_process_stat(root, FIXTURE_PID, 0, "java", 1000000ULL, FIXTURE_THREADS + 1) == -1){
+        return -1;
+    }
+    pid_collector_sample(collector, &sample);
+    pid_collector_sample(collector, &sample);
+    if (collector->relists != relists + 2 || !has_thread(collector, born + 1) || sample.threads != FIXTURE_THREADS + 1){
+        fprintf(stderr, "pidtrack: start of a thread: %llu rebuilds, %d threads\n", collector->relists - relists, \
+                collector->thread_count);
+        return -1;
+    }
+    return 0;
+}
+
+int main(){
+    uncachedRun* run = (uncachedRun*)calloc(1, sizeof(uncachedRun));
+    pidCollector* collector = (pidCollector*)malloc(sizeof(pidCollector));
+    if (run == NULL || collector == NULL) return 1;
+    snprintf(run->root, sizeof(run->root), "/tmp/bench_pidtrack_XXXXXX");
+    if (mkdtemp(run->root) == NULL){
+        perror("mkdtemp");
+        return 1;
+    }
+    if (generate_process_fixture(run->root, FIXTURE_PID, FIXTURE_THREADS) == -1){
+        fprintf(stderr, "failed to generate the process fixture in %s\n", run->root);
+        remove_fixture_tree(run->root);
+        return 1;
+    }
+    snprintf(run->task_dir, sizeof(run->task_dir), "%s/proc/%d/task", run->root, FIXTURE_PID);
+    set_proc_root(run->root);
+    int status = 0;
+    if (pid_collector_init(collector, FIXTURE_PID) == -1){
+        fprintf(stderr, "pid_collector_init failed on the fixture\n");
+        remove_fixture_tree(run->root);
+        return 1;
+    }
+    pidSample sample;
+    pid_collector_sample(collector, &sample);
+    fprintf(stderr, "pidtrack: %d threads tracked, %d descriptors kept open, smaps_rollup %s, io %s\n", \
+            collector->thread_count, collector->fd_budget, collector->rollup_ok ? "read" : "missing", \
+            collector->io_ok ? "read" : "missing");
+
+    char params[96];
+    snprintf(params, sizeof(params), "\"threads\":%d,\"cached_fds\":true", FIXTURE_THREADS);
+    unsigned long long relists = collector->relists;
+    BenchResult cached = bench_measure(bench_cached_tick, collector, 200000000LL);
+    bench_report("pidtrack/tick", params, &cached);
+    snprintf(params, sizeof(params), "\"threads\":%d,\"cached_fds\":false", FIXTURE_THREADS);
+    BenchResult uncached = bench_measure(bench_uncached_tick, run, 200000000LL);
+    bench_report("pidtrack/tick", params, &uncached);
+    if (collector->relists != relists || cached.allocs_per_op > 0.0){
+        fprintf(stderr, "pidtrack: the steady tick rebuilt the thread table %llu times, %.2f allocs/op\n", \
+                collector->relists - relists, cached.allocs_per_op);
+        status = 1;
+    }
+    if (status == 0 && check_thread_changes(collector, run->root) == -1) status = 1;
+
+    pid_collector_close(collector);
+    set_proc_root(NULL);
+    remove_fixture_tree(run->root);
+    free(collector);
+    free(run);
+    return status;
+}
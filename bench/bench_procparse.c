@@ -0,0 +1,193 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "benchTool.h"
+#include "procParse.h"
+
+/*
+procparse_fields against the sscanf paths it replaced, on text shaped like the files the collectors
+read: the aggregate cpu line of /proc/stat, all per-CPU lines of a 256-CPU /proc/stat, and one
+256-column row of /proc/interrupts ("%10u" per CPU). Before timing, procparse_fields is checked
+against sscanf on these inputs; the run fails on any difference.
+*/
+
+#define WIDE_CPUS 256
+#define STAT_FIELDS 10
+
+typedef struct {
+    const char* text;
+    int lines;
+    int fields;
+    unsigned long long sum;
+}parseInput;
+///_|> descry: One benchmark input and the checksum every parser must reach
+///_|> members:
+///_|>     - text: NUL-terminated input, type const char*
+///_|>     - lines / fields: lines and fields per line it holds, type int
+///_|>     - sum: sum of all fields, as parsed by sscanf, type unsigned long long
+
+static unsigned long long rng_state = 0x2545f4914f6cdd1dULL;
+///_|> descry: state of the generator of counters and fuzz inputs
+
+static unsigned long long next_rand(){
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static unsigned long long random_counter(){
+    // counters of every size: idle jiffies of a long-running host, zeros of unused columns
+    static const unsigned long long scale[] = {1, 10, 1000, 1000000, 10000000000ULL, 10000000000000ULL};
+    return next_rand() % scale[next_rand() % 6];
+}
+
+static char* make_percpu_stat(int cpus){
+    ///_|> descry: per-CPU lines of /proc/stat as the kernel prints them
+    ///_|> cpus: number of lines, type int
+    ///_|> returning: returns the malloc'ed text
+    char* text = (char*)malloc((size_t)cpus * (STAT_FIELDS * 21 + 16) + 1);
+    char* p = text;
+    for (int c = 0; c < cpus; c++){
+        p += sprintf(p, "cpu%d", c);
+        for (int f = 0; f < STAT_FIELDS; f++) p += sprintf(p, " %llu", random_counter());
+        *p++ = '\n';
+    }
+    *p = '\0';
+    return text;
+}
+
+static char* make_irq_row(int cpus){
+    ///_|> descry: one numbered /proc/interrupts line, its counters after the colon
+    ///_|> cpus: number of counter columns, type int
+    ///_|> returning: returns the malloc'ed text
+    char* text = (char*)malloc((size_t)cpus * 11 + 64);
+    char* p = text + sprintf(text, " 124:");
+    // most columns of a real file are zero or small: a source is pinned to few CPUs
+    static const unsigned int scale[] = {1, 1, 1, 100, 10000, 4000000000u};
+    for (int c = 0; c < cpus; c++) p += sprintf(p, " %10u", (unsigned int)(next_rand() % scale[next_rand() % 6]));
+    sprintf(p, "  IR-PCI-MSI 524288-edge      eth0-TxRx-0\n");
+    return text;
+}
+
+static unsigned long long sum_percpu_sscanf(const char* text){
+    unsigned long long sum = 0;
+    for (const char* line = text; *line != '\0'; line = strchr(line, '\n') + 1){
+        int cpu;
+        unsigned long long f[STAT_FIELDS];
+        sscanf(line, "cpu%d %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu", &cpu, &f[0], &f[1], &f[2], &f[3], \
+               &f[4], &f[5], &f[6], &f[7], &f[8], &f[9]);
+        for (int i = 0; i < STAT_FIELDS; i++) sum += f[i];
+    }
+    return sum;
+}
+
+static unsigned long long sum_percpu_procparse(const char* text){
+    unsigned long long sum = 0;
+    for (const char* line = text; *line != '\0'; line = strchr(line, '\n') + 1){
+        unsigned long long cpu;
+        unsigned long long f[STAT_FIELDS];
+        const char* fields = procparse_u64(line + 3, &cpu);
+        int got = procparse_fields(fields, f, STAT_FIELDS, NULL);
+        for (int i = 0; i < got; i++) sum += f[i];
+    }
+    return sum;
+}
+
+static unsigned long long sum_fields_sscanf(const char* text){
+    // the %n loop a collector needs for a column count only known at run time
+    unsigned long long sum = 0;
+    const char* p = strchr(text, ':') + 1;
+    unsigned long long value;
+    int used;
+    while (sscanf(p, " %llu%n", &value, &used) == 1){
+        sum += value;
+        p += used;
+    }
+    return sum;
+}
+
+static unsigned long long sum_fields_procparse(const char* text){
+    unsigned long long values[64];
+    unsigned long long sum = 0;
+    const char* p = strchr(text, ':') + 1;
+    int got;
+    while ((got = procparse_fields(p, values, 64, &p)) > 0){
+        for (int i = 0; i < got; i++) sum += values[i];
+    }
+    return sum;
+}
+
+static unsigned long long sink = 0;
+///_|> descry: keeps the parsed values alive
+
+static void bench_cpu_line_sscanf(void* arg){
+    const parseInput* input = (const parseInput*)arg;
+    unsigned long long f[7];
+    sscanf(input->text, "cpu  %llu %llu %llu %llu %llu %llu %llu", &f[0], &f[1], &f[2], &f[3], &f[4], &f[5], &f[6]);
+    sink += f[3];
+}
+
+static void bench_cpu_line_procparse(void* arg){
+    const parseInput* input = (const parseInput*)arg;
+    unsigned long long f[7];
+    procparse_fields(input->text + 3, f, 7, NULL);
+    sink += f[3];
+}
+
+static void bench_percpu_sscanf(void* arg){
+    sink += sum_percpu_sscanf(((const parseInput*)arg)->text);
+}
+
+static void bench_percpu_procparse(void* arg){
+    sink += sum_percpu_procparse(((const parseInput*)arg)->text);
+}
+
+static void bench_irq_row_sscanf(void* arg){
+    sink += sum_fields_sscanf(((const parseInput*)arg)->text);
+}
+
+static void bench_irq_row_procparse(void* arg){
+    sink += sum_fields_procparse(((const parseInput*)arg)->text);
+}
+
+int main(){
+    parseInput cpu_line = {"cpu  2178222523 28813 15411241 13053426780 996126 0 70929 0 0 0\n", 1, 7, 0};
+    parseInput percpu = {make_percpu_stat(WIDE_CPUS), WIDE_CPUS, STAT_FIELDS, 0};
+    parseInput irq_row = {make_irq_row(WIDE_CPUS), 1, WIDE_CPUS, 0};
+    unsigned long long f[7];
+    sscanf(cpu_line.text, "cpu  %llu %llu %llu %llu %llu %llu %llu", &f[0], &f[1], &f[2], &f[3], &f[4], &f[5], &f[6]);
+    for (int i = 0; i < 7; i++) cpu_line.sum += f[i];
+    percpu.sum = sum_percpu_sscanf(percpu.text);
+    irq_row.sum = sum_fields_sscanf(irq_row.text);
+
+    char params[160];
+    snprintf(params, sizeof(params), "\"parser\":\"sscanf\",\"fields\":%d", cpu_line.fields);
+    bench_run("procparse/cpu_line", params, bench_cpu_line_sscanf, &cpu_line);
+    snprintf(params, sizeof(params), "\"parser\":\"sscanf\",\"cpus\":%d,\"fields\":%d", WIDE_CPUS, percpu.lines * STAT_FIELDS);
+    bench_run("procparse/percpu_stat", params, bench_percpu_sscanf, &percpu);
+    snprintf(params, sizeof(params), "\"parser\":\"sscanf\",\"cpus\":%d,\"fields\":%d", WIDE_CPUS, irq_row.fields);
+    bench_run("procparse/irq_row", params, bench_irq_row_sscanf, &irq_row);
+
+    int status = 0;
+    procparse_fields(cpu_line.text + 3, f, 7, NULL);
+    unsigned long long line_sum = f[0] + f[1] + f[2] + f[3] + f[4] + f[5] + f[6];
+    if (line_sum != cpu_line.sum || sum_percpu_procparse(percpu.text) != percpu.sum || \
+        sum_fields_procparse(irq_row.text) != irq_row.sum){
+        fprintf(stderr, "procparse does not agree with sscanf\n");
+        status = 1;
+    }else{
+        snprintf(params, sizeof(params), "\"parser\":\"procparse\",\"fields\":%d", cpu_line.fields);
+        bench_run("procparse/cpu_line", params, bench_cpu_line_procparse, &cpu_line);
+        snprintf(params, sizeof(params), "\"parser\":\"procparse\",\"cpus\":%d,\"fields\":%d", WIDE_CPUS, \
+                 percpu.lines * STAT_FIELDS);
+        bench_run("procparse/percpu_stat", params, bench_percpu_procparse, &percpu);
+        snprintf(params, sizeof(params), "\"parser\":\"procparse\",\"cpus\":%d,\"fields\":%d", WIDE_CPUS, irq_row.fields);
+        bench_run("procparse/irq_row", params, bench_irq_row_procparse, &irq_row);
+    }
+    free((char*)percpu.text);
+    free((char*)irq_row.text);
+    return status;
+}
@@ -0,0 +1,111 @@
+#define _XOPEN_SOURCE 700
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "benchTool.h"
+#include "procfsGenerator.h"
+#include "procRoot.h"
+#include "cpu.h"
+#include "core.h"
+#include "memory.h"
+#include "interrupts.h"
+
+/*
+Scaling benchmark: generates synthetic trees for N = 4 .. 1024 logical CPUs (2 sockets from N = 8)
+and reports the cost of each collector and renderer per N as JSON lines, so a regression shows up
+as a change in the curve rather than in a single point.
+*/
+
+#define MIN_NS 100000000LL
+
+static void bench_get_cpuInfo(void* arg){
+    (void)arg;
+    free(get_cpuInfo());
+}
+
+static void bench_get_MemoryInfo(void* arg){
+    (void)arg;
+    free(get_MemoryInfo());
+}
+
+static void bench_get_cores_num(void* arg){
+    (void)arg;
+    get_cores_num();
+}
+
+static void bench_get_max_freq(void* arg){
+    (void)arg;
+    get_max_freq();
+}
+
+static void bench_irq_collector_sample(void* arg){
+    irqSample sample;
+    irq_collector_sample((irqCollector*)arg, &sample);
+}
+
+static void bench_irq_collector_sample_busy(void* arg){
+    // the fixture never changes; wiping the text the next read is compared with makes every counter look
+    // changed, so this is the cost of a host where every source fires on every CPU
+    irqCollector* collector = (irqCollector*)arg;
+    for (int f = 0; f < IRQ_FILES; f++) memset(collector->bufs[f], 0, collector->lengths[f]);
+    irqSample sample;
+    irq_collector_sample(collector, &sample);
+}
+
+static void bench_draw_all_core(void* arg){
+    draw_all_core((coreInfo*)arg);
+}
+
+int main(int argc, char** argv){
+    int max_cpus = (argc > 1) ? atoi(argv[1]) : 1024;
+    char root[] = "/tmp/myMonitoringTool-scaling-XXXXXX";
+    if (mkdtemp(root) == NULL){
+        perror("mkdtemp");
+        return 1;
+    }
+    for (int n = 4; n <= max_cpus; n *= 2){
+        int sockets = (n >= 8) ? 2 : 1;
+        remove_fixture_tree(root);
+        if (generate_procfs_fixture(root, n, sockets) == -1){
+            fprintf(stderr, "failed to generate fixture for %d CPUs\n", n);
+            return 1;
+        }
+        set_proc_root(root);
+        char params[64];
+        snprintf(params, sizeof(params), "\"n\":%d,\"sockets\":%d", n, sockets);
+        BenchResult result;
+
+        result = bench_measure(bench_get_cpuInfo, NULL, MIN_NS);
+        bench_report("scaling/get_cpuInfo", params, &result);
+        result = bench_measure(bench_get_MemoryInfo, NULL, MIN_NS);
+        bench_report("scaling/get_MemoryInfo", params, &result);
+        result = bench_measure(bench_get_cores_num, NULL, MIN_NS);
+        bench_report("scaling/get_cores_num", params, &result);
+        result = bench_measure(bench_get_max_freq, NULL, MIN_NS);
+        bench_report("scaling/get_max_freq", params, &result);
+
+        // /proc/interrupts grows with CPUs and with sources (one NIC queue per four CPUs)
+        irqCollector irq_collector;
+        if (irq_collector_init(&irq_collector) == -1){
+            fprintf(stderr, "failed to read the interrupt files for %d CPUs\n", n);
+            return 1;
+        }
+        result = bench_measure(bench_irq_collector_sample, &irq_collector, MIN_NS);
+        bench_report("scaling/irq_collector_sample", params, &result);
+        result = bench_measure(bench_irq_collector_sample_busy, &irq_collector, MIN_NS);
+        bench_report("scaling/irq_collector_sample_busy", params, &result);
+        irq_collector_close(&irq_collector);
+
+        coreInfo info;
+        info.cores_num = n;
+        info.max_freq = 3.8;
+        bench_silence_stdout();
+        result = bench_measure(bench_draw_all_core, &info, MIN_NS);
+        bench_restore_stdout();
+        bench_report("scaling/draw_all_core", params, &result);
+    }
+    remove_fixture_tree(root);
+    return 0;
+}
@@ -0,0 +1,86 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "shmSnapshot.h"
+#include "timeTool.h"
+
+/*
+Contention benchmark for the seqlock snapshot: one writer publishes as fast as it can while
+N reader threads take snapshots. Prints one JSON object per reader count:
+reads per second per reader, the fraction of reads that had to retry, and publishes per second.
+*/
+
+#define RUN_NS 300000000LL  // 0.3 s per configuration
+
+typedef struct {
+    const ShmSnapshot* shm;
+    volatile int* stop;
+    unsigned long long reads;
+    unsigned long long retries;
+    unsigned long long torn;
+}readerArg;
+
+static void* reader_main(void* arg){
+    readerArg* r = (readerArg*)arg;
+    ShmSample sample;
+    while (!__atomic_load_n(r->stop, __ATOMIC_RELAXED)){
+        r->retries += shm_snapshot_read(r->shm, &sample);
+        // the writer keeps used == total / 2, a torn copy would break the relation
+        if (sample.sample_seq != 0 && sample.used_memory * 2.0f != sample.total_memory) r->torn++;
+        r->reads++;
+    }
+    return NULL;
+}
+
+int main(int argc, char** argv){
+    int max_readers = (argc > 1) ? atoi(argv[1]) : 16;
+    char name[64];
+    snprintf(name, sizeof(name), "/myMonitoringTool-bench-%d", (int)getpid());
+    ShmSnapshot* writer = shm_snapshot_create(name);
+    if (writer == NULL) return 1;
+    const ShmSnapshot* reader_map = shm_snapshot_attach(name);
+    if (reader_map == NULL){
+        shm_snapshot_destroy(writer, name);
+        return 1;
+    }
+
+    for (int n = 1; n <= max_readers; n *= 2){
+        volatile int stop = 0;
+        pthread_t* threads = (pthread_t*)malloc(sizeof(pthread_t) * n);
+        readerArg* args = (readerArg*)calloc(n, sizeof(readerArg));
+        for (int i = 0; i < n; i++){
+            args[i].shm = reader_map;
+            args[i].stop = &stop;
+            pthread_create(&threads[i], NULL, reader_main, &args[i]);
+        }
+        unsigned long long publishes = 0;
+        long long start = now_mono_ns();
+        while (now_mono_ns() - start < RUN_NS){
+            float total = (float)(publishes % 1024 + 2);
+            shm_snapshot_publish(writer, 50.0f, total, total / 2.0f, start);
+            publishes++;
+        }
+        __atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+        unsigned long long reads = 0, retries = 0, torn = 0;
+        for (int i = 0; i < n; i++){
+            pthread_join(threads[i], NULL);
+            reads += args[i].reads;
+            retries += args[i].retries;
+            torn += args[i].torn;
+        }
+        double secs = (double)(now_mono_ns() - start) / 1e9;
+        printf("{\"bench\":\"shm_snapshot_read\",\"readers\":%d,\"reads_per_sec_per_reader\":%.0f,"
+               "\"ns_per_read\":%.1f,\"retry_ratio\":%.4f,\"publishes_per_sec\":%.0f,\"torn\":%llu}\n",
+               n, reads / secs / n, reads ? secs * 1e9 * n / reads : 0.0,
+               reads ? (double)retries / reads : 0.0, publishes / secs, torn);
+        free(threads);
+        free(args);
+    }
+    shm_snapshot_detach(reader_map);
+    shm_snapshot_destroy(writer, name);
+    return 0;
+}
@@ -0,0 +1,157 @@
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "benchTool.h"
+#include "timeTool.h"
+
+/*
+Time to first frame of `myMonitoringTool --cores`: the tool is forked and exec'd on the fixture
+tree with its stdout on a pipe, and the clock runs from the fork until the cores panel ("Number of
+Cores") arrives on the pipe, then until the tool exits. Cold runs delete the hardware cache file
+(--hw-cache) before each start, so the core count and max frequency are read from the fixture and
+the file is written; warm runs keep the file of the previous run and only read it. The run fails if
+the tool exits with an error, never draws the panel, leaves no cache entry behind, or rewrites the
+entry on a warm start (the file is replaced by a rename, so its inode would change).
+The first argument replaces ./myMonitoringTool, e.g. a build of another commit to compare against;
+one without --hw-cache reports its cold start-up and then fails the cache check.
+*/
+
+#define STARTUP_MIN_NS 300000000LL
+#define STARTUP_OUT_BUF 4096
+
+typedef struct {
+    const char* tool;
+    const char* root;
+    char cache_arg[96];
+    const char* cache_path;
+    int cold;
+    long long first_frame_ns;
+    long long exit_ns;
+    unsigned long long runs;
+    int failures;
+}startupRun;
+///_|> descry: State of the start-up benchmark, summed over its runs
+///_|> members:
+///_|>     - tool / root: binary to start and the --proc-root it reads, type const char*
+///_|>     - cache_arg / cache_path: "--hw-cache=FILE" passed to the tool and FILE, type char[] / const char*
+///_|>     - cold: whether the cache file is deleted before each run, type int
+///_|>     - first_frame_ns / exit_ns: summed time from fork to the cores panel and to the exit, type long long
+///_|>     - runs / failures: runs made and runs without a panel or with a failed exit, type unsigned long long / int
+
+static void run_tool_once(void* arg){
+    ///_|> descry: starts the tool once and waits for its cores panel and its exit
+    ///_|> arg: the benchmark state, type startupRun*
+    ///_|> returning: this function does not return anything
+    startupRun* run = (startupRun*)arg;
+    if (run->cold) unlink(run->cache_path);
+    int out_fd[2];
+    if (pipe(out_fd) == -1){
+        run->failures++;
+        return;
+    }
+    long long start_ns = now_mono_ns();
+    pid_t pid = fork();
+    if (pid == 0){
+        int null_fd = open("/dev/null", O_RDWR);
+        dup2(null_fd, STDIN_FILENO);
+        dup2(null_fd, STDERR_FILENO);
+        dup2(out_fd[1], STDOUT_FILENO);
+        close(out_fd[0]);
+        close(out_fd[1]);
+        close(null_fd);
+        char proc_root[320];
+        snprintf(proc_root, sizeof(proc_root), "--proc-root=%s", run->root);
+        execl(run->tool, run->tool, "--cores", proc_root, run->cache_arg, (char*)NULL);
+        _exit(127);
+    }
+    close(out_fd[1]);
+    if (pid < 0){
+        close(out_fd[0]);
+        run->failures++;
+        return;
+    }
+    // the panel title may be split across reads, so the tail of the previous read is kept
+    char buf[STARTUP_OUT_BUF + 32];
+    size_t kept = 0;
+    long long first_frame_ns = -1;
+    ssize_t got;
+    while ((got = read(out_fd[0], buf + kept, STARTUP_OUT_BUF)) > 0){
+        if (first_frame_ns != -1) continue;
+        size_t len = kept + (size_t)got;
+        buf[len] = '\0';
+        if (strstr(buf, "Number of Cores") != NULL){
+            first_frame_ns = now_mono_ns() - start_ns;
+            continue;
+        }
+        kept = (len < 16) ? len : 16;
+        memmove(buf, buf + len - kept, kept);
+    }
+    close(out_fd[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    long long exit_ns = now_mono_ns() - start_ns;
+    if (first_frame_ns == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0){
+        run->failures++;
+        return;
+    }
+    run->first_frame_ns += first_frame_ns;
+    run->exit_ns += exit_ns;
+    run->runs++;
+}
+
+static int measure_startup(startupRun* run){
+    ///_|> descry: times the tool's start-up in one cache state and reports time to first frame and to exit
+    ///_|> run: the benchmark state with tool, root, cache and cold set, type startupRun*
+    ///_|> returning: returns 0 on success, -1 if a run failed
+    run->first_frame_ns = 0;
+    run->exit_ns = 0;
+    run->runs = 0;
+    run->failures = 0;
+    BenchResult result = bench_measure(run_tool_once, run, STARTUP_MIN_NS);
+    if (run->failures > 0 || run->runs == 0){
+        fprintf(stderr, "startup: %d of %llu runs of %s drew no cores panel or failed\n", run->failures, \
+                result.iters, run->tool);
+        return -1;
+    }
+    char params[96];
+    snprintf(params, sizeof(params), "\"cache\":\"%s\",\"until\":\"first_frame\"", run->cold ? "cold" : "warm");
+    result.ns_per_op = (double)run->first_frame_ns / (double)run->runs;
+    bench_report("startup/cores", params, &result);
+    snprintf(params, sizeof(params), "\"cache\":\"%s\",\"until\":\"exit\"", run->cold ? "cold" : "warm");
+    result.ns_per_op = (double)run->exit_ns / (double)run->runs;
+    bench_report("startup/cores", params, &result);
+    return 0;
+}
+
+int main(int argc, char** argv){
+    startupRun run;
+    memset(&run, 0, sizeof(run));
+    run.tool = (argc > 1) ? argv[1] : "./myMonitoringTool";
+    run.root = "bench/fixtures/procfs";
+    snprintf(run.cache_arg, sizeof(run.cache_arg), "--hw-cache=/tmp/bench_startup_%d.hw", (int)getpid());
+    run.cache_path = run.cache_arg + strlen("--hw-cache=");
+
+    run.cold = 1;
+    int status = (measure_startup(&run) == -1) ? 1 : 0;
+    // the last cold run left the entry the warm runs start from
+    struct stat st;
+    if (status == 0 && (stat(run.cache_path, &st) == -1 || st.st_size == 0)){
+        fprintf(stderr, "startup: no hardware cache entry was written to %s\n", run.cache_path);
+        status = 1;
+    }
+    run.cold = 0;
+    if (status == 0 && measure_startup(&run) == -1) status = 1;
+    struct stat after;
+    if (status == 0 && (stat(run.cache_path, &after) == -1 || after.st_ino != st.st_ino)){
+        fprintf(stderr, "startup: a warm start rewrote the hardware cache entry instead of reading it\n");
+        status = 1;
+    }
+    unlink(run.cache_path);
+    return status;
+}
@@ -0,0 +1,237 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "benchTool.h"
+#include "tsCompress.h"
+#include "flightRecorder.h"
+
+/*
+Compression ratio and encode/decode throughput of the --record format on generated series that
+look like what the producers emit: 100 ms ticks with scheduler jitter, CPU utilization computed
+from jiffy deltas the way calcu_cpu_utiliz does, and used memory from KB counters converted to GB
+like convert_MemoryInfo_GB. Raw size is 20 bytes per sample (8-byte timestamp, three floats).
+Every series is decoded once and compared bit for bit before timing; the run fails on a mismatch.
+flight/record times one committed sample of --flight-recorder (stores into a mapped file in /tmp,
+wrapping many times); it must make no heap allocation once the file is mapped.
+*/
+
+#define SERIES_SAMPLES 100000
+#define MAX_BLOCKS (SERIES_SAMPLES / TS_BLOCK_SAMPLES + 1)
+#define TICK_US 100000
+#define RAW_BYTES_PER_SAMPLE 20
+
+typedef struct {
+    const char* name;
+    tsPoint* points;
+    int count;
+    tsBlockHeader headers[MAX_BLOCKS];
+    unsigned char* streams[MAX_BLOCKS];
+    int blocks;
+    size_t encoded_bytes;
+    tsPoint* decoded;
+    FILE* sink;
+}benchSeries;
+///_|> descry: One generated series with its encoded blocks
+///_|> members:
+///_|>     - name: pattern name used in the report, type const char*
+///_|>     - points / count: the generated samples, type tsPoint* / int
+///_|>     - headers / streams / blocks: the series encoded into blocks, type tsBlockHeader[] / unsigned char*[] / int
+///_|>     - encoded_bytes: size on disk, headers included, type size_t
+///_|>     - decoded: decode target, type tsPoint*
+///_|>     - sink: /dev/null, receives blocks while encoding is timed, type FILE*
+
+static unsigned long long rng_state = 0x9e3779b97f4a7c15ULL;
+
+static unsigned int next_rand(){
+    ///_|> descry: xorshift64 generator, deterministic so every run compresses the same series
+    ///_|> returning: returns 32 pseudo-random bits
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (unsigned int)(rng_state >> 32);
+}
+
+static void generate_series(tsPoint* points, int count, int busy){
+    ///_|> descry: generates a 4-CPU host sampled every 100 ms
+    ///_|> points: receives count samples, type tsPoint*
+    ///_|> count: number of samples, type int
+    ///_|> busy: 0 for a mostly idle desktop, 1 for a loaded server with bursty CPU and churning memory, type int
+    ///_|> returning: this function does not return anything
+    long long ts = 1760000000000000LL;
+    unsigned long total_kb = 16323584UL;
+    unsigned long free_kb = busy ? 4100000UL : 11800000UL;
+    for (int i = 0; i < count; i++){
+        // usleep wakes up 50-300 us late, the next tick is scheduled from the actual wake-up
+        ts += TICK_US + 50 + next_rand() % 250;
+        long long total_delta = 40; // 4 CPUs x 10 jiffies per 100 ms
+        long long busy_delta = busy ? (long long)(next_rand() % 41) : (long long)(next_rand() % 4);
+        float cpu = ((float)busy_delta) / ((float)total_delta) * 100.0;
+        if (busy){
+            free_kb = (unsigned long)((long)free_kb + (long)(next_rand() % 20001) - 10000);
+        }else if (next_rand() % 8 == 0){
+            free_kb = (unsigned long)((long)free_kb + (long)(next_rand() % 801) - 400);
+        }
+        points[i].ts_us = ts;
+        points[i].values[TS_CPU] = cpu;
+        points[i].values[TS_MEM_TOTAL] = total_kb / (1024.0 * 1024.0);
+        points[i].values[TS_MEM_USED] = points[i].values[TS_MEM_TOTAL] - (float)(free_kb / (1024.0 * 1024.0));
+    }
+}
+
+static void encode_series(benchSeries* series, FILE* out){
+    ///_|> descry: encodes the whole series block by block into out
+    ///_|> series: series to encode, type benchSeries*
+    ///_|> out: file receiving the blocks, type FILE*
+    ///_|> returning: this function does not return anything
+    static tsEncoder enc;
+    ts_encoder_reset(&enc);
+    for (int i = 0; i < series->count; i++){
+        ts_encoder_add(&enc, &series->points[i]);
+        if (ts_encoder_full(&enc)) ts_encoder_write(&enc, out);
+    }
+    ts_encoder_write(&enc, out);
+}
+
+static void bench_encode(void* arg){
+    benchSeries* series = (benchSeries*)arg;
+    encode_series(series, series->sink);
+}
+
+static void bench_decode(void* arg){
+    benchSeries* series = (benchSeries*)arg;
+    tsPoint* out = series->decoded;
+    for (int b = 0; b < series->blocks; b++){
+        out += ts_decode_block(&series->headers[b], series->streams[b], out);
+    }
+}
+
+static int load_blocks(benchSeries* series){
+    ///_|> descry: encodes the series into a temporary file and reads its blocks back into memory
+    ///_|> series: series to encode, type benchSeries*
+    ///_|> returning: returns 0 on success, -1 on an I/O or format error
+    FILE* file = tmpfile();
+    if (file == NULL){
+        perror("tmpfile");
+        return -1;
+    }
+    encode_series(series, file);
+    series->encoded_bytes = (size_t)ftell(file);
+    rewind(file);
+    series->blocks = 0;
+    while (series->blocks < MAX_BLOCKS){
+        unsigned char* stream = (unsigned char*)malloc(TS_BLOCK_BYTES);
+        if (stream == NULL) break;
+        int got = ts_read_block(file, &series->headers[series->blocks], stream);
+        if (got != 1){
+            free(stream);
+            if (got == -1) series->blocks = -1;
+            break;
+        }
+        series->streams[series->blocks++] = stream;
+    }
+    fclose(file);
+    return (series->blocks > 0) ? 0 : -1;
+}
+
+static int check_roundtrip(benchSeries* series){
+    ///_|> descry: decodes the series once and compares every field bit for bit
+    ///_|> series: series with loaded blocks, type benchSeries*
+    ///_|> returning: returns 0 if the decoded series equals the input, -1 otherwise
+    memset(series->decoded, 0, sizeof(tsPoint) * series->count);
+    bench_decode(series);
+    for (int i = 0; i < series->count; i++){
+        // fields one by one: tsPoint has tail padding
+        bool same = series->decoded[i].ts_us == series->points[i].ts_us;
+        for (int s = 0; s < TS_SERIES; s++){
+            same = same && memcmp(&series->decoded[i].values[s], &series->points[i].values[s], sizeof(float)) == 0;
+        }
+        if (!same){
+            fprintf(stderr, "%s: sample %d does not round-trip\n", series->name, i);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int run_series(const char* name, int busy){
+    ///_|> descry: generates, checks and benchmarks one series pattern
+    ///_|> name: pattern name, type const char*
+    ///_|> busy: passed to generate_series, type int
+    ///_|> returning: returns 0 on success, -1 on a setup failure or round-trip mismatch
+    static benchSeries series;
+    memset(&series, 0, sizeof(series));
+    series.name = name;
+    series.count = SERIES_SAMPLES;
+    series.points = (tsPoint*)malloc(sizeof(tsPoint) * SERIES_SAMPLES);
+    series.decoded = (tsPoint*)malloc(sizeof(tsPoint) * SERIES_SAMPLES);
+    series.sink = fopen("/dev/null", "wb");
+    int status = -1;
+    if (series.points == NULL || series.decoded == NULL || series.sink == NULL){
+        perror("bench_tscompress setup");
+    }else{
+        generate_series(series.points, series.count, busy);
+        if (load_blocks(&series) == 0 && check_roundtrip(&series) == 0) status = 0;
+    }
+    if (status == 0){
+        double bytes_per_sample = (double)series.encoded_bytes / series.count;
+        char params[256];
+        snprintf(params, sizeof(params), "\"series\":\"%s\",\"samples\":%d,\"bytes_per_sample\":%.2f,\"ratio\":%.2f", \
+                 name, series.count, bytes_per_sample, RAW_BYTES_PER_SAMPLE / bytes_per_sample);
+        bench_run("tscompress/encode", params, bench_encode, &series);
+
+        BenchResult result = bench_measure(bench_decode, &series, 500000000LL);
+        double samples_per_sec = series.count / (result.ns_per_op / 1e9);
+        // how much faster than real time a recording made at 10 samples/s replays
+        snprintf(params, sizeof(params), "\"series\":\"%s\",\"samples\":%d,\"samples_per_sec\":%.0f,\"x_realtime_10hz\":%.0f", \
+                 name, series.count, samples_per_sec, samples_per_sec / (1e6 / TICK_US));
+        bench_report("tscompress/decode", params, &result);
+    }
+    for (int b = 0; b < series.blocks; b++) free(series.streams[b]);
+    free(series.points);
+    free(series.decoded);
+    if (series.sink != NULL) fclose(series.sink);
+    return status;
+}
+
+static long long flight_wall_ns = 0;
+///_|> descry: timestamp of the next flight recorder sample, one tick apart
+
+static void bench_flight_record(void* arg){
+    const schedInfo* sched = (const schedInfo*)arg;
+    static vmstatInfo vm;
+    flight_wall_ns += TICK_US * 1000LL;
+    flight_record_sample(12.5f, 3.25f, 15.5f, sched, &vm, 0, flight_wall_ns);
+}
+
+static int run_flight_record(){
+    ///_|> descry: benchmarks the per-sample cost of the flight recorder on a small file in /tmp
+    ///_|> returning: returns 0 on success, -1 if the file cannot be set up or a sample allocates
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/bench_flight_%d.bin", (int)getpid());
+    char spec[96];
+    snprintf(spec, sizeof(spec), "%s,64K", path);
+    schedInfo sched = {.ctxt_rate = 1500.0f, .fork_rate = 4.0f, .procs_running = 2, .procs_blocked = 0, \
+                       .load = {0.5f, 0.4f, 0.3f}};
+    if (flight_recorder_configure(spec) == -1) return -1;
+    bench_flight_record(&sched); // maps the file
+    BenchResult result = bench_measure(bench_flight_record, &sched, 200000000LL);
+    flight_recorder_close();
+    unlink(path);
+    bench_report("flight/record", "\"file_bytes\":65536", &result);
+    return (result.allocs_per_op == 0) ? 0 : -1;
+}
+
+int main(){
+    if (run_series("idle", 0) == -1 || run_series("busy", 1) == -1){
+        fprintf(stderr, "compressed recording does not round-trip\n");
+        return 1;
+    }
+    if (run_flight_record() == -1){
+        fprintf(stderr, "flight recorder setup failed or a sample allocated\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,19 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "procfsGenerator.h"
+
+// usage: bench/gen_procfs DIR NCPUS [SOCKETS]   then run ./myMonitoringTool --proc-root=DIR
+int main(int argc, char** argv){
+    if (argc < 3){
+        fprintf(stderr, "usage: %s DIR NCPUS [SOCKETS]\n", argv[0]);
+        return 1;
+    }
+    int ncpus = atoi(argv[2]);
+    int sockets = (argc > 3) ? atoi(argv[3]) : 1;
+    if (generate_procfs_fixture(argv[1], ncpus, sockets) == -1){
+        fprintf(stderr, "failed to generate %d CPUs over %d sockets in %s\n", ncpus, sockets, argv[1]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,392 @@
+#define _XOPEN_SOURCE 700
+#include "procfsGenerator.h"
+#include <errno.h>
+#include <ftw.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+static int make_dirs(const char* path){
+    ///_|> descry: creates a directory and all missing parents (mkdir -p)
+    ///_|> path: directory to create, type const char*
+    ///_|> returning: returns 0 on success, -1 on failure
+    char buf[512];
+    snprintf(buf, sizeof(buf), "%s", path);
+    for (char* p = buf + 1; *p; p++){
+        if (*p != '/') continue;
+        *p = '\0';
+        if (mkdir(buf, 0755) == -1 && errno != EEXIST) return -1;
+        *p = '/';
+    }
+    if (mkdir(buf, 0755) == -1 && errno != EEXIST) return -1;
+    return 0;
+}
+
+static FILE* open_fixture(const char* root, const char* rel){
+    ///_|> descry: opens root/rel for writing, creating parent directories
+    ///_|> returning: returns the opened file, or NULL on failure
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", root, rel);
+    char* slash = strrchr(path, '/');
+    *slash = '\0';
+    if (make_dirs(path) == -1) return NULL;
+    *slash = '/';
+    return fopen(path, "w");
+}
+
+static int write_stat(const char* root, int ncpus){
+    FILE* out = open_fixture(root, "proc/stat");
+    if (out == NULL) return -1;
+    unsigned long long totals[10] = {0};
+    unsigned long long (*per)[10] = malloc(sizeof(*per) * ncpus);
+    if (per == NULL){
+        fclose(out);
+        return -1;
+    }
+    for (int c = 0; c < ncpus; c++){
+        unsigned long long seed = (unsigned long long)c * 2654435761ULL + 12345;
+        per[c][0] = 1000000 + seed % 4000000;       // user
+        per[c][1] = seed % 10000;                   // nice
+        per[c][2] = 100000 + seed % 900000;         // system
+        per[c][3] = 10000000 + seed % 40000000;     // idle
+        per[c][4] = 10000 + seed % 90000;           // iowait
+        per[c][5] = 0;                              // irq
+        per[c][6] = 1000 + seed % 9000;             // softirq
+        per[c][7] = per[c][8] = per[c][9] = 0;      // steal guest guest_nice
+        for (int f = 0; f < 10; f++) totals[f] += per[c][f];
+    }
+    fprintf(out, "cpu ");
+    for (int f = 0; f < 10; f++) fprintf(out, " %llu", totals[f]);
+    fprintf(out, "\n");
+    for (int c = 0; c < ncpus; c++){
+        fprintf(out, "cpu%d", c);
+        for (int f = 0; f < 10; f++) fprintf(out, " %llu", per[c][f]);
+        fprintf(out, "\n");
+    }
+    free(per);
+    // intr has one counter per interrupt line; large hosts have thousands of them
+    int irqs = 64 + ncpus * 4;
+    fprintf(out, "intr 9182736455");
+    for (int i = 0; i < irqs; i++) fprintf(out, " %d", (i * 7919) % 100000);
+    fprintf(out, "\nctxt 348771209312\nbtime 1729310400\nprocesses 48219371\n");
+    fprintf(out, "procs_running %d\nprocs_blocked %d\n", 1 + ncpus / 16, ncpus / 64);
+    fprintf(out, "softirq 998312412 0 201311 12 30122 0 0 9912 312201 0 401223\n");
+    fclose(out);
+    return 0;
+}
+
+static int write_cpuinfo(const char* root, int ncpus, int sockets){
+    FILE* out = open_fixture(root, "proc/cpuinfo");
+    if (out == NULL) return -1;
+    int per_socket = ncpus / sockets;
+    for (int c = 0; c < ncpus; c++){
+        int socket = c / per_socket;
+        fprintf(out, "processor\t: %d\nvendor_id\t: GenuineIntel\ncpu family\t: 6\nmodel\t\t: 143\n", c);
+        fprintf(out, "model name\t: Intel(R) Xeon(R) Platinum 8480+\nstepping\t: 8\nmicrocode\t: 0x2b000461\n");
+        fprintf(out, "cpu MHz\t\t: 2000.000\ncache size\t: 107520 KB\nphysical id\t: %d\nsiblings\t: %d\n", \
+                socket, per_socket);
+        fprintf(out, "core id\t\t: %d\ncpu cores\t: %d\napicid\t\t: %d\ninitial apicid\t: %d\n", \
+                (c % per_socket) / 2, per_socket / 2, c, c);
+        fprintf(out, "fpu\t\t: yes\nfpu_exception\t: yes\ncpuid level\t: 31\nwp\t\t: yes\n");
+        fprintf(out, "flags\t\t: fpu vme de pse tsc msr pae mce cx8 apic sep mtrr pge mca cmov pat pse36 clflush "
+                     "dts acpi mmx fxsr sse sse2 ss ht tm pbe syscall nx pdpe1gb rdtscp lm constant_tsc art "
+                     "arch_perfmon pebs bts rep_good nopl xtopology nonstop_tsc cpuid aperfmperf pni pclmulqdq "
+                     "ssse3 fma cx16 pcid sse4_1 sse4_2 x2apic movbe popcnt aes xsave avx f16c rdrand avx2 avx512f\n");
+        fprintf(out, "bugs\t\t: spectre_v1 spectre_v2 spec_store_bypass swapgs eibrs_pbrsb\nbogomips\t: 4000.00\n");
+        fprintf(out, "clflush size\t: 64\ncache_alignment\t: 64\naddress sizes\t: 46 bits physical, 57 bits virtual\n");
+        fprintf(out, "power management:\n\n");
+    }
+    fclose(out);
+    return 0;
+}
+
+static int write_meminfo(const char* root, int ncpus){
+    FILE* out = open_fixture(root, "proc/meminfo");
+    if (out == NULL) return -1;
+    unsigned long long total_kb = (unsigned long long)ncpus * 8ULL * 1024 * 1024; // 8 GB per CPU
+    fprintf(out, "MemTotal:       %llu kB\nMemFree:        %llu kB\nMemAvailable:   %llu kB\n", \
+            total_kb, total_kb / 3, total_kb / 2);
+    fprintf(out, "Buffers:          123456 kB\nCached:         %llu kB\nSwapCached:            0 kB\n", total_kb / 8);
+    fprintf(out, "SwapTotal:              0 kB\nSwapFree:               0 kB\nDirty:               412 kB\n");
+    fclose(out);
+    return 0;
+}
+
+static int write_loadavg(const char* root, int ncpus){
+    FILE* out = open_fixture(root, "proc/loadavg");
+    if (out == NULL) return -1;
+    // runnable/total scheduling entities and the last PID, like the kernel's line
+    fprintf(out, "%.2f %.2f %.2f %d/%d 48219371\n", ncpus * 0.30, ncpus * 0.28, ncpus * 0.25, \
+            1 + ncpus / 16, 300 + ncpus * 40);
+    fclose(out);
+    return 0;
+}
+
+static const char vmstat_names[] =
+    "nr_free_pages nr_free_pages_blocks nr_zone_inactive_anon nr_zone_active_anon "
+    "nr_zone_inactive_file nr_zone_active_file nr_zone_unevictable nr_zone_write_pending nr_mlock "
+    "nr_zspages nr_free_cma numa_hit numa_miss numa_foreign numa_interleave numa_local numa_other "
+    "nr_inactive_anon nr_active_anon nr_inactive_file nr_active_file nr_unevictable "
+    "nr_slab_reclaimable nr_slab_unreclaimable nr_isolated_anon nr_isolated_file workingset_nodes "
+    "workingset_refault_anon workingset_refault_file workingset_activate_anon "
+    "workingset_activate_file workingset_restore_anon workingset_restore_file workingset_nodereclaim "
+    "nr_anon_pages nr_mapped nr_file_pages nr_dirty nr_writeback nr_shmem nr_shmem_hugepages "
+    "nr_shmem_pmdmapped nr_file_hugepages nr_file_pmdmapped nr_anon_transparent_hugepages "
+    "nr_vmscan_write nr_vmscan_immediate_reclaim nr_dirtied nr_written nr_throttled_written "
+    "nr_kernel_misc_reclaimable nr_foll_pin_acquired nr_foll_pin_released nr_kernel_stack "
+    "nr_page_table_pages nr_sec_page_table_pages nr_iommu_pages nr_swapcached pgpromote_success "
+    "pgpromote_candidate pgpromote_candidate_nrl pgdemote_kswapd pgdemote_direct pgdemote_khugepaged "
+    "pgdemote_proactive nr_hugetlb nr_balloon_pages nr_kernel_file_pages nr_dirty_threshold "
+    "nr_dirty_background_threshold nr_memmap_pages nr_memmap_boot_pages pgpgin pgpgout pswpin "
+    "pswpout pgalloc_dma pgalloc_dma32 pgalloc_normal pgalloc_movable pgalloc_device allocstall_dma "
+    "allocstall_dma32 allocstall_normal allocstall_movable allocstall_device pgskip_dma pgskip_dma32 "
+    "pgskip_normal pgskip_movable pgskip_device pgfree pgactivate pgdeactivate pglazyfree pgfault "
+    "pgmajfault pglazyfreed pgrefill pgreuse pgsteal_kswapd pgsteal_direct pgsteal_khugepaged "
+    "pgsteal_proactive pgscan_kswapd pgscan_direct pgscan_khugepaged pgscan_proactive "
+    "pgscan_direct_throttle pgscan_anon pgscan_file pgsteal_anon pgsteal_file zone_reclaim_success "
+    "zone_reclaim_failed pginodesteal slabs_scanned kswapd_inodesteal kswapd_low_wmark_hit_quickly "
+    "kswapd_high_wmark_hit_quickly pageoutrun pgrotated drop_pagecache drop_slab oom_kill "
+    "numa_pte_updates numa_huge_pte_updates numa_hint_faults numa_hint_faults_local "
+    "numa_pages_migrated pgmigrate_success pgmigrate_fail thp_migration_success thp_migration_fail "
+    "thp_migration_split compact_migrate_scanned compact_free_scanned compact_isolated compact_stall "
+    "compact_fail compact_success compact_daemon_wake compact_daemon_migrate_scanned "
+    "compact_daemon_free_scanned htlb_buddy_alloc_success htlb_buddy_alloc_fail "
+    "unevictable_pgs_culled unevictable_pgs_scanned unevictable_pgs_rescued unevictable_pgs_mlocked "
+    "unevictable_pgs_munlocked unevictable_pgs_cleared unevictable_pgs_stranded thp_fault_alloc "
+    "thp_fault_fallback thp_fault_fallback_charge thp_collapse_alloc thp_collapse_alloc_failed "
+    "thp_file_alloc thp_file_fallback thp_file_fallback_charge thp_file_mapped thp_split_page "
+    "thp_split_page_failed thp_deferred_split_page thp_underused_split_page thp_split_pmd "
+    "thp_scan_exceed_none_pte thp_scan_exceed_swap_pte thp_scan_exceed_share_pte thp_split_pud "
+    "thp_zero_page_alloc thp_zero_page_alloc_failed thp_swpout thp_swpout_fallback balloon_inflate "
+    "balloon_deflate balloon_migrate swap_ra swap_ra_hit swpin_zero swpout_zero ksm_swpin_copy "
+    "cow_ksm zswpin zswpout zswpwb direct_map_level2_splits direct_map_level3_splits "
+    "direct_map_level2_collapses direct_map_level3_collapses nr_unstable ";
+///_|> descry: names of /proc/vmstat on a 6.x kernel, in kernel order
+
+static int write_vmstat(const char* root, int ncpus){
+    FILE* out = open_fixture(root, "proc/vmstat");
+    if (out == NULL) return -1;
+    // the file does not grow with the CPU count, only its values do
+    int index = 0;
+    for (const char* name = vmstat_names; *name != '\0'; index++){
+        int len = (int)strcspn(name, " ");
+        unsigned long long value = (unsigned long long)((index * 7919) % 100003) * (unsigned long long)ncpus * 1000ULL;
+        fprintf(out, "%.*s %llu\n", len, name, value);
+        name += len;
+        while (*name == ' ') name++;
+    }
+    fclose(out);
+    return 0;
+}
+
+static int write_cpufreq(const char* root, int ncpus){
+    for (int c = 0; c < ncpus; c++){
+        char rel[128];
+        snprintf(rel, sizeof(rel), "sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", c);
+        FILE* out = open_fixture(root, rel);
+        if (out == NULL) return -1;
+        fprintf(out, "3800000\n");
+        fclose(out);
+        snprintf(rel, sizeof(rel), "sys/devices/system/cpu/cpu%d/cpufreq/scaling_cur_freq", c);
+        out = open_fixture(root, rel);
+        if (out == NULL) return -1;
+        fprintf(out, "%d\n", 800000 + (c * 7919) % 3000000);
+        fclose(out);
+    }
+    return 0;
+}
+
+static int write_boot_id(const char* root){
+    // a fixed boot id: the fixture is one boot for the hardware cache (hwCache)
+    FILE* out = open_fixture(root, "proc/sys/kernel/random/boot_id");
+    if (out == NULL) return -1;
+    fprintf(out, "5f0c3a8e-1d2b-4c6f-9a7e-3b8d2e4f6a10\n");
+    fclose(out);
+    return 0;
+}
+
+static int write_numa_nodes(const char* root, int ncpus, int sockets){
+    // one NUMA node per socket, CPUs numbered socket by socket like write_cpuinfo, memory split evenly
+    int per_socket = ncpus / sockets;
+    unsigned long long node_kb = (unsigned long long)per_socket * 8ULL * 1024 * 1024;
+    for (int n = 0; n < sockets; n++){
+        char rel[128];
+        snprintf(rel, sizeof(rel), "sys/devices/system/node/node%d/cpulist", n);
+        FILE* out = open_fixture(root, rel);
+        if (out == NULL) return -1;
+        fprintf(out, "%d-%d\n", n * per_socket, (n + 1) * per_socket - 1);
+        fclose(out);
+        snprintf(rel, sizeof(rel), "sys/devices/system/node/node%d/meminfo", n);
+        out = open_fixture(root, rel);
+        if (out == NULL) return -1;
+        // the first node is the busy one, as on hosts where one node fills up first
+        unsigned long long free_kb = (n == 0) ? node_kb / 16 : node_kb / 2;
+        fprintf(out, "Node %d MemTotal:       %llu kB\nNode %d MemFree:        %llu kB\n", n, node_kb, n, free_kb);
+        fprintf(out, "Node %d MemUsed:        %llu kB\nNode %d FilePages:      %llu kB\n", n, node_kb - free_kb, \
+                n, node_kb / 8);
+        fclose(out);
+        snprintf(rel, sizeof(rel), "sys/devices/system/node/node%d/numastat", n);
+        out = open_fixture(root, rel);
+        if (out == NULL) return -1;
+        unsigned long long hit = 48213377ULL + (unsigned long long)n * 1000003ULL;
+        unsigned long long miss = (n == 0) ? 0 : 412337ULL;
+        fprintf(out, "numa_hit %llu\nnuma_miss %llu\nnuma_foreign %llu\ninterleave_hit 10544\n", hit, miss, \
+                (n == 0) ? 412337ULL : 0ULL);
+        fprintf(out, "local_node %llu\nother_node %llu\n", hit - 1000, miss + 1000);
+        fclose(out);
+    }
+    return 0;
+}
+
+static void write_irq_counters(FILE* out, int ncpus, unsigned long long seed, int pinned_cpu){
+    // one "%10u" column per CPU like the kernel; a pinned source only counts on its own CPU
+    for (int c = 0; c < ncpus; c++){
+        unsigned int count = (unsigned int)((seed + (unsigned long long)c * 2654435761ULL) % 5000000);
+        if (pinned_cpu >= 0) count = (c == pinned_cpu) ? count * 40 : 0;
+        fprintf(out, " %10u", count);
+    }
+}
+
+static int write_interrupts(const char* root, int ncpus){
+    FILE* out = open_fixture(root, "proc/interrupts");
+    if (out == NULL) return -1;
+    // legacy lines, then one NIC queue per four CPUs, each pinned to one CPU as irqbalance leaves them
+    int queues = (ncpus + 3) / 4;
+    int last_irq = 24 + queues;
+    int prec = 3;
+    for (int v = last_irq; v >= 1000; v /= 10) prec++;
+    fprintf(out, "%*s", prec + 8, "");
+    for (int c = 0; c < ncpus; c++) fprintf(out, "CPU%-8d", c);
+    fprintf(out, "\n");
+    const char* legacy[] = {"IO-APIC   2-edge      timer", "IO-APIC   1-edge      i8042", \
+                            "IO-APIC   8-edge      rtc0", "IO-APIC   9-fasteoi   acpi"};
+    for (int i = 0; i < 4; i++){
+        fprintf(out, "%*d:", prec, i);
+        write_irq_counters(out, ncpus, 1000 + i, -1);
+        fprintf(out, "  %s\n", legacy[i]);
+    }
+    for (int q = 0; q < queues; q++){
+        fprintf(out, "%*d:", prec, 24 + q);
+        write_irq_counters(out, ncpus, 7919ULL * (q + 1), (q * 4) % ncpus);
+        fprintf(out, "  IR-PCI-MSIX-0000:3b:00.0 %d-edge      eth0-TxRx-%d\n", q, q);
+    }
+    const char* arch[][2] = {{"NMI", "Non-maskable interrupts"}, {"LOC", "Local timer interrupts"}, \
+                             {"RES", "Rescheduling interrupts"}, {"CAL", "Function call interrupts"}, \
+                             {"TLB", "TLB shootdowns"}};
+    for (int i = 0; i < 5; i++){
+        fprintf(out, "%*s:", prec, arch[i][0]);
+        write_irq_counters(out, ncpus, 31337ULL * (i + 1), -1);
+        fprintf(out, "   %s\n", arch[i][1]);
+    }
+    fprintf(out, "%*s: %10u\n%*s: %10u\n", prec, "ERR", 0, prec, "MIS", 0);
+    fclose(out);
+    return 0;
+}
+
+static int write_softirqs(const char* root, int ncpus){
+    FILE* out = open_fixture(root, "proc/softirqs");
+    if (out == NULL) return -1;
+    fprintf(out, "                    ");
+    for (int c = 0; c < ncpus; c++) fprintf(out, "CPU%-8d", c);
+    fprintf(out, "\n");
+    const char* names[] = {"HI", "TIMER", "NET_TX", "NET_RX", "BLOCK", "IRQ_POLL", "TASKLET", "SCHED", "HRTIMER", "RCU"};
+    for (int i = 0; i < 10; i++){
+        fprintf(out, "%12s:", names[i]);
+        write_irq_counters(out, ncpus, 48611ULL * (i + 1), -1);
+        fprintf(out, "\n");
+    }
+    fclose(out);
+    return 0;
+}
+
+int generate_procfs_fixture(const char* root, int ncpus, int sockets){
+    ///_|> descry: writes a synthetic procfs/sysfs tree for ncpus logical CPUs below root
+    ///_|> root: directory to write into (created if missing), type const char*
+    ///_|> ncpus: number of logical CPUs, type int
+    ///_|> sockets: number of sockets the CPUs are spread over, type int
+    ///_|> returning: returns 0 on success, -1 on failure
+    if (ncpus <= 0 || sockets <= 0 || ncpus % sockets != 0) return -1;
+    if (make_dirs(root) == -1) return -1;
+    if (write_stat(root, ncpus) == -1) return -1;
+    if (write_cpuinfo(root, ncpus, sockets) == -1) return -1;
+    if (write_meminfo(root, ncpus) == -1) return -1;
+    if (write_loadavg(root, ncpus) == -1) return -1;
+    if (write_vmstat(root, ncpus) == -1) return -1;
+    if (write_cpufreq(root, ncpus) == -1) return -1;
+    if (write_numa_nodes(root, ncpus, sockets) == -1) return -1;
+    if (write_interrupts(root, ncpus) == -1) return -1;
+    if (write_softirqs(root, ncpus) == -1) return -1;
+    if (write_boot_id(root) == -1) return -1;
+    return 0;
+}
+
+int write_process_stat(const char* root, int pid, int tid, const char* comm, unsigned long long ticks, int threads){
+    ///_|> descry: writes the stat line of a process (tid 0, proc/PID/stat) or of one of its threads
+    ///_|>         (proc/PID/task/TID/stat), with the negative tpgid and nice fields a real line has
+    ///_|> root: fixture root, type const char*
+    ///_|> pid / tid: process and thread id, tid 0 for the process itself, type int
+    ///_|> comm: name written between the parentheses, may hold blanks, type const char*
+    ///_|> ticks: CPU time in clock ticks, split between utime and stime, type unsigned long long
+    ///_|> threads: num_threads field, type int
+    ///_|> returning: returns 0 on success, -1 on failure
+    char rel[128];
+    if (tid == 0) snprintf(rel, sizeof(rel), "proc/%d/stat", pid);
+    else snprintf(rel, sizeof(rel), "proc/%d/task/%d/stat", pid, tid);
+    FILE* out = open_fixture(root, rel);
+    if (out == NULL) return -1;
+    fprintf(out, "%d (%s) S 1 %d %d 0 -1 4194560 183207 0 12 0 %llu %llu 0 0 20 -2 %d 0 4821 12884901888 " \
+            "131072 18446744073709551615 1 1 0 0 0 0 0 4096 17663 0 0 0 17 %d 0 0 0 0 0 0 0 0 0 0 0 0 0\n", \
+            (tid == 0) ? pid : tid, comm, pid, pid, ticks * 3 / 4, ticks - ticks * 3 / 4, threads, tid % 64);
+    fclose(out);
+    return 0;
+}
+
+int generate_process_fixture(const char* root, int pid, int threads){
+    ///_|> descry: writes a process with threads threads below root: proc/PID/stat, smaps_rollup and io, and
+    ///_|>         proc/PID/task/TID/stat for tids PID, PID+1, ...
+    ///_|> root: directory to write into (created if missing), type const char*
+    ///_|> pid: process id, type int
+    ///_|> threads: number of threads, the first being the main thread, type int
+    ///_|> returning: returns 0 on success, -1 on failure
+    if (threads <= 0 || make_dirs(root) == -1) return -1;
+    if (write_process_stat(root, pid, 0, "java", 1000000ULL, threads) == -1) return -1;
+    for (int t = 0; t < threads; t++){
+        char comm[32];
+        // JVM thread names hold blanks and '#'
+        if (t == 0) snprintf(comm, sizeof(comm), "java");
+        else snprintf(comm, sizeof(comm), "GC Thread#%d", t);
+        if (write_process_stat(root, pid, pid + t, comm, 1000ULL * (t + 1), threads) == -1) return -1;
+    }
+    char rel[128];
+    snprintf(rel, sizeof(rel), "proc/%d/smaps_rollup", pid);
+    FILE* out = open_fixture(root, rel);
+    if (out == NULL) return -1;
+    fprintf(out, "00400000-7ffc8b5fd000 ---p 00000000 00:00 0                          [rollup]\n" \
+            "Rss:             4194304 kB\nPss:             4020736 kB\nPss_Dirty:       3932160 kB\n" \
+            "Pss_Anon:        3932160 kB\nPss_File:          88576 kB\nPss_Shmem:             0 kB\n" \
+            "Shared_Clean:     173568 kB\nShared_Dirty:          0 kB\nPrivate_Clean:      88576 kB\n" \
+            "Private_Dirty:   3932160 kB\nReferenced:      4194304 kB\nAnonymous:       3932160 kB\n" \
+            "LazyFree:              0 kB\nAnonHugePages:   3145728 kB\nShmemPmdMapped:        0 kB\n" \
+            "FilePmdMapped:         0 kB\nShared_Hugetlb:        0 kB\nPrivate_Hugetlb:       0 kB\n" \
+            "Swap:              65536 kB\nSwapPss:           65536 kB\nLocked:                0 kB\n");
+    fclose(out);
+    snprintf(rel, sizeof(rel), "proc/%d/io", pid);
+    if ((out = open_fixture(root, rel)) == NULL) return -1;
+    fprintf(out, "rchar: 98234871234\nwchar: 1283741234\nsyscr: 9182734\nsyscw: 1827364\n" \
+            "read_bytes: 4823871488\nwrite_bytes: 918273024\ncancelled_write_bytes: 12288\n");
+    fclose(out);
+    return 0;
+}
+
+static int remove_entry(const char* path, const struct stat* st, int flag, struct FTW* ftw){
+    (void)st;
+    (void)flag;
+    (void)ftw;
+    return remove(path);
+}
+
+int remove_fixture_tree(const char* root){
+    ///_|> descry: deletes a generated fixture tree (rm -r)
+    ///_|> root: directory to delete, type const char*
+    ///_|> returning: returns 0 on success, -1 on failure
+    return nftw(root, remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+}
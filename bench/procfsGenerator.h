@@ -0,0 +1,27 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef PROCFS_GENERATOR_HEADER
+#define PROCFS_GENERATOR_HEADER
+
+/*
+Generator of synthetic procfs/sysfs trees for N logical CPUs, used by the scaling benchmark and by
+bench/gen_procfs. The tree mirrors what the collectors read on a real multi-socket host:
+proc/stat with one line per CPU, proc/cpuinfo with one block per CPU (two hyper-threads per core),
+proc/meminfo, proc/loadavg, a full-size proc/vmstat, proc/interrupts and proc/softirqs with one counter column per CPU, a cpufreq directory
+per CPU under sys/devices/system/cpu, and one NUMA node per socket under sys/devices/system/node
+(cpulist, meminfo, numastat).
+generate_process_fixture adds one process the way --pid reads it: proc/PID/stat, smaps_rollup, io and
+a task/TID/stat per thread.
+*/
+
+int generate_procfs_fixture(const char* root, int ncpus, int sockets);
+
+int generate_process_fixture(const char* root, int pid, int threads);
+
+int write_process_stat(const char* root, int pid, int tid, const char* comm, unsigned long long ticks, int threads);
+
+int remove_fixture_tree(const char* root);
+
+#endif
@@ -0,0 +1,80 @@
+#define _DEFAULT_SOURCE
+#include "clientQueue.h"
+
+int client_queue_init(ClientQueue* queue, int capacity){
+    ///_|> descry: allocates the ring storage of a client queue
+    ///_|> queue: pointer to the queue to initialize, type ClientQueue*
+    ///_|> capacity: maximum number of queued records, type int
+    ///_|> returning: returns 0 on success, -1 on allocation failure (errno set by malloc)
+    queue->records = (StreamRecord*)malloc(sizeof(StreamRecord) * capacity);
+    if (queue->records == NULL) return -1;
+    queue->capacity = capacity;
+    queue->head = 0;
+    queue->count = 0;
+    queue->head_offset = 0;
+    queue->dropped = 0;
+    return 0;
+}
+
+void client_queue_push(ClientQueue* queue, StreamRecord* rec){
+    ///_|> descry: appends a record, dropping the oldest not-yet-started record when the queue is full (the new
+    ///_|>         record itself with a single slot whose record is partially sent)
+    ///_|> queue: pointer to the client queue, type ClientQueue*
+    ///_|> rec: pointer to the record to append, type StreamRecord*
+    ///_|> returning: this function does not return anything
+    if (queue->count == queue->capacity && queue->head_offset > 0 && queue->capacity == 1){
+        // the only slot is partially on the wire: it must go out whole, so the new record is the one dropped
+        queue->dropped++;
+        return;
+    }
+    if (queue->count == queue->capacity){
+        if (queue->head_offset == 0){
+            // nothing of the head is on the wire yet, drop it
+            queue->head = (queue->head + 1) % queue->capacity;
+            queue->head_offset = 0;
+        }else{
+            // head is partially sent: move it one slot forward over the second oldest record
+            int next = (queue->head + 1) % queue->capacity;
+            memcpy(&queue->records[next], &queue->records[queue->head], sizeof(StreamRecord));
+            queue->head = next;
+        }
+        queue->count--;
+        queue->dropped++;
+    }
+    int tail = (queue->head + queue->count) % queue->capacity;
+    memcpy(&queue->records[tail], rec, sizeof(StreamRecord));
+    queue->count++;
+}
+
+int client_queue_flush(ClientQueue* queue, int fd){
+    ///_|> descry: writes as many queued records to a non-blocking socket as it accepts
+    ///_|> queue: pointer to the client queue, type ClientQueue*
+    ///_|> fd: connected client socket, type int
+    ///_|> returning: returns 0 when the queue is drained or the socket is full, -1 if the client is gone
+    while (queue->count > 0){
+        char* start = (char*)&queue->records[queue->head] + queue->head_offset;
+        size_t left = sizeof(StreamRecord) - queue->head_offset;
+        ssize_t sent = send(fd, start, left, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent == -1){
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        queue->head_offset += (size_t)sent;
+        if (queue->head_offset == sizeof(StreamRecord)){
+            queue->head = (queue->head + 1) % queue->capacity;
+            queue->count--;
+            queue->head_offset = 0;
+        }
+    }
+    return 0;
+}
+
+void client_queue_free(ClientQueue* queue){
+    ///_|> descry: releases the ring storage of a client queue
+    ///_|> queue: pointer to the client queue, type ClientQueue*
+    ///_|> returning: this function does not return anything
+    free(queue->records);
+    queue->records = NULL;
+    queue->count = 0;
+}
@@ -0,0 +1,45 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include "streamProtocol.h"
+
+#ifndef CLIENT_QUEUE_HEADER
+#define CLIENT_QUEUE_HEADER
+
+/*
+This module implements the bounded per-client send queue used by the daemon.
+When a viewer cannot keep up, the oldest queued samples are dropped instead of 
+blocking the sampler; a record that is already partially sent is never dropped,
+so the byte stream of every client stays aligned on record boundaries.
+*/
+
+typedef struct {
+    StreamRecord* records;
+    int capacity;
+    int head;
+    int count;
+    size_t head_offset;
+    unsigned long dropped;
+}ClientQueue;
+///_|> descry: Ring buffer of records waiting to be written to one client socket
+///_|> members:
+///_|>     - records: ring storage of capacity records, type StreamRecord*
+///_|>     - capacity: maximum number of queued records, type int
+///_|>     - head: index of the oldest queued record, type int
+///_|>     - count: number of queued records, type int
+///_|>     - head_offset: bytes of the head record already written, type size_t
+///_|>     - dropped: number of records dropped because the queue was full, type unsigned long
+
+int client_queue_init(ClientQueue* queue, int capacity);
+
+void client_queue_push(ClientQueue* queue, StreamRecord* rec);
+
+int client_queue_flush(ClientQueue* queue, int fd);
+
+void client_queue_free(ClientQueue* queue);
+
+#endif
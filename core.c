@@ -1,58 +1,71 @@
 
 #include "core.h"
+#include "procRoot.h"
+#include "arena.h"
+#include "procParse.h"
 #include <string.h>
+#define CPUINFO_BUF_SIZE 16384
 
 
+static procFile cpuinfo_file = PROC_FILE_INIT("/proc/cpuinfo");
+static procFile max_freq_file = PROC_FILE_INIT("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq");
+static char* cpuinfo_buf = NULL;
+///_|> descry: descriptors kept open across reads, and the /proc/cpuinfo read buffer from the process arena
+
 int get_cores_num(){
     ///_|> descry: this function retrieves the number of physical cores from /proc/cpuinfo
     ///_|> returning: returns the number of physical CPU cores as an integer; returns -1 on failure
-    FILE* cpuinfo = fopen("/proc/cpuinfo","r");
-    if ( cpuinfo == NULL ){
+    if (cpuinfo_buf == NULL && (cpuinfo_buf = arena_alloc(CPUINFO_BUF_SIZE)) == NULL){
+        return -1;
+    }
+    // "cpu cores" sits in the first processor block, so only the head of the file is read;
+    // the whole file grows with the CPU count
+    if (proc_file_read(&cpuinfo_file, cpuinfo_buf, CPUINFO_BUF_SIZE) == -1){
         perror("Failed to open /proc/cpuinfo");
         return -1;
     }
 
-    char read[100];
-    int core_num = -1;
-    while(fgets(read, sizeof(read), cpuinfo) != NULL){
-        // Search for line containing "cpu cores"
-        if (strstr(read, "cpu cores") != NULL){
-            // Parse the number of cores from the line containing “cpu cores”
-            if( sscanf(read, "cpu cores : %d", &core_num) == 1){
-                break;
-            }
-        }
-    }
-    fclose(cpuinfo);
-    return core_num;
+    // Parse the number of cores from the line containing "cpu cores" ("cpu cores\t: 8")
+    unsigned long long core_num;
+    if (procparse_find_u64(cpuinfo_buf, "cpu cores", &core_num) == -1) return -1;
+    return (int)core_num;
 }
 
 float get_max_freq(){
     ///_|> descry: this function reads the maximum frequency of CPU 
     ///_|> returning: returns the max frequency of the CPU in GHz as float; returns -1 on failure
-    FILE* cpufreq = fopen("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq", "r");
-    if ( cpufreq == NULL ){
+    char read[32];
+    if (proc_file_read(&max_freq_file, read, sizeof(read)) == -1){
         perror("Failed to open /sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq");
         return -1;
     }
 
-    int max_freq_kHz;
-    if (fscanf(cpufreq, "%d", &max_freq_kHz) != 1){
-        fclose(cpufreq);
+    unsigned long long max_freq_kHz;
+    if (procparse_u64(read, &max_freq_kHz) == NULL){
         perror("Failed to read cpuinfo_max_freq");
         return -1;
     }
-
-    fclose(cpufreq);
     return ((float)max_freq_kHz)/1000000.0;  
 }
 
+int fill_coreinfo(coreInfo* info){
+    ///_|> descry: this function populates a caller-owned coreInfo struct with core number and max frequency
+    ///_|> info: pointer to the coreInfo struct to fill, type coreInfo*
+    ///_|> returning: returns 0 on success, -1 if either value could not be read
+    if (info == NULL){
+        perror("fill_coreinfo(): info == NULL");
+        return -1;
+    }
+    info->cores_num = get_cores_num();
+    info->max_freq = get_max_freq();
+    return (info->cores_num == -1 || info->max_freq == -1) ? -1 : 0;
+}
+
 coreInfo* get_coreinfo(){
     ///_|> descry: this function allocates and populates a coreInfo struct with core number and max frequency
     ///_|> returning: returns a pointer to a dynamically allocated coreInfo struct containing core info
     coreInfo* info = (coreInfo*)malloc(sizeof(coreInfo));
-    info->cores_num = get_cores_num();
-    info->max_freq = get_max_freq();
+    fill_coreinfo(info);
     return info;
 }
 
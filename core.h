@@ -12,6 +12,7 @@
 This module provides functions to retrieve and visualize core-related information from the system, 
 including the number of physical cores and the maximum frequency of a CPU. 
 It also includes function to display core data specific format.
+fill_coreinfo is the allocation-free variant writing into caller-owned storage.
 */
 
 typedef struct {
@@ -30,6 +31,8 @@ int get_cores_num();
 
 coreInfo* get_coreinfo();
 
+int fill_coreinfo(coreInfo* info);
+
 coreInfo* combine_coreinfo(int core_num, float max_freq);
 
 void draw_all_core(coreInfo* info);
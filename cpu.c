@@ -6,6 +6,10 @@
 #include <stdlib.h>
 
 #include "cpu.h"
+#include "procRoot.h"
+#include "anomaly.h"
+#include "arena.h"
+#include "procParse.h"
 #define VERTICAL_DIV 12
 
 // typedef struct {
@@ -22,6 +26,123 @@
 //user + nice + system + idle + iowait + irq + softirq
 // idle = idle = 13053426780 
 
+static procFile stat_file = PROC_FILE_INIT("/proc/stat");
+static procFile loadavg_file = PROC_FILE_INIT("/proc/loadavg");
+static char* stat_buf = NULL;
+///_|> descry: /proc/stat and /proc/loadavg kept open across samples, and the /proc/stat read buffer taken
+///_|>         from the process arena
+
+static const char* stat_counter(const char* line, const char* key, size_t key_len){
+    ///_|> descry: returns the text after "key " when a /proc/stat line starts with it
+    ///_|> line: start of the line, type const char*
+    ///_|> key / key_len: counter name and its length, type const char* / size_t
+    ///_|> returning: returns a pointer to the value, NULL if the line holds another counter
+    if (strncmp(line, key, key_len) != 0 || line[key_len] != ' ') return NULL;
+    return line + key_len + 1;
+}
+
+static long long stat_value(const char* value){
+    ///_|> descry: parses the first number of a counter line
+    ///_|> value: text after the counter name, type const char*
+    ///_|> returning: returns the number, -1 if there is none
+    unsigned long long parsed;
+    return (procparse_u64(value, &parsed) != NULL) ? (long long)parsed : -1;
+}
+
+static void parse_sched_counters(const char* stat_text, cpuInfo* info){
+    ///_|> descry: picks ctxt, intr, processes, procs_running and procs_blocked out of the lines that follow
+    ///_|>         the cpu lines of /proc/stat; counters that are missing (older kernel, truncated read) stay -1
+    ///_|> stat_text: NUL-terminated contents of /proc/stat, type const char*
+    ///_|> info: cpuInfo receiving the counters, type cpuInfo*
+    ///_|> returning: this function does not return anything
+    info->ctxt = -1;
+    info->intr = -1;
+    info->processes = -1;
+    info->procs_running = -1;
+    info->procs_blocked = -1;
+    // every line is looked at by its first bytes only; the per-CPU lines and the per-IRQ tail of the intr
+    // line (thousands of columns on large hosts) are skipped with strchr
+    for (const char* line = strchr(stat_text, '\n'); line != NULL; line = strchr(line, '\n')){
+        line++;
+        const char* value;
+        if (line[0] == 'c' && (value = stat_counter(line, "ctxt", 4)) != NULL){
+            info->ctxt = stat_value(value);
+        }
+        else if (line[0] == 'i' && (value = stat_counter(line, "intr", 4)) != NULL){
+            info->intr = stat_value(value); // the first column is the total
+        }
+        else if (line[0] == 'p'){
+            if ((value = stat_counter(line, "processes", 9)) != NULL) info->processes = stat_value(value);
+            else if ((value = stat_counter(line, "procs_running", 13)) != NULL) info->procs_running = (int)stat_value(value);
+            else if ((value = stat_counter(line, "procs_blocked", 13)) != NULL) info->procs_blocked = (int)stat_value(value);
+        }
+    }
+}
+
+int parse_cpuInfo(const char* stat_text, cpuInfo* info){
+    ///_|> descry: parses total and idle CPU times, and the scheduler counters, from the text of /proc/stat;
+    ///_|>         leaves the load averages to parse_loadavg
+    ///_|> stat_text: NUL-terminated contents of /proc/stat (at least its first line), type const char*
+    ///_|> info: pointer to the cpuInfo struct to fill, type cpuInfo*
+    ///_|> returning: returns 0 on success, -1 if the aggregate cpu line cannot be parsed
+    unsigned long long cpu_data[7];
+    // Parse first line of /proc/stat for CPU values
+    int count = (strncmp(stat_text, "cpu ", 4) == 0) ? procparse_fields(stat_text + 3, cpu_data, 7, NULL) : 0;
+    if (count < 7) { 
+        perror("Failed to parse CPU data");
+        return -1;
+    }
+    long long total_time = 0;
+    // Sum all CPU time fields to get total_time
+    for (int i = 0; i < 7; i++){
+        total_time += (long long)cpu_data[i];
+    }
+    info->total_time = total_time;
+    // get idle_time (4th field)
+    info->idle_time = cpu_data[3];
+    parse_sched_counters(stat_text, info);
+    return 0;
+}
+
+int parse_loadavg(const char* loadavg_text, cpuInfo* info){
+    ///_|> descry: parses the 1, 5 and 15 minute load averages from the text of /proc/loadavg
+    ///_|> loadavg_text: NUL-terminated contents of /proc/loadavg, NULL if it could not be read, type const char*
+    ///_|> info: pointer to the cpuInfo struct to fill, type cpuInfo*
+    ///_|> returning: returns 0 on success, -1 if the text cannot be parsed (the load averages are set to -1)
+    const char* p = loadavg_text;
+    for (int i = 0; i < 3 && p != NULL; i++){
+        double load;
+        if ((p = procparse_decimal(p, &load)) != NULL) info->load[i] = (float)load;
+    }
+    if (p == NULL){
+        info->load[0] = info->load[1] = info->load[2] = -1;
+        return -1;
+    }
+    return 0;
+}
+
+int fill_cpuInfo(cpuInfo* info){
+    ///_|> descry: retrieves current CPU times and scheduler counters by parsing /proc/stat and /proc/loadavg
+    ///_|>         into caller-owned storage; performs no heap allocation after the first call
+    ///_|> info: pointer to the cpuInfo struct to fill, type cpuInfo*
+    ///_|> returning: returns 0 on success, -1 on failure
+    if (info == NULL){
+        perror("fill_cpuInfo(): info == NULL");
+        return -1;
+    }
+    // the kernel formats the whole file for any read, so taking all of it costs only the copy
+    if (stat_buf == NULL && (stat_buf = arena_alloc(CPU_STAT_BUF_SIZE)) == NULL) return -1;
+    if (proc_file_read(&stat_file, stat_buf, CPU_STAT_BUF_SIZE) <= 0){
+        perror("Failed to read cpu information from /proc/stat");
+        return -1;
+    }
+    if (parse_cpuInfo(stat_buf, info) == -1) return -1;
+    // the load averages are optional: a fixture root may not have the file
+    char loadavg_text[CPU_LOADAVG_BUF_SIZE];
+    parse_loadavg(proc_file_read(&loadavg_file, loadavg_text, sizeof(loadavg_text)) > 0 ? loadavg_text : NULL, info);
+    return 0;
+}
+
 cpuInfo* get_cpuInfo(){
     ///_|> descry: retrieves current total and idle CPU times by parsing /proc/stat
     ///_|> returning: returns a dynamically allocated cpuInfo struct; returns NULL on failure
@@ -30,45 +151,10 @@ cpuInfo* get_cpuInfo(){
         perror("Failed to allocate for cpuInfo");
         return NULL;
     }
-    long long total_time = 0;
-    long long idle_time = 0;
-
-    FILE* stat = fopen("/proc/stat", "r");
-    if ( stat == NULL ){
-        perror("Failed to open /proc/stat");
-        free(info);
-        return NULL;
-    }
-
-    long long cpu_data[7];
-    char read_line[256];
-
-    if (fgets(read_line, sizeof(read_line), stat)){
-         // Parse first line of /proc/stat for CPU values
-        int count = sscanf(read_line, "cpu  %lld %lld %lld %lld %lld %lld %lld", &cpu_data[0], &cpu_data[1], \
-        &cpu_data[2], &cpu_data[3], &cpu_data[4], &cpu_data[5], &cpu_data[6]);
-        if (count < 7) { 
-            free(info);
-            fclose(stat);
-            perror("Failed to parse CPU data");
-            return NULL;
-        }
-    }else{
+    if (fill_cpuInfo(info) == -1){
         free(info);
-        fclose(stat);
-        perror("Failed to read cpu information from /proc/stat");
         return NULL;
     }
-    // Sum all CPU time fields to get total_time
-    for (int i = 0; i < 7; i++){
-        total_time += cpu_data[i];
-    }
-    // get idle_time (4th field)
-    idle_time = cpu_data[3];
-    info->total_time = total_time;
-    info->idle_time = idle_time;
-
-    fclose(stat);
     return info;
 }
 
@@ -103,6 +189,20 @@ void update_delta(cpuDelta* delta, cpuInfo* new_info){
     memcpy(delta->after, new_info, sizeof(cpuInfo));
 }
 
+void advance_delta(cpuDelta* delta, const cpuInfo* new_info){
+    ///_|> descry: shifts the current snapshot into 'before' and stores new_info as 'after', in place;
+    ///_|>         both snapshots are caller-owned and nothing is allocated or freed
+    ///_|> delta: pointer to a cpuDelta whose before/after point at caller-owned cpuInfo, type cpuDelta*
+    ///_|> new_info: pointer to the latest cpuInfo struct, type const cpuInfo*
+    ///_|> returning: this function does not return anything
+    if (delta == NULL || delta->before == NULL || delta->after == NULL){
+        perror("advance_delta(): delta is incomplete");
+        return;
+    }
+    *delta->before = *delta->after;
+    *delta->after = *new_info;
+}
+
 float calcu_cpu_utiliz(cpuDelta* delta){
     ///_|> descry: calculates CPU utilization percentage based on the delta between two cpuInfo states
     ///_|> delta: pointer to a cpuDelta struct holding before and after cpuInfo, type cpuDelta*
@@ -124,13 +224,59 @@ float calcu_cpu_utiliz(cpuDelta* delta){
     return ((float)(utiliz_delta))/((float)total_delta) * 100.0;
 }
 
-void draw_cpu_chart(float *samples, int sample_count, int total) {
+void clear_sched_info(schedInfo* sched){
+    ///_|> descry: marks every scheduler signal as unknown
+    ///_|> sched: struct to reset, type schedInfo*
+    ///_|> returning: this function does not return anything
+    sched->ctxt_rate = sched->fork_rate = sched->intr_rate = -1;
+    sched->procs_running = sched->procs_blocked = -1;
+    sched->load[0] = sched->load[1] = sched->load[2] = -1;
+}
+
+static float counter_rate(long long before, long long after, long long interval_ns){
+    ///_|> descry: per-second rate of a monotonic counter between two snapshots
+    ///_|> before / after: counter values, -1 when missing, type long long
+    ///_|> interval_ns: time between the snapshots in nanoseconds, type long long
+    ///_|> returning: returns the rate, -1 if a value is missing or the interval is empty
+    if (before < 0 || after < before || interval_ns <= 0) return -1;
+    return (float)((double)(after - before) * 1e9 / (double)interval_ns);
+}
+
+void calcu_sched_info(cpuDelta* delta, long long interval_ns, schedInfo* sched){
+    ///_|> descry: derives the scheduler signals of an interval from the two snapshots of a cpuDelta
+    ///_|> delta: pointer to a cpuDelta struct holding before and after cpuInfo, type cpuDelta*
+    ///_|> interval_ns: time between the two reads in nanoseconds, type long long
+    ///_|> sched: receives the rates and the current run-queue counts, type schedInfo*
+    ///_|> returning: this function does not return anything
+    cpuInfo* before = delta->before;
+    cpuInfo* after = delta->after;
+    sched->ctxt_rate = counter_rate(before->ctxt, after->ctxt, interval_ns);
+    sched->fork_rate = counter_rate(before->processes, after->processes, interval_ns);
+    sched->intr_rate = counter_rate(before->intr, after->intr, interval_ns);
+    sched->procs_running = after->procs_running;
+    sched->procs_blocked = after->procs_blocked;
+    for (int i = 0; i < 3; i++) sched->load[i] = after->load[i];
+}
+
+void draw_cpu_chart(float *samples, const unsigned char* marks, int sample_count, int total, const schedInfo* sched) {
     ///_|> descry: renders a graph of in CPU utilization samples
     ///_|> samples: pointer to an array of float CPU usage samples, type float*
+    ///_|> marks: per-sample anomaly marks drawn as ANOMALY_GLYPH, NULL for none, type const unsigned char*
     ///_|> sample_count: number of samples currently stored, type int
     ///_|> total: total number of columns (width of chart), type int
+    ///_|> sched: scheduler signals of the newest sample shown after the title, NULL for none, type const schedInfo*
     ///_|> returning: this function does not return anything
-    printf("v CPU %5.2f %% \n", samples[sample_count-1]);
+    printf("\033[2Kv CPU %5.2f %% ", samples[sample_count-1]);
+    if (sched != NULL && sched->ctxt_rate >= 0){
+        printf(" ctxsw %.0f/s  forks %.1f/s  intr %.0f/s", sched->ctxt_rate, sched->fork_rate, sched->intr_rate);
+    }
+    if (sched != NULL && sched->procs_running >= 0){
+        printf("  run %d  blocked %d", sched->procs_running, sched->procs_blocked);
+    }
+    if (sched != NULL && sched->load[0] >= 0){
+        printf("  load %.2f %.2f %.2f", sched->load[0], sched->load[1], sched->load[2]);
+    }
+    printf("\n");
     printf("  %3d %% | \n", 100); 
     // vertical axis
     for (int i = 0; i < VERTICAL_DIV-1; i++) {
@@ -157,7 +303,7 @@ void draw_cpu_chart(float *samples, int sample_count, int total) {
         if (plot_row > VERTICAL_DIV) plot_row = VERTICAL_DIV;
 
         printf("\033[%dA", plot_row);
-        printf(":");
+        printf("%c", (marks != NULL && marks[i]) ? ANOMALY_GLYPH : ':');
         printf("\033[%dB", plot_row);   
         // printf("\033[C");    
     } 
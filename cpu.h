@@ -13,16 +13,51 @@
 This module provides utilities for tracking and visualizing CPU usage over time.
 It supports reading system CPU time statistics, calculating CPU usage deltas, 
 and rendering a real-time cpu utilization graph.
+fill_cpuInfo/advance_delta are the allocation-free variants used by the sampling loop: they write 
+into caller-owned storage and read /proc/stat through a persistent descriptor.
+The kernel formats all of /proc/stat on every read, however few bytes are asked for, so the parser
+takes the whole file and keeps the scheduler counters below the cpu lines as well (ctxt, intr,
+processes, procs_running, procs_blocked), together with /proc/loadavg; calcu_sched_info turns two
+snapshots into context switches, forks and interrupts per second (schedInfo).
 */
 
+#define CPU_STAT_BUF_SIZE (256 * 1024) // /proc/stat of a large host: one line per CPU and a long intr line
+#define CPU_LOADAVG_BUF_SIZE 128
+
 typedef struct {
     int total_time;
     int idle_time;
+    long long ctxt;
+    long long intr;
+    long long processes;
+    int procs_running;
+    int procs_blocked;
+    float load[3];
 }cpuInfo;
-///_|> descry: Represents snapshot data of total and idle CPU times
+///_|> descry: Represents snapshot data of total and idle CPU times and of the scheduler counters
 ///_|> members:
 ///_|>     - total_time: accumulated CPU time including all states (type int)
 ///_|>     - idle_time: portion of total_time when CPU was idle (type int)
+///_|>     - ctxt / intr / processes: context switches, interrupts and forks since boot, -1 if the line was
+///_|>                                missing (type long long)
+///_|>     - procs_running / procs_blocked: tasks runnable and blocked on I/O right now, -1 if missing (type int)
+///_|>     - load: 1, 5 and 15 minute load averages from /proc/loadavg, -1 if not read (type float[])
+
+typedef struct {
+    float ctxt_rate;
+    float fork_rate;
+    float intr_rate;
+    int procs_running;
+    int procs_blocked;
+    float load[3];
+}schedInfo;
+///_|> descry: Scheduler and run-queue signals of one sampling interval
+///_|> members:
+///_|>     - ctxt_rate / fork_rate / intr_rate: context switches, forks and interrupts per second, -1 when
+///_|>                                          unknown (first sample, missing counter), type float
+///_|>     - procs_running / procs_blocked: runnable and I/O-blocked tasks at the end of the interval, -1 when
+///_|>                                      unknown, type int
+///_|>     - load: 1, 5 and 15 minute load averages, -1 when unknown, type float[]
 
 typedef struct{
     cpuInfo* before;
@@ -36,11 +71,23 @@ typedef struct{
 
 cpuInfo* get_cpuInfo();
 
+int fill_cpuInfo(cpuInfo* info);
+
+int parse_cpuInfo(const char* stat_text, cpuInfo* info);
+
+int parse_loadavg(const char* loadavg_text, cpuInfo* info);
+
+void advance_delta(cpuDelta* delta, const cpuInfo* new_info);
+
 void update_delta(cpuDelta* delta, cpuInfo* new_info);
 
 float calcu_cpu_utiliz(cpuDelta* delta);
 
-void draw_cpu_chart(float *samples, int sample_count, int total);
+void clear_sched_info(schedInfo* sched);
+
+void calcu_sched_info(cpuDelta* delta, long long interval_ns, schedInfo* sched);
+
+void draw_cpu_chart(float *samples, const unsigned char* marks, int sample_count, int total, const schedInfo* sched);
 
 void free_cpu_delta(cpuDelta* delta);
 
@@ -0,0 +1,345 @@
+#define _POSIX_C_SOURCE 200809L
+#include "flightRecorder.h"
+#include <stddef.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "timeTool.h"
+
+static char flight_path[256];
+static long long flight_size = 0;
+static bool flight_failed = false;
+static flightHeader* flight_map = NULL;
+static size_t flight_map_size = 0;
+static flightRecord* flight_slots = NULL;
+///_|> descry: --flight-recorder target and the mapping of the file, set up by the first recorded sample
+
+static uint32_t record_checksum(const flightRecord* rec){
+    ///_|> descry: FNV-1a of every byte of a record before its checksum field
+    ///_|> rec: record to check, type const flightRecord*
+    ///_|> returning: returns the checksum
+    const unsigned char* bytes = (const unsigned char*)rec;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < offsetof(flightRecord, checksum); i++){
+        h ^= bytes[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static const char* split_spec(const char* spec, char* path, size_t path_size){
+    ///_|> descry: copies the FILE part of "FILE[,...]" and finds the rest
+    ///_|> spec: option value, type const char*
+    ///_|> path / path_size: receives FILE, type char* / size_t
+    ///_|> returning: returns the text after the first ',', or "" when there is none
+    const char* comma = strchr(spec, ',');
+    size_t len = (comma != NULL) ? (size_t)(comma - spec) : strlen(spec);
+    if (len >= path_size) len = path_size - 1;
+    memcpy(path, spec, len);
+    path[len] = '\0';
+    return (comma != NULL) ? comma + 1 : "";
+}
+
+static int parse_size(const char* text, long long* bytes){
+    ///_|> descry: parses a size in bytes with an optional K, M or G suffix (powers of 1024)
+    ///_|> text: e.g. "64M", type const char*
+    ///_|> bytes: receives the size, type long long*
+    ///_|> returning: returns 0 on success, -1 if the text is not a positive size
+    char* end;
+    long long value = strtoll(text, &end, 10);
+    if (end == text || value <= 0) return -1;
+    switch (*end){
+        case 'k': case 'K': value *= 1024LL; end++; break;
+        case 'm': case 'M': value *= 1024LL * 1024; end++; break;
+        case 'g': case 'G': value *= 1024LL * 1024 * 1024; end++; break;
+        default: break;
+    }
+    if (*end != '\0') return -1;
+    *bytes = value;
+    return 0;
+}
+
+int flight_recorder_configure(const char* spec){
+    ///_|> descry: enables the flight recorder (--flight-recorder=FILE[,SIZE]); the file is mapped by the
+    ///_|>         first recorded sample
+    ///_|> spec: "FILE,SIZE" with SIZE in bytes or with a K/M/G suffix (FLIGHT_DEFAULT_SIZE when left out),
+    ///_|>       NULL or "" to disable, type const char*
+    ///_|> returning: returns 0 on success, -1 if the size is invalid or too small
+    flight_path[0] = '\0';
+    if (spec == NULL || spec[0] == '\0') return 0;
+    const char* size_text = split_spec(spec, flight_path, sizeof(flight_path));
+    flight_size = FLIGHT_DEFAULT_SIZE;
+    if (flight_path[0] == '\0' || (size_text[0] != '\0' && parse_size(size_text, &flight_size) == -1)){
+        flight_path[0] = '\0';
+        return -1;
+    }
+    long long minimum = FLIGHT_HEADER_BYTES + FLIGHT_MIN_RECORDS * (long long)sizeof(flightRecord);
+    if (flight_size < minimum){
+        fprintf(stderr, "--flight-recorder size must be at least %lld bytes\n", minimum);
+        flight_path[0] = '\0';
+        return -1;
+    }
+    return 0;
+}
+
+static int check_existing(int fd, const struct stat* st, uint64_t* capacity){
+    ///_|> descry: validates a non-empty file before it is reused, so that no other file is overwritten
+    ///_|> fd / st: the opened file and its status, type int / const struct stat*
+    ///_|> capacity: receives the slot count of the file, 0 if it was never initialized, type uint64_t*
+    ///_|> returning: returns 0 if the file can be written to, -1 otherwise
+    flightHeader header;
+    if (st->st_size < FLIGHT_HEADER_BYTES || pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)){
+        fprintf(stderr, "%s exists and is not a flight recorder file, not overwriting it\n", flight_path);
+        return -1;
+    }
+    // created but never initialized: the recorder died between allocating and writing the header
+    if (header.magic == 0 && header.commit_index == 0){
+        *capacity = 0;
+        return 0;
+    }
+    if (header.magic != FLIGHT_MAGIC){
+        fprintf(stderr, "%s exists and is not a flight recorder file, not overwriting it\n", flight_path);
+        return -1;
+    }
+    if (header.version != FLIGHT_VERSION || header.record_size != sizeof(flightRecord) || \
+        header.header_size != FLIGHT_HEADER_BYTES || header.capacity == 0 || \
+        st->st_size < (off_t)(FLIGHT_HEADER_BYTES + header.capacity * sizeof(flightRecord))){
+        fprintf(stderr, "%s was written by another version of the flight recorder\n", flight_path);
+        return -1;
+    }
+    *capacity = header.capacity;
+    return 0;
+}
+
+static int open_recorder(){
+    ///_|> descry: maps the flight recorder file, creating it with its blocks allocated, or reopening it
+    ///_|>         to continue after the last committed record
+    ///_|> returning: returns 0 on success, -1 on failure
+    int fd = open(flight_path, O_RDWR | O_CREAT, 0644);
+    if (fd == -1){
+        perror(flight_path);
+        return -1;
+    }
+    struct stat st;
+    uint64_t capacity = 0;
+    if (fstat(fd, &st) == -1 || (st.st_size > 0 && check_existing(fd, &st, &capacity) == -1)){
+        close(fd);
+        return -1;
+    }
+    uint64_t wanted = (uint64_t)(flight_size - FLIGHT_HEADER_BYTES) / sizeof(flightRecord);
+    bool fresh = (capacity == 0);
+    if (fresh){
+        capacity = wanted;
+        // allocate every block now: a store into a hole of a full file system would raise SIGBUS
+        int err = posix_fallocate(fd, 0, (off_t)(FLIGHT_HEADER_BYTES + capacity * sizeof(flightRecord)));
+        if (err == EINVAL || err == EOPNOTSUPP){
+            err = (ftruncate(fd, (off_t)(FLIGHT_HEADER_BYTES + capacity * sizeof(flightRecord))) == -1) ? errno : 0;
+        }
+        if (err != 0){
+            errno = err;
+            perror("allocating the flight recorder file failed");
+            close(fd);
+            return -1;
+        }
+    }
+    else if (capacity != wanted){
+        fprintf(stderr, "%s keeps its %llu records, remove it to change its size\n", flight_path, \
+                (unsigned long long)capacity);
+    }
+    flight_map_size = FLIGHT_HEADER_BYTES + capacity * sizeof(flightRecord);
+    void* mapped = mmap(NULL, flight_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // the mapping keeps the file open
+    if (mapped == MAP_FAILED){
+        perror("mmap of the flight recorder file failed");
+        return -1;
+    }
+    flight_map = (flightHeader*)mapped;
+    flight_slots = (flightRecord*)((char*)mapped + FLIGHT_HEADER_BYTES);
+    if (fresh){
+        flight_map->version = FLIGHT_VERSION;
+        flight_map->record_size = sizeof(flightRecord);
+        flight_map->header_size = FLIGHT_HEADER_BYTES;
+        flight_map->capacity = capacity;
+        flight_map->commit_index = 0;
+        flight_map->created_wall_ns = now_wall_ns();
+        flight_map->opens = 0;
+        flight_map->reserved = 0;
+        __atomic_store_n(&flight_map->magic, FLIGHT_MAGIC, __ATOMIC_RELEASE);
+    }
+    flight_map->opens++;
+    return 0;
+}
+
+void flight_record_sample(float cpu_utiliz, float used_memory, float total_memory, const schedInfo* sched, \
+const vmstatInfo* vm, int anomaly, long long wall_ns){
+    ///_|> descry: commits one sample to the flight recorder: the record is stored into its slot, then the
+    ///_|>         header's commit index is advanced; no system call once the file is mapped
+    ///_|> cpu_utiliz: CPU utilization in percent, negative when the CPU graph is off, type float
+    ///_|> used_memory / total_memory: memory in GB, negative when the memory graph is off, type float
+    ///_|> sched: scheduler signals of the sample, type const schedInfo*
+    ///_|> vm: paging and reclaim rates of the sample, type const vmstatInfo*
+    ///_|> anomaly: AnomalyFlag bits of the sample, type int
+    ///_|> wall_ns: wall-clock time the sample was taken in nanoseconds, type long long
+    ///_|> returning: this function does not return anything
+    if (flight_path[0] == '\0' || flight_failed) return;
+    if (flight_map == NULL){
+        // mapped by the consuming process only, after the producers have been forked
+        if (open_recorder() == -1){
+            flight_failed = true;
+            return;
+        }
+        atexit(flight_recorder_close);
+    }
+    flightRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.index = flight_map->commit_index + 1;
+    rec.wall_ns = wall_ns;
+    rec.cpu_utiliz = cpu_utiliz;
+    rec.used_memory = used_memory;
+    rec.total_memory = total_memory;
+    rec.ctxt_rate = sched->ctxt_rate;
+    rec.fork_rate = sched->fork_rate;
+    rec.load1 = sched->load[0];
+    rec.procs_running = sched->procs_running;
+    rec.procs_blocked = sched->procs_blocked;
+    rec.majfault_rate = vm->rate[VMSTAT_PGMAJFAULT];
+    rec.direct_scan_rate = vm->rate[VMSTAT_SCAN_DIRECT];
+    rec.anomaly = (uint32_t)anomaly;
+    rec.checksum = record_checksum(&rec);
+
+    flightRecord* slot = &flight_slots[(rec.index - 1) % flight_map->capacity];
+    // the slot stops matching any index before its old contents are overwritten
+    __atomic_store_n(&slot->index, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy((char*)slot + sizeof(rec.index), (const char*)&rec + sizeof(rec.index), sizeof(rec) - sizeof(rec.index));
+    __atomic_store_n(&slot->index, rec.index, __ATOMIC_RELEASE);
+    __atomic_store_n(&flight_map->commit_index, rec.index, __ATOMIC_RELEASE);
+}
+
+void flight_recorder_close(){
+    ///_|> descry: unmaps the flight recorder file; registered with atexit. Nothing is flushed here: every
+    ///_|>         committed record is already in the page cache
+    ///_|> returning: this function does not return anything
+    if (flight_map == NULL) return;
+    munmap(flight_map, flight_map_size);
+    flight_map = NULL;
+    flight_slots = NULL;
+}
+
+static int parse_time(const char* text, long long newest_ns, long long unbounded, long long* ns){
+    ///_|> descry: parses one end of a --dump-flight window
+    ///_|> text: "" for no bound, "-DURATION" before the newest record (s, m, h or d, seconds without a suffix),
+    ///_|>       or wall-clock seconds since the epoch, type const char*
+    ///_|> newest_ns: wall-clock time of the newest record in nanoseconds, type long long
+    ///_|> unbounded: value used for an empty bound, type long long
+    ///_|> ns: receives the time in nanoseconds, type long long*
+    ///_|> returning: returns 0 on success, -1 if the text cannot be parsed
+    if (text[0] == '\0'){
+        *ns = unbounded;
+        return 0;
+    }
+    char* end;
+    double value = strtod(text, &end);
+    if (end == text) return -1;
+    double unit = 1e9;
+    switch (*end){
+        case 's': end++; break;
+        case 'm': unit = 60e9; end++; break;
+        case 'h': unit = 3600e9; end++; break;
+        case 'd': unit = 86400e9; end++; break;
+        default: break;
+    }
+    if (*end != '\0') return -1;
+    *ns = (text[0] == '-') ? newest_ns + (long long)(value * unit) : (long long)(value * 1e9);
+    return 0;
+}
+
+static bool read_record(const flightHeader* header, const flightRecord* slots, uint64_t index, flightRecord* rec){
+    ///_|> descry: copies record index out of its slot and checks that it is whole
+    ///_|> header / slots: mapped file, type const flightHeader* / const flightRecord*
+    ///_|> index: commit index of the wanted record, type uint64_t
+    ///_|> rec: receives the copy, type flightRecord*
+    ///_|> returning: returns true if the slot holds that record intact, false if it was overwritten or torn
+    const flightRecord* slot = &slots[(index - 1) % header->capacity];
+    if (__atomic_load_n(&slot->index, __ATOMIC_ACQUIRE) != index) return false;
+    memcpy(rec, slot, sizeof(flightRecord));
+    return rec->index == index && rec->checksum == record_checksum(rec);
+}
+
+int flight_dump_file(const char* spec, FILE* out){
+    ///_|> descry: prints the records of a time window as CSV, oldest first (--dump-flight=FILE[,FROM[,TO]]);
+    ///_|>         works on a file that a recorder is still writing
+    ///_|> spec: FILE, then optionally the window's start and end (see parse_time), type const char*
+    ///_|> out: stream receiving the CSV, type FILE*
+    ///_|> returning: returns 0 on success, 1 if the file cannot be read or the window is invalid
+    char path[256];
+    char from_text[64] = "";
+    const char* window = split_spec(spec, path, sizeof(path));
+    split_spec(window, from_text, sizeof(from_text));
+    const char* to_text = strchr(window, ',') ? strchr(window, ',') + 1 : "";
+
+    int fd = open(path, O_RDONLY);
+    if (fd == -1){
+        perror(path);
+        return 1;
+    }
+    flightHeader header;
+    struct stat st;
+    if (fstat(fd, &st) == -1 || pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) || \
+        header.magic != FLIGHT_MAGIC || header.version != FLIGHT_VERSION || \
+        header.record_size != sizeof(flightRecord) || header.capacity == 0 || \
+        st.st_size < (off_t)(header.header_size + header.capacity * sizeof(flightRecord))){
+        fprintf(stderr, "%s: not a flight recorder file\n", path);
+        close(fd);
+        return 1;
+    }
+    size_t map_size = header.header_size + header.capacity * sizeof(flightRecord);
+    void* mapped = mmap(NULL, map_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED){
+        perror("mmap of the flight recorder file failed");
+        return 1;
+    }
+    const flightHeader* live = (const flightHeader*)mapped;
+    const flightRecord* slots = (const flightRecord*)((const char*)mapped + header.header_size);
+    uint64_t commit = __atomic_load_n(&live->commit_index, __ATOMIC_ACQUIRE);
+    uint64_t first = (commit > header.capacity) ? commit - header.capacity + 1 : 1;
+
+    // relative bounds count back from the newest intact record
+    long long newest_ns = 0;
+    flightRecord rec;
+    for (uint64_t i = commit; i >= first && i > 0; i--){
+        if (read_record(live, slots, i, &rec)){
+            newest_ns = rec.wall_ns;
+            break;
+        }
+    }
+    long long from_ns, to_ns;
+    if (parse_time(from_text, newest_ns, -1LL, &from_ns) == -1 || \
+        parse_time(to_text, newest_ns, 0x7fffffffffffffffLL, &to_ns) == -1){
+        fprintf(stderr, "Invalid --dump-flight window: %s\n", window);
+        munmap(mapped, map_size);
+        return 1;
+    }
+
+    unsigned long long shown = 0, unreadable = 0;
+    fprintf(out, "wall_us,cpu_percent,mem_used_gb,mem_total_gb,ctxsw_per_s,forks_per_s,procs_running,procs_blocked," \
+                 "load1,majfault_per_s,direct_scan_per_s,anomaly\n");
+    for (uint64_t i = first; i <= commit; i++){
+        if (!read_record(live, slots, i, &rec)){
+            unreadable++;
+            continue;
+        }
+        if (rec.wall_ns < from_ns || rec.wall_ns > to_ns) continue;
+        fprintf(out, "%lld,%.2f,%.3f,%.3f,%.0f,%.1f,%d,%d,%.2f,%.1f,%.1f,%u\n", (long long)(rec.wall_ns / 1000), \
+                rec.cpu_utiliz, rec.used_memory, rec.total_memory, rec.ctxt_rate, rec.fork_rate, rec.procs_running, \
+                rec.procs_blocked, rec.load1, rec.majfault_rate, rec.direct_scan_rate, rec.anomaly);
+        shown++;
+    }
+    fprintf(stderr, "%s: %llu records committed by %u recorder run(s), %llu kept, %llu in the window, %llu unreadable\n", \
+            path, (unsigned long long)commit, live->opens, (unsigned long long)(commit - first + 1), shown, unreadable);
+    munmap(mapped, map_size);
+    return 0;
+}
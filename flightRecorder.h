@@ -0,0 +1,94 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "cpu.h"
+#include "vmstat.h"
+
+#ifndef FLIGHT_RECORDER_HEADER
+#define FLIGHT_RECORDER_HEADER
+
+/*
+This module keeps the most recent samples in a fixed-size circular file (--flight-recorder=FILE,SIZE)
+so that the last stretch of full-resolution data is still there after an incident, or after the tool
+itself crashed. The file is a one-page flightHeader followed by fixed-size flightRecord slots and is
+mapped MAP_SHARED: a sample is a handful of stores into the page cache, with no write() or fsync().
+Memory written into a shared file mapping belongs to the kernel's page cache, so it survives the death
+of the process at any instruction and reaches the disk with normal writeback.
+Every record carries its commit index and a checksum, and is stored before the header's commit_index
+is advanced past it; a reader trusts only records whose index matches the slot it expects, so a record
+torn by a crash (or still being written while the file is read) is skipped instead of misread.
+A restarted recorder reopens the file and continues after the last committed record.
+--dump-flight=FILE[,FROM[,TO]] prints the records of a time window as CSV, oldest first; it also reads
+the file while a recorder is writing it.
+Like tsCompress, the recorder is module-level state of the consuming process (local consumer or
+daemon); the file is mapped on the first recorded sample.
+*/
+
+#define FLIGHT_MAGIC 0x31544c46u // "FLT1" in a little-endian file
+#define FLIGHT_VERSION 1
+#define FLIGHT_HEADER_BYTES 4096 // one page, the records start page-aligned
+#define FLIGHT_DEFAULT_SIZE (16LL * 1024 * 1024)
+#define FLIGHT_MIN_RECORDS 64
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t header_size;
+    uint64_t capacity;
+    uint64_t commit_index;
+    int64_t created_wall_ns;
+    uint32_t opens;
+    uint32_t reserved;
+}flightHeader;
+///_|> descry: Header at the start of a flight recorder file
+///_|> members:
+///_|>     - magic / version: FLIGHT_MAGIC and FLIGHT_VERSION, type uint32_t
+///_|>     - record_size / header_size: sizeof(flightRecord) and the offset of the first slot, type uint32_t
+///_|>     - capacity: number of record slots, type uint64_t
+///_|>     - commit_index: records committed since the file was created; record i (from 1) is in slot
+///_|>                     (i - 1) % capacity and the newest one is commit_index, type uint64_t
+///_|>     - created_wall_ns: wall-clock time the file was created in nanoseconds, type int64_t
+///_|>     - opens: how many recorders have written to the file, more than one means restarts, type uint32_t
+///_|>     - reserved: zero, type uint32_t
+
+typedef struct {
+    uint64_t index;
+    int64_t wall_ns;
+    float cpu_utiliz;
+    float used_memory;
+    float total_memory;
+    float ctxt_rate;
+    float fork_rate;
+    float load1;
+    int32_t procs_running;
+    int32_t procs_blocked;
+    float majfault_rate;
+    float direct_scan_rate;
+    uint32_t anomaly;
+    uint32_t checksum;
+}flightRecord;
+///_|> descry: One 64-byte sample slot; fields not sampled in the run are -1
+///_|> members:
+///_|>     - index: commit index of the record, 0 for a slot never written, type uint64_t
+///_|>     - wall_ns: wall-clock time the sample was taken in nanoseconds, type int64_t
+///_|>     - cpu_utiliz / used_memory / total_memory: CPU in percent, memory in GB, type float
+///_|>     - ctxt_rate / fork_rate / load1: context switches and forks per second, 1-minute load, type float
+///_|>     - procs_running / procs_blocked: runnable and I/O-blocked tasks, type int32_t
+///_|>     - majfault_rate / direct_scan_rate: major faults and direct-reclaim scans per second (--vmstat), type float
+///_|>     - anomaly: AnomalyFlag bits of the sample, type uint32_t
+///_|>     - checksum: FNV-1a of every byte before it, type uint32_t
+
+int flight_recorder_configure(const char* spec);
+
+void flight_record_sample(float cpu_utiliz, float used_memory, float total_memory, const schedInfo* sched, \
+const vmstatInfo* vm, int anomaly, long long wall_ns);
+
+void flight_recorder_close();
+
+int flight_dump_file(const char* spec, FILE* out);
+
+#endif
@@ -0,0 +1,142 @@
+#define _POSIX_C_SOURCE 200809L
+#include "hwCache.h"
+#include "procRoot.h"
+#include "procParse.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+static char cache_path[256] = "";
+static procFile boot_id_file = PROC_FILE_INIT("/proc/sys/kernel/random/boot_id");
+///_|> descry: cache file, empty when the cache is off, and the boot id kept open like the other procfs reads
+
+void hw_cache_configure(const char* spec){
+    ///_|> descry: picks the cache file (--hw-cache=FILE|off)
+    ///_|> spec: file, "off" to disable the cache, NULL for the default under $XDG_CACHE_HOME or ~/.cache,
+    ///_|>       type const char*
+    ///_|> returning: this function does not return anything
+    cache_path[0] = '\0';
+    if (spec != NULL){
+        if (strcmp(spec, "off") != 0) snprintf(cache_path, sizeof(cache_path), "%s", spec);
+        return;
+    }
+    const char* xdg = getenv("XDG_CACHE_HOME");
+    const char* home = getenv("HOME");
+    if (xdg != NULL && xdg[0] == '/'){
+        snprintf(cache_path, sizeof(cache_path), "%s/%s", xdg, HW_CACHE_NAME);
+    }else if (home != NULL && home[0] == '/'){
+        snprintf(cache_path, sizeof(cache_path), "%s/.cache/%s", home, HW_CACHE_NAME);
+    }
+}
+
+const char* hw_cache_path(){
+    ///_|> descry: cache file in use
+    ///_|> returning: returns the path, "" when the cache is off
+    return cache_path;
+}
+
+static int read_cache_key(char* key, size_t size){
+    ///_|> descry: builds the key an entry must carry: the boot id and the root the values are read under
+    ///_|> key: receives "boot_id ID\nroot DIR\n", type char*
+    ///_|> size: size of key, type size_t
+    ///_|> returning: returns 0 on success, -1 if there is no boot id to key on
+    char boot_id[HW_BOOT_ID_LEN];
+    ssize_t got = proc_file_read(&boot_id_file, boot_id, sizeof(boot_id));
+    if (got <= 0) return -1;
+    boot_id[strcspn(boot_id, "\n")] = '\0';
+    char root[320];
+    // "/" on the real system, "DIR/" under --proc-root
+    proc_path(root, sizeof(root), "/");
+    snprintf(key, size, "boot_id %s\nroot %s\n", boot_id, root);
+    return 0;
+}
+
+static ssize_t read_cache_file(char* buf, size_t size){
+    ///_|> descry: reads the whole cache file
+    ///_|> buf: receives the NUL-terminated contents, type char*
+    ///_|> size: size of buf, type size_t
+    ///_|> returning: returns the number of bytes read, -1 if the file cannot be read
+    int fd = open(cache_path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) return -1;
+    ssize_t got = read(fd, buf, size - 1);
+    close(fd);
+    if (got < 0) return -1;
+    buf[got] = '\0';
+    return got;
+}
+
+static int load_entry(const char* key, coreInfo* info){
+    ///_|> descry: takes the values of the cache file if it was written under the same key
+    ///_|> key: key of this boot and root, type const char*
+    ///_|> info: receives the cached values, type coreInfo*
+    ///_|> returning: returns 0 on a valid entry, -1 otherwise
+    char buf[HW_CACHE_BUF];
+    size_t magic_len = strlen(HW_CACHE_MAGIC);
+    size_t key_len = strlen(key);
+    if (read_cache_file(buf, sizeof(buf)) == -1) return -1;
+    if (strncmp(buf, HW_CACHE_MAGIC, magic_len) != 0 || strncmp(buf + magic_len, key, key_len) != 0) return -1;
+    unsigned long long cores, max_freq_khz;
+    const char* values = buf + magic_len + key_len;
+    if (procparse_find_u64(values, "cores", &cores) == -1 || procparse_find_u64(values, "max_freq_khz", &max_freq_khz) == -1){
+        return -1;
+    }
+    if (cores == 0 || cores > 1000000 || max_freq_khz == 0) return -1;
+    info->cores_num = (int)cores;
+    info->max_freq = (float)max_freq_khz / 1000000.0f;
+    return 0;
+}
+
+static void make_parent_dir(){
+    ///_|> descry: creates the directory of the cache file if it is missing (one level, e.g. ~/.cache)
+    ///_|> returning: this function does not return anything
+    char dir[256];
+    snprintf(dir, sizeof(dir), "%s", cache_path);
+    char* slash = strrchr(dir, '/');
+    if (slash == NULL || slash == dir) return;
+    *slash = '\0';
+    mkdir(dir, 0755);
+}
+
+static int store_entry(const char* key, const coreInfo* info){
+    ///_|> descry: writes the cache file under a temporary name and renames it into place; a file at the cache
+    ///_|>         path that is not a cache file is left alone
+    ///_|> key: key of this boot and root, type const char*
+    ///_|> info: values to cache, type const coreInfo*
+    ///_|> returning: returns 0 on success, -1 on failure
+    char buf[HW_CACHE_BUF];
+    if (read_cache_file(buf, sizeof(buf)) > 0 && strncmp(buf, HW_CACHE_MAGIC, strlen(HW_CACHE_MAGIC)) != 0){
+        fprintf(stderr, "%s exists and is not a hardware cache file, not overwriting it\n", cache_path);
+        return -1;
+    }
+    int len = snprintf(buf, sizeof(buf), "%s%scores %d\nmax_freq_khz %.0f\n", HW_CACHE_MAGIC, key, info->cores_num, \
+                       (double)info->max_freq * 1000000.0);
+    if (len <= 0 || len >= (int)sizeof(buf)) return -1;
+    char tmp_path[300];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%d", cache_path, (int)getpid());
+    make_parent_dir();
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC, 0644);
+    if (fd == -1) return -1;
+    ssize_t written = write(fd, buf, (size_t)len);
+    close(fd);
+    if (written != len || rename(tmp_path, cache_path) == -1){
+        unlink(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+int get_static_coreinfo(coreInfo* info){
+    ///_|> descry: core count and max frequency from the cache entry of this boot, else read in this process
+    ///_|>         (fill_coreinfo) and cached for the next run
+    ///_|> info: receives the values, type coreInfo*
+    ///_|> returning: returns one of HwCacheResult, -1 if the values cannot be read
+    char key[HW_BOOT_ID_LEN + 400];
+    bool cached = cache_path[0] != '\0' && read_cache_key(key, sizeof(key)) == 0;
+    if (cached && load_entry(key, info) == 0) return HW_CACHE_HIT;
+    if (fill_coreinfo(info) == -1) return -1;
+    if (!cached) return HW_CACHE_OFF;
+    // a cache that cannot be written only costs the next run the same reads
+    store_entry(key, info);
+    return HW_CACHE_MISS;
+}
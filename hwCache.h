@@ -0,0 +1,46 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "core.h"
+
+#ifndef HW_CACHE_HEADER
+#define HW_CACHE_HEADER
+
+/*
+This module keeps the hardware facts that do not change while the machine is up (physical core count,
+maximum frequency) in a small cache file, so the cores panel is drawn by the main process from one
+read, without forking a producer and without parsing /proc/cpuinfo on every run. Core discovery is
+lazy: nothing is read unless the cores panel is shown.
+The file records /proc/sys/kernel/random/boot_id, which is new on every boot, and the --proc-root it
+was read under; an entry of another boot or root is ignored and rewritten. Without a readable boot_id
+nothing is cached. The file is written under a temporary name and renamed into place, so a reader
+never sees half of it, and an existing file that is not a cache is never replaced.
+The default file is $XDG_CACHE_HOME/myMonitoringTool.hw, else ~/.cache/myMonitoringTool.hw;
+--hw-cache=FILE moves it and --hw-cache=off reads the hardware on every run.
+*/
+
+#define HW_CACHE_MAGIC "myMonitoringTool-hw 1\n"
+#define HW_CACHE_NAME "myMonitoringTool.hw"
+#define HW_CACHE_BUF 1024
+#define HW_BOOT_ID_LEN 64
+
+typedef enum {
+    HW_CACHE_OFF = 0,
+    HW_CACHE_HIT = 1,
+    HW_CACHE_MISS = 2
+}HwCacheResult;
+///_|> descry: Where get_static_coreinfo took its values from
+///_|> members:
+///_|>     - HW_CACHE_OFF: read from procfs/sysfs, the cache is off or there is no boot_id to key it on
+///_|>     - HW_CACHE_HIT: read from a cache entry of this boot
+///_|>     - HW_CACHE_MISS: read from procfs/sysfs and written to the cache
+
+void hw_cache_configure(const char* spec);
+
+const char* hw_cache_path();
+
+int get_static_coreinfo(coreInfo* info);
+
+#endif
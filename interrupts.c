@@ -0,0 +1,379 @@
+#define _DEFAULT_SOURCE
+#include "interrupts.h"
+#include "arena.h"
+#include "timeTool.h"
+#include "procParse.h"
+
+static const char* const irq_file_paths[IRQ_FILES] = {"/proc/interrupts", "/proc/softirqs"};
+
+static int count_header_cpus(const char* buf, int* cpu_ids, int max_ids){
+    ///_|> descry: counts the "CPUn" columns of the header line, the first line of both files
+    ///_|> buf: NUL-terminated file contents, type const char*
+    ///_|> cpu_ids: receives the first max_ids CPU numbers, NULL to only count, type int*
+    ///_|> max_ids: capacity of cpu_ids, type int
+    ///_|> returning: returns the number of CPU columns
+    int count = 0;
+    const char* p = buf;
+    while (*p != '\0' && *p != '\n'){
+        if (p[0] == 'C' && p[1] == 'P' && p[2] == 'U'){
+            unsigned long long id = 0;
+            const char* end = procparse_u64(p + 3, &id);
+            if (cpu_ids != NULL && count < max_ids) cpu_ids[count] = (int)id;
+            count++;
+            p = (end != NULL) ? end : p + 3;
+        }else{
+            p++;
+        }
+    }
+    return count;
+}
+
+static bool parse_count(const char* field, unsigned int* value){
+    ///_|> descry: parses one "%10u" counter: blanks, then digits up to the end of the field
+    ///_|> field: first character of the field, type const char*
+    ///_|> value: receives the counter, type unsigned int*
+    ///_|> returning: returns false if the field does not hold a counter (the layout moved), true otherwise
+    // a '\n' or the terminating NUL is neither blank nor digit, so a short line stops the scan
+    int i = 0;
+    while (i < IRQ_FIELD_WIDTH - 1 && field[i] == ' ') i++;
+    if (i == IRQ_FIELD_WIDTH - 1) return false;
+    unsigned int parsed = 0;
+    for (; i < IRQ_FIELD_WIDTH - 1; i++){
+        unsigned int digit = (unsigned int)((unsigned char)field[i] - '0');
+        if (digit > 9) return false;
+        parsed = parsed * 10 + digit;
+    }
+    *value = parsed;
+    return true;
+}
+
+static bool parse_counts(const char* colon, int cpus, unsigned int* counts){
+    ///_|> descry: parses the cpus counter columns after a label with procparse_fields, a chunk of columns at a time
+    ///_|> colon: the ':' that ends the label, type const char*
+    ///_|> cpus: number of columns, type int
+    ///_|> counts: receives the counters, type unsigned int*
+    ///_|> returning: returns false if the line does not hold cpus "%10u" columns (the layout moved), true otherwise
+    unsigned long long chunk[IRQ_PARSE_CHUNK];
+    const char* p = colon + 1;
+    for (int c = 0; c < cpus; ){
+        int want = (cpus - c < IRQ_PARSE_CHUNK) ? cpus - c : IRQ_PARSE_CHUNK;
+        if (procparse_fields(p, chunk, want, &p) != want) return false;
+        for (int k = 0; k < want; k++, c++){
+            if (chunk[k] > 0xffffffffULL) return false;
+            counts[c] = (unsigned int)chunk[k];
+        }
+    }
+    // every column is blank-padded to its width, so the last one ends exactly at the width of all of them
+    return p == colon + 1 + cpus * IRQ_FIELD_WIDTH;
+}
+
+static void name_row(irqRow* row, const char* line, const char* eol, int counters_end){
+    ///_|> descry: names a line after the driver action at its end (numbered interrupts) or after its label
+    ///_|> row: row being recorded, label already set, type irqRow*
+    ///_|> line / eol: the line and its '\n', type const char*
+    ///_|> counters_end: offset within the line just past the last counter, type int
+    ///_|> returning: this function does not return anything
+    bool numbered = true;
+    for (int i = 0; i < row->label_len; i++){
+        if (row->label[i] < '0' || row->label[i] > '9') numbered = false;
+    }
+    const char* name = row->label;
+    int len = row->label_len;
+    // "  IO-APIC   2-edge      timer": the actions follow the last run of blanks after the chip name
+    const char* action = NULL;
+    for (const char* p = line + counters_end; numbered && p + 1 < eol; p++){
+        if (p[0] == ' ' && p[1] == ' ') action = p + 2;
+    }
+    while (action != NULL && action < eol && *action == ' ') action++;
+    // a numbered line without an action keeps its number
+    if (action != NULL && action < eol){
+        name = action;
+        len = (int)(eol - action);
+    }
+    if (len > IRQ_NAME_LEN - 1) len = IRQ_NAME_LEN - 1;
+    memcpy(row->name, name, len);
+    row->name[len] = '\0';
+}
+
+static int build_layout(irqCollector* collector){
+    ///_|> descry: records the position of every per-CPU line of both freshly read files and primes their counters
+    ///_|> collector: collector with both buffers filled this tick, type irqCollector*
+    ///_|> returning: returns 0 on success, -1 if a file has no CPU columns
+    collector->layout_valid = false;
+    collector->row_count = 0;
+    int columns = count_header_cpus(collector->bufs[0], collector->cpu_ids, collector->cpu_capacity);
+    if (columns <= 0) return -1;
+    // CPUs brought online after start-up do not fit the arrays and are left out
+    collector->cpu_count = (columns < collector->cpu_capacity) ? columns : collector->cpu_capacity;
+    int cpus = collector->cpu_count;
+    for (int f = 0; f < IRQ_FILES; f++){
+        const char* buf = collector->bufs[f];
+        if (count_header_cpus(buf, NULL, 0) < cpus) return -1;
+        const char* line = strchr(buf, '\n');
+        while (line != NULL && collector->row_count < collector->row_capacity){
+            line++;
+            const char* eol = strchr(line, '\n');
+            if (eol == NULL) break; // cut off by a full buffer
+            irqRow* row = &collector->rows[collector->row_count];
+            const char* colon = memchr(line, ':', eol - line);
+            if (colon == NULL){
+                line = eol;
+                continue;
+            }
+            const char* label = line;
+            while (label < colon && *label == ' ') label++;
+            int counters_end = (int)(colon - line) + 1 + cpus * IRQ_FIELD_WIDTH;
+            // lines without one counter per CPU (ERR, MIS) carry no per-CPU load
+            if (colon == label || colon - label >= IRQ_LABEL_LEN || counters_end > eol - line){
+                line = eol;
+                continue;
+            }
+            unsigned int* counts = &collector->prev[collector->row_count * cpus];
+            if (parse_counts(colon, cpus, counts)){
+                row->file = f;
+                row->offset = (int)(line - buf);
+                row->colon = (int)(colon - line);
+                row->label_len = (int)(colon - label);
+                memcpy(row->label, label, row->label_len);
+                row->label[row->label_len] = '\0';
+                name_row(row, line, eol, counters_end);
+                collector->row_count++;
+            }
+            line = eol;
+        }
+    }
+    collector->layout_valid = true;
+    return 0;
+}
+
+static void offer_top(unsigned int* deltas, int* rows, int count, unsigned int delta, int row){
+    ///_|> descry: inserts a (delta, row) pair into a descending top-count list if it belongs there
+    ///_|> deltas / rows: the list, busiest first, type unsigned int* / int*
+    ///_|> count: length of the list, type int
+    ///_|> delta / row: candidate, type unsigned int / int
+    ///_|> returning: this function does not return anything
+    if (delta <= deltas[count - 1]) return;
+    int k = count - 1;
+    while (k > 0 && deltas[k - 1] < delta){
+        deltas[k] = deltas[k - 1];
+        rows[k] = rows[k - 1];
+        k--;
+    }
+    deltas[k] = delta;
+    rows[k] = row;
+}
+
+static bool accumulate_deltas(irqCollector* collector){
+    ///_|> descry: parses the counters at the recorded positions and sums the deltas per CPU and per line,
+    ///_|>         keeping every CPU's busiest lines
+    ///_|> collector: collector with a valid layout and both buffers filled this tick, type irqCollector*
+    ///_|> returning: returns false as soon as a line is not where the layout expects it, true otherwise
+    int cpus = collector->cpu_count;
+    memset(collector->cpu_totals, 0, sizeof(unsigned long long) * cpus);
+    memset(collector->top_deltas, 0, sizeof(unsigned int) * cpus * IRQ_TOP_SOURCES);
+    for (int r = 0; r < collector->row_count; r++){
+        const irqRow* row = &collector->rows[r];
+        const char* colon = collector->bufs[row->file] + row->offset + row->colon;
+        if (*colon != ':' || memcmp(colon - row->label_len, row->label, row->label_len) != 0) return false;
+        // same layout, same positions: a line or a column whose text did not change has no delta
+        const char* prev_field = collector->prev_bufs[row->file] + row->offset + row->colon + 2;
+        const char* field = colon + 2;
+        collector->source_totals[r] = 0;
+        if (memcmp(field, prev_field, cpus * IRQ_FIELD_WIDTH - 1) == 0) continue;
+        unsigned int* prev = &collector->prev[r * cpus];
+        unsigned long long source_total = 0;
+        for (int c = 0; c < cpus; c++, field += IRQ_FIELD_WIDTH, prev_field += IRQ_FIELD_WIDTH){
+            unsigned int count;
+            if (memcmp(field, prev_field, IRQ_FIELD_WIDTH - 1) == 0) continue;
+            if (!parse_count(field, &count)) return false;
+            unsigned int delta = count - prev[c]; // unsigned: survives the counter wrapping
+            prev[c] = count;
+            if (delta == 0) continue;
+            collector->cpu_totals[c] += delta;
+            source_total += delta;
+            offer_top(&collector->top_deltas[c * IRQ_TOP_SOURCES], &collector->top_rows[c * IRQ_TOP_SOURCES], \
+                      IRQ_TOP_SOURCES, delta, r);
+        }
+        collector->source_totals[r] = source_total;
+    }
+    return true;
+}
+
+static int read_files(irqCollector* collector){
+    ///_|> descry: re-reads both files, keeping the text of the previous tick in prev_bufs
+    ///_|> collector: initialized collector, type irqCollector*
+    ///_|> returning: returns true if both files kept the sizes the layout was built for, false if they changed,
+    ///_|>            -1 if a file cannot be read
+    bool same = true;
+    for (int f = 0; f < IRQ_FILES; f++){
+        char* previous = collector->bufs[f];
+        collector->bufs[f] = collector->prev_bufs[f];
+        collector->prev_bufs[f] = previous;
+        ssize_t got = proc_file_read(&collector->files[f], collector->bufs[f], collector->buf_sizes[f]);
+        if (got <= 0) return -1;
+        if (got != collector->lengths[f]) same = false;
+        collector->lengths[f] = got;
+    }
+    return same;
+}
+
+int irq_collector_init(irqCollector* collector){
+    ///_|> descry: sizes the buffers and arrays for the files as they are now, records their layout and
+    ///_|>         primes the counters, so the first irq_collector_sample reports the first interval
+    ///_|> collector: collector to initialize in place, type irqCollector*
+    ///_|> returning: returns the number of CPU columns, -1 if a file cannot be read
+    memset(collector, 0, sizeof(irqCollector));
+    int lines = 0;
+    for (int f = 0; f < IRQ_FILES; f++){
+        collector->files[f] = (procFile)PROC_FILE_INIT(irq_file_paths[f]);
+        // start-up may use the heap: grow a probe buffer until the whole file fits
+        size_t size = 64 * 1024;
+        char* probe = NULL;
+        ssize_t got;
+        while (true){
+            char* grown = realloc(probe, size);
+            if (grown == NULL){
+                free(probe);
+                return -1;
+            }
+            probe = grown;
+            got = proc_file_read(&collector->files[f], probe, size);
+            if (got == -1 || (size_t)got < size - 1) break;
+            size *= 2;
+        }
+        if (got <= 0){
+            fprintf(stderr, "Failed to read %s\n", irq_file_paths[f]);
+            free(probe);
+            return -1;
+        }
+        if (f == 0) collector->cpu_capacity = count_header_cpus(probe, NULL, 0);
+        for (const char* p = probe; (p = strchr(p, '\n')) != NULL; p++) lines++;
+        free(probe);
+        // twice the current size leaves room for lines registered later
+        collector->buf_sizes[f] = 2 * (size_t)got + 4096;
+        collector->bufs[f] = arena_alloc(collector->buf_sizes[f]);
+        collector->prev_bufs[f] = arena_alloc(collector->buf_sizes[f]);
+        if (collector->bufs[f] == NULL || collector->prev_bufs[f] == NULL) return -1;
+    }
+    if (collector->cpu_capacity <= 0){
+        fprintf(stderr, "No CPU columns in %s\n", irq_file_paths[0]);
+        return -1;
+    }
+    int cpus = collector->cpu_capacity;
+    collector->row_capacity = lines + IRQ_SPARE_ROWS;
+    collector->cpu_ids = arena_alloc(sizeof(int) * cpus);
+    collector->rows = arena_alloc(sizeof(irqRow) * collector->row_capacity);
+    collector->prev = arena_alloc(sizeof(unsigned int) * (size_t)collector->row_capacity * cpus);
+    collector->cpu_totals = arena_alloc(sizeof(unsigned long long) * cpus);
+    collector->source_totals = arena_alloc(sizeof(unsigned long long) * collector->row_capacity);
+    collector->top_deltas = arena_alloc(sizeof(unsigned int) * cpus * IRQ_TOP_SOURCES);
+    collector->top_rows = arena_alloc(sizeof(int) * cpus * IRQ_TOP_SOURCES);
+    if (collector->cpu_ids == NULL || collector->rows == NULL || collector->prev == NULL || \
+        collector->cpu_totals == NULL || collector->source_totals == NULL || collector->top_deltas == NULL || \
+        collector->top_rows == NULL) return -1;
+    irqSample primer;
+    if (irq_collector_sample(collector, &primer) == -1) return -1;
+    return collector->cpu_count;
+}
+
+static void fill_irq_sample(irqCollector* collector, irqSample* sample, float seconds){
+    ///_|> descry: turns the deltas of accumulate_deltas into rates of the busiest CPUs and their busiest lines
+    ///_|> collector: collector after accumulate_deltas, type irqCollector*
+    ///_|> sample: receives the rates, type irqSample*
+    ///_|> seconds: length of the interval, type float
+    ///_|> returning: this function does not return anything
+    unsigned long long hot_totals[IRQ_VIEW_CPUS];
+    int hot_cpus[IRQ_VIEW_CPUS];
+    int hot_count = 0;
+    unsigned long long total = 0;
+    for (int c = 0; c < collector->cpu_count; c++){
+        unsigned long long cpu_total = collector->cpu_totals[c];
+        total += cpu_total;
+        // ascending CPU order breaks ties, so an idle host lists its first CPUs
+        int k = (hot_count < IRQ_VIEW_CPUS) ? hot_count++ : IRQ_VIEW_CPUS;
+        if (k == IRQ_VIEW_CPUS){
+            if (cpu_total <= hot_totals[IRQ_VIEW_CPUS - 1]) continue;
+            k = IRQ_VIEW_CPUS - 1;
+        }
+        while (k > 0 && hot_totals[k - 1] < cpu_total){
+            hot_totals[k] = hot_totals[k - 1];
+            hot_cpus[k] = hot_cpus[k - 1];
+            k--;
+        }
+        hot_totals[k] = cpu_total;
+        hot_cpus[k] = c;
+    }
+    sample->total_rate = total / seconds;
+    sample->hot_count = hot_count;
+    for (int h = 0; h < hot_count; h++){
+        int c = hot_cpus[h];
+        irqCpuRate* hot = &sample->hot[h];
+        hot->cpu = collector->cpu_ids[c];
+        hot->total_rate = hot_totals[h] / seconds;
+        for (int k = 0; k < IRQ_TOP_SOURCES; k++){
+            irqSourceRate* source = &hot->top[k];
+            unsigned int delta = collector->top_deltas[c * IRQ_TOP_SOURCES + k];
+            if (delta == 0){
+                source->name[0] = '\0';
+                source->rate = source->share = 0.0f;
+                continue;
+            }
+            int r = collector->top_rows[c * IRQ_TOP_SOURCES + k];
+            memcpy(source->name, collector->rows[r].name, IRQ_NAME_LEN);
+            source->rate = delta / seconds;
+            source->share = (float)delta / (float)collector->source_totals[r] * 100.0f;
+        }
+    }
+}
+
+int irq_collector_sample(irqCollector* collector, irqSample* sample){
+    ///_|> descry: reads both files and reports the busiest CPUs and sources for the interval since the last call;
+    ///_|>         allocation-free
+    ///_|> collector: initialized collector, type irqCollector*
+    ///_|> sample: receives the rates (timestamp_ns is left to the caller), type irqSample*
+    ///_|> returning: returns 0 on success, -1 if a file cannot be read or has no CPU columns
+    int same = read_files(collector);
+    if (same == -1) return -1;
+    long long now = now_mono_ns();
+    float seconds = (now - collector->prev_ns) / 1e9f;
+    collector->prev_ns = now;
+    memset(sample, 0, sizeof(irqSample));
+    // the fast path only trusts the layout while the files keep their size and every label its place
+    if (!collector->layout_valid || !same || seconds <= 0.0f || !accumulate_deltas(collector)){
+        if (build_layout(collector) == -1) return -1;
+        sample->cpu_count = collector->cpu_count;
+        return 0;
+    }
+    sample->cpu_count = collector->cpu_count;
+    fill_irq_sample(collector, sample, seconds);
+    return 0;
+}
+
+void irq_collector_close(irqCollector* collector){
+    ///_|> descry: closes both descriptors of the collector; the arena buffers stay with the process
+    ///_|> collector: collector to close, type irqCollector*
+    ///_|> returning: this function does not return anything
+    for (int f = 0; f < IRQ_FILES; f++) proc_file_close(&collector->files[f]);
+}
+
+void draw_irq_panel(const irqSample* sample){
+    ///_|> descry: draws the busiest CPUs and their busiest sources, IRQ_PANEL_ROWS rows; every row is cleared
+    ///_|>         first because the set of CPUs changes from one reading to the next
+    ///_|> sample: latest reading, type const irqSample*
+    ///_|> returning: this function does not return anything
+    printf("\033[2Kv Interrupts + softirqs: %.0f/s on %d CPUs (busiest sources: per second, %% of the source)\n", \
+           sample->total_rate, sample->cpu_count);
+    for (int h = 0; h < IRQ_VIEW_CPUS; h++){
+        printf("\033[2K");
+        if (h == 0 && sample->hot_count == 0) printf("  interrupt lines changed, rates resume on the next reading");
+        if (h < sample->hot_count){
+            const irqCpuRate* hot = &sample->hot[h];
+            printf("  cpu%-4d %9.0f/s ", hot->cpu, hot->total_rate);
+            for (int k = 0; k < IRQ_TOP_SOURCES && hot->top[k].name[0] != '\0'; k++){
+                printf(" %-15s %8.0f %3.0f%% ", hot->top[k].name, hot->top[k].rate, hot->top[k].share);
+            }
+        }
+        printf("\n");
+    }
+    printf("\n");
+}
@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "procRoot.h"
+
+#ifndef INTERRUPTS_HEADER
+#define INTERRUPTS_HEADER
+
+/*
+This module finds interrupt hot spots (--irq): which CPUs take the most hardware interrupts and
+softirqs, and which sources (a NIC queue, the local timer, NET_RX, ...) they come from.
+/proc/interrupts and /proc/softirqs have one line per source and one "%10u" column per online CPU,
+so on large hosts they are megabytes wide. The kernel prints every counter at the same fixed width,
+which keeps each line at the same offset and each CPU column at the same position from tick to tick:
+irq_collector_init records that layout once (irqRow), and every tick re-reads both files through
+descriptors kept open (procFile) and looks only at the counters at the recorded positions, without
+searching the text. The previous tick's text is kept, so a counter (or a whole line) whose digits did
+not change is skipped with a byte compare; most sources are idle on most CPUs. The layout is rebuilt when the files change shape (a driver registers an interrupt,
+a CPU goes offline); that tick only primes the new counters.
+Per-CPU, per-source deltas are reduced to the IRQ_VIEW_CPUS busiest CPUs and their IRQ_TOP_SOURCES
+busiest sources, a fixed-size irqSample that fits one pipe write; draw_irq_panel renders it.
+*/
+
+#define IRQ_FILES 2 // /proc/interrupts, /proc/softirqs
+#define IRQ_FIELD_WIDTH 11 // one counter column: "%10u" and its separating blank
+#define IRQ_PARSE_CHUNK 64 // counter columns parsed per procparse_fields call when a layout is built
+#define IRQ_LABEL_LEN 16
+#define IRQ_NAME_LEN 16
+#define IRQ_SPARE_ROWS 64 // lines that may appear after start-up before new ones are ignored
+#define IRQ_TOP_SOURCES 3
+#define IRQ_VIEW_CPUS 8
+#define IRQ_PANEL_ROWS (2 + IRQ_VIEW_CPUS) // title, one row per CPU, blank line
+
+typedef struct {
+    char name[IRQ_NAME_LEN];
+    float rate;
+    float share;
+}irqSourceRate;
+///_|> descry: One interrupt source on one CPU over the last interval
+///_|> members:
+///_|>     - name: driver action of a numbered interrupt ("eth0-rx-3"), otherwise the line's label ("LOC",
+///_|>             "NET_RX"), truncated, type char[]
+///_|>     - rate: interrupts per second on this CPU, type float
+///_|>     - share: part of the source's machine-wide rate taken by this CPU in percent; near 100 means the
+///_|>              source is pinned to this CPU, type float
+
+typedef struct {
+    int cpu;
+    float total_rate;
+    irqSourceRate top[IRQ_TOP_SOURCES];
+}irqCpuRate;
+///_|> descry: Interrupt load of one CPU over the last interval
+///_|> members:
+///_|>     - cpu: CPU number from the files' header, type int
+///_|>     - total_rate: hardware interrupts and softirqs per second on this CPU, type float
+///_|>     - top: busiest sources, busiest first; unused entries have an empty name, type irqSourceRate[]
+
+typedef struct {
+    long long timestamp_ns;
+    int cpu_count;
+    int hot_count;
+    float total_rate;
+    irqCpuRate hot[IRQ_VIEW_CPUS];
+}irqSample;
+///_|> descry: One timestamped reading of the interrupt hot spots, sent from the IRQ producer to the consumer
+///_|> members:
+///_|>     - timestamp_ns: monotonic time the reading was taken in nanoseconds, type long long
+///_|>     - cpu_count: number of CPU columns being parsed, type int
+///_|>     - hot_count: number of valid entries in hot, 0 on a tick that rebuilt the layout, type int
+///_|>     - total_rate: machine-wide interrupts and softirqs per second, type float
+///_|>     - hot: busiest CPUs, busiest first, type irqCpuRate[]
+
+typedef struct {
+    int file;
+    int offset;
+    int colon;
+    int label_len;
+    char label[IRQ_LABEL_LEN];
+    char name[IRQ_NAME_LEN];
+}irqRow;
+///_|> descry: Position of one per-CPU line of /proc/interrupts or /proc/softirqs, recorded when the layout is built
+///_|> members:
+///_|>     - file: 0 for /proc/interrupts, 1 for /proc/softirqs, type int
+///_|>     - offset: byte offset of the line in the file, type int
+///_|>     - colon: offset of the ':' ending the label within the line; counter k starts at
+///_|>              colon + 2 + k * IRQ_FIELD_WIDTH, type int
+///_|>     - label_len / label: text before the colon without leading blanks, checked every tick, type int / char[]
+///_|>     - name: name shown for the source, type char[]
+
+typedef struct {
+    procFile files[IRQ_FILES];
+    char* bufs[IRQ_FILES];
+    char* prev_bufs[IRQ_FILES];
+    size_t buf_sizes[IRQ_FILES];
+    ssize_t lengths[IRQ_FILES];
+    bool layout_valid;
+    int cpu_capacity;
+    int cpu_count;
+    int* cpu_ids;
+    int row_capacity;
+    int row_count;
+    irqRow* rows;
+    unsigned int* prev;
+    unsigned long long* cpu_totals;
+    unsigned long long* source_totals;
+    unsigned int* top_deltas;
+    int* top_rows;
+    long long prev_ns;
+}irqCollector;
+///_|> descry: Layout and open descriptors of the IRQ collector; every array is taken from the process arena
+///_|>         at start-up, sized for the files as they were then plus IRQ_SPARE_ROWS, so sampling and
+///_|>         rebuilding the layout never allocate
+///_|> members:
+///_|>     - files / bufs / buf_sizes: both files kept open across ticks and their read buffers, type procFile[] /
+///_|>                                 char*[] / size_t[]
+///_|>     - prev_bufs: text of the previous tick, swapped with bufs on every read, type char*[]
+///_|>     - lengths / layout_valid: file sizes the layout was built for and whether it was, type ssize_t[] / bool
+///_|>     - cpu_capacity / cpu_count / cpu_ids: CPU columns that fit the arrays, those parsed, and their CPU
+///_|>                                           numbers, type int / int / int*
+///_|>     - row_capacity / row_count / rows: recorded lines of both files, interrupts first, type int / int / irqRow*
+///_|>     - prev: counters of the previous tick, row_count x cpu_count, type unsigned int*
+///_|>     - cpu_totals / source_totals: per-CPU and per-line sums of the current deltas, type unsigned long long*
+///_|>     - top_deltas / top_rows: busiest IRQ_TOP_SOURCES lines of every CPU, type unsigned int* / int*
+///_|>     - prev_ns: monotonic time of the previous read in nanoseconds, type long long
+
+int irq_collector_init(irqCollector* collector);
+
+int irq_collector_sample(irqCollector* collector, irqSample* sample);
+
+void irq_collector_close(irqCollector* collector);
+
+void draw_irq_panel(const irqSample* sample);
+
+#endif
@@ -1,12 +1,54 @@
 #include <math.h>
+#include <string.h>
 #include "memory.h"
+#include "procRoot.h"
+#include "anomaly.h"
+#include "arena.h"
+#include "procParse.h"
 #define VERTICAL_DIV 12
+#define MEMINFO_BUF_SIZE 8192
 
 typedef struct {
     unsigned long total_memory_kb;    // total memory in kb
     unsigned long free_memory_kb;     // free memory in kb
 } OriginMemInfo;
 
+static procFile meminfo_file = PROC_FILE_INIT("/proc/meminfo");
+static char* meminfo_buf = NULL;
+///_|> descry: /proc/meminfo kept open across samples, and its read buffer taken from the process arena
+
+static int parse_meminfo_kb(const char* meminfo_text, OriginMemInfo* info){
+    ///_|> descry: parses MemTotal and MemFree from the text of /proc/meminfo
+    ///_|> meminfo_text: NUL-terminated contents of /proc/meminfo, type const char*
+    ///_|> info: pointer to OriginMemInfo struct to be filled, type OriginMemInfo*
+    ///_|> returning: returns 0 on success, -1 if either field is missing
+    unsigned long long total_kb, free_kb;
+    if (procparse_find_u64(meminfo_text, "MemTotal:", &total_kb) == -1
+        || procparse_find_u64(meminfo_text, "MemFree:", &free_kb) == -1){
+        return -1;
+    }
+    info->total_memory_kb = (unsigned long)total_kb;
+    info->free_memory_kb = (unsigned long)free_kb;
+    return 0;
+}
+
+void fetch_memory_info_from_meminfo(OriginMemInfo* info){
+    ///_|> descry: update the OriginMemInfo struct with MemTotal and MemFree parsed from /proc/meminfo
+    ///_|> info: pointer to OriginMemInfo struct to be filled, type OriginMemInfo*
+    ///_|> returning: this function does not return anything; exits on failure like fetch_memory_info
+    if (meminfo_buf == NULL && (meminfo_buf = arena_alloc(MEMINFO_BUF_SIZE)) == NULL){
+        exit(EXIT_FAILURE);
+    }
+    if (proc_file_read(&meminfo_file, meminfo_buf, MEMINFO_BUF_SIZE) == -1){
+        perror("Failed to read /proc/meminfo");
+        exit(EXIT_FAILURE);
+    }
+    if (parse_meminfo_kb(meminfo_buf, info) == -1){
+        fprintf(stderr, "Failed to parse MemTotal/MemFree from /proc/meminfo\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
 void fetch_memory_info(OriginMemInfo* info){
     ///_|> descry: update the OriginMemInfo struct with total and free memory using sysinfo
     ///_|> info: pointer to OriginMemInfo struct to be filled, type OriginMemInfo*
@@ -15,6 +57,11 @@ void fetch_memory_info(OriginMemInfo* info){
         perror("fetch_memory_info(): info == NULL");
         return;
     }
+    // fixture roots have no sysinfo(), read the same two values from their meminfo
+    if (proc_root_is_set()){
+        fetch_memory_info_from_meminfo(info);
+        return;
+    }
     struct sysinfo sys_info;
     if (sysinfo(&sys_info) != 0) {
         perror("sysinfo");
@@ -40,6 +87,17 @@ OriginMemInfo* get_originMem_info(){
 }
 
 
+static void convert_MemoryInfo_GB(const OriginMemInfo* origin, MemoryInfo* MemInfo){
+    ///_|> descry: converts OriginMemInfo values from KB to GB and calculates used memory, in place
+    ///_|> origin: pointer to a populated OriginMemInfo struct, type const OriginMemInfo*
+    ///_|> MemInfo: pointer to the MemoryInfo struct to fill, type MemoryInfo*
+    ///_|> returning: this function does not return anything
+    // Convert total and free memory from KB to GB
+    MemInfo->total_memory = origin->total_memory_kb/(1024.0 * 1024.0);
+    float free_memory = origin->free_memory_kb/(1024.0 * 1024.0);
+    MemInfo->used_memory = MemInfo->total_memory - free_memory; 
+}
+
 MemoryInfo* calcu_MemoryInfo_GB(OriginMemInfo* origin){
     ///_|> descry: converts OriginMemInfo values from KB to GB and calculates used memory
     ///_|> origin: pointer to a populated OriginMemInfo struct, type OriginMemInfo*
@@ -53,10 +111,7 @@ MemoryInfo* calcu_MemoryInfo_GB(OriginMemInfo* origin){
         perror("malloc failed");
         exit(EXIT_FAILURE);
     }
-     // Convert total and free memory from KB to GB
-    MemInfo->total_memory = origin->total_memory_kb/(1024.0 * 1024.0);
-    float free_memory = origin->free_memory_kb/(1024.0 * 1024.0);
-    MemInfo->used_memory = MemInfo->total_memory - free_memory; 
+    convert_MemoryInfo_GB(origin, MemInfo);
     return MemInfo;
 }
 
@@ -69,18 +124,57 @@ MemoryInfo* get_MemoryInfo(){
     return info;
 }
 
+int parse_MemoryInfo(const char* meminfo_text, MemoryInfo* info){
+    ///_|> descry: computes memory usage in GB from the text of /proc/meminfo (same fields as sysinfo())
+    ///_|> meminfo_text: NUL-terminated contents of /proc/meminfo, type const char*
+    ///_|> info: pointer to the MemoryInfo struct to fill, type MemoryInfo*
+    ///_|> returning: returns 0 on success, -1 if MemTotal/MemFree cannot be parsed
+    OriginMemInfo origin;
+    if (parse_meminfo_kb(meminfo_text, &origin) == -1){
+        fprintf(stderr, "Failed to parse MemTotal/MemFree from /proc/meminfo\n");
+        return -1;
+    }
+    convert_MemoryInfo_GB(&origin, info);
+    return 0;
+}
+
+int fill_MemoryInfo(MemoryInfo* info){
+    ///_|> descry: retrieves memory info in GB into caller-owned storage; performs no heap allocation
+    ///_|> info: pointer to the MemoryInfo struct to fill, type MemoryInfo*
+    ///_|> returning: returns 0 on success, -1 if info is NULL (fetch failures exit like get_MemoryInfo)
+    if (info == NULL){
+        perror("fill_MemoryInfo(): info == NULL");
+        return -1;
+    }
+    OriginMemInfo origin;
+    fetch_memory_info(&origin);
+    convert_MemoryInfo_GB(&origin, info);
+    return 0;
+}
+
 // up \033[nA down\033[nB right\033[nC left\033[nD 
-void draw_memory_chart(float *samples, int sample_count, int total, float total_memory) {
+void draw_memory_chart(float *samples, const unsigned char* marks, int sample_count, int total, float total_memory, \
+const vmstatInfo* vm) {
     ///_|> descry: draws a graph to visualize memory usage over time
     ///_|> samples: array of memory usage values in GB that already stored, type float*
+    ///_|> marks: per-sample anomaly marks drawn as ANOMALY_GLYPH, NULL for none, type const unsigned char*
     ///_|> sample_count: number of memory samples alreday stored, type int
     ///_|> total: total number of samples, type int
     ///_|> total_memory: total system memory in GB for scaling, type float
+    ///_|> vm: paging and reclaim rates of the newest sample shown after the title, NULL for none, type const vmstatInfo*
     ///_|> returning: this function does not return anything
 
     float current_memory = samples[sample_count-1];
 
-    printf("v Memory %5.2f GB\n", current_memory);
+    printf("\033[2Kv Memory %5.2f GB", current_memory);
+    if (vm != NULL && vm->rate[VMSTAT_PGFAULT] >= 0){
+        const float* r = vm->rate;
+        printf("  faults %.0f/s major %.0f/s  swap in %.0f out %.0f/s  scan %.0f/s direct %.0f/s  steal %.0f/s" \
+               "  thp %.0f/s fallback %.0f/s", r[VMSTAT_PGFAULT], r[VMSTAT_PGMAJFAULT], r[VMSTAT_PSWPIN], \
+               r[VMSTAT_PSWPOUT], r[VMSTAT_SCAN_BACKGROUND] + r[VMSTAT_SCAN_DIRECT], r[VMSTAT_SCAN_DIRECT], \
+               r[VMSTAT_STEAL_BACKGROUND] + r[VMSTAT_STEAL_DIRECT], r[VMSTAT_THP_ALLOC], r[VMSTAT_THP_FALLBACK]);
+    }
+    printf("\n");
     printf(" %3d GB | \n", (int)round(total_memory)); // width = 6 for " %2d GB"
     // vertical axis
     for (int i = 0; i < VERTICAL_DIV-1; i++) {
@@ -107,7 +201,7 @@ void draw_memory_chart(float *samples, int sample_count, int total, float total_
         if (plot_row > VERTICAL_DIV) plot_row = VERTICAL_DIV;
 
         printf("\033[%dA", plot_row);
-        printf("#");
+        printf("%c", (marks != NULL && marks[i]) ? ANOMALY_GLYPH : '#');
         printf("\033[%dB", plot_row);   
         // printf("\033[C");    
     } 
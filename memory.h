@@ -6,11 +6,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "vmstat.h"
+
 #ifndef MEMORY_HEADER
 #define MEMORY_HEADER
 /*
 This module provides functions for retrieving and visualizing memory usage statistics, 
 including total and used memory, and drawing a graph of usage over time.
+fill_MemoryInfo is the allocation-free variant used by the sampling loop.
 */
 typedef struct {
     float total_memory;           //  (GB)
@@ -24,6 +27,11 @@ typedef struct {
 
 MemoryInfo* get_MemoryInfo();
 
-void draw_memory_chart(float *samples, int sample_count, int total, float total_memory);
+int fill_MemoryInfo(MemoryInfo* info);
+
+int parse_MemoryInfo(const char* meminfo_text, MemoryInfo* info);
+
+void draw_memory_chart(float *samples, const unsigned char* marks, int sample_count, int total, float total_memory, \
+const vmstatInfo* vm);
 
 #endif
\ No newline at end of file
@@ -1,7 +1,11 @@
+#define _DEFAULT_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <math.h>
 
 #include "memory.h"
 #include "cpu.h"
@@ -11,6 +15,127 @@
 #include "sysInfoProducer.h"
 #include "pipeTool.h"
 #include "signalHandler.h"
+#include "sysInfoDaemon.h"
+#include "sysInfoViewer.h"
+#include "timeTool.h"
+#include "selfStats.h"
+#include "procRoot.h"
+#include "threadEngine.h"
+#include "alertEngine.h"
+#include "tsCompress.h"
+#include "flightRecorder.h"
+#include "samplerTuning.h"
+#include "pidTrack.h"
+#include "hwCache.h"
+
+static int run_local_with_threads(CLAInfo* cla, const coreInfo* core){
+    ///_|> descry: local pipeline of --engine=threads: the collectors run on worker threads of this process
+    ///_|>         and the consumer takes their samples from in-memory queues instead of pipes
+    ///_|> cla: parsed command-line arguments, type CLAInfo*
+    ///_|> core: core count and max frequency for the cores panel, NULL without it, type const coreInfo*
+    ///_|> returning: returns 0 on success, 1 on error or when the user quits with Ctrl+C
+    cla->start_ns = now_mono_ns();
+    ThreadEngine* engine = (ThreadEngine*)malloc(sizeof(ThreadEngine));
+    if (!engine){
+        perror("Memory allocation for thread engine failed in main");
+        return 1;
+    }
+    // worker threads inherit the main thread's affinity, policy and nice value
+    sampler_tuning_apply(cla);
+    if (thread_engine_start(engine, cla) == -1){
+        free(engine);
+        return 1;
+    }
+    sampler_tuning_release();
+    // optional shared-memory snapshot for local agents
+    ShmSnapshot* shm = (cla->shm_enabled && (cla->graph_flag[0] || cla->graph_flag[1])) ? \
+                       shm_snapshot_create(cla->shm_name) : NULL;
+    int status = run_local_consumer(-1, core, -1, -1, engine, cla, shm);
+    shm_snapshot_destroy(shm, cla->shm_name);
+    // wakes sleeping workers and joins them, also when the user quit early
+    thread_engine_stop(engine);
+    free(engine);
+    if (cla->self_stats) self_stats_print(stdout);
+    sampler_tuning_report(stdout);
+    alert_reap_hooks();
+    // health-check scripts: a normal run during which any --alert rule fired exits with 2
+    if (status == 0 && alert_any_fired()) status = ALERT_EXIT_FIRED;
+    return status;
+}
+
+static int run_pid_tracking(CLAInfo* cla){
+    ///_|> descry: --pid: samples one process and its threads every --tdelay in this process and charts its CPU
+    ///_|>         and memory above the thread panel; no producer is forked
+    ///_|> cla: parsed command-line arguments, type CLAInfo*
+    ///_|> returning: returns 0 when all samples were shown or the process exited, 1 on error or user exit
+    pidCollector* collector = (pidCollector*)malloc(sizeof(pidCollector));
+    if (!collector){
+        perror("Memory allocation for pid collector failed in main");
+        return 1;
+    }
+    if (pid_collector_init(collector, cla->pid) == -1){
+        fprintf(stderr, "Cannot read /proc/%d/stat: no such process, or not allowed to read it\n", cla->pid);
+        free(collector);
+        return 1;
+    }
+    int total_samples = cla->samples;
+    float* memory_samples = (float*)malloc(sizeof(float) * total_samples);
+    float* cpu_samples = (float*)malloc(sizeof(float) * total_samples);
+    if (!memory_samples || !cpu_samples){
+        perror("Memory allocation for pid samples failed in main");
+        free(memory_samples);
+        free(cpu_samples);
+        pid_collector_close(collector);
+        free(collector);
+        return 1;
+    }
+    sampler_tuning_apply(cla);
+
+    printf("\033[2J");
+    printf("\033[1;1H");
+    printf("Tracking process %d (%d threads listed): %d samples, --every %d microSecs (%.3f secs)\n\n", cla->pid, \
+           collector->listed, total_samples, cla->tdelay, (float)cla->tdelay / 1000000.0);
+    fflush(stdout);
+    // the first reading only primes the counters
+    pidSample sample;
+    pid_collector_sample(collector, &sample);
+    float peak_gb = 0.0f;
+    int status = 0;
+    long long next_tick = now_mono_ns();
+    for (int i = 0; i < total_samples; i++){
+        next_tick += (long long)cla->tdelay * 1000LL;
+        struct timespec deadline = {next_tick / 1000000000LL, next_tick % 1000000000LL};
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR && !check_sigint()){}
+        if (prompt_for_int_signal()){
+            status = 1;
+            break;
+        }
+        long long woke = now_mono_ns();
+        self_stats_record(STAGE_TICK_JITTER, woke - next_tick);
+        if (pid_collector_sample(collector, &sample) == -1){
+            printf("Process %d exited.\n", cla->pid);
+            break;
+        }
+        self_stats_record(STAGE_FETCH_CPU, now_mono_ns() - woke);
+        // PSS when smaps_rollup is readable, else RSS; the chart is scaled to the peak so far
+        memory_samples[i] = sample.pss_mb / 1024.0f;
+        cpu_samples[i] = sample.cpu_machine;
+        if (memory_samples[i] > peak_gb) peak_gb = memory_samples[i];
+        float scale_gb = ceilf(peak_gb * 1.25f);
+        render_utilization_charts(cla, memory_samples, cpu_samples, NULL, NULL, i + 1, (scale_gb < 1.0f) ? 1.0f : scale_gb, \
+                                  NULL, NULL);
+        draw_pid_panel(&sample, cla->pid);
+        fflush(stdout);
+    }
+    sampler_tuning_release();
+    free(memory_samples);
+    free(cpu_samples);
+    pid_collector_close(collector);
+    free(collector);
+    if (cla->self_stats) self_stats_print(stdout);
+    sampler_tuning_report(stdout);
+    return status;
+}
 
 // notice: the  tall  of the terminal should be bigger than 33, in the case let it bigger than 40!
 int main(int argc,char** argv){
@@ -23,8 +148,66 @@ int main(int argc,char** argv){
         return 1;
     }
     // Parse command-line arguments and populate CLAInfo
-    // cla->graph_flag: index 0 = memory, 1 = cpu, 2 = cores
+    // cla->graph_flag: index 0 = memory, 1 = cpu, 2 = cores, 3 = NUMA nodes, 4 = interrupts
     read_CLA(argc, argv, cla);
+    // every collector (and every forked producer) reads below --proc-root when given
+    set_proc_root(cla->proc_root);
+    // threshold rules are evaluated by whichever process consumes the samples
+    for (int i = 0; i < cla->alert_count; i++){
+        if (alert_add_rule(cla->alert_specs[i]) == -1){
+            fprintf(stderr, "Invalid alert rule: %s\n", cla->alert_specs[i]);
+            free(cla);
+            return 1;
+        }
+    }
+
+    // --dump-record only decodes a recording
+    if (cla->mode == MODE_DUMP_RECORD){
+        int status = ts_dump_file(cla->record_path, stdout);
+        free(cla);
+        return status;
+    }
+    // --dump-flight only prints a window of a flight recorder file
+    if (cla->mode == MODE_DUMP_FLIGHT){
+        int status = flight_dump_file(cla->flight_spec, stdout);
+        free(cla);
+        return status;
+    }
+    // --record: the consuming process appends every sample to a compressed recording
+    ts_record_set_path(cla->record_path);
+    // --flight-recorder: and keeps the most recent ones in a circular memory-mapped file
+    if (flight_recorder_configure(cla->flight_spec) == -1){
+        fprintf(stderr, "Invalid --flight-recorder=FILE,SIZE: %s\n", cla->flight_spec);
+        free(cla);
+        return 1;
+    }
+
+    // core count and max frequency are kept per boot in a cache file (--hw-cache)
+    hw_cache_configure(cla->hw_cache_spec);
+
+    // --daemon, --attach and --aggregate replace the local producer/consumer pipeline
+    if (cla->mode == MODE_DAEMON || cla->mode == MODE_ATTACH || cla->mode == MODE_AGGREGATE){
+        int status = (cla->mode == MODE_DAEMON) ? run_daemon(cla) : \
+                     (cla->mode == MODE_ATTACH) ? run_viewer(cla) : run_aggregate_viewer(cla);
+        free(cla);
+        return status;
+    }
+
+    // --pid follows a single process from this one
+    if (cla->mode == MODE_PID){
+        int status = run_pid_tracking(cla);
+        free(cla);
+        return status;
+    }
+
+    // the cores panel is static: read (or taken from the cache) here, before anything is forked
+    coreInfo core;
+    if (cla->graph_flag[2] && get_static_coreinfo(&core) == -1){
+        fprintf(stderr, "core information is invalid: %d, %.2f\n", core.cores_num, core.max_freq);
+        free(cla);
+        return 1;
+    }
+    const coreInfo* core_panel = cla->graph_flag[2] ? &core : NULL;
 
     int total_samples = cla->samples;
 
@@ -33,9 +216,17 @@ int main(int argc,char** argv){
     printf("\033[1;1H"); 
     printf("Number of samples: %d, --every %d microSecs (%.3f secs)\n\n", total_samples, cla->tdelay, \
     (float)cla->tdelay/1000000.0);
+
+    // --engine=threads replaces the forked producers and their pipes
+    if (cla->engine == ENGINE_THREADS){
+        int status = run_local_with_threads(cla, core_panel);
+        free(cla);
+        return status;
+    }
     // initialize fd with -1
     int utiliz_fd[2] = {-1, -1}; // pipe for CPU/memory utilization
-    int core_fd[2] = {-1, -1}; // pipe for core info
+    int numa_fd[2] = {-1, -1}; // pipe for per-node NUMA readings
+    int irq_fd[2] = {-1, -1}; // pipe for interrupt hot spots
 
     // Create pipe for utilization info
     if (pipe(utiliz_fd) == -1){
@@ -44,16 +235,30 @@ int main(int argc,char** argv){
         return 1;
     }
 
-    // Create pipe for core info
-    if (pipe(core_fd) == -1){
-        perror("pipt created for core information failed in main");
+    // Create pipe for NUMA readings
+    if (pipe(numa_fd) == -1){
+        perror("pipe created for NUMA information failed in main");
+        free(cla);
+        return 1;
+    }
+
+    // Create pipe for interrupt readings
+    if (pipe(irq_fd) == -1){
+        perror("pipe created for interrupt information failed in main");
         free(cla);
         return 1;
     }
 
+    // common time origin of producers and consumer (places adaptive samples on the time axis)
+    cla->start_ns = now_mono_ns();
+
+    // --pin-cpu, --sched-fifo, --nice, --mlock: set on this process for the producers forked below
+    sampler_tuning_apply(cla);
+
     // initalize the children process pid
     pid_t utiliz_pid = -1;
-    pid_t core_pid = -1;
+    pid_t numa_pid = -1;
+    pid_t irq_pid = -1;
 
     // if need a memory or cpu graph
     if (cla->graph_flag[0]  || cla->graph_flag[1]){
@@ -62,83 +267,113 @@ int main(int argc,char** argv){
             //Child process: set itself be the leader of a process group
             setpgid(0, 0);
             // child process: close unused FDs, start utilization producer
-            safe_close(&core_fd[0]);
-            safe_close(&core_fd[1]);
+            safe_close(&numa_fd[0]);
+            safe_close(&numa_fd[1]);
+            safe_close(&irq_fd[0]);
+            safe_close(&irq_fd[1]);
             safe_close(&utiliz_fd[0]);
             fetch_utilization_with_pipe(cla, utiliz_fd[1]);
         }
         else if (utiliz_pid < 0){
             perror("fork for utilization in main failed");
             free(cla);
-            exit_failure_with_two_pipe_close(utiliz_fd, core_fd);
+            exit_failure_with_two_pipe_close(utiliz_fd, numa_fd);
         }
     }
 
-    if (cla->graph_flag[2]){
-        core_pid = fork();
-        if (core_pid == 0){
+    if (cla->graph_flag[3]){
+        numa_pid = fork();
+        if (numa_pid == 0){
             //Child process: set itself be the leader of a process group
             setpgid(0, 0);
-            // child process: close unused FDs, start core info producer
+            // child process: close unused FDs, start the per-node NUMA producer
             safe_close(&utiliz_fd[0]);
             safe_close(&utiliz_fd[1]);
-            safe_close(&core_fd[0]);
-            fetch_core_info_with_pipe(core_fd[1]);
+            safe_close(&irq_fd[0]);
+            safe_close(&irq_fd[1]);
+            safe_close(&numa_fd[0]);
+            fetch_numa_with_pipe(cla, numa_fd[1]);
         }
-        else if (core_pid < 0){
-            perror("fork for core in main failed");
+        else if (numa_pid < 0){
+            perror("fork for NUMA in main failed");
             free(cla);
-            exit_failure_with_two_pipe_close(utiliz_fd, core_fd);
+            safe_close(&numa_fd[0]);
+            safe_close(&numa_fd[1]);
+            safe_close(&irq_fd[0]);
+            safe_close(&irq_fd[1]);
+            // the utilization producer is already running: stop and reap it
+            kill_all_children(utiliz_pid, -1);
+            wait_for_children(utiliz_pid);
+            exit_failure_with_two_pipe_close(utiliz_fd, numa_fd);
         }
     }
 
-    // parent process: close write ends, keep read ends
-    safe_close(&utiliz_fd[1]);
-    safe_close(&core_fd[1]);
-    // read and print memory / cpu graphs if needed
-    if (cla->graph_flag[0] || cla->graph_flag[1]){
-        UtilizInfo utiliz_info;
-        utiliz_info.cpu_utiliz = -1;
-        utiliz_info.mem_utiliz.total_memory = -1;
-        utiliz_info.mem_utiliz.used_memory = -1;
-        if (parent_utilization_reader_printer(utiliz_fd[0], &utiliz_info, cla) == 1 ){
+    if (cla->graph_flag[4]){
+        irq_pid = fork();
+        if (irq_pid == 0){
+            //Child process: set itself be the leader of a process group
+            setpgid(0, 0);
+            // child process: close unused FDs, start the interrupt hot-spot producer
             safe_close(&utiliz_fd[0]);
-            safe_close(&core_fd[0]);
+            safe_close(&utiliz_fd[1]);
+            safe_close(&numa_fd[0]);
+            safe_close(&numa_fd[1]);
+            safe_close(&irq_fd[0]);
+            fetch_irq_with_pipe(cla, irq_fd[1]);
+        }
+        else if (irq_pid < 0){
+            perror("fork for interrupts in main failed");
             free(cla);
-            kill_all_children(utiliz_pid, core_pid); // kill all the children and grandchildren processes
-            return 1;
-        }; 
+            safe_close(&numa_fd[0]);
+            safe_close(&numa_fd[1]);
+            safe_close(&irq_fd[0]);
+            safe_close(&irq_fd[1]);
+            // stop and reap every producer forked so far
+            kill_all_children(utiliz_pid, numa_pid);
+            wait_for_children(utiliz_pid);
+            wait_for_children(numa_pid);
+            exit_failure_with_two_pipe_close(utiliz_fd, numa_fd);
+        }
     }
 
-    // prompt again if Ctrl+C was triggered before core info
-    if (prompt_for_int_signal()){
+    // parent process: back to its own scheduling, close write ends, keep read ends
+    sampler_tuning_release();
+    safe_close(&utiliz_fd[1]);
+    safe_close(&numa_fd[1]);
+    safe_close(&irq_fd[1]);
+    // read and print the graphs, each as soon as its data arrives
+    // optional shared-memory snapshot for local agents
+    ShmSnapshot* shm = (cla->shm_enabled && (cla->graph_flag[0] || cla->graph_flag[1])) ? \
+                       shm_snapshot_create(cla->shm_name) : NULL;
+    int reader_status = run_local_consumer(utiliz_fd[0], core_panel, numa_fd[0], irq_fd[0], NULL, cla, shm);
+    shm_snapshot_destroy(shm, cla->shm_name);
+    if (reader_status == 1){
         safe_close(&utiliz_fd[0]);
-        safe_close(&core_fd[0]);
+        safe_close(&numa_fd[0]);
+        safe_close(&irq_fd[0]);
+        kill_all_children(utiliz_pid, numa_pid); // kill all the children and grandchildren processes
+        kill_all_children(irq_pid, -1);
+        if (cla->self_stats) self_stats_print(stdout);
+        sampler_tuning_report(stdout);
         free(cla);
-        kill_all_children(utiliz_pid, core_pid); // kill all the children and grandchildren processes
         return 1;
     }
-    // read and print core info if needed
-    if (cla->graph_flag[2]){
-        coreInfo core_info;
-        core_info.cores_num = -1;
-        core_info.max_freq = -1;
-        if (parent_core_info_reader_printer(core_fd[0], &core_info) == 1){
-            safe_close(&utiliz_fd[0]);
-            safe_close(&core_fd[0]);
-            free(cla);
-            kill_all_children(utiliz_pid, core_pid); // kill all the children and grandchildren processes
-            return 1;
-        }
-    }
     // Clean up remaining read ends
     safe_close(&utiliz_fd[0]);
-    safe_close(&core_fd[0]);
+    safe_close(&numa_fd[0]);
+    safe_close(&irq_fd[0]);
+
+    if (wait_for_children(irq_pid) == -1){
+        perror("child process of main for getting interrupt information exited abnormally.");
+        free(cla);
+        kill_all_children(utiliz_pid, numa_pid);
+        return 1;
+    }
 
-    //Wait for core child process first to avoid zombie process during execution
-    if (wait_for_children(core_pid) == -1){
-        perror("child process of main for getting core information exited abnormally.");
+    if (wait_for_children(numa_pid) == -1){
+        perror("child process of main for getting NUMA information exited abnormally.");
         free(cla);
+        kill_all_children(utiliz_pid, -1);
         return 1;
     }
 
@@ -147,12 +382,17 @@ int main(int argc,char** argv){
         utiliz_pid = -1;
         perror("child process of main for getting utilization exited abnormally.");
         free(cla);
-        kill_all_children(utiliz_pid, core_pid); // kill all the children and grandchildren processes
+        kill_all_children(utiliz_pid, -1); // kill all the children and grandchildren processes
         return 1;
     }
 
+    // all producers are reaped now, so RUSAGE_CHILDREN covers every process of the tool
+    if (cla->self_stats) self_stats_print(stdout);
+    sampler_tuning_report(stdout);
 
     free(cla);
 
-    return 0;
+    alert_reap_hooks();
+    // health-check scripts: a normal run during which any --alert rule fired exits with 2
+    return alert_any_fired() ? ALERT_EXIT_FIRED : 0;
 }
\ No newline at end of file
@@ -0,0 +1,219 @@
+#define _DEFAULT_SOURCE
+#include "numa.h"
+#include <dirent.h>
+#include <limits.h>
+#include "arena.h"
+#include "procParse.h"
+
+static const char history_ramp[] = " .:-=+*#%@";
+///_|> descry: glyphs of the per-node history rows, from 0 % (blank) to 100 % ('@')
+
+static int compare_ints(const void* a, const void* b){
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+int numa_discover_nodes(int* node_ids, int max_nodes){
+    ///_|> descry: lists the NUMA nodes below /sys/devices/system/node (honours --proc-root)
+    ///_|> node_ids: receives up to max_nodes node ids in ascending order, type int*
+    ///_|> max_nodes: capacity of node_ids, type int
+    ///_|> returning: returns the number of nodes found, -1 if the directory cannot be read
+    char path[320];
+    DIR* dir = opendir(proc_path(path, sizeof(path), "/sys/devices/system/node"));
+    if (dir == NULL) return -1;
+    int count = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL && count < max_nodes){
+        unsigned long long id;
+        const char* end;
+        // "node12" but not "node12x" or "has_memory"
+        if (strncmp(entry->d_name, "node", 4) == 0 && (end = procparse_u64(entry->d_name + 4, &id)) != NULL && \
+            *end == '\0' && id <= INT_MAX) node_ids[count++] = (int)id;
+    }
+    closedir(dir);
+    qsort(node_ids, count, sizeof(int), compare_ints);
+    return count;
+}
+
+static int map_cpulist(numaCollector* collector, int node_index){
+    ///_|> descry: marks the CPUs of one node's cpulist ("0-3,8-11") as belonging to node_index
+    ///_|> collector: collector being initialized, type numaCollector*
+    ///_|> node_index: index of the node in collector->node_ids, type int
+    ///_|> returning: returns 0 on success, -1 if the cpulist cannot be read
+    char abs_path[64];
+    snprintf(abs_path, sizeof(abs_path), "/sys/devices/system/node/node%d/cpulist", collector->node_ids[node_index]);
+    procFile cpulist = PROC_FILE_INIT(abs_path);
+    ssize_t got = proc_file_read(&cpulist, collector->node_buf, NUMA_NODE_BUF_SIZE);
+    proc_file_close(&cpulist);
+    if (got == -1) return -1;
+    const char* p = collector->node_buf;
+    while (*p != '\0' && *p != '\n'){
+        unsigned long long first, last;
+        const char* after;
+        if ((p = procparse_u64(p, &first)) == NULL) break;
+        last = first;
+        if (*p == '-' && (after = procparse_u64(p + 1, &last)) != NULL) p = after;
+        for (unsigned long long cpu = first; cpu <= last && cpu < NUMA_MAX_CPUS; cpu++){
+            collector->cpu_node[cpu] = (signed char)node_index;
+        }
+        if (*p == ',') p++;
+    }
+    return 0;
+}
+
+int numa_collector_init(numaCollector* collector){
+    ///_|> descry: discovers the nodes and their CPUs, takes the read buffers and primes the deltas,
+    ///_|>         so the first numa_collector_sample reports the first interval
+    ///_|> collector: collector to initialize in place, type numaCollector*
+    ///_|> returning: returns the number of nodes, -1 if no NUMA topology is exposed or a file cannot be read
+    memset(collector, 0, sizeof(numaCollector));
+    memset(collector->cpu_node, -1, sizeof(collector->cpu_node));
+    collector->stat = (procFile)PROC_FILE_INIT("/proc/stat");
+    collector->node_count = numa_discover_nodes(collector->node_ids, NUMA_MAX_NODES);
+    if (collector->node_count <= 0){
+        fprintf(stderr, "No NUMA nodes found below /sys/devices/system/node\n");
+        return -1;
+    }
+    collector->stat_buf = arena_alloc(NUMA_STAT_BUF_SIZE);
+    collector->node_buf = arena_alloc(NUMA_NODE_BUF_SIZE);
+    if (collector->stat_buf == NULL || collector->node_buf == NULL) return -1;
+    for (int n = 0; n < collector->node_count; n++){
+        int id = collector->node_ids[n];
+        snprintf(collector->meminfo_paths[n], 64, "/sys/devices/system/node/node%d/meminfo", id);
+        snprintf(collector->numastat_paths[n], 64, "/sys/devices/system/node/node%d/numastat", id);
+        collector->meminfo[n] = (procFile)PROC_FILE_INIT(collector->meminfo_paths[n]);
+        collector->numastat[n] = (procFile)PROC_FILE_INIT(collector->numastat_paths[n]);
+        if (map_cpulist(collector, n) == -1){
+            perror("Failed to read NUMA node cpulist");
+            return -1;
+        }
+    }
+    numaSample primer;
+    if (numa_collector_sample(collector, &primer) == -1) return -1;
+    return collector->node_count;
+}
+
+static int sum_cpu_jiffies(numaCollector* collector, long long* total, long long* idle){
+    ///_|> descry: sums the per-CPU lines of /proc/stat by node, with the same fields as parse_cpuInfo
+    ///_|> collector: initialized collector, type numaCollector*
+    ///_|> total / idle: per-node sums to fill, indexed like node_ids, type long long*
+    ///_|> returning: returns 0 on success, -1 if /proc/stat cannot be read
+    if (proc_file_read(&collector->stat, collector->stat_buf, NUMA_STAT_BUF_SIZE) <= 0) return -1;
+    memset(total, 0, sizeof(long long) * NUMA_MAX_NODES);
+    memset(idle, 0, sizeof(long long) * NUMA_MAX_NODES);
+    // the aggregate "cpu " line comes first, every "cpuN" line follows it
+    const char* line = strchr(collector->stat_buf, '\n');
+    while (line != NULL && strncmp(line + 1, "cpu", 3) == 0){
+        unsigned long long cpu;
+        unsigned long long f[7];
+        const char* fields = procparse_u64(line + 4, &cpu);
+        if (fields != NULL && cpu < NUMA_MAX_CPUS && collector->cpu_node[cpu] >= 0 && \
+            procparse_fields(fields, f, 7, NULL) == 7){
+            int n = collector->cpu_node[cpu];
+            total[n] += (long long)(f[0] + f[1] + f[2] + f[3] + f[4] + f[5] + f[6]);
+            idle[n] += (long long)f[3];
+        }
+        line = strchr(line + 1, '\n');
+    }
+    return 0;
+}
+
+static long long find_counter(const char* text, const char* key){
+    ///_|> descry: value of a "key value" line (numastat) or of a "Node N key: value kB" line (node meminfo)
+    ///_|> text: NUL-terminated file contents, type const char*
+    ///_|> key: counter name including its trailing ':' for meminfo, type const char*
+    ///_|> returning: returns the value, -1 if the key is missing
+    unsigned long long value;
+    if (procparse_find_u64(text, key, &value) == -1) return -1;
+    return (long long)value;
+}
+
+int numa_collector_sample(numaCollector* collector, numaSample* sample){
+    ///_|> descry: reads every node's memory, CPU and allocation counters for the interval since the last call;
+    ///_|>         allocation-free
+    ///_|> collector: initialized collector, type numaCollector*
+    ///_|> sample: receives the per-node values (timestamp_ns is left to the caller), type numaSample*
+    ///_|> returning: returns 0 on success, -1 if a file cannot be read or parsed
+    long long total[NUMA_MAX_NODES], idle[NUMA_MAX_NODES];
+    if (sum_cpu_jiffies(collector, total, idle) == -1) return -1;
+    sample->node_count = collector->node_count;
+    for (int n = 0; n < collector->node_count; n++){
+        numaNodeInfo* node = &sample->nodes[n];
+        node->node_id = collector->node_ids[n];
+        if (proc_file_read(&collector->meminfo[n], collector->node_buf, NUMA_NODE_BUF_SIZE) <= 0) return -1;
+        long long total_kb = find_counter(collector->node_buf, "MemTotal:");
+        long long free_kb = find_counter(collector->node_buf, "MemFree:");
+        if (proc_file_read(&collector->numastat[n], collector->node_buf, NUMA_NODE_BUF_SIZE) <= 0) return -1;
+        long long hit = find_counter(collector->node_buf, "numa_hit");
+        long long miss = find_counter(collector->node_buf, "numa_miss");
+        if (total_kb < 0 || free_kb < 0 || hit < 0 || miss < 0) return -1;
+
+        node->total_memory = total_kb / (1024.0 * 1024.0);
+        node->used_memory = (total_kb - free_kb) / (1024.0 * 1024.0);
+        long long total_delta = total[n] - collector->prev_total[n];
+        long long busy_delta = total_delta - (idle[n] - collector->prev_idle[n]);
+        node->cpu_utiliz = (total_delta > 0) ? (float)busy_delta / (float)total_delta * 100.0f : 0.0f;
+        long long alloc_delta = (hit - collector->prev_hit[n]) + (miss - collector->prev_miss[n]);
+        node->miss_percent = (alloc_delta > 0) ? (float)(miss - collector->prev_miss[n]) / (float)alloc_delta * 100.0f : 0.0f;
+
+        collector->prev_total[n] = total[n];
+        collector->prev_idle[n] = idle[n];
+        collector->prev_hit[n] = hit;
+        collector->prev_miss[n] = miss;
+    }
+    return 0;
+}
+
+void numa_collector_close(numaCollector* collector){
+    ///_|> descry: closes every descriptor of the collector; the arena buffers stay with the process
+    ///_|> collector: collector to close, type numaCollector*
+    ///_|> returning: this function does not return anything
+    for (int n = 0; n < collector->node_count; n++){
+        proc_file_close(&collector->meminfo[n]);
+        proc_file_close(&collector->numastat[n]);
+    }
+    proc_file_close(&collector->stat);
+}
+
+static void draw_history_row(const numaSample* samples, int sample_count, int total, int node, bool memory){
+    ///_|> descry: prints one node's memory or CPU history, one glyph of history_ramp per sample
+    ///_|> samples / sample_count / total: received samples, how many and the chart width, type const numaSample* / int / int
+    ///_|> node: index into numaSample.nodes, type int
+    ///_|> memory: memory share of the node when true, CPU utilization otherwise, type bool
+    ///_|> returning: this function does not return anything
+    int levels = (int)sizeof(history_ramp) - 2; // index of '@'
+    printf("|");
+    for (int i = 0; i < total; i++){
+        if (i >= sample_count){
+            printf(" ");
+            continue;
+        }
+        const numaNodeInfo* info = &samples[i].nodes[node];
+        float percent = memory ? ((info->total_memory > 0) ? info->used_memory / info->total_memory * 100.0f : 0.0f) \
+                               : info->cpu_utiliz;
+        int level = (int)(percent / 100.0f * levels + 0.5f);
+        if (level < 0) level = 0;
+        if (level > levels) level = levels;
+        printf("%c", history_ramp[level]);
+    }
+    printf("|\n");
+}
+
+void draw_numa_panel(const numaSample* samples, int sample_count, int total){
+    ///_|> descry: draws the per-node memory and CPU history, NUMA_PANEL_ROWS(node_count) rows
+    ///_|> samples: received samples, oldest first, type const numaSample*
+    ///_|> sample_count: number of received samples, at least 1, type int
+    ///_|> total: total number of samples (the chart width), type int
+    ///_|> returning: this function does not return anything
+    const numaSample* latest = &samples[sample_count - 1];
+    printf("v NUMA nodes: %d\n", latest->node_count);
+    for (int n = 0; n < latest->node_count; n++){
+        const numaNodeInfo* node = &latest->nodes[n];
+        printf("  node%-2d mem %6.2f/%6.2f GB       ", node->node_id, node->used_memory, node->total_memory);
+        draw_history_row(samples, sample_count, total, n, true);
+        printf("  node%-2d cpu %6.2f %%  miss %5.2f %% ", node->node_id, node->cpu_utiliz, node->miss_percent);
+        draw_history_row(samples, sample_count, total, n, false);
+    }
+    printf("\n");
+}
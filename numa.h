@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "procRoot.h"
+
+#ifndef NUMA_HEADER
+#define NUMA_HEADER
+
+/*
+This module provides a per-NUMA-node view of memory and CPU usage (--numa).
+The node list and each node's CPUs come from /sys/devices/system/node/nodeN/cpulist once at start-up;
+every tick then reads each node's meminfo and numastat and /proc/stat through descriptors kept open
+(procFile), sums the per-CPU jiffies by node, and fills a fixed-size numaSample that fits one pipe write.
+Like the other collectors it reads below --proc-root, so it runs against generated sysfs trees.
+draw_numa_panel renders one memory and one CPU history row per node below the machine-wide charts.
+*/
+
+#define NUMA_MAX_NODES 8
+#define NUMA_MAX_CPUS 4096
+#define NUMA_STAT_BUF_SIZE (256 * 1024) // per-CPU lines of /proc/stat on large hosts
+#define NUMA_NODE_BUF_SIZE 4096
+#define NUMA_PANEL_ROWS(nodes) (2 + 2 * (nodes)) // title, two rows per node, blank line
+
+typedef struct {
+    int node_id;
+    float total_memory;
+    float used_memory;
+    float cpu_utiliz;
+    float miss_percent;
+}numaNodeInfo;
+///_|> descry: Usage of one NUMA node over the last interval
+///_|> members:
+///_|>     - node_id: N of /sys/devices/system/node/nodeN, type int
+///_|>     - total_memory / used_memory: node memory in GB, type float
+///_|>     - cpu_utiliz: utilization of the node's CPUs in percent, type float
+///_|>     - miss_percent: share of the node's page allocations that had to fall back to another node
+///_|>                     (numa_miss over numa_hit + numa_miss), in percent, type float
+
+typedef struct {
+    long long timestamp_ns;
+    int node_count;
+    numaNodeInfo nodes[NUMA_MAX_NODES];
+}numaSample;
+///_|> descry: One timestamped reading of every node, sent from the NUMA producer to the consumer
+///_|> members:
+///_|>     - timestamp_ns: monotonic time the reading was taken in nanoseconds, type long long
+///_|>     - node_count: number of valid entries in nodes, type int
+///_|>     - nodes: per-node usage in ascending node id order, type numaNodeInfo[]
+
+typedef struct {
+    int node_count;
+    int node_ids[NUMA_MAX_NODES];
+    char meminfo_paths[NUMA_MAX_NODES][64];
+    char numastat_paths[NUMA_MAX_NODES][64];
+    procFile meminfo[NUMA_MAX_NODES];
+    procFile numastat[NUMA_MAX_NODES];
+    procFile stat;
+    signed char cpu_node[NUMA_MAX_CPUS];
+    long long prev_total[NUMA_MAX_NODES];
+    long long prev_idle[NUMA_MAX_NODES];
+    long long prev_hit[NUMA_MAX_NODES];
+    long long prev_miss[NUMA_MAX_NODES];
+    char* stat_buf;
+    char* node_buf;
+}numaCollector;
+///_|> descry: Topology and open descriptors of the NUMA collector; procFiles point into the struct's own
+///_|>         path arrays, so a collector must not be moved after numa_collector_init
+///_|> members:
+///_|>     - node_count / node_ids: nodes found at start-up, in ascending order, type int / int[]
+///_|>     - meminfo_paths / numastat_paths: absolute sysfs paths of each node's files, type char[][64]
+///_|>     - meminfo / numastat / stat: files kept open across ticks, type procFile[] / procFile
+///_|>     - cpu_node: index into node_ids of every CPU, -1 for CPUs without a node, type signed char[]
+///_|>     - prev_total / prev_idle: per-node jiffies of the previous tick, type long long[]
+///_|>     - prev_hit / prev_miss: per-node numastat counters of the previous tick, type long long[]
+///_|>     - stat_buf / node_buf: read buffers taken from the process arena, type char*
+
+int numa_discover_nodes(int* node_ids, int max_nodes);
+
+int numa_collector_init(numaCollector* collector);
+
+int numa_collector_sample(numaCollector* collector, numaSample* sample);
+
+void numa_collector_close(numaCollector* collector);
+
+void draw_numa_panel(const numaSample* samples, int sample_count, int total);
+
+#endif
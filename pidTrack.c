@@ -0,0 +1,355 @@
+#define _DEFAULT_SOURCE
+#include "pidTrack.h"
+#include "arena.h"
+#include "timeTool.h"
+#include "procParse.h"
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+static const char* skip_fields(const char* p, int count){
+    ///_|> descry: skips blank-separated fields of a stat line; used instead of parsing them because some
+    ///_|>         (tpgid, priority, nice) can be negative
+    ///_|> p: position before the first field to skip, type const char*
+    ///_|> count: number of fields to skip, type int
+    ///_|> returning: returns the position just past the last skipped field
+    for (int i = 0; i < count; i++){
+        while (*p == ' ') p++;
+        while (*p != ' ' && *p != '\0' && *p != '\n') p++;
+    }
+    return p;
+}
+
+static int parse_stat(const char* buf, unsigned long long* ticks, unsigned long long* threads, \
+unsigned long long* rss_pages, char* comm){
+    ///_|> descry: reads the fields the collector needs from a /proc/N/stat or /proc/N/task/T/stat line
+    ///_|> buf: NUL-terminated file contents, type const char*
+    ///_|> ticks: receives utime + stime (fields 14 and 15) in clock ticks, type unsigned long long*
+    ///_|> threads / rss_pages: receive num_threads (20) and rss (24), NULL when not needed, type unsigned long long*
+    ///_|> comm: receives the name between the parentheses, PID_COMM_LEN bytes, NULL when not needed, type char*
+    ///_|> returning: returns 0 on success, -1 if the line is cut short
+    // the name may hold blanks and parentheses itself, the fields start after the last ')'
+    const char* open = strchr(buf, '(');
+    const char* close = strrchr(buf, ')');
+    if (open == NULL || close == NULL || close < open) return -1;
+    if (comm != NULL){
+        size_t len = (size_t)(close - open - 1);
+        if (len > PID_COMM_LEN - 1) len = PID_COMM_LEN - 1;
+        memcpy(comm, open + 1, len);
+        comm[len] = '\0';
+    }
+    // field 3 (state) is the first after the name
+    unsigned long long utime, stime, value;
+    const char* p = procparse_u64(skip_fields(close + 1, 11), &utime);
+    if (p == NULL || (p = procparse_u64(p, &stime)) == NULL) return -1;
+    *ticks = utime + stime;
+    if (threads == NULL) return 0;
+    if ((p = procparse_u64(skip_fields(p, 4), &value)) == NULL) return -1;
+    *threads = value;
+    if ((p = procparse_u64(skip_fields(p, 3), &value)) == NULL) return -1;
+    *rss_pages = value;
+    return 0;
+}
+
+static int compare_tids(const void* a, const void* b){
+    return *(const int*)a - *(const int*)b;
+}
+
+static int list_threads(pidCollector* collector){
+    ///_|> descry: rebuilds the thread table from /proc/N/task, keeping the entries (and open descriptors) of
+    ///_|>         threads still there and closing those of threads that are gone
+    ///_|> collector: collector to update, type pidCollector*
+    ///_|> returning: returns 0 on success, -1 if the directory cannot be listed (the process is gone)
+    char path[320];
+    DIR* dir = opendir(proc_path(path, sizeof(path), collector->task_path));
+    if (dir == NULL) return -1;
+    int count = 0;
+    int listed = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL){
+        unsigned long long tid;
+        const char* end = procparse_u64(entry->d_name, &tid);
+        if (end == NULL || *end != '\0' || tid > 0x7fffffffULL) continue;
+        listed++;
+        if (count < PID_MAX_THREADS) collector->tids[count++] = (int)tid;
+    }
+    closedir(dir);
+    qsort(collector->tids, count, sizeof(int), compare_tids);
+
+    // both lists are sorted, a single pass pairs old entries with the new tids
+    int old = 0;
+    for (int i = 0; i < count; i++){
+        int tid = collector->tids[i];
+        while (old < collector->thread_count && collector->threads[old].tid < tid){
+            proc_file_close(&collector->threads[old++].file);
+        }
+        pidThread* thread = &collector->spare[i];
+        if (old < collector->thread_count && collector->threads[old].tid == tid){
+            *thread = collector->threads[old++];
+        }else{
+            memset(thread, 0, sizeof(pidThread));
+            thread->tid = tid;
+            snprintf(thread->path, sizeof(thread->path), "/proc/%d/task/%d/stat", collector->pid, tid);
+            thread->file.fd = -1;
+            thread->file.generation = -1;
+        }
+        thread->file.abs_path = thread->path;
+    }
+    while (old < collector->thread_count) proc_file_close(&collector->threads[old++].file);
+
+    pidThread* table = collector->threads;
+    collector->threads = collector->spare;
+    collector->spare = table;
+    collector->thread_count = count;
+    collector->listed = listed;
+    collector->relists++;
+    return 0;
+}
+
+static void insert_top(pidSample* sample, const pidThread* thread, float cpu){
+    ///_|> descry: keeps the PID_TOP_THREADS busiest threads of a tick, busiest first
+    ///_|> sample: reading being filled, type pidSample*
+    ///_|> thread: thread just read, type const pidThread*
+    ///_|> cpu: its CPU use in percent of one CPU, type float
+    ///_|> returning: this function does not return anything
+    int pos = sample->top_count;
+    if (pos == PID_TOP_THREADS){
+        if (cpu <= sample->top[PID_TOP_THREADS - 1].cpu) return;
+        pos--;
+    }else{
+        sample->top_count++;
+    }
+    while (pos > 0 && sample->top[pos - 1].cpu < cpu){
+        sample->top[pos] = sample->top[pos - 1];
+        pos--;
+    }
+    sample->top[pos].tid = thread->tid;
+    sample->top[pos].cpu = cpu;
+    memcpy(sample->top[pos].comm, thread->comm, PID_COMM_LEN);
+}
+
+static bool read_threads(pidCollector* collector, pidSample* sample, float seconds){
+    ///_|> descry: reads the stat file of every tracked thread and ranks the threads by CPU time since the last tick
+    ///_|> collector: collector holding the thread table, type pidCollector*
+    ///_|> sample: reading receiving the busiest threads, type pidSample*
+    ///_|> seconds: length of the interval, 0 on the first tick, type float
+    ///_|> returning: returns false if a thread could not be read (it exited), true otherwise
+    bool all_read = true;
+    float scale = (seconds > 0.0f) ? 100.0f / (seconds * (float)collector->ticks_per_sec) : 0.0f;
+    for (int i = 0; i < collector->thread_count; i++){
+        pidThread* thread = &collector->threads[i];
+        // a stat line is far below PID_STAT_BUF and procfs returns it in one read, so the read that
+        // proc_file_read does to see the end of the file is left out: one syscall per thread
+        int fd = proc_file_fd(&thread->file);
+        ssize_t got = (fd == -1) ? -1 : pread(fd, collector->buf, PID_STAT_BUF - 1, 0);
+        if (got >= 0) collector->buf[got] = '\0';
+        // past the descriptor budget a thread's file is only open while it is read
+        if (i >= collector->fd_budget) proc_file_close(&thread->file);
+        unsigned long long ticks;
+        if (got <= 0 || parse_stat(collector->buf, &ticks, NULL, NULL, thread->comm) == -1){
+            all_read = false;
+            thread->primed = false;
+            continue;
+        }
+        if (thread->primed && seconds > 0.0f && ticks >= thread->ticks){
+            insert_top(sample, thread, (float)(ticks - thread->ticks) * scale);
+        }
+        thread->ticks = ticks;
+        thread->primed = true;
+    }
+    return all_read;
+}
+
+static void read_memory(pidCollector* collector, pidSample* sample, unsigned long long rss_pages){
+    ///_|> descry: fills RSS, PSS and swap, from smaps_rollup when it can be read, else RSS from the stat line
+    ///_|> collector: collector holding the smaps_rollup descriptor, type pidCollector*
+    ///_|> sample: reading to fill, type pidSample*
+    ///_|> rss_pages: rss field of /proc/N/stat in pages, type unsigned long long
+    ///_|> returning: this function does not return anything
+    sample->rss_mb = (float)(rss_pages * collector->page_kb) / 1024.0f;
+    sample->pss_mb = sample->rss_mb;
+    sample->swap_mb = -1.0f;
+    if (!collector->rollup_ok) return;
+    unsigned long long rss, pss, swap;
+    // the first line is the "[rollup]" mapping header, every value line starts after a newline
+    if (proc_file_read(&collector->rollup, collector->buf, PID_ROLLUP_BUF) <= 0 || \
+        procparse_find_u64(collector->buf, "\nRss", &rss) == -1 || \
+        procparse_find_u64(collector->buf, "\nPss", &pss) == -1){
+        return;
+    }
+    sample->rss_mb = (float)rss / 1024.0f;
+    sample->pss_mb = (float)pss / 1024.0f;
+    if (procparse_find_u64(collector->buf, "\nSwap", &swap) == 0) sample->swap_mb = (float)swap / 1024.0f;
+}
+
+static void read_io(pidCollector* collector, pidSample* sample, float seconds){
+    ///_|> descry: fills the storage read and write rates from /proc/N/io when it can be read
+    ///_|> collector: collector holding the io descriptor and the previous counters, type pidCollector*
+    ///_|> sample: reading to fill, type pidSample*
+    ///_|> seconds: length of the interval, 0 on the first tick, type float
+    ///_|> returning: this function does not return anything
+    sample->read_rate = -1.0f;
+    sample->write_rate = -1.0f;
+    if (!collector->io_ok) return;
+    unsigned long long read_bytes, write_bytes;
+    // "\nwrite_bytes" does not match cancelled_write_bytes
+    if (proc_file_read(&collector->io, collector->buf, PID_ROLLUP_BUF) <= 0 || \
+        procparse_find_u64(collector->buf, "\nread_bytes", &read_bytes) == -1 || \
+        procparse_find_u64(collector->buf, "\nwrite_bytes", &write_bytes) == -1){
+        return;
+    }
+    if (seconds > 0.0f && read_bytes >= collector->prev_read && write_bytes >= collector->prev_write){
+        sample->read_rate = (float)(read_bytes - collector->prev_read) / seconds;
+        sample->write_rate = (float)(write_bytes - collector->prev_write) / seconds;
+    }
+    collector->prev_read = read_bytes;
+    collector->prev_write = write_bytes;
+}
+
+static void raise_fd_limit(pidCollector* collector){
+    ///_|> descry: raises the soft descriptor limit to the hard one and sets how many thread files may stay open
+    ///_|> collector: collector receiving fd_budget, type pidCollector*
+    ///_|> returning: this function does not return anything
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == -1){
+        collector->fd_budget = 0;
+        return;
+    }
+    if (limit.rlim_cur < limit.rlim_max){
+        rlim_t wanted = limit.rlim_max;
+        if (wanted == RLIM_INFINITY || wanted > PID_MAX_THREADS + PID_SPARE_FDS){
+            wanted = PID_MAX_THREADS + PID_SPARE_FDS;
+        }
+        if (wanted > limit.rlim_cur){
+            limit.rlim_cur = wanted;
+            if (setrlimit(RLIMIT_NOFILE, &limit) == -1) getrlimit(RLIMIT_NOFILE, &limit);
+        }
+    }
+    long budget = (limit.rlim_cur == RLIM_INFINITY) ? PID_MAX_THREADS : (long)limit.rlim_cur - PID_SPARE_FDS;
+    collector->fd_budget = (budget > PID_MAX_THREADS) ? PID_MAX_THREADS : (budget < 0) ? 0 : (int)budget;
+}
+
+int pid_collector_init(pidCollector* collector, int pid){
+    ///_|> descry: opens the files of a process, checks which of them can be read and lists its threads
+    ///_|> collector: collector to set up, type pidCollector*
+    ///_|> pid: process to track, type int
+    ///_|> returning: returns 0 on success, -1 if the process does not exist or cannot be read, or the arena is full
+    memset(collector, 0, sizeof(pidCollector));
+    collector->pid = pid;
+    snprintf(collector->stat_path, PID_PATH_LEN, "/proc/%d/stat", pid);
+    snprintf(collector->rollup_path, PID_PATH_LEN, "/proc/%d/smaps_rollup", pid);
+    snprintf(collector->io_path, PID_PATH_LEN, "/proc/%d/io", pid);
+    snprintf(collector->task_path, PID_PATH_LEN, "/proc/%d/task", pid);
+    procFile stat = PROC_FILE_INIT(collector->stat_path);
+    procFile rollup = PROC_FILE_INIT(collector->rollup_path);
+    procFile io = PROC_FILE_INIT(collector->io_path);
+    collector->stat = stat;
+    collector->rollup = rollup;
+    collector->io = io;
+
+    collector->buf = arena_alloc(PID_ROLLUP_BUF);
+    collector->threads = arena_alloc(sizeof(pidThread) * PID_MAX_THREADS);
+    collector->spare = arena_alloc(sizeof(pidThread) * PID_MAX_THREADS);
+    collector->tids = arena_alloc(sizeof(int) * PID_MAX_THREADS);
+    if (collector->buf == NULL || collector->threads == NULL || collector->spare == NULL || collector->tids == NULL){
+        return -1;
+    }
+    long ticks = sysconf(_SC_CLK_TCK);
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    long page = sysconf(_SC_PAGESIZE);
+    collector->ticks_per_sec = (ticks > 0) ? ticks : 100;
+    collector->cpus = (cpus > 0) ? (int)cpus : 1;
+    collector->page_kb = (page >= 1024) ? page / 1024 : 4;
+    raise_fd_limit(collector);
+
+    unsigned long long ticks_now;
+    if (proc_file_read(&collector->stat, collector->buf, PID_STAT_BUF) <= 0 || \
+        parse_stat(collector->buf, &ticks_now, NULL, NULL, NULL) == -1){
+        proc_file_close(&collector->stat);
+        return -1;
+    }
+    // smaps_rollup needs Linux 4.14, io needs ptrace access to the process; both are optional
+    collector->rollup_ok = proc_file_read(&collector->rollup, collector->buf, PID_ROLLUP_BUF) > 0 && \
+                           strstr(collector->buf, "\nPss") != NULL;
+    collector->io_ok = proc_file_read(&collector->io, collector->buf, PID_ROLLUP_BUF) > 0 && \
+                       strstr(collector->buf, "\nread_bytes") != NULL;
+    if (!collector->rollup_ok) proc_file_close(&collector->rollup);
+    if (!collector->io_ok) proc_file_close(&collector->io);
+    if (list_threads(collector) == -1){
+        pid_collector_close(collector);
+        return -1;
+    }
+    return 0;
+}
+
+int pid_collector_sample(pidCollector* collector, pidSample* sample){
+    ///_|> descry: takes one reading of the process and its threads; the first one only primes the counters,
+    ///_|>         so its CPU and I/O rates are -1
+    ///_|> collector: collector set up by pid_collector_init, type pidCollector*
+    ///_|> sample: receives the reading, type pidSample*
+    ///_|> returning: returns 0 on success, -1 if the process has exited
+    memset(sample, 0, sizeof(pidSample));
+    unsigned long long ticks, threads, rss_pages;
+    if (proc_file_read(&collector->stat, collector->buf, PID_STAT_BUF) <= 0 || \
+        parse_stat(collector->buf, &ticks, &threads, &rss_pages, NULL) == -1){
+        return -1;
+    }
+    long long now = now_mono_ns();
+    float seconds = (collector->prev_ns > 0) ? (float)((now - collector->prev_ns) / 1e9) : 0.0f;
+    sample->timestamp_ns = now;
+    sample->threads = (int)threads;
+    sample->cpu = -1.0f;
+    sample->cpu_machine = -1.0f;
+    if (seconds > 0.0f && ticks >= collector->prev_ticks){
+        sample->cpu = (float)(ticks - collector->prev_ticks) * 100.0f / (seconds * (float)collector->ticks_per_sec);
+        sample->cpu_machine = sample->cpu / (float)collector->cpus;
+    }
+    collector->prev_ticks = ticks;
+    collector->prev_ns = now;
+
+    // threads started or exited since the listing: list again before reading, new threads prime this tick
+    if ((int)threads != collector->listed && list_threads(collector) == -1) return -1;
+    // a thread that exited and one that started in the same interval keep the count, but the exited one fails
+    if (!read_threads(collector, sample, seconds) && list_threads(collector) == -1) return -1;
+
+    read_memory(collector, sample, rss_pages);
+    read_io(collector, sample, seconds);
+    sample->relists = collector->relists;
+    return 0;
+}
+
+void pid_collector_close(pidCollector* collector){
+    ///_|> descry: closes every descriptor of the collector; the arena tables stay with the process
+    ///_|> collector: collector to close, type pidCollector*
+    ///_|> returning: this function does not return anything
+    for (int i = 0; i < collector->thread_count; i++) proc_file_close(&collector->threads[i].file);
+    collector->thread_count = 0;
+    proc_file_close(&collector->stat);
+    proc_file_close(&collector->rollup);
+    proc_file_close(&collector->io);
+}
+
+void draw_pid_panel(const pidSample* sample, int pid){
+    ///_|> descry: draws the process, memory and I/O lines and the busiest threads, PID_PANEL_ROWS rows; every row
+    ///_|>         is cleared first because the set of threads changes from one reading to the next
+    ///_|> sample: latest reading, type const pidSample*
+    ///_|> pid: tracked process, type int
+    ///_|> returning: this function does not return anything
+    printf("\033[2Kv Process %d: cpu %.1f %% of one CPU (%.2f %% of all CPUs), %d threads, thread list rebuilt %llu times\n", \
+           pid, sample->cpu, sample->cpu_machine, sample->threads, sample->relists);
+    printf("\033[2K  rss %.1f MB  pss %.1f MB", sample->rss_mb, sample->pss_mb);
+    if (sample->swap_mb >= 0) printf("  swap %.1f MB", sample->swap_mb);
+    if (sample->read_rate >= 0){
+        printf("   read %.2f MB/s  write %.2f MB/s", sample->read_rate / 1048576.0f, sample->write_rate / 1048576.0f);
+    }
+    printf("\n");
+    printf("\033[2Kv Busiest threads (%% of one CPU)\n");
+    for (int t = 0; t < PID_TOP_THREADS; t++){
+        printf("\033[2K");
+        if (t < sample->top_count){
+            printf("  tid %-8d %-16s %6.1f %%", sample->top[t].tid, sample->top[t].comm, sample->top[t].cpu);
+        }
+        printf("\n");
+    }
+    printf("\n");
+}
@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "procRoot.h"
+
+#ifndef PID_TRACK_HEADER
+#define PID_TRACK_HEADER
+
+/*
+This module follows one process at a high rate (--pid=N): its CPU time, the CPU time of each of its
+threads, its memory (RSS, and PSS and swap from /proc/N/smaps_rollup) and its disk I/O (/proc/N/io).
+/proc/N/stat, smaps_rollup, io and the stat file of every thread stay open across ticks (procFile), so
+a tick is one pread per file. The thread table is sorted by thread id and rebuilt from /proc/N/task
+only when the thread set changes: the process's thread count moved, or a thread's file failed because
+the thread exited. Threads still there keep their open descriptors, so a 2000-thread JVM costs 2000
+preads a tick and no directory listing. The soft descriptor limit is raised toward the hard one at
+start; threads beyond it are opened, read and closed every tick.
+All tables come from the process arena; the steady-state sampling loop does not allocate.
+*/
+
+#define PID_MAX_THREADS 4096 // threads tracked; later ones are counted but not read
+#define PID_TOP_THREADS 8
+#define PID_COMM_LEN 16 // TASK_COMM_LEN of the kernel
+#define PID_PATH_LEN 48 // "/proc/<pid>/task/<tid>/stat" with 10-digit ids
+#define PID_STAT_BUF 1024
+#define PID_ROLLUP_BUF 4096
+#define PID_SPARE_FDS 64 // descriptors left to the rest of the tool
+#define PID_PANEL_ROWS (4 + PID_TOP_THREADS) // process, memory and I/O lines, thread title, threads, blank line
+
+typedef struct {
+    int tid;
+    char path[PID_PATH_LEN];
+    procFile file;
+    unsigned long long ticks;
+    bool primed;
+    char comm[PID_COMM_LEN];
+}pidThread;
+///_|> descry: One thread of the tracked process
+///_|> members:
+///_|>     - tid: thread id, the table is sorted on it, type int
+///_|>     - path / file: "/proc/<pid>/task/<tid>/stat" and its descriptor; file.abs_path points into path, so it
+///_|>                    is fixed up whenever an entry is copied, type char[] / procFile
+///_|>     - ticks / primed: utime + stime at the previous tick and whether there was one, type unsigned long long / bool
+///_|>     - comm: thread name, type char[]
+
+typedef struct {
+    int tid;
+    float cpu;
+    char comm[PID_COMM_LEN];
+}pidThreadRate;
+///_|> descry: CPU use of one thread over the last interval
+///_|> members:
+///_|>     - tid: thread id, type int
+///_|>     - cpu: CPU time in percent of one CPU, type float
+///_|>     - comm: thread name, type char[]
+
+typedef struct {
+    long long timestamp_ns;
+    float cpu;
+    float cpu_machine;
+    int threads;
+    float rss_mb;
+    float pss_mb;
+    float swap_mb;
+    float read_rate;
+    float write_rate;
+    int top_count;
+    pidThreadRate top[PID_TOP_THREADS];
+    unsigned long long relists;
+}pidSample;
+///_|> descry: One timestamped reading of the tracked process
+///_|> members:
+///_|>     - timestamp_ns: monotonic time the reading was taken in nanoseconds, type long long
+///_|>     - cpu / cpu_machine: CPU time of all threads in percent of one CPU and of all online CPUs, -1 on the
+///_|>                          first reading, type float
+///_|>     - threads: thread count from /proc/N/stat, type int
+///_|>     - rss_mb / pss_mb / swap_mb: resident, proportional and swapped-out memory in MB; PSS is the RSS and
+///_|>                                  swap -1 when smaps_rollup cannot be read, type float
+///_|>     - read_rate / write_rate: bytes per second read from and written to storage, -1 when /proc/N/io
+///_|>                               cannot be read or on the first reading, type float
+///_|>     - top_count / top: busiest threads over the interval, busiest first, type int / pidThreadRate[]
+///_|>     - relists: times the thread table was rebuilt from /proc/N/task so far, type unsigned long long
+
+typedef struct {
+    int pid;
+    char stat_path[PID_PATH_LEN];
+    char rollup_path[PID_PATH_LEN];
+    char io_path[PID_PATH_LEN];
+    char task_path[PID_PATH_LEN];
+    procFile stat;
+    procFile rollup;
+    procFile io;
+    bool rollup_ok;
+    bool io_ok;
+    char* buf;
+    pidThread* threads;
+    pidThread* spare;
+    int* tids;
+    int thread_count;
+    int listed;
+    int fd_budget;
+    unsigned long long relists;
+    unsigned long long prev_ticks;
+    unsigned long long prev_read;
+    unsigned long long prev_write;
+    long long prev_ns;
+    long ticks_per_sec;
+    int cpus;
+    long page_kb;
+}pidCollector;
+///_|> descry: Open descriptors and thread table of the --pid collector; tables are taken from the process arena
+///_|>         at start-up, sized for PID_MAX_THREADS
+///_|> members:
+///_|>     - pid: tracked process, type int
+///_|>     - stat_path / rollup_path / io_path / task_path: its files under /proc, type char[]
+///_|>     - stat / rollup / io: descriptors kept open across ticks, type procFile
+///_|>     - rollup_ok / io_ok: whether smaps_rollup and io could be read (kernel support, permissions), type bool
+///_|>     - buf: read buffer of PID_ROLLUP_BUF bytes shared by all files, type char*
+///_|>     - threads / thread_count: thread table sorted by tid, type pidThread* / int
+///_|>     - spare / tids: second table and tid list used while /proc/N/task is merged in, type pidThread* / int*
+///_|>     - listed: threads found by the last listing, including those beyond PID_MAX_THREADS, type int
+///_|>     - fd_budget: threads whose descriptor stays open; the others are reopened every tick, type int
+///_|>     - relists: times the thread table was rebuilt, type unsigned long long
+///_|>     - prev_ticks / prev_read / prev_write / prev_ns: process counters and monotonic time of the previous
+///_|>                                                    tick, prev_ns 0 before the first, type unsigned long long / long long
+///_|>     - ticks_per_sec / cpus / page_kb: clock ticks per second, online CPUs and page size in kB, type long / int / long
+
+int pid_collector_init(pidCollector* collector, int pid);
+
+int pid_collector_sample(pidCollector* collector, pidSample* sample);
+
+void pid_collector_close(pidCollector* collector);
+
+void draw_pid_panel(const pidSample* sample, int pid);
+
+#endif
@@ -57,4 +57,29 @@ void kill_all_children(pid_t child1, pid_t child2){
             perror("Failed to send SIGTERM to child2 group");
         }
     }
+}
+
+ssize_t read_full(int fd, void* buf, size_t len){
+    ///_|> descry: reads exactly len bytes unless EOF or an error occurs; a signal that arrives before
+    ///_|>         any byte was read is reported to the caller so it can check its signal flags
+    ///_|> fd: file descriptor to read from, type int
+    ///_|> buf: destination buffer of at least len bytes, type void*
+    ///_|> len: number of bytes to read, type size_t
+    ///_|> returning: returns len on success, 0 on EOF before any byte, -1 on error or early EINTR
+    size_t done = 0;
+    while (done < len){
+        ssize_t got = read(fd, (char*)buf + done, len - done);
+        if (got == 0){
+            // EOF in the middle of a record is treated as an error
+            if (done == 0) return 0;
+            errno = EPIPE;
+            return -1;
+        }
+        if (got == -1){
+            if (errno == EINTR && done > 0) continue; // never leave a record half read
+            return -1;
+        }
+        done += (size_t)got;
+    }
+    return (ssize_t)done;
 }
\ No newline at end of file
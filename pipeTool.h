@@ -27,4 +27,6 @@ void exit_failure_with_two_pipe_close(int* fd1, int* fd2);
 
 void kill_all_children(pid_t child1, pid_t child2);
 
+ssize_t read_full(int fd, void* buf, size_t len);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "procParse.h"
+
+static unsigned long long append_digits(unsigned long long acc, const char* digits, int count){
+    ///_|> descry: appends count decimal digits to acc, one digit at a time
+    ///_|> acc: value of the digits before them, type unsigned long long
+    ///_|> digits / count: the digits, all '0'..'9', type const char* / int
+    ///_|> returning: returns acc * 10^count + the value of the digits
+    for (; count > 0; count--, digits++) acc = acc * 10 + (unsigned long long)(*digits - '0');
+    return acc;
+}
+
+int procparse_fields(const char* text, unsigned long long* values, int max_values, const char** end){
+    ///_|> descry: parses a run of blank-separated decimal fields; leading blanks are skipped and the run ends
+    ///_|>         at the first byte that is neither a blank nor a digit, or after max_values fields
+    ///_|> text: NUL-terminated text, e.g. just after the "cpu3" of a /proc/stat line, type const char*
+    ///_|> values: receives the fields, type unsigned long long*
+    ///_|> max_values: capacity of values, type int
+    ///_|> end: receives the position just past the last parsed field (text if none), NULL to ignore, type const char**
+    ///_|> returning: returns the number of fields parsed
+    const char* p = text;
+    const char* last = text;
+    int count = 0;
+    while (count < max_values){
+        while (*p == ' ') p++;
+        const char* digits = p;
+        while ((unsigned char)(*p - '0') <= 9) p++;
+        if (p == digits) break;
+        values[count++] = append_digits(0, digits, (int)(p - digits));
+        last = p;
+    }
+    if (end != NULL) *end = last;
+    return count;
+}
+
+const char* procparse_u64(const char* text, unsigned long long* value){
+    ///_|> descry: parses one decimal value after optional blanks (spaces and tabs)
+    ///_|> text: NUL-terminated text, type const char*
+    ///_|> value: receives the value, type unsigned long long*
+    ///_|> returning: returns the position just past the digits, NULL if there are none
+    while (*text == ' ' || *text == '\t') text++;
+    const char* p = text;
+    while ((unsigned char)(*p - '0') <= 9) p++;
+    if (p == text) return NULL;
+    *value = append_digits(0, text, (int)(p - text));
+    return p;
+}
+
+const char* procparse_decimal(const char* text, double* value){
+    ///_|> descry: parses one non-negative decimal number with an optional fraction ("0.43"), as in /proc/loadavg
+    ///_|> text: NUL-terminated text, type const char*
+    ///_|> value: receives the number, type double*
+    ///_|> returning: returns the position just past the number, NULL if there is none
+    unsigned long long whole;
+    const char* p = procparse_u64(text, &whole);
+    if (p == NULL) return NULL;
+    *value = (double)whole;
+    if (*p == '.'){
+        unsigned long long fraction = 0;
+        const char* digits = p + 1;
+        const char* q = digits;
+        while ((unsigned char)(*q - '0') <= 9 && q - digits < 18) q++;
+        fraction = append_digits(0, digits, (int)(q - digits));
+        double scale = 1.0;
+        for (const char* d = digits; d < q; d++) scale *= 10.0;
+        *value += (double)fraction / scale;
+        for (p = q; (unsigned char)(*p - '0') <= 9; p++){} // digits beyond double precision
+    }
+    return p;
+}
+
+int procparse_find_u64(const char* text, const char* key, unsigned long long* value){
+    ///_|> descry: value of the first "key value", "key: value" or "key\t: value" line (meminfo, numastat,
+    ///_|>         cpuinfo); the key is looked up as a substring like strstr does
+    ///_|> text: NUL-terminated file contents, type const char*
+    ///_|> key: name of the value, without the ':', type const char*
+    ///_|> value: receives the value, type unsigned long long*
+    ///_|> returning: returns 0 on success, -1 if the key is missing or not followed by a number
+    const char* at = strstr(text, key);
+    if (at == NULL) return -1;
+    at += strlen(key);
+    while (*at == ' ' || *at == '\t') at++;
+    if (*at == ':') at++;
+    return (procparse_u64(at, value) != NULL) ? 0 : -1;
+}
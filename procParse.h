@@ -0,0 +1,26 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef PROC_PARSE_HEADER
+#define PROC_PARSE_HEADER
+
+/*
+This module is the number parser shared by the collectors. Most procfs and sysfs values are runs of
+blank-separated decimal integers (the cpu lines of /proc/stat, the counter columns of /proc/interrupts,
+"key value" lines), so procparse_fields takes a whole run in one pass over the bytes instead of one
+format-string interpretation per field as the sscanf calls it replaces, and never reads past the
+terminating NUL. Single values and "key: value" lines have their own helpers.
+*/
+
+int procparse_fields(const char* text, unsigned long long* values, int max_values, const char** end);
+
+const char* procparse_u64(const char* text, unsigned long long* value);
+
+const char* procparse_decimal(const char* text, double* value);
+
+int procparse_find_u64(const char* text, const char* key, unsigned long long* value);
+
+#endif
@@ -0,0 +1,87 @@
+#define _POSIX_C_SOURCE 200809L
+#include "procRoot.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+static char proc_root[256] = "";
+static int proc_root_generation = 0;
+///_|> descry: internal root prefix (empty string means the real filesystem) and a counter bumped on
+///_|>         every change so cached procFile descriptors know when to reopen
+
+void set_proc_root(const char* root){
+    ///_|> descry: sets the directory that replaces "/" for procfs/sysfs reads; a trailing '/' is removed
+    ///_|> root: directory containing proc/ and sys/, NULL or "" to use the real filesystem, type const char*
+    ///_|> returning: this function does not return anything
+    proc_root_generation++;
+    if (root == NULL){
+        proc_root[0] = '\0';
+        return;
+    }
+    snprintf(proc_root, sizeof(proc_root), "%s", root);
+    size_t len = strlen(proc_root);
+    while (len > 0 && proc_root[len - 1] == '/'){
+        proc_root[--len] = '\0';
+    }
+}
+
+int proc_root_is_set(){
+    ///_|> descry: checks whether collectors read from a fixture root
+    ///_|> returning: returns 1 if a root other than "/" is set, otherwise 0
+    return proc_root[0] != '\0';
+}
+
+const char* proc_path(char* buf, size_t size, const char* abs_path){
+    ///_|> descry: builds the path a collector should open for a procfs/sysfs file
+    ///_|> buf: buffer receiving the path, type char*
+    ///_|> size: size of buf, type size_t
+    ///_|> abs_path: absolute path on a real system, e.g. "/proc/stat", type const char*
+    ///_|> returning: returns buf for convenient use in fopen()
+    snprintf(buf, size, "%s%s", proc_root, abs_path);
+    return buf;
+}
+
+
+int proc_file_fd(procFile* file){
+    ///_|> descry: returns the cached descriptor of a procFile, opening or reopening it (after a root change)
+    ///_|> file: cached file, type procFile*
+    ///_|> returning: returns the open fd, or -1 on failure (errno set)
+    if (file->fd != -1 && file->generation != proc_root_generation){
+        proc_file_close(file);
+    }
+    if (file->fd == -1){
+        char path[320];
+        file->fd = open(proc_path(path, sizeof(path), file->abs_path), O_RDONLY | O_CLOEXEC);
+        if (file->fd == -1) return -1;
+        file->generation = proc_root_generation;
+    }
+    return file->fd;
+}
+
+ssize_t proc_file_read(procFile* file, char* buf, size_t size){
+    ///_|> descry: reads a whole procfs/sysfs file (up to size-1 bytes) from offset 0 through a cached fd
+    ///_|>         and NUL-terminates it; opens or reopens the file when needed
+    ///_|> file: cached file, type procFile*
+    ///_|> buf: destination buffer, type char*
+    ///_|> size: size of buf, type size_t
+    ///_|> returning: returns the number of bytes read, or -1 on failure (errno set)
+    if (proc_file_fd(file) == -1) return -1;
+    size_t done = 0;
+    while (done < size - 1){
+        ssize_t got = pread(file->fd, buf + done, size - 1 - done, (off_t)done);
+        if (got == -1) return -1;
+        if (got == 0) break;
+        done += (size_t)got;
+    }
+    buf[done] = '\0';
+    return (ssize_t)done;
+}
+
+void proc_file_close(procFile* file){
+    ///_|> descry: closes the cached descriptor of a procFile
+    ///_|> file: cached file, type procFile*
+    ///_|> returning: this function does not return anything
+    if (file->fd != -1){
+        close(file->fd);
+        file->fd = -1;
+    }
+}
\ No newline at end of file
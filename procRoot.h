@@ -0,0 +1,43 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/types.h>
+
+#ifndef PROC_ROOT_HEADER
+#define PROC_ROOT_HEADER
+
+/*
+This module lets every collector read procfs/sysfs below a configurable root directory 
+(--proc-root=DIR) instead of "/", so collectors and benchmarks can run against fixture trees.
+Collectors keep using the real absolute paths (e.g. "/proc/stat") and pass them through proc_path().
+procFile keeps such a file open across samples and re-reads it with pread, so a sampling tick costs 
+one syscall and no allocation; it reopens itself when the root changes.
+*/
+
+typedef struct {
+    const char* abs_path;
+    int fd;
+    int generation;
+}procFile;
+///_|> descry: A procfs/sysfs file kept open across samples
+///_|> members:
+///_|>     - abs_path: absolute path on a real system, e.g. "/proc/stat", type const char*
+///_|>     - fd: open descriptor, -1 until the first read, type int
+///_|>     - generation: proc root generation the fd was opened under, type int
+
+#define PROC_FILE_INIT(path) {path, -1, -1}
+
+void set_proc_root(const char* root);
+
+int proc_root_is_set();
+
+const char* proc_path(char* buf, size_t size, const char* abs_path);
+
+int proc_file_fd(procFile* file);
+
+ssize_t proc_file_read(procFile* file, char* buf, size_t size);
+
+void proc_file_close(procFile* file);
+
+#endif
@@ -0,0 +1,178 @@
+#define _GNU_SOURCE
+#include "samplerTuning.h"
+#include <errno.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+static bool tuning_requested = false;
+static pid_t tuning_pid = -1;
+static int mlock_flags = 0;
+///_|> descry: whether any setting was asked for, the process that applied them, and the mlockall() flags
+///_|>         that worked there (0 when memory is not locked), repeated by every producer process
+
+static cpu_set_t saved_affinity;
+static bool affinity_changed = false;
+static struct sched_param saved_param;
+static int saved_policy = SCHED_OTHER;
+static bool policy_changed = false;
+static int saved_nice = 0;
+static bool nice_changed = false;
+///_|> descry: settings of the main process before sampler_tuning_apply, restored by sampler_tuning_release
+
+static char applied_notes[256] = "";
+static char denied_notes[256] = "";
+///_|> descry: what was applied and what was skipped, for the report on exit
+
+static void append_note(char* list, size_t size, const char* note){
+    ///_|> descry: appends one entry to a comma-separated list
+    ///_|> list / size: NUL-terminated list and its buffer size, type char* / size_t
+    ///_|> note: entry to append, type const char*
+    ///_|> returning: this function does not return anything
+    size_t len = strlen(list);
+    if (len + 1 >= size) return;
+    snprintf(list + len, size - len, "%s%s", (len > 0) ? ", " : "", note);
+}
+
+static void deny(const char* setting, int err, const char* fallback){
+    ///_|> descry: reports a setting the tool could not make; the run continues without it
+    ///_|> setting: the setting as given, e.g. "SCHED_FIFO 10", type const char*
+    ///_|> err: errno of the failed call, type int
+    ///_|> fallback: what the samplers do instead, type const char*
+    ///_|> returning: this function does not return anything
+    fprintf(stderr, "%s not applied (%s), %s\n", setting, strerror(err), fallback);
+    char note[96];
+    snprintf(note, sizeof(note), "%s (%s)", setting, (err == EPERM || err == EACCES) ? "no permission" : strerror(err));
+    append_note(denied_notes, sizeof(denied_notes), note);
+}
+
+static void pin_cpu(int cpu){
+    ///_|> descry: restricts the calling process to one CPU, remembering its previous affinity
+    ///_|> cpu: CPU number, type int
+    ///_|> returning: this function does not return anything
+    char setting[48];
+    snprintf(setting, sizeof(setting), "CPU %d", cpu);
+    if (sched_getaffinity(0, sizeof(saved_affinity), &saved_affinity) == -1){
+        deny(setting, errno, "samplers run on any CPU");
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &saved_affinity)){
+        deny(setting, EINVAL, "samplers run on any CPU"); // offline, missing or outside our cpuset
+        return;
+    }
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) == -1){
+        deny(setting, errno, "samplers run on any CPU");
+        return;
+    }
+    affinity_changed = true;
+    char note[48];
+    snprintf(note, sizeof(note), "pinned to CPU %d", cpu);
+    append_note(applied_notes, sizeof(applied_notes), note);
+}
+
+static void set_nice(int nice_value){
+    ///_|> descry: sets the nice value of the calling process, remembering the previous one
+    ///_|> nice_value: nice value from -20 to 19, type int
+    ///_|> returning: this function does not return anything
+    char setting[48];
+    snprintf(setting, sizeof(setting), "nice %d", nice_value);
+    errno = 0;
+    saved_nice = getpriority(PRIO_PROCESS, 0);
+    if ((saved_nice == -1 && errno != 0) || setpriority(PRIO_PROCESS, 0, nice_value) == -1){
+        deny(setting, errno, "samplers keep the current nice value");
+        return;
+    }
+    nice_changed = true;
+    append_note(applied_notes, sizeof(applied_notes), setting);
+}
+
+static void set_fifo(int priority){
+    ///_|> descry: switches the calling process to SCHED_FIFO, remembering its previous policy
+    ///_|> priority: real-time priority, clamped to what the system supports, type int
+    ///_|> returning: this function does not return anything
+    int max_priority = sched_get_priority_max(SCHED_FIFO);
+    if (max_priority > 0 && priority > max_priority) priority = max_priority;
+    char setting[48];
+    snprintf(setting, sizeof(setting), "SCHED_FIFO %d", priority);
+    saved_policy = sched_getscheduler(0);
+    if (saved_policy == -1 || sched_getparam(0, &saved_param) == -1){
+        deny(setting, errno, "samplers keep the normal policy");
+        return;
+    }
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = priority;
+    if (sched_setscheduler(0, SCHED_FIFO, &param) == -1){
+        deny(setting, errno, "samplers keep the normal policy");
+        return;
+    }
+    policy_changed = true;
+    append_note(applied_notes, sizeof(applied_notes), setting);
+}
+
+static void lock_memory(){
+    ///_|> descry: locks the memory of the main process; future mappings too when the locked-memory
+    ///_|>         limit allows it, since with a finite limit MCL_FUTURE makes later allocations fail
+    ///_|> returning: this function does not return anything
+    struct rlimit limit;
+    bool unlimited = (getrlimit(RLIMIT_MEMLOCK, &limit) == 0 && limit.rlim_cur == RLIM_INFINITY) || geteuid() == 0;
+    int flags = unlimited ? (MCL_CURRENT | MCL_FUTURE) : MCL_CURRENT;
+    if (mlockall(flags) == -1){
+        deny("mlockall", errno, "memory stays pageable");
+        return;
+    }
+    mlock_flags = flags;
+    append_note(applied_notes, sizeof(applied_notes), unlimited ? "memory locked" : \
+                "memory locked at start-up only (RLIMIT_MEMLOCK)");
+}
+
+void sampler_tuning_apply(const CLAInfo* cla){
+    ///_|> descry: applies --pin-cpu, --nice, --sched-fifo and --mlock to the main process, before it starts
+    ///_|>         the producers that inherit them; every setting that fails is reported and skipped
+    ///_|> cla: parsed command-line arguments, type const CLAInfo*
+    ///_|> returning: this function does not return anything
+    if (cla->pin_cpu < 0 && cla->fifo_priority == 0 && cla->nice_value == SAMPLER_NICE_UNSET && !cla->mlock) return;
+    tuning_requested = true;
+    tuning_pid = getpid();
+    if (cla->pin_cpu >= 0) pin_cpu(cla->pin_cpu);
+    if (cla->nice_value != SAMPLER_NICE_UNSET) set_nice(cla->nice_value);
+    if (cla->fifo_priority > 0) set_fifo(cla->fifo_priority);
+    if (cla->mlock) lock_memory();
+}
+
+void sampler_tuning_child(){
+    ///_|> descry: locks the memory of a producer process, since fork() does not inherit memory locks;
+    ///_|>         does nothing in the main process and its threads, or when --mlock is off or failed
+    ///_|> returning: this function does not return anything
+    if (mlock_flags == 0 || getpid() == tuning_pid) return;
+    if (mlockall(mlock_flags) == -1) perror("mlockall in a producer failed, its memory stays pageable");
+}
+
+void sampler_tuning_release(){
+    ///_|> descry: returns the calling thread (the consumer, once the producers have started) to the
+    ///_|>         affinity, policy and nice value it had; a positive --nice cannot be taken back without
+    ///_|>         privileges, and the memory lock stays since it covers the whole process
+    ///_|> returning: this function does not return anything
+    if (policy_changed) sched_setscheduler(0, saved_policy, &saved_param);
+    // lowering the nice value again needs CAP_SYS_NICE; without it the consumer keeps the samplers' one
+    if (nice_changed) setpriority(PRIO_PROCESS, 0, saved_nice);
+    if (affinity_changed) sched_setaffinity(0, sizeof(saved_affinity), &saved_affinity);
+}
+
+void sampler_tuning_report(FILE* out){
+    ///_|> descry: prints the settings the samplers ran with and the achieved tick jitter
+    ///_|> out: stream to print to, type FILE*
+    ///_|> returning: this function does not return anything
+    if (!tuning_requested) return;
+    SelfStatsSummary summary;
+    self_stats_summary(&summary);
+    const StageSummary* jitter = &summary.stages[STAGE_TICK_JITTER];
+    fprintf(out, "\nSamplers: %s%s%s\n", applied_notes[0] ? applied_notes : "default scheduling", \
+            denied_notes[0] ? "; not applied: " : "", denied_notes);
+    fprintf(out, "Tick jitter over %llu wake-ups: p50 %.1f us, p99 %.1f us, max %.1f us\n", jitter->count, \
+            jitter->p50_ns / 1e3, jitter->p99_ns / 1e3, jitter->max_ns / 1e3);
+}
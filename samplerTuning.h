@@ -0,0 +1,35 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "CLA.h"
+#include "selfStats.h"
+
+#ifndef SAMPLER_TUNING_HEADER
+#define SAMPLER_TUNING_HEADER
+
+/*
+This module makes the samplers wake up on time on a loaded host: --pin-cpu=N pins them to one CPU,
+--sched-fifo[=PRIO] runs them under the real-time SCHED_FIFO policy, --nice=N sets their nice value,
+and --mlock locks the tool's memory so that a tick never waits for a page fault.
+The settings are applied to the main process before the producers start, since forked children
+and new threads inherit affinity, policy and nice; the consumer then returns to its own settings so
+that rendering never competes with the samplers. Memory locks are not inherited by fork(), so every
+producer process locks its own memory when it starts.
+Each setting the tool is not allowed to make (no CAP_SYS_NICE, RLIMIT_RTPRIO or RLIMIT_MEMLOCK too
+low, CPU not in the allowed set) is reported and skipped, and the run continues without it.
+On exit the achieved settings are printed with the tick jitter (p50/p99/max of how late the
+producers woke up, the tick_jitter stage of selfStats).
+Like selfStats, the state is module-level state of the main process.
+*/
+
+void sampler_tuning_apply(const CLAInfo* cla);
+
+void sampler_tuning_child();
+
+void sampler_tuning_release();
+
+void sampler_tuning_report(FILE* out);
+
+#endif
@@ -0,0 +1,130 @@
+#include "selfStats.h"
+
+static LatencyHist stage_hists[STAGE_COUNT];
+///_|> descry: internal per-stage histograms of the consumer process
+
+static long long live_producers_cpu_us = 0;
+static long live_producers_max_rss_kb = 0;
+///_|> descry: latest usage reported by running producers (RUSAGE_CHILDREN only covers reaped ones)
+
+static const char* stage_names[STAGE_COUNT] = {"fetch_cpu", "fetch_mem", "pipe_hop", "render", "tick_jitter", "pair_skew"};
+
+static int hist_index(long long value){
+    ///_|> descry: maps a value to its bucket: exact below 2^HIST_SUB_BITS, then HIST_SUB_COUNT buckets per power of two
+    ///_|> value: non-negative value in nanoseconds, type long long
+    ///_|> returning: returns the bucket index
+    if (value < HIST_SUB_COUNT) return (int)value;
+    int exp = 63 - __builtin_clzll((unsigned long long)value);
+    if (exp > HIST_MAX_EXP) return HIST_BUCKETS - 1;
+    int sub = (int)((value >> (exp - HIST_SUB_BITS)) & (HIST_SUB_COUNT - 1));
+    return (exp - HIST_SUB_BITS + 1) * HIST_SUB_COUNT + sub;
+}
+
+static long long hist_bucket_value(int index){
+    ///_|> descry: returns the upper edge of a bucket, used as the reported value of a percentile
+    ///_|> index: bucket index, type int
+    ///_|> returning: returns the largest value mapping to this bucket
+    if (index < 2 * HIST_SUB_COUNT) return index;
+    int exp = index / HIST_SUB_COUNT + HIST_SUB_BITS - 1;
+    long long sub = index % HIST_SUB_COUNT;
+    long long lower = (HIST_SUB_COUNT + sub) << (exp - HIST_SUB_BITS);
+    return lower + (1LL << (exp - HIST_SUB_BITS)) - 1;
+}
+
+void hist_record(LatencyHist* hist, long long value_ns){
+    ///_|> descry: adds one value to a histogram
+    ///_|> hist: pointer to the histogram, type LatencyHist*
+    ///_|> value_ns: value in nanoseconds, negative values are recorded as 0, type long long
+    ///_|> returning: this function does not return anything
+    if (value_ns < 0) value_ns = 0;
+    hist->counts[hist_index(value_ns)]++;
+    if (hist->total == 0 || value_ns < hist->min) hist->min = value_ns;
+    if (hist->total == 0 || value_ns > hist->max) hist->max = value_ns;
+    hist->total++;
+}
+
+long long hist_percentile(const LatencyHist* hist, double percentile){
+    ///_|> descry: computes a percentile from the bucket counts
+    ///_|> hist: pointer to the histogram, type const LatencyHist*
+    ///_|> percentile: percentile between 0 and 100, type double
+    ///_|> returning: returns the percentile in nanoseconds (clamped to the exact max), 0 if empty
+    if (hist->total == 0) return 0;
+    unsigned long long rank = (unsigned long long)(percentile / 100.0 * hist->total + 0.5);
+    if (rank < 1) rank = 1;
+    unsigned long long seen = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++){
+        seen += hist->counts[i];
+        if (seen >= rank){
+            long long value = hist_bucket_value(i);
+            return (value > hist->max) ? hist->max : value;
+        }
+    }
+    return hist->max;
+}
+
+long long rusage_cpu_us(const struct rusage* usage){
+    ///_|> descry: adds user and system CPU time of a rusage
+    ///_|> usage: pointer to a filled rusage struct, type const struct rusage*
+    ///_|> returning: returns user+system time in microseconds
+    return (long long)(usage->ru_utime.tv_sec + usage->ru_stime.tv_sec) * 1000000LL + \
+           usage->ru_utime.tv_usec + usage->ru_stime.tv_usec;
+}
+
+void self_stats_record(int stage, long long value_ns){
+    ///_|> descry: records one measurement of a pipeline stage in this process
+    ///_|> stage: one of PipelineStage, type int
+    ///_|> value_ns: measured latency in nanoseconds, type long long
+    ///_|> returning: this function does not return anything
+    if (stage < 0 || stage >= STAGE_COUNT) return;
+    hist_record(&stage_hists[stage], value_ns);
+}
+
+void self_stats_set_producers(long long cpu_us, long max_rss_kb){
+    ///_|> descry: stores the latest usage reported by the running producers
+    ///_|> cpu_us: user+system CPU time of all producers in microseconds, type long long
+    ///_|> max_rss_kb: peak RSS of the largest producer in KB, type long
+    ///_|> returning: this function does not return anything
+    live_producers_cpu_us = cpu_us;
+    live_producers_max_rss_kb = max_rss_kb;
+}
+
+void self_stats_summary(SelfStatsSummary* out){
+    ///_|> descry: fills a summary with current usage and stage percentiles
+    ///_|> out: pointer to the summary to fill, type SelfStatsSummary*
+    ///_|> returning: this function does not return anything
+    struct rusage self_usage;
+    struct rusage children_usage;
+    getrusage(RUSAGE_SELF, &self_usage);
+    getrusage(RUSAGE_CHILDREN, &children_usage);
+    out->self_cpu_us = rusage_cpu_us(&self_usage);
+    out->self_max_rss_kb = self_usage.ru_maxrss;
+    // reaped producers are accounted by the kernel, running ones by their own reports
+    long long reaped_cpu_us = rusage_cpu_us(&children_usage);
+    out->producers_cpu_us = (reaped_cpu_us > live_producers_cpu_us) ? reaped_cpu_us : live_producers_cpu_us;
+    out->producers_max_rss_kb = (children_usage.ru_maxrss > live_producers_max_rss_kb) ? \
+                                children_usage.ru_maxrss : live_producers_max_rss_kb;
+    for (int i = 0; i < STAGE_COUNT; i++){
+        const LatencyHist* hist = &stage_hists[i];
+        out->stages[i].count = hist->total;
+        out->stages[i].p50_ns = hist_percentile(hist, 50.0);
+        out->stages[i].p90_ns = hist_percentile(hist, 90.0);
+        out->stages[i].p99_ns = hist_percentile(hist, 99.0);
+        out->stages[i].max_ns = hist->total ? hist->max : 0;
+    }
+}
+
+void self_stats_print(FILE* out){
+    ///_|> descry: prints the self-overhead report (usage and one histogram line per stage)
+    ///_|> out: stream to print to, type FILE*
+    ///_|> returning: this function does not return anything
+    SelfStatsSummary summary;
+    self_stats_summary(&summary);
+    fprintf(out, "\nSelf stats: cpu %.3f s (main) + %.3f s (producers), max RSS %ld KB (main) / %ld KB (largest producer)\n", \
+            summary.self_cpu_us / 1e6, summary.producers_cpu_us / 1e6, summary.self_max_rss_kb, summary.producers_max_rss_kb);
+    fprintf(out, "  %-12s %8s %10s %10s %10s %10s\n", "stage", "count", "p50(us)", "p90(us)", "p99(us)", "max(us)");
+    for (int i = 0; i < STAGE_COUNT; i++){
+        StageSummary* st = &summary.stages[i];
+        fprintf(out, "  %-12s %8llu %10.1f %10.1f %10.1f %10.1f\n", stage_names[i], st->count, \
+                st->p50_ns / 1e3, st->p90_ns / 1e3, st->p99_ns / 1e3, st->max_ns / 1e3);
+    }
+}
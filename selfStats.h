@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#ifndef SELF_STATS_HEADER
+#define SELF_STATS_HEADER
+
+/*
+This module measures the monitor's own overhead (--self-stats). It keeps one HDR-style log-linear
+latency histogram per pipeline stage (fetch, pipe hop, render, tick jitter) in module-level state,
+like signalHandler keeps its flag, so any function of the consumer process can record into it.
+Producers measure their stages locally and ship the numbers with each sample (sampleTiming).
+CPU time and RSS come from getrusage(RUSAGE_SELF) plus RUSAGE_CHILDREN once the producers are reaped,
+and from the usage the producers report about themselves while they are still running.
+*/
+
+#define HIST_SUB_BITS 5
+#define HIST_SUB_COUNT (1 << HIST_SUB_BITS)
+#define HIST_MAX_EXP 47
+#define HIST_BUCKETS ((HIST_MAX_EXP - HIST_SUB_BITS + 2) * HIST_SUB_COUNT)
+
+typedef enum {
+    STAGE_FETCH_CPU = 0,
+    STAGE_FETCH_MEM,
+    STAGE_PIPE_HOP,
+    STAGE_RENDER,
+    STAGE_TICK_JITTER,
+    STAGE_PAIR_SKEW,
+    STAGE_COUNT
+}PipelineStage;
+///_|> descry: Stages with their own latency histogram
+///_|> members:
+///_|>     - STAGE_FETCH_CPU: time spent in get_cpuInfo in the CPU producer
+///_|>     - STAGE_FETCH_MEM: time spent in get_MemoryInfo in the memory producer
+///_|>     - STAGE_PIPE_HOP: from a reading being ready in a producer to the consumer receiving it
+///_|>     - STAGE_RENDER: time spent in draw_* for one frame
+///_|>     - STAGE_TICK_JITTER: how late a producer woke up compared to its schedule
+///_|>     - STAGE_PAIR_SKEW: time between the CPU and memory reads that were paired into one sample
+
+typedef struct {
+    unsigned long long counts[HIST_BUCKETS];
+    unsigned long long total;
+    long long min;
+    long long max;
+}LatencyHist;
+///_|> descry: Log-linear histogram of nanosecond values with ~3% relative bucket width
+///_|> members:
+///_|>     - counts: number of values per bucket, type unsigned long long[HIST_BUCKETS]
+///_|>     - total: number of recorded values, type unsigned long long
+///_|>     - min / max: exact extremes of recorded values, type long long
+
+typedef struct {
+    unsigned long long count;
+    long long p50_ns;
+    long long p90_ns;
+    long long p99_ns;
+    long long max_ns;
+}StageSummary;
+///_|> descry: Percentile summary of one stage histogram
+///_|> members:
+///_|>     - count: number of recorded values, type unsigned long long
+///_|>     - p50_ns / p90_ns / p99_ns / max_ns: percentiles and maximum in nanoseconds, type long long
+
+typedef struct {
+    long long self_cpu_us;
+    long long producers_cpu_us;
+    long self_max_rss_kb;
+    long producers_max_rss_kb;
+    StageSummary stages[STAGE_COUNT];
+}SelfStatsSummary;
+///_|> descry: Snapshot of the tool's own overhead, printed on exit and published on the daemon stream
+///_|> members:
+///_|>     - self_cpu_us: user+system CPU time of this process in microseconds, type long long
+///_|>     - producers_cpu_us: user+system CPU time of all producer processes in microseconds, type long long
+///_|>     - self_max_rss_kb: peak RSS of this process in KB, type long
+///_|>     - producers_max_rss_kb: peak RSS of the largest producer process in KB, type long
+///_|>     - stages: percentile summary per PipelineStage, type StageSummary[STAGE_COUNT]
+
+void hist_record(LatencyHist* hist, long long value_ns);
+
+long long hist_percentile(const LatencyHist* hist, double percentile);
+
+long long rusage_cpu_us(const struct rusage* usage);
+
+void self_stats_record(int stage, long long value_ns);
+
+void self_stats_set_producers(long long cpu_us, long max_rss_kb);
+
+void self_stats_summary(SelfStatsSummary* out);
+
+void self_stats_print(FILE* out);
+
+#endif
@@ -0,0 +1,160 @@
+#define _POSIX_C_SOURCE 200809L
+#include "shmSnapshot.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static int segment_is_stale(const char* name){
+    ///_|> descry: tells whether an existing segment may be replaced: it was never initialized, or the
+    ///_|>         process that created it no longer exists
+    ///_|> name: POSIX shared-memory name starting with '/', type const char*
+    ///_|> returning: returns 1 if it is stale, 0 if its writer is alive, -1 if it cannot be inspected
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd == -1) return (errno == ENOENT) ? 1 : -1; // removed meanwhile
+    struct stat st;
+    if (fstat(fd, &st) == -1){
+        close(fd);
+        return -1;
+    }
+    if (st.st_size < (off_t)sizeof(ShmSnapshot)){
+        close(fd);
+        return 1;
+    }
+    void* mapped = mmap(NULL, sizeof(ShmSnapshot), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) return -1;
+    const ShmSnapshot* shm = (const ShmSnapshot*)mapped;
+    int stale = 1;
+    if (__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) == SHM_SNAPSHOT_MAGIC){
+        pid_t writer = (pid_t)__atomic_load_n(&shm->writer_pid, __ATOMIC_RELAXED);
+        // EPERM: the writer exists but belongs to another user
+        stale = (writer <= 0 || (kill(writer, 0) == -1 && errno == ESRCH)) ? 1 : 0;
+    }
+    munmap(mapped, sizeof(ShmSnapshot));
+    return stale;
+}
+
+ShmSnapshot* shm_snapshot_create(const char* name){
+    ///_|> descry: creates the named segment and maps it read-write for the sampler; a segment left behind
+    ///_|>         by a writer that has exited is replaced, one whose writer is still running is not
+    ///_|> name: POSIX shared-memory name starting with '/', type const char*
+    ///_|> returning: returns the mapped snapshot, or NULL on failure or if another writer owns the name
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd == -1 && errno == EEXIST){
+        int stale = segment_is_stale(name);
+        if (stale == 0){
+            fprintf(stderr, "Another sampler is publishing to shared memory %s, not sharing it\n", name);
+            return NULL;
+        }
+        if (stale == 1){
+            shm_unlink(name);
+            fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+        }
+    }
+    if (fd == -1){
+        perror("shm_open for snapshot failed");
+        return NULL;
+    }
+    if (ftruncate(fd, sizeof(ShmSnapshot)) == -1){
+        perror("ftruncate for snapshot failed");
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+    void* mapped = mmap(NULL, sizeof(ShmSnapshot), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // the mapping keeps the segment alive
+    if (mapped == MAP_FAILED){
+        perror("mmap for snapshot failed");
+        shm_unlink(name);
+        return NULL;
+    }
+    ShmSnapshot* shm = (ShmSnapshot*)mapped;
+    __atomic_store_n(&shm->lock_seq, 0, __ATOMIC_RELAXED);
+    memset(&shm->sample, 0, sizeof(ShmSample));
+    __atomic_store_n(&shm->writer_pid, (int)getpid(), __ATOMIC_RELAXED);
+    __atomic_store_n(&shm->magic, SHM_SNAPSHOT_MAGIC, __ATOMIC_RELEASE);
+    return shm;
+}
+
+void shm_snapshot_publish(ShmSnapshot* shm, float cpu_utiliz, float total_memory, float used_memory, long long wall_ns){
+    ///_|> descry: writes a new sample under the seqlock; only one process may publish into a segment
+    ///_|> shm: snapshot mapped by shm_snapshot_create, type ShmSnapshot*
+    ///_|> cpu_utiliz: CPU utilization in percent, type float
+    ///_|> total_memory: total memory in GB, type float
+    ///_|> used_memory: used memory in GB, type float
+    ///_|> wall_ns: wall-clock time of the sample in nanoseconds, type long long
+    ///_|> returning: this function does not return anything
+    if (shm == NULL) return;
+    unsigned int seq = __atomic_load_n(&shm->lock_seq, __ATOMIC_RELAXED);
+    // odd: readers that start now will retry; the fence keeps the payload stores after it
+    __atomic_store_n(&shm->lock_seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    shm->sample.sample_seq++;
+    shm->sample.wall_ns = wall_ns;
+    shm->sample.cpu_utiliz = cpu_utiliz;
+    shm->sample.total_memory = total_memory;
+    shm->sample.used_memory = used_memory;
+    // even again: publishes the payload
+    __atomic_store_n(&shm->lock_seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+void shm_snapshot_destroy(ShmSnapshot* shm, const char* name){
+    ///_|> descry: unmaps the writer mapping and removes the segment name
+    ///_|> shm: snapshot mapped by shm_snapshot_create, type ShmSnapshot*
+    ///_|> name: POSIX shared-memory name, type const char*
+    ///_|> returning: this function does not return anything
+    if (shm == NULL) return;
+    munmap(shm, sizeof(ShmSnapshot));
+    shm_unlink(name);
+}
+
+ShmSnapshot* shm_snapshot_attach(const char* name){
+    ///_|> descry: maps an existing segment read-only for a reader process
+    ///_|> name: POSIX shared-memory name starting with '/', type const char*
+    ///_|> returning: returns the mapped snapshot, or NULL if it does not exist or is not initialized
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd == -1) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) == -1 || st.st_size < (off_t)sizeof(ShmSnapshot)){
+        close(fd);
+        return NULL;
+    }
+    void* mapped = mmap(NULL, sizeof(ShmSnapshot), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) return NULL;
+    ShmSnapshot* shm = (ShmSnapshot*)mapped;
+    if (__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != SHM_SNAPSHOT_MAGIC){
+        munmap(mapped, sizeof(ShmSnapshot));
+        return NULL;
+    }
+    return shm;
+}
+
+int shm_snapshot_read(const ShmSnapshot* shm, ShmSample* out){
+    ///_|> descry: copies a consistent snapshot of the latest sample, retrying while the writer is active
+    ///_|> shm: snapshot mapped by shm_snapshot_attach, type const ShmSnapshot*
+    ///_|> out: pointer to receive the sample, type ShmSample*
+    ///_|> returning: returns the number of retries needed (>= 0)
+    int retries = 0;
+    while (1){
+        unsigned int before = __atomic_load_n(&shm->lock_seq, __ATOMIC_ACQUIRE);
+        if ((before & 1u) == 0){
+            memcpy(out, (const void*)&shm->sample, sizeof(ShmSample));
+            // keep the payload loads before the second sequence load
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            unsigned int after = __atomic_load_n(&shm->lock_seq, __ATOMIC_RELAXED);
+            if (before == after) return retries;
+        }
+        retries++;
+    }
+}
+
+void shm_snapshot_detach(const ShmSnapshot* shm){
+    ///_|> descry: unmaps a reader mapping
+    ///_|> shm: snapshot mapped by shm_snapshot_attach, type const ShmSnapshot*
+    ///_|> returning: this function does not return anything
+    if (shm != NULL) munmap((void*)shm, sizeof(ShmSnapshot));
+}
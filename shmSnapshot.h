@@ -0,0 +1,65 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef SHM_SNAPSHOT_HEADER
+#define SHM_SNAPSHOT_HEADER
+
+/*
+This module publishes the newest CPU/memory sample into a named POSIX shared-memory segment
+guarded by a seqlock. The sampler is the only writer; any number of local processes can attach
+read-only and take a consistent copy of the latest sample with plain loads (no syscall, no socket).
+The writer creates the segment exclusively and records its pid in it, so a second sampler started
+with the same --shm name refuses to publish instead of mixing its samples into the same seqlock;
+a segment whose writer has exited without removing it is replaced. The pid sits after the sample,
+so readers built against the earlier layout still find the sample where they expect it.
+The reader half (shm_snapshot_attach / shm_snapshot_read / shm_snapshot_detach) only depends on
+this header and is also built as libmonsnapshot.a for other agents.
+*/
+
+#ifndef DEFAULT_SHM_NAME
+#define DEFAULT_SHM_NAME "/myMonitoringTool"
+#endif
+#define SHM_SNAPSHOT_MAGIC 0x4d4f4e31u  // "MON1"
+
+typedef struct {
+    unsigned long long sample_seq;
+    long long wall_ns;
+    float cpu_utiliz;
+    float total_memory;
+    float used_memory;
+}ShmSample;
+///_|> descry: Consistent copy of the latest published sample
+///_|> members:
+///_|>     - sample_seq: number of samples published so far, 0 means nothing published yet, type unsigned long long
+///_|>     - wall_ns: wall-clock time the sample was published in nanoseconds, type long long
+///_|>     - cpu_utiliz: CPU utilization in percent, type float
+///_|>     - total_memory: total memory in GB, type float
+///_|>     - used_memory: used memory in GB, type float
+
+typedef struct {
+    unsigned int magic;
+    unsigned int lock_seq;
+    ShmSample sample;
+    int writer_pid;
+}ShmSnapshot;
+///_|> descry: Layout of the shared segment
+///_|> members:
+///_|>     - magic: SHM_SNAPSHOT_MAGIC once the segment is initialized, type unsigned int
+///_|>     - lock_seq: seqlock counter, odd while the writer is updating sample, type unsigned int
+///_|>     - sample: latest sample, only valid to copy under the seqlock, type ShmSample
+///_|>     - writer_pid: process that created the segment and publishes into it, type int
+
+ShmSnapshot* shm_snapshot_create(const char* name);
+
+void shm_snapshot_publish(ShmSnapshot* shm, float cpu_utiliz, float total_memory, float used_memory, long long wall_ns);
+
+void shm_snapshot_destroy(ShmSnapshot* shm, const char* name);
+
+ShmSnapshot* shm_snapshot_attach(const char* name);
+
+int shm_snapshot_read(const ShmSnapshot* shm, ShmSample* out);
+
+void shm_snapshot_detach(const ShmSnapshot* shm);
+
+#endif
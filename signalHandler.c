@@ -1,5 +1,7 @@
 #define _POSIX_C_SOURCE 199309L
 #include <signal.h>
+#include <errno.h>
+#include <sys/signalfd.h>
 #include "signalHandler.h"
 
 typedef int (*CheckSignal)();
@@ -105,4 +107,86 @@ int prompt_for_int_signal(){
         }    
     }
     return 0;
-}
\ No newline at end of file
+}
+
+static char quit_answer[20];
+static int quit_answer_len = 0;
+static int quit_prompt_row = 0;
+///_|> descry: state of the non-blocking quit prompt: answer typed so far and the terminal row it is shown on
+
+int open_sigint_fd(){
+    ///_|> descry: blocks SIGINT in the calling thread and returns a signalfd that becomes readable on Ctrl+C,
+    ///_|>         so an event loop receives the signal as data instead of as EINTR on its reads
+    ///_|> returning: returns the non-blocking signalfd, -1 on error (SIGINT is left unblocked)
+    sigset_t block_set, old_set;
+    sigemptyset(&block_set);
+    sigaddset(&block_set, SIGINT);
+    if (sigprocmask(SIG_BLOCK, &block_set, &old_set) == -1){
+        perror("sigprocmask for SIGINT failed");
+        return -1;
+    }
+    int fd = signalfd(-1, &block_set, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (fd == -1){
+        perror("signalfd for SIGINT failed");
+        sigprocmask(SIG_SETMASK, &old_set, NULL);
+    }
+    return fd;
+}
+
+void close_sigint_fd(int fd){
+    ///_|> descry: closes a signalfd from open_sigint_fd and hands SIGINT back to the sigaction handler
+    ///_|> fd: signalfd to close, -1 is ignored, type int
+    ///_|> returning: this function does not return anything
+    if (fd == -1) return;
+    close(fd);
+    sigset_t unblock_set;
+    sigemptyset(&unblock_set);
+    sigaddset(&unblock_set, SIGINT);
+    sigprocmask(SIG_UNBLOCK, &unblock_set, NULL);
+}
+
+int take_sigint(int sigint_fd){
+    ///_|> descry: drains every signal queued on the signalfd
+    ///_|> sigint_fd: signalfd from open_sigint_fd, type int
+    ///_|> returning: returns 1 if at least one SIGINT was read, 0 otherwise
+    struct signalfd_siginfo info;
+    int received = 0;
+    while (read(sigint_fd, &info, sizeof(info)) == (ssize_t)sizeof(info)){
+        if (info.ssi_signo == SIGINT) received = 1;
+    }
+    return received;
+}
+
+void open_quit_prompt(int row){
+    ///_|> descry: shows the quit question on a terminal row of its own and leaves the cursor after it,
+    ///_|>         where the terminal echoes the answer; read_quit_answer() collects the answer without blocking
+    ///_|> row: terminal row not redrawn while the prompt is open, type int
+    ///_|> returning: this function does not return anything
+    quit_prompt_row = row;
+    quit_answer_len = 0;
+    printf("\033[%d;1H\033[2K", row);
+    printf("Do you want to quit the program? (y/n): ");
+    fflush(stdout);
+}
+
+int read_quit_answer(int in_fd){
+    ///_|> descry: reads what is available of the answer to the open quit prompt and closes the prompt once
+    ///_|>         a whole line (or end of input) arrived
+    ///_|> in_fd: readable input fd, normally STDIN_FILENO, type int
+    ///_|> returning: returns 1 if the user confirms exit, 0 to continue, -1 if the line is not complete yet
+    ssize_t got = read(in_fd, quit_answer + quit_answer_len, sizeof(quit_answer) - 1 - quit_answer_len);
+    if (got == -1 && (errno == EINTR || errno == EAGAIN)) return -1;
+    if (got > 0){
+        quit_answer_len += (int)got;
+        quit_answer[quit_answer_len] = '\0';
+        // keep reading until the line ends; an overlong line is judged by its first character
+        if (strchr(quit_answer, '\n') == NULL && quit_answer_len < (int)sizeof(quit_answer) - 1) return -1;
+    }
+    // like fgets() failing before: a read error or end of input means continue
+    int quit = (got > 0 || quit_answer_len > 0) && quit_answer[0] == 'y';
+    printf("\033[%d;1H\033[2K", quit_prompt_row);
+    if (quit) printf("Exiting...");
+    fflush(stdout);
+    quit_answer_len = 0;
+    return quit;
+}
@@ -11,6 +11,9 @@
 This module handles signals, particularly SIGINT (Ctrl+C), 
 and provides a prompt to confirm program termination decided by user responce.
 It uses internal flags to check/reset signal states.
+An event loop can instead receive SIGINT through a signalfd (open_sigint_fd) and run the same
+prompt without blocking (open_quit_prompt / read_quit_answer), so it keeps serving its other fds
+while the user decides.
 */
 
 int check_sigint();
@@ -19,4 +22,14 @@ void init_sigaction();
 
 int prompt_for_int_signal();
 
+int open_sigint_fd();
+
+void close_sigint_fd(int fd);
+
+int take_sigint(int sigint_fd);
+
+void open_quit_prompt(int row);
+
+int read_quit_answer(int in_fd);
+
 #endif
\ No newline at end of file
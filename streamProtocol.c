@@ -0,0 +1,44 @@
+#include "streamProtocol.h"
+#include "timeTool.h"
+
+StreamRecord make_utiliz_record(unsigned int seq, UtilizInfo* info){
+    ///_|> descry: wraps one utilization sample into a stream record stamped with its sampling time
+    ///_|> seq: sequence number of this sample, type unsigned int
+    ///_|> info: pointer to the sample to publish, type UtilizInfo*
+    ///_|> returning: returns the filled StreamRecord by value
+    StreamRecord rec;
+    memset(&rec, 0, sizeof(StreamRecord));
+    rec.type = STREAM_UTILIZ;
+    rec.seq = seq;
+    // convert the monotonic sample time to wall-clock time, so consumers see when it was sampled
+    rec.wall_ns = now_wall_ns() - (now_mono_ns() - info->timestamp_ns);
+    rec.data.utiliz = *info;
+    return rec;
+}
+
+StreamRecord make_core_record(coreInfo* info){
+    ///_|> descry: wraps static core information into a stream record
+    ///_|> info: pointer to the core information to publish, type coreInfo*
+    ///_|> returning: returns the filled StreamRecord by value
+    StreamRecord rec;
+    memset(&rec, 0, sizeof(StreamRecord));
+    rec.type = STREAM_CORE;
+    rec.seq = 0;
+    rec.wall_ns = now_wall_ns();
+    rec.data.core = *info;
+    return rec;
+}
+
+
+StreamRecord make_self_stats_record(unsigned int seq){
+    ///_|> descry: wraps the current self-stats summary of this process into a stream record
+    ///_|> seq: sequence number of this summary, type unsigned int
+    ///_|> returning: returns the filled StreamRecord by value
+    StreamRecord rec;
+    memset(&rec, 0, sizeof(StreamRecord));
+    rec.type = STREAM_SELFSTATS;
+    rec.seq = seq;
+    rec.wall_ns = now_wall_ns();
+    self_stats_summary(&rec.data.self_stats);
+    return rec;
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "sysInfoProducer.h"
+#include "selfStats.h"
+
+#ifndef STREAM_PROTOCOL_HEADER
+#define STREAM_PROTOCOL_HEADER
+
+/*
+This module defines the record format published by the daemon (--daemon) to its viewers (--attach)
+over a Unix domain socket. Every record has the same fixed size, so a reader only has to read 
+sizeof(StreamRecord) bytes at a time and switch on the type.
+*/
+
+typedef enum {
+    STREAM_UTILIZ = 1,
+    STREAM_CORE = 2,
+    STREAM_SELFSTATS = 3
+}StreamType;
+///_|> descry: Kinds of records carried on the stream
+///_|> members:
+///_|>     - STREAM_UTILIZ: one CPU/memory utilization sample (UtilizInfo)
+///_|>     - STREAM_CORE: static core information (coreInfo), sent once to every new client
+///_|>     - STREAM_SELFSTATS: the daemon's own overhead and stage latencies (SelfStatsSummary), sent periodically
+
+typedef struct {
+    int type;
+    unsigned int seq;
+    long long wall_ns;
+    union {
+        UtilizInfo utiliz;
+        coreInfo core;
+        SelfStatsSummary self_stats;
+    }data;
+}StreamRecord;
+///_|> descry: One fixed-size record on the daemon stream
+///_|> members:
+///_|>     - type: one of StreamType, type int
+///_|>     - seq: per-type sequence number, gaps tell a client that samples were dropped, type unsigned int
+///_|>     - wall_ns: wall-clock time the sample was taken (publish time for STREAM_CORE) in ns, type long long
+///_|>     - data: payload selected by type, type union
+
+StreamRecord make_utiliz_record(unsigned int seq, UtilizInfo* info);
+
+StreamRecord make_core_record(coreInfo* info);
+
+StreamRecord make_self_stats_record(unsigned int seq);
+
+#endif
@@ -1,121 +1,478 @@
 #define _DEFAULT_SOURCE
 #include "sysInfoConsumer.h"
 #include <unistd.h>
+#include <poll.h>
+#include "timeTool.h"
 
-int parent_utilization_reader_printer(int utiliz_read_fd, UtilizInfo* info, CLAInfo* cla){
-    ///_|> descry: reads system utilization (CPU & memory) from a pipe and visualizes it using charts
-    ///_|> utiliz_read_fd: fd to read UtilizInfo from child process, type int
-    ///_|> info: pointer to UtilizInfo struct that receives data from pipe, type UtilizInfo*
-    ///_|> cla: pointer to CLAInfo controlling number of samples and which graphs to show, type CLAInfo*
-    ///_|> returning: returns 0 on success; 1 on error or signal
-    int total_samples = cla->samples;
-    float * memory_samples = (float *) malloc(sizeof(float)*total_samples);
-    float * cpu_samples = (float *) malloc(sizeof(float)*total_samples);
+static int place_timed_sample(CLAInfo* cla, UtilizInfo* current, float* memory_samples, float* cpu_samples, \
+unsigned char* memory_marks, unsigned char* cpu_marks, int columns){
+    ///_|> descry: places a timestamped sample in the chart column covering its time, one column per --tdelay;
+    ///_|>         skipped columns hold the new value, CPU keeps the peak of a column so bursts stay visible
+    ///_|> cla: pointer to CLAInfo holding start time, tdelay and chart width, type CLAInfo*
+    ///_|> current: newest sample, type UtilizInfo*
+    ///_|> memory_samples / cpu_samples: per-column values, type float*
+    ///_|> memory_marks / cpu_marks: per-column anomaly marks, a column is marked if any of its samples is, type unsigned char*
+    ///_|> columns: number of columns filled so far, type int
+    ///_|> returning: returns the new number of filled columns
+    long long elapsed = current->timestamp_ns - cla->start_ns;
+    int column = (int)(elapsed / ((long long)cla->tdelay * 1000LL));
+    if (column < 0) column = 0;
+    if (column >= cla->samples) column = cla->samples - 1;
+    if (column < columns - 1) column = columns - 1; // never move backwards in time
+
+    for (int c = columns; c <= column; c++){
+        memory_samples[c] = current->mem_utiliz.used_memory;
+        cpu_samples[c] = current->cpu_utiliz;
+        memory_marks[c] = 0;
+        cpu_marks[c] = 0;
+    }
+    memory_samples[column] = current->mem_utiliz.used_memory;
+    if (current->cpu_utiliz > cpu_samples[column]) cpu_samples[column] = current->cpu_utiliz;
+    if (current->anomaly & ANOMALY_MEM) memory_marks[column] = 1;
+    if (current->anomaly & ANOMALY_CPU) cpu_marks[column] = 1;
+    return column + 1;
+}
+
+typedef struct {
+    CLAInfo* cla;
+    ThreadEngine* engine;
+    ShmSnapshot* shm;
+    float* memory_samples;
+    float* cpu_samples;
+    unsigned char* marks;
+    AnomalyDetector cpu_detector;
+    AnomalyDetector mem_detector;
+    int received;
+    int columns;
+    float total_memory;
+    schedInfo sched;
+    vmstatInfo vm;
+    coreInfo core;
+    bool core_drawn;
+    int core_row;
+    numaSample* numa_samples;
+    int numa_received;
+    int numa_row;
+    irqSample irq_latest;
+    int irq_received;
+    int irq_row;
+    bool prompt_open;
+}consumerView;
+///_|> descry: Everything the local consumer has received so far, shared by the panels' handlers
+///_|> members:
+///_|>     - cla / engine / shm: run configuration, thread engine (NULL with pipes) and --shm snapshot (NULL when off),
+///_|>                           type CLAInfo* / ThreadEngine* / ShmSnapshot*
+///_|>     - memory_samples / cpu_samples: per-column chart values, type float*
+///_|>     - marks: anomaly marks, the first half for memory, the second half for CPU, type unsigned char*
+///_|>     - cpu_detector / mem_detector: --anomaly baselines kept for the whole run, type AnomalyDetector
+///_|>     - received / columns: samples received, and chart columns filled with --adaptive, type int
+///_|>     - total_memory: total memory of the newest sample in GB, scales the memory chart, type float
+///_|>     - sched: scheduler signals of the newest sample, shown in the CPU chart's title, type schedInfo
+///_|>     - vm: paging and reclaim rates of the newest sample, shown in the memory chart's title, type vmstatInfo
+///_|>     - core / core_drawn: core info passed in by the caller and whether its panel is on screen,
+///_|>                         type coreInfo / bool
+///_|>     - core_row: terminal row of the cores panel, below the enabled charts, NUMA and interrupt panels, type int
+///_|>     - numa_samples / numa_received: per-node readings received so far (--numa), type numaSample* / int
+///_|>     - numa_row: terminal row of the NUMA panel, below the memory and CPU charts, type int
+///_|>     - irq_latest / irq_received: newest interrupt reading and how many arrived (--irq), type irqSample / int
+///_|>     - irq_row: terminal row of the interrupt panel, below the NUMA panel, type int
+///_|>     - prompt_open: the Ctrl+C quit prompt is waiting for an answer; samples are still taken but the
+///_|>                    screen is left alone until it closes, type bool
 
-    if (!memory_samples || !cpu_samples) {
-        perror("Memory allocation failed for utilization reader printer");
-        free(memory_samples);
-        free(cpu_samples);
-        return 1;
+typedef struct {
+    int fd;
+    int (*on_ready)(consumerView* view, int fd);
+}consumerPanel;
+///_|> descry: One panel of the local consumer: the fd it waits on and what to do when it becomes readable
+///_|> members:
+///_|>     - fd: pipe read end, or the engine's wake fd, -1 once the panel is finished, type int
+///_|>     - on_ready: reads what is available and renders it; returns 1 when the panel's producer is finished,
+///_|>                 0 when more data will follow and -1 on error, type int (*)(consumerView*, int)
+
+static void redraw_charts(consumerView* view){
+    ///_|> descry: redraws the memory and CPU charts with every sample taken so far
+    ///_|> view: consumer state, type consumerView*
+    ///_|> returning: this function does not return anything
+    if (view->received == 0) return;
+    CLAInfo* cla = view->cla;
+    int count = cla->adaptive ? view->columns : view->received;
+    render_utilization_charts(cla, view->memory_samples, view->cpu_samples, view->marks, view->marks + cla->samples, \
+                              count, view->total_memory, &view->sched, &view->vm);
+    fflush(stdout);
+}
+
+static int accept_utiliz_sample(consumerView* view, UtilizInfo* info){
+    ///_|> descry: validates one utilization sample, feeds stats, alerts, anomaly detection, --shm and --record,
+    ///_|>         and redraws the charts unless the quit prompt is open
+    ///_|> view: consumer state, type consumerView*
+    ///_|> info: sample just received, type UtilizInfo*
+    ///_|> returning: returns 0 on success, -1 if the sample is invalid or one too many
+    CLAInfo* cla = view->cla;
+    // check value's validation
+    if (info->cpu_utiliz < 0 && (info->mem_utiliz.used_memory < 0 || info->mem_utiliz.total_memory < 0)){
+        fprintf(stderr, "Utilization info get from utilization reader is invalid, cpu: %.2f, memory: %.2f, %.2f \n", \
+        info->cpu_utiliz, info->mem_utiliz.total_memory, info->mem_utiliz.used_memory);
+        return -1;
+    }
+    // prevent overflow
+    int i = view->received;
+    if ( !cla->adaptive && i >= cla->samples){
+        fprintf(stderr, "Utilization reader receives information more than total samples times: %d \n", i);
+        return -1;
     }
 
-    int i = 0; 
-    int num_of_sigint = 0;
+    record_sample_stats(info);
+    alert_evaluate(info->cpu_utiliz, info->mem_utiliz.used_memory, info->mem_utiliz.total_memory, \
+                   info->timestamp_ns);
+    mark_sample_anomalies(cla, &view->cpu_detector, &view->mem_detector, info);
+
+    UtilizInfo current;
+    current.cpu_utiliz = info->cpu_utiliz;
+    current.mem_utiliz = info->mem_utiliz;
+    current.timestamp_ns = info->timestamp_ns;
+    current.anomaly = info->anomaly;
+
+    long long wall_ns = now_wall_ns() - (now_mono_ns() - info->timestamp_ns);
+    shm_snapshot_publish(view->shm, current.cpu_utiliz, current.mem_utiliz.total_memory, \
+                         current.mem_utiliz.used_memory, wall_ns);
+    ts_record_sample(current.cpu_utiliz, current.mem_utiliz.used_memory, current.mem_utiliz.total_memory, wall_ns);
+    flight_record_sample(current.cpu_utiliz, current.mem_utiliz.used_memory, current.mem_utiliz.total_memory, \
+                         &info->sched, &info->vm, current.anomaly, wall_ns);
+    unsigned char* memory_marks = view->marks;
+    unsigned char* cpu_marks = view->marks + cla->samples;
+    if (cla->adaptive){
+        // non-uniform spacing: the column is given by the timestamp, not by the sample count
+        view->columns = place_timed_sample(cla, &current, view->memory_samples, view->cpu_samples, memory_marks, \
+                                           cpu_marks, view->columns);
+    }else{
+        view->memory_samples[i] = current.mem_utiliz.used_memory;
+        view->cpu_samples[i] = current.cpu_utiliz;
+        memory_marks[i] = (current.anomaly & ANOMALY_MEM) != 0;
+        cpu_marks[i] = (current.anomaly & ANOMALY_CPU) != 0;
+    }
+    view->total_memory = current.mem_utiliz.total_memory;
+    view->sched = info->sched;
+    view->vm = info->vm;
+    view->received++;
+    // while the quit prompt is open the samples only buffer here; the charts catch up when it closes
+    if (!view->prompt_open) redraw_charts(view);
+    return 0;
+}
+
+static int utiliz_panel_ready(consumerView* view, int fd){
+    ///_|> descry: consumerPanel.on_ready of the memory/CPU charts
+    ///_|> view: consumer state, type consumerView*
+    ///_|> fd: readable utilization pipe, or the engine's wake fd, type int
+    ///_|> returning: returns 1 at end of stream, 0 when more samples will follow, -1 on error
+    UtilizInfo info;
+    if (view->engine == NULL){
+        // one record per wake-up: a pipe write of a UtilizInfo is atomic, so a readable pipe holds a whole one
+        ssize_t read_utiliz = read(fd, &info, sizeof(UtilizInfo));
+        if (read_utiliz == 0) return 1;
+        if (read_utiliz == -1){
+            perror("read utilization information from pipe failed");
+            return -1;
+        }
+        return accept_utiliz_sample(view, &info);
+    }
+    // the engine's wake fd covers every queued sample: take all of them
+    while (true){
+        ssize_t taken = thread_engine_try_utiliz(view->engine, &info);
+        if (taken == 0) return 1;
+        if (taken == -1) return 0;
+        if (accept_utiliz_sample(view, &info) == -1) return -1;
+    }
+}
+
+static void draw_core_panel(consumerView* view){
+    ///_|> descry: draws the cores panel in its own rows below the charts, independent of how far they are
+    ///_|> view: consumer state with valid core info, type consumerView*
+    ///_|> returning: this function does not return anything
+    printf("\033[%d;1H", view->core_row);
+    draw_all_core(&view->core);
+    fflush(stdout);
+    view->core_drawn = true;
+}
+
+static void redraw_numa_panel(consumerView* view){
+    ///_|> descry: redraws the NUMA panel in its own rows with every reading taken so far
+    ///_|> view: consumer state, type consumerView*
+    ///_|> returning: this function does not return anything
+    if (view->numa_received == 0) return;
+    printf("\033[%d;1H", view->numa_row);
+    draw_numa_panel(view->numa_samples, view->numa_received, view->cla->samples);
+    fflush(stdout);
+}
+
+static int numa_panel_ready(consumerView* view, int fd){
+    ///_|> descry: consumerPanel.on_ready of the per-node NUMA view
+    ///_|> view: consumer state, type consumerView*
+    ///_|> fd: readable NUMA pipe, or the engine's wake fd, type int
+    ///_|> returning: returns 1 at end of stream, 0 when more readings will follow, -1 on error
     while (true){
-        // printf("loop iteration in utilization reader: %d \n", i);
-        // check if SIGINT signal was received, if received, handling it.
-        if (prompt_for_int_signal()){
-            free(memory_samples);
-            free(cpu_samples);
-            safe_close(&utiliz_read_fd);
-            return 1;
+        numaSample sample;
+        ssize_t got = (view->engine != NULL) ? thread_engine_try_numa(view->engine, &sample) : \
+                      read(fd, &sample, sizeof(numaSample));
+        // the producer explains why it ended without a single reading
+        if (got == 0) return (view->numa_received > 0) ? 1 : -1;
+        if (got == -1){
+            if (errno == EAGAIN) return 0;
+            perror("read NUMA information from pipe failed");
+            return -1;
         }
-        // read one sample from pipe
-        ssize_t read_utiliz = read(utiliz_read_fd, info, sizeof(UtilizInfo));
-        if (read_utiliz > 0){
-            // check value's validation
-            if (info->cpu_utiliz < 0 && (info->mem_utiliz.used_memory < 0 || info->mem_utiliz.total_memory < 0)){
-                fprintf(stderr, "Utilization info get from utilization reader is invalid, cpu: %.2f, memory: %.2f, %.2f \n", \
-                info->cpu_utiliz, info->mem_utiliz.total_memory, info->mem_utiliz.used_memory);
-                safe_close(&utiliz_read_fd);
-                free(memory_samples);
-                free(cpu_samples);
-                return 1;
-            }
-            // prevent overflow
-            if ( i >= total_samples + num_of_sigint){
-                fprintf(stderr, "Utilization reader receives information more than total samples times: %d \n", i);
-                safe_close(&utiliz_read_fd);
-                free(memory_samples);
-                free(cpu_samples);
-                return 1;
-            }
+        if (sample.node_count <= 0 || sample.node_count > NUMA_MAX_NODES || view->numa_received >= view->cla->samples){
+            fprintf(stderr, "NUMA information get from reader is invalid or one too many: %d nodes\n", sample.node_count);
+            return -1;
+        }
+        view->numa_samples[view->numa_received++] = sample;
+        if (!view->prompt_open) redraw_numa_panel(view);
+        // a pipe is read one record per wake-up like the utilization pipe
+        if (view->engine == NULL) return 0;
+    }
+}
 
-            UtilizInfo current;
-            current.cpu_utiliz = info->cpu_utiliz;
-            current.mem_utiliz = info->mem_utiliz;
+static void redraw_irq_panel(consumerView* view){
+    ///_|> descry: redraws the interrupt panel in its own rows with the newest reading
+    ///_|> view: consumer state, type consumerView*
+    ///_|> returning: this function does not return anything
+    if (view->irq_received == 0) return;
+    printf("\033[%d;1H", view->irq_row);
+    draw_irq_panel(&view->irq_latest);
+    fflush(stdout);
+}
 
-            printf("\033[3;1H");
-            // if need memory graph, render memory graph
-            if (cla->graph_flag[0]){
-                memory_samples[i] = current.mem_utiliz.used_memory;
-                draw_memory_chart(memory_samples, i+1, total_samples, current.mem_utiliz.total_memory);
-                printf("\n");
-            }
-            // if need cpu graph, render CPU graph
-            if (cla->graph_flag[1]){
-                cpu_samples[i] = current.cpu_utiliz;
-                draw_cpu_chart(cpu_samples, i+1, total_samples);
-                printf("\n");
-            }
-            i++;
+static int irq_panel_ready(consumerView* view, int fd){
+    ///_|> descry: consumerPanel.on_ready of the interrupt hot-spot view
+    ///_|> view: consumer state, type consumerView*
+    ///_|> fd: readable IRQ pipe, or the engine's wake fd, type int
+    ///_|> returning: returns 1 at end of stream, 0 when more readings will follow, -1 on error
+    while (true){
+        irqSample sample;
+        ssize_t got = (view->engine != NULL) ? thread_engine_try_irq(view->engine, &sample) : \
+                      read(fd, &sample, sizeof(irqSample));
+        // the producer explains why it ended without a single reading
+        if (got == 0) return (view->irq_received > 0) ? 1 : -1;
+        if (got == -1){
+            if (errno == EAGAIN) return 0;
+            perror("read interrupt information from pipe failed");
+            return -1;
+        }
+        if (sample.hot_count < 0 || sample.hot_count > IRQ_VIEW_CPUS || view->irq_received >= view->cla->samples){
+            fprintf(stderr, "Interrupt information get from reader is invalid or one too many: %d CPUs\n", sample.hot_count);
+            return -1;
+        }
+        // only the newest reading is shown, there is no history to keep
+        view->irq_latest = sample;
+        view->irq_received++;
+        if (!view->prompt_open) redraw_irq_panel(view);
+        if (view->engine == NULL) return 0;
+    }
+}
+
+static int screen_bottom_row(consumerView* view){
+    ///_|> descry: first terminal row below the charts and, once drawn, the cores panel
+    ///_|> view: consumer state, type consumerView*
+    ///_|> returning: returns the row number
+    if (!view->core_drawn) return view->core_row;
+    // draw_all_core: a title line, then 4 lines per row of up to 4 cores
+    return view->core_row + 1 + 4 * ((view->core.cores_num + 3) / 4);
+}
+
+static bool panels_open(consumerPanel* panels){
+    ///_|> descry: checks whether any panel still waits for data
+    ///_|> panels: the consumer's CONSUMER_PANELS panels, type consumerPanel*
+    ///_|> returning: returns true while at least one panel has an fd
+    for (int p = 0; p < CONSUMER_PANELS; p++){
+        if (panels[p].fd != -1) return true;
+    }
+    return false;
+}
+
+int run_local_consumer(int utiliz_read_fd, const coreInfo* core, int numa_read_fd, int irq_read_fd, ThreadEngine* engine, \
+CLAInfo* cla, ShmSnapshot* shm){
+    ///_|> descry: multiplexes every local producer with poll() and renders each panel as soon as its data
+    ///_|>         arrives, so no producer waits for another; the cores panel is drawn up front
+    ///_|> utiliz_read_fd: fd to read UtilizInfo from the utilization coordinator, -1 without charts or with
+    ///_|>                 the thread engine, type int
+    ///_|> core: core count and max frequency for the cores panel, NULL without it, type const coreInfo*
+    ///_|> numa_read_fd: fd to read numaSample from the NUMA producer, -1 without --numa or with the thread engine,
+    ///_|>               type int
+    ///_|> irq_read_fd: fd to read irqSample from the IRQ producer, -1 without --irq or with the thread engine, type int
+    ///_|> engine: worker-thread engine to take samples from instead of the pipes, NULL otherwise, type ThreadEngine*
+    ///_|> cla: pointer to CLAInfo controlling number of samples and which graphs to show, type CLAInfo*
+    ///_|> shm: shared-memory snapshot to publish every sample into, NULL when --shm is off, type ShmSnapshot*
+    ///_|> returning: returns 0 on success; 1 if any panel failed or when the user quits with Ctrl+C.
+    ///_|>            The read ends stay open, the caller closes them
+    consumerView view;
+    memset(&view, 0, sizeof(view));
+    view.cla = cla;
+    view.engine = engine;
+    view.shm = shm;
+    view.memory_samples = (float *) malloc(sizeof(float)*cla->samples);
+    view.cpu_samples = (float *) malloc(sizeof(float)*cla->samples);
+    view.marks = (unsigned char*) calloc(2 * cla->samples, sizeof(unsigned char));
+    anomaly_init(&view.cpu_detector, cla->anomaly_k, ANOMALY_CPU_MIN_STDDEV);
+    anomaly_init(&view.mem_detector, cla->anomaly_k, ANOMALY_MEM_MIN_STDDEV);
+    view.numa_samples = (numaSample*) malloc(sizeof(numaSample) * cla->samples);
+    // charts start on row 3, below the header line; the NUMA panel needs the node count to reserve its rows
+    view.numa_row = 3 + (cla->graph_flag[0] ? CHART_PANEL_ROWS : 0) + (cla->graph_flag[1] ? CHART_PANEL_ROWS : 0);
+    int numa_ids[NUMA_MAX_NODES];
+    int numa_nodes = cla->graph_flag[3] ? numa_discover_nodes(numa_ids, NUMA_MAX_NODES) : 0;
+    view.irq_row = view.numa_row + ((numa_nodes > 0) ? NUMA_PANEL_ROWS(numa_nodes) : 0);
+    view.core_row = view.irq_row + (cla->graph_flag[4] ? IRQ_PANEL_ROWS : 0);
+
+    // with the thread engine every panel waits on the engine's wake fd
+    consumerPanel panels[CONSUMER_PANELS] = {
+        {(engine != NULL) ? thread_engine_wake_fd(engine) : utiliz_read_fd, utiliz_panel_ready},
+        {(engine != NULL) ? thread_engine_wake_fd(engine) : numa_read_fd, numa_panel_ready},
+        {(engine != NULL) ? thread_engine_wake_fd(engine) : irq_read_fd, irq_panel_ready}
+    };
+    if (!cla->graph_flag[0] && !cla->graph_flag[1]) panels[0].fd = -1;
+    if (!cla->graph_flag[3]) panels[1].fd = -1;
+    if (!cla->graph_flag[4]) panels[2].fd = -1;
+
+    int status = 0;
+    bool failed = false;
+    if (!view.memory_samples || !view.cpu_samples || !view.marks || !view.numa_samples) {
+        perror("Memory allocation failed for local consumer");
+        status = 1;
+    }
+    // Ctrl+C arrives as data on this fd instead of interrupting reads
+    int sigint_fd = (status == 0) ? open_sigint_fd() : -1;
+    if (status == 0 && sigint_fd == -1) status = 1;
+    // static facts: the panel is on screen before any producer has sampled
+    if (status == 0 && core != NULL){
+        view.core = *core;
+        draw_core_panel(&view);
+    }
+    // the prompt stays open after the producers finish, the run ends once it is answered
+    while (status == 0 && (panels_open(panels) || view.prompt_open)){
+        // one entry per panel, then Ctrl+C and, while the prompt is open, stdin
+        struct pollfd fds[CONSUMER_PANELS + 2];
+        int sigint_slot = CONSUMER_PANELS;
+        int stdin_slot = CONSUMER_PANELS + 1;
+        for (int p = 0; p < CONSUMER_PANELS; p++) fds[p].fd = panels[p].fd; // poll skips negative fds
+        fds[sigint_slot].fd = sigint_fd;
+        fds[stdin_slot].fd = view.prompt_open ? STDIN_FILENO : -1;
+        for (int p = 0; p < CONSUMER_PANELS + 2; p++){
+            fds[p].events = POLLIN;
+            fds[p].revents = 0;
         }
-        else if (read_utiliz == 0){
-            // if EOF, end the loop
+        if (poll(fds, CONSUMER_PANELS + 2, -1) == -1){
+            if (errno == EINTR) continue;
+            perror("poll on producer fds failed");
+            status = 1;
             break;
         }
-        else{
-            // handle with SIGINT
-            if (check_sigint()){
-                // handle SIGINT: ignore this failed read and continue
-                num_of_sigint ++;
-                continue;
-             } 
-            perror("read utilization information from pipe failed");
-            free(memory_samples);
-            free(cpu_samples);
-            safe_close(&utiliz_read_fd); // close the read end fd after done
-            return 1;
+        // wake-ups arriving from now on stay pending, nothing a handler misses below is lost
+        if (engine != NULL) thread_engine_drain_wake(engine);
+        for (int p = 0; p < CONSUMER_PANELS; p++){
+            // POLLHUP without POLLIN: the producer closed its end, the handler's read sees EOF
+            if (panels[p].fd == -1 || fds[p].revents == 0) continue;
+            int ready = panels[p].on_ready(&view, panels[p].fd);
+            // a failed panel is dropped, the others keep rendering and the run reports the failure at the end
+            if (ready == -1) failed = true;
+            if (ready != 0) panels[p].fd = -1;
+        }
+        // row 2, between the header and the charts, is never redrawn: the prompt and the echoed answer live there
+        if (fds[sigint_slot].revents != 0 && take_sigint(sigint_fd) && !view.prompt_open){
+            view.prompt_open = true;
+            open_quit_prompt(2);
+        }
+        if (fds[stdin_slot].revents != 0){
+            int answer = read_quit_answer(STDIN_FILENO);
+            if (answer == 1){
+                printf("\033[%d;1H", screen_bottom_row(&view));
+                status = 1;
+            }
+            if (answer == 0){
+                // catch up with everything that arrived while the prompt was open
+                view.prompt_open = false;
+                redraw_charts(&view);
+                redraw_numa_panel(&view);
+                redraw_irq_panel(&view);
+                if (view.core_drawn) draw_core_panel(&view);
+            }
         }
     }
-    free(memory_samples);
-    free(cpu_samples);
-    safe_close(&utiliz_read_fd);
-    return 0;
+    close_sigint_fd(sigint_fd);
+    // the cores panel may have been drawn before the last chart: leave the cursor below everything
+    if (status == 0 && view.core_drawn) draw_core_panel(&view);
+    if (failed) status = 1;
+    free(view.memory_samples);
+    free(view.cpu_samples);
+    free(view.marks);
+    free(view.numa_samples);
+    return status;
 }
 
-int parent_core_info_reader_printer(int core_read_fd, coreInfo* info){
-    ///_|> descry: reads coreInfo from pipe and draws a visualization of CPU cores
-    ///_|> core_read_fd: fd for reading core information from child, type int
-    ///_|> info: pointer to coreInfo struct to populate and render, type coreInfo*
-    ///_|> returning: returns 0 on success; 1 on error
-    ssize_t read_core = read(core_read_fd, info, sizeof(coreInfo));
-    if (read_core > 0){
-        //check value validation
-        if (info->cores_num < 0 || info->max_freq < 0){
-            fprintf(stderr, "core information get from reader is invalid: %d, %.2f \n", \
-                    info->cores_num, info->max_freq);
-            safe_close(&core_read_fd);
-            return 1;
-        }
-        draw_all_core(info);
+void render_utilization_charts(CLAInfo* cla, float* memory_samples, float* cpu_samples, unsigned char* memory_marks, \
+unsigned char* cpu_marks, int sample_count, float total_memory, const schedInfo* sched, \
+const vmstatInfo* vm){
+    ///_|> descry: redraws the enabled memory and CPU charts below the header line
+    ///_|> cla: pointer to CLAInfo selecting the graphs and the chart width, type CLAInfo*
+    ///_|> memory_samples: stored memory samples in GB, type float*
+    ///_|> cpu_samples: stored CPU samples in percent, type float*
+    ///_|> memory_marks / cpu_marks: anomaly marks of the stored samples, NULL for none, type unsigned char*
+    ///_|> sample_count: number of valid samples in both arrays, type int
+    ///_|> total_memory: total memory in GB used to scale the memory chart, type float
+    ///_|> sched: scheduler signals shown in the CPU chart's title, NULL for none, type const schedInfo*
+    ///_|> vm: paging and reclaim rates shown in the memory chart's title, NULL for none, type const vmstatInfo*
+    ///_|> returning: this function does not return anything
+    long long render_start = now_mono_ns();
+    printf("\033[3;1H");
+    // if need memory graph, render memory graph
+    if (cla->graph_flag[0]){
+        draw_memory_chart(memory_samples, memory_marks, sample_count, cla->samples, total_memory, vm);
+        printf("\n");
     }
-    else if (read_core == -1){
-        perror("read utilization information from pipe failed"); 
-        safe_close(&core_read_fd);
-        return 1;
+    // if need cpu graph, render CPU graph
+    if (cla->graph_flag[1]){
+        draw_cpu_chart(cpu_samples, cpu_marks, sample_count, cla->samples, sched);
+        printf("\n");
     }
+    self_stats_record(STAGE_RENDER, now_mono_ns() - render_start);
+}
 
-    safe_close(&core_read_fd); // close read-end fd after done
-    return 0;
-}
\ No newline at end of file
+void record_sample_stats(UtilizInfo* info){
+    ///_|> descry: records the stage timings carried by a received sample into the self-stats histograms
+    ///_|> info: pointer to the sample just received from the coordinator, type UtilizInfo*
+    ///_|> returning: this function does not return anything
+    long long received = now_mono_ns();
+    int newest_fetch = 0;
+    if (info->cpu_timing.fetch_ns >= 0 && info->cpu_timing.jitter_ns >= 0){
+        self_stats_record(STAGE_FETCH_CPU, info->cpu_timing.fetch_ns);
+        self_stats_record(STAGE_TICK_JITTER, info->cpu_timing.jitter_ns);
+        newest_fetch = info->cpu_timing.fetch_ns;
+    }
+    if (info->mem_timing.fetch_ns >= 0 && info->mem_timing.jitter_ns >= 0){
+        self_stats_record(STAGE_FETCH_MEM, info->mem_timing.fetch_ns);
+        self_stats_record(STAGE_TICK_JITTER, info->mem_timing.jitter_ns);
+        if (info->mem_timing.fetch_ns > newest_fetch) newest_fetch = info->mem_timing.fetch_ns;
+    }
+    // the reading was ready once its fetch finished; everything after that is pipe transport
+    if (info->timestamp_ns > 0){
+        self_stats_record(STAGE_PIPE_HOP, received - info->timestamp_ns - newest_fetch);
+    }
+    if (info->skew_ns >= 0) self_stats_record(STAGE_PAIR_SKEW, info->skew_ns);
+    self_stats_set_producers(info->producers_cpu_us, info->producers_max_rss_kb);
+}
+void mark_sample_anomalies(CLAInfo* cla, AnomalyDetector* cpu_detector, AnomalyDetector* mem_detector, UtilizInfo* info){
+    ///_|> descry: sets info->anomaly by feeding the sample's fresh readings to the metrics' detectors (--anomaly)
+    ///_|> cla: pointer to CLAInfo, detection is off when anomaly_k is 0, type CLAInfo*
+    ///_|> cpu_detector / mem_detector: per-metric detectors kept for the whole run, type AnomalyDetector*
+    ///_|> info: pointer to the sample just received, type UtilizInfo*
+    ///_|> returning: this function does not return anything
+    info->anomaly = ANOMALY_NONE;
+    if (cla->anomaly_k <= 0) return;
+    // with --adaptive one metric may be repeated from an earlier sample; only fresh readings (whose
+    // fetch time has not been reported yet) update the baseline
+    bool fresh_cpu = !cla->adaptive || info->cpu_timing.fetch_ns >= 0;
+    bool fresh_mem = !cla->adaptive || info->mem_timing.fetch_ns >= 0;
+    if (fresh_cpu && info->cpu_utiliz >= 0 && anomaly_update(cpu_detector, info->cpu_utiliz)){
+        info->anomaly |= ANOMALY_CPU;
+    }
+    if (fresh_mem && info->mem_utiliz.used_memory >= 0 && anomaly_update(mem_detector, info->mem_utiliz.used_memory)){
+        info->anomaly |= ANOMALY_MEM;
+    }
+}
@@ -12,19 +12,41 @@
 #include "sysInfoProducer.h"
 #include "pipeTool.h"
 #include "signalHandler.h"
+#include "shmSnapshot.h"
+#include "threadEngine.h"
+#include "alertEngine.h"
+#include "anomaly.h"
+#include "tsCompress.h"
+#include "flightRecorder.h"
+#include "numa.h"
+#include "interrupts.h"
 
 #ifndef SYSINFO_CONSUMER_HEADER
 #define SYSINFO_CONSUMER_HEADER
 
 /*
 This module acts as the consumer in the system monitoring pipeline.
-It is responsible for receiving system utilization and core information from child processes via pipes,
+It is responsible for receiving system utilization from child processes via pipes,
 and rendering visual output using graph drawing functions.
+Every panel waits on its own fd in one poll() loop and is redrawn as soon as its data arrives, so a slow
+producer does not hold up the others. The cores panel has no producer: the caller passes the static
+hardware facts (hwCache) and the panel is drawn before the first sample.
+With --engine=threads all panels poll the ThreadEngine's wake fd and take their data from its queues.
 */
 
-int parent_utilization_reader_printer(int utiliz_read_fd, UtilizInfo* info, CLAInfo* cla);
+#define CHART_PANEL_ROWS 15 // terminal rows of one chart: title, 13 plot rows down to the axis, blank line
+#define CONSUMER_PANELS 3 // memory/CPU charts, NUMA nodes, interrupts
 
-int parent_core_info_reader_printer(int core_read_fd, coreInfo* info);
+int run_local_consumer(int utiliz_read_fd, const coreInfo* core, int numa_read_fd, int irq_read_fd, ThreadEngine* engine, \
+CLAInfo* cla, ShmSnapshot* shm);
+
+void record_sample_stats(UtilizInfo* info);
+
+void mark_sample_anomalies(CLAInfo* cla, AnomalyDetector* cpu_detector, AnomalyDetector* mem_detector, UtilizInfo* info);
+
+void render_utilization_charts(CLAInfo* cla, float* memory_samples, float* cpu_samples, unsigned char* memory_marks, \
+unsigned char* cpu_marks, int sample_count, float total_memory, const schedInfo* sched, \
+const vmstatInfo* vm);
 
 #endif
 
@@ -0,0 +1,276 @@
+#define _DEFAULT_SOURCE
+#include "sysInfoDaemon.h"
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include "timeTool.h"
+#include "hwCache.h"
+
+#define MAX_CLIENTS 64
+#define SELF_STATS_EVERY 10 // publish a self-stats record every N samples
+
+typedef struct {
+    int fd;
+    ClientQueue queue;
+}daemonClient;
+///_|> descry: One connected viewer of the daemon
+///_|> members:
+///_|>     - fd: non-blocking connected socket, -1 when the slot is free, type int
+///_|>     - queue: records waiting to be sent to this viewer, type ClientQueue
+
+static int clear_stale_socket(const struct sockaddr_un* addr){
+    ///_|> descry: removes a socket file left behind by a daemon that is gone; anything else at the path is kept
+    ///_|> addr: address the daemon is about to bind, type const struct sockaddr_un*
+    ///_|> returning: returns 0 when the path is free, -1 if it is not a socket or a live daemon still owns it
+    struct stat st;
+    if (lstat(addr->sun_path, &st) == -1) return 0;
+    if (!S_ISSOCK(st.st_mode)){
+        fprintf(stderr, "%s exists and is not a socket, not replacing it\n", addr->sun_path);
+        return -1;
+    }
+    // a socket that still accepts connections belongs to a running daemon
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probe != -1 && connect(probe, (const struct sockaddr*)addr, sizeof(*addr)) == 0){
+        safe_close(&probe);
+        fprintf(stderr, "A daemon is already serving on %s\n", addr->sun_path);
+        return -1;
+    }
+    safe_close(&probe);
+    unlink(addr->sun_path);
+    return 0;
+}
+
+static int open_listen_socket(const char* path){
+    ///_|> descry: creates a non-blocking listening Unix domain socket, replacing a stale socket file
+    ///_|> path: filesystem path of the socket, type const char*
+    ///_|> returning: returns the listening fd, or -1 on failure
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+    if (clear_stale_socket(&addr) == -1) return -1;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1){
+        perror("socket for daemon failed");
+        return -1;
+    }
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1 || listen(fd, 16) == -1){
+        perror("bind/listen daemon socket failed");
+        safe_close(&fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+static void drop_client(daemonClient* client){
+    ///_|> descry: disconnects a viewer and releases its queue
+    ///_|> client: pointer to the client slot, type daemonClient*
+    ///_|> returning: this function does not return anything
+    safe_close(&client->fd);
+    client_queue_free(&client->queue);
+}
+
+static void accept_clients(int listen_fd, daemonClient* clients, CLAInfo* cla, coreInfo* core, bool have_core){
+    ///_|> descry: accepts all pending viewers and queues the static core information for them
+    ///_|> listen_fd: listening socket, type int
+    ///_|> clients: array of MAX_CLIENTS client slots, type daemonClient*
+    ///_|> cla: pointer to CLAInfo holding the per-client queue size, type CLAInfo*
+    ///_|> core: core count and max frequency read at start, type coreInfo*
+    ///_|> have_core: whether they could be read, type bool
+    ///_|> returning: this function does not return anything
+    while (true){
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd == -1) return; // EAGAIN: no more pending clients
+        int slot = -1;
+        for (int i = 0; i < MAX_CLIENTS; i++){
+            if (clients[i].fd == -1){
+                slot = i;
+                break;
+            }
+        }
+        if (slot == -1){
+            fprintf(stderr, "Daemon refused a viewer: too many clients\n");
+            safe_close(&fd);
+            continue;
+        }
+        if (client_queue_init(&clients[slot].queue, cla->client_queue) == -1){
+            perror("Daemon refused a viewer: client queue allocation failed");
+            safe_close(&fd);
+            continue;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        clients[slot].fd = fd;
+        if (have_core){
+            StreamRecord rec = make_core_record(core);
+            client_queue_push(&clients[slot].queue, &rec);
+        }
+    }
+}
+
+static void publish(daemonClient* clients, StreamRecord* rec){
+    ///_|> descry: queues a record for every connected viewer and writes as much as each socket accepts
+    ///_|> clients: array of MAX_CLIENTS client slots, type daemonClient*
+    ///_|> rec: pointer to the record to publish, type StreamRecord*
+    ///_|> returning: this function does not return anything
+    for (int i = 0; i < MAX_CLIENTS; i++){
+        if (clients[i].fd == -1) continue;
+        client_queue_push(&clients[i].queue, rec);
+        if (client_queue_flush(&clients[i].queue, clients[i].fd) == -1){
+            drop_client(&clients[i]);
+        }
+    }
+}
+
+static void stop_daemon(int listen_fd, CLAInfo* cla, daemonClient* clients, int* utiliz_fd, pid_t utiliz_pid, \
+ShmSnapshot* shm){
+    ///_|> descry: closes every socket and pipe, removes the socket file and terminates the producers
+    ///_|> returning: this function does not return anything
+    for (int i = 0; i < MAX_CLIENTS; i++){
+        if (clients[i].fd != -1) drop_client(&clients[i]);
+    }
+    safe_close(&listen_fd);
+    unlink(cla->socket_path);
+    shm_snapshot_destroy(shm, cla->shm_name);
+    safe_close(utiliz_fd);
+    kill_all_children(utiliz_pid, -1);
+    wait_for_children(utiliz_pid);
+}
+
+int run_daemon(CLAInfo* cla){
+    ///_|> descry: runs the sampler once and serves its samples to any number of viewers until Ctrl+C
+    ///_|> cla: pointer to parsed command-line arguments, type CLAInfo*
+    ///_|> returning: returns 0 when stopped by Ctrl+C, 1 on error
+    int listen_fd = open_listen_socket(cla->socket_path);
+    if (listen_fd == -1) return 1;
+
+    int utiliz_fd[2] = {-1, -1};
+    if (pipe(utiliz_fd) == -1){
+        perror("pipe for daemon created failed");
+        safe_close(&listen_fd);
+        exit(EXIT_FAILURE);
+    }
+
+    // static facts, read (or taken from the hardware cache) once; every viewer gets them on connect
+    coreInfo core_info;
+    bool have_core = get_static_coreinfo(&core_info) != -1;
+    if (!have_core) fprintf(stderr, "Daemon failed to get core information, serving utilization only\n");
+
+    // the daemon always samples both metrics and never stops on its own; viewers pick what to draw
+    CLAInfo producer_cla = *cla;
+    producer_cla.samples = -1;
+    producer_cla.graph_flag[0] = 1;
+    producer_cla.graph_flag[1] = 1;
+    producer_cla.start_ns = now_mono_ns();
+    // --pin-cpu, --sched-fifo, --nice, --mlock: inherited by the producers, the daemon loop drops them
+    sampler_tuning_apply(cla);
+
+    pid_t utiliz_pid = fork();
+    if (utiliz_pid == 0){
+        setpgid(0, 0);
+        safe_close(&listen_fd);
+        safe_close(&utiliz_fd[0]);
+        fetch_utilization_with_pipe(&producer_cla, utiliz_fd[1]);
+    }
+    else if (utiliz_pid < 0){
+        perror("fork for utilization in daemon failed");
+        safe_close(&listen_fd);
+        safe_close(&utiliz_fd[0]);
+        safe_close(&utiliz_fd[1]);
+        exit(EXIT_FAILURE);
+    }
+    sampler_tuning_release();
+    safe_close(&utiliz_fd[1]);
+
+    printf("Daemon publishing on %s every %d microSecs (Ctrl+C to stop)\n", cla->socket_path, cla->tdelay);
+    fflush(stdout);
+
+    daemonClient clients[MAX_CLIENTS];
+    for (int i = 0; i < MAX_CLIENTS; i++){
+        clients[i].fd = -1;
+        clients[i].queue.records = NULL;
+    }
+    unsigned int seq = 0;
+    int status = 0;
+    ShmSnapshot* shm = cla->shm_enabled ? shm_snapshot_create(cla->shm_name) : NULL;
+    // with --anomaly every published sample carries its anomaly bits to the viewers
+    AnomalyDetector cpu_detector;
+    AnomalyDetector mem_detector;
+    anomaly_init(&cpu_detector, cla->anomaly_k, ANOMALY_CPU_MIN_STDDEV);
+    anomaly_init(&mem_detector, cla->anomaly_k, ANOMALY_MEM_MIN_STDDEV);
+
+    struct pollfd pfds[2 + MAX_CLIENTS];
+    while (!check_sigint()){
+        pfds[0].fd = listen_fd;
+        pfds[0].events = POLLIN;
+        pfds[1].fd = utiliz_fd[0];
+        pfds[1].events = POLLIN;
+        for (int i = 0; i < MAX_CLIENTS; i++){
+            pfds[2 + i].fd = clients[i].fd;
+            pfds[2 + i].events = POLLIN;
+            if (clients[i].fd != -1 && clients[i].queue.count > 0) pfds[2 + i].events |= POLLOUT;
+        }
+
+        if (poll(pfds, 2 + MAX_CLIENTS, -1) == -1){
+            if (errno == EINTR) continue; // re-check SIGINT
+            perror("poll in daemon failed");
+            status = 1;
+            break;
+        }
+
+        if (pfds[0].revents & POLLIN){
+            accept_clients(listen_fd, clients, cla, &core_info, have_core);
+        }
+
+        if (pfds[1].revents & (POLLIN | POLLHUP)){
+            UtilizInfo info;
+            ssize_t got = read_full(utiliz_fd[0], &info, sizeof(UtilizInfo));
+            if (got == -1 && errno == EINTR) continue;
+            if (got != sizeof(UtilizInfo)){
+                fprintf(stderr, "Daemon lost its utilization producer\n");
+                status = 1;
+                break;
+            }
+            record_sample_stats(&info);
+            alert_evaluate(info.cpu_utiliz, info.mem_utiliz.used_memory, info.mem_utiliz.total_memory, \
+                           info.timestamp_ns);
+            mark_sample_anomalies(cla, &cpu_detector, &mem_detector, &info);
+            StreamRecord rec = make_utiliz_record(seq++, &info);
+            shm_snapshot_publish(shm, info.cpu_utiliz, info.mem_utiliz.total_memory, info.mem_utiliz.used_memory, \
+                                 rec.wall_ns);
+            ts_record_sample(info.cpu_utiliz, info.mem_utiliz.used_memory, info.mem_utiliz.total_memory, rec.wall_ns);
+            flight_record_sample(info.cpu_utiliz, info.mem_utiliz.used_memory, info.mem_utiliz.total_memory, \
+                                 &info.sched, &info.vm, info.anomaly, rec.wall_ns);
+            publish(clients, &rec);
+            if (seq % SELF_STATS_EVERY == 0){
+                StreamRecord stats_rec = make_self_stats_record(seq / SELF_STATS_EVERY);
+                publish(clients, &stats_rec);
+            }
+        }
+
+        for (int i = 0; i < MAX_CLIENTS; i++){
+            if (clients[i].fd == -1 || pfds[2 + i].fd != clients[i].fd) continue;
+            short revents = pfds[2 + i].revents;
+            if (revents & (POLLHUP | POLLERR | POLLIN)){
+                // viewers never send data: readable means closed
+                char junk[64];
+                ssize_t got = recv(clients[i].fd, junk, sizeof(junk), MSG_DONTWAIT);
+                if (got == 0 || (got == -1 && errno != EAGAIN && errno != EINTR)){
+                    drop_client(&clients[i]);
+                    continue;
+                }
+            }
+            if ((revents & POLLOUT) && client_queue_flush(&clients[i].queue, clients[i].fd) == -1){
+                drop_client(&clients[i]);
+            }
+        }
+    }
+
+    printf("\nDaemon stopping...\n");
+    stop_daemon(listen_fd, cla, clients, &utiliz_fd[0], utiliz_pid, shm);
+    if (cla->self_stats) self_stats_print(stdout);
+    sampler_tuning_report(stdout);
+    return status;
+}
@@ -0,0 +1,31 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdbool.h>
+
+#include "CLA.h"
+#include "sysInfoProducer.h"
+#include "streamProtocol.h"
+#include "clientQueue.h"
+#include "flightRecorder.h"
+#include "pipeTool.h"
+#include "signalHandler.h"
+#include "shmSnapshot.h"
+#include "sysInfoConsumer.h"
+
+#ifndef SYSINFO_DAEMON_HEADER
+#define SYSINFO_DAEMON_HEADER
+
+/*
+This module implements --daemon mode. The daemon starts the usual producer process tree once,
+sampling until it is stopped with Ctrl+C, and publishes every sample as a StreamRecord to all 
+viewers connected to a Unix domain socket. Each viewer has its own bounded ClientQueue, so a slow
+viewer only loses its own old samples and never stalls the sampler or the other viewers.
+With --shm the newest sample is also published into a seqlock-guarded shared-memory snapshot.
+*/
+
+int run_daemon(CLAInfo* cla);
+
+#endif
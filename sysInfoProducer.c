@@ -1,90 +1,390 @@
 #define _DEFAULT_SOURCE
 #include "sysInfoProducer.h"
 #include <unistd.h>
+#include <poll.h>
+
+static bool keep_sampling(CLAInfo* cla_info, int i, int next_interval_us){
+    ///_|> descry: decides whether a utilization child takes another sample
+    ///_|> cla_info: pointer to parsed command-line arguments, type CLAInfo*
+    ///_|> i: number of samples already taken, type int
+    ///_|> next_interval_us: interval the child is about to sleep, type int
+    ///_|> returning: returns true while the run is not finished
+    if (cla_info->samples < 0) return true; // daemon: sample until killed
+    if (!cla_info->adaptive) return i < cla_info->samples;
+    // adaptive runs cover the same time span as a fixed run: samples * tdelay
+    long long deadline = cla_info->start_ns + (long long)cla_info->samples * cla_info->tdelay * 1000LL;
+    return now_mono_ns() + (long long)next_interval_us * 1000LL <= deadline;
+}
 
-void child_memory_writer(int total_samples, int tdelay, int mem_write_fd){
-    ///_|> descry: child process that fetches memory usage samples and writes them to a pipe
-    ///_|> total_samples: number of samples to collect, type int
-    ///_|> tdelay: delay between each sample in microseconds, type int
-    ///_|> mem_write_fd: write-end fd for memory pipe, type int
-    ///_|> returning: this function does not return; it exits the process
-    for (int i = 0; i < total_samples; i++){
-        usleep(tdelay); // wait between samples
-        MemoryInfo* curr_memory = get_MemoryInfo();
-        if (curr_memory == NULL){
-            fprintf(stderr, "Failed to get memory information in child process \n");
-            safe_close(&mem_write_fd);
-            free(curr_memory);
-            exit(EXIT_FAILURE);
+static int pause_and_measure_jitter(producerOutput* out, int interval_us, long long* tick_ns){
+    ///_|> descry: waits one sampling interval (or the coordinator's next tick) through the output and
+    ///_|>         measures how late the wake-up was
+    ///_|> out: output whose pause_us does the waiting, type producerOutput*
+    ///_|> interval_us: interval to wait in microseconds, type int
+    ///_|> tick_ns: receives the shared tick's timestamp, 0 when the output just slept, type long long*
+    ///_|> returning: returns the lateness of the wake-up in nanoseconds, or -1 if the output asked to stop
+    long long scheduled = now_mono_ns() + (long long)interval_us * 1000LL;
+    *tick_ns = out->pause_us(out->ctx, interval_us);
+    if (*tick_ns == -1) return -1;
+    // a tick is the schedule: lateness is how long after it this producer started reading
+    if (*tick_ns > 0) scheduled = *tick_ns;
+    long long late = now_mono_ns() - scheduled;
+    return (late > 0) ? (int)late : 0;
+}
+
+static void fill_usage(sampleTiming* timing, int usage_scope){
+    ///_|> descry: stores the calling producer's CPU time and peak RSS in a sampleTiming
+    ///_|> timing: pointer to the timing record to fill, type sampleTiming*
+    ///_|> usage_scope: getrusage() scope, RUSAGE_SELF or RUSAGE_THREAD, type int
+    ///_|> returning: this function does not return anything
+    struct rusage usage;
+    getrusage(usage_scope, &usage);
+    timing->cpu_time_us = rusage_cpu_us(&usage);
+    timing->max_rss_kb = usage.ru_maxrss;
+}
+
+int run_memory_producer(CLAInfo* cla_info, producerOutput* out){
+    ///_|> descry: sampling loop for timestamped memory usage, with the paging and reclaim rates of
+    ///_|>         /proc/vmstat read in the same tick under --vmstat; allocation-free, delivers through out
+    ///_|> cla_info: pointer to parsed command-line arguments (samples, tdelay, adaptive bounds, vmstat), type CLAInfo*
+    ///_|> out: where readings go and how intervals are waited, type producerOutput*
+    ///_|> returning: returns 0 when the run is complete or the output stopped it, -1 if memory could not be read
+    sampler_tuning_child(); // --mlock: memory locks do not survive fork()
+    vmstatCollector vmstat;
+    vmstatCounters vm_before, vm_after;
+    long long vm_prev = now_mono_ns(); // the rates are per second of time between two reads
+    if (cla_info->vmstat && (vmstat_collector_init(&vmstat) == -1 || fill_vmstatCounters(&vmstat, &vm_after) == -1)){
+        return -1;
+    }
+
+    AdaptiveSampler sampler;
+    adaptive_init(&sampler, cla_info->adapt_min_us, cla_info->adapt_max_us, cla_info->tdelay);
+    int interval = cla_info->adaptive ? sampler.interval_us : cla_info->tdelay;
+
+    int status = 0;
+    for (int i = 0; keep_sampling(cla_info, i, interval); i++){
+        memSample sample;
+        long long tick_ns;
+        sample.timing.jitter_ns = pause_and_measure_jitter(out, interval, &tick_ns);
+        if (sample.timing.jitter_ns == -1) break;
+        long long fetch_start = now_mono_ns();
+        int fetched = fill_MemoryInfo(&sample.mem);
+        clear_vmstat_info(&sample.vm);
+        if (fetched == 0 && cla_info->vmstat){
+            vm_before = vm_after;
+            fetched = fill_vmstatCounters(&vmstat, &vm_after);
+            calcu_vmstat_rates(&vm_before, &vm_after, fetch_start - vm_prev, &sample.vm);
+            vm_prev = fetch_start;
         }
-        // write memory info to pipe
-        if (write(mem_write_fd, curr_memory, sizeof(MemoryInfo)) == -1){
-            perror("write memory to pipe failed");
-            safe_close(&mem_write_fd);
-            free(curr_memory);
-            exit(EXIT_FAILURE);
+        sample.timing.fetch_ns = (int)(now_mono_ns() - fetch_start);
+        sample.timestamp_ns = (tick_ns > 0) ? tick_ns : fetch_start;
+        if (fetched == -1){
+            status = -1;
+            break;
+        }
+        fill_usage(&sample.timing, out->usage_scope);
+        if (out->emit(out->ctx, &sample, sizeof(memSample)) == -1) break;
+        if (cla_info->adaptive){
+            interval = adaptive_next_interval(&sampler, sample.mem.used_memory, sample.mem.total_memory);
         }
-        free(curr_memory);
     }
-    safe_close(&mem_write_fd); // close write-end after done
-    exit(EXIT_SUCCESS); // exit the process when done
+    if (cla_info->vmstat) vmstat_collector_close(&vmstat);
+    return status;
 }
 
-void child_cpu_writer(int total_samples, int tdelay, int cpu_write_fd){
-    ///_|> descry: child process that computes CPU utilization and writes results to a pipe
-    ///_|> total_samples: number of samples to collect, type int
-    ///_|> tdelay: delay between samples in microseconds, type int
-    ///_|> cpu_write_fd: write-end fd for CPU pipe, type int
-    ///_|> returning: this function does not return; it exits the process
-    cpuDelta* cpu_delta = (cpuDelta *)malloc(sizeof(cpuDelta));
-    cpu_delta->before = (cpuInfo*)malloc(sizeof(cpuInfo));
-    cpu_delta->after = (cpuInfo*)malloc(sizeof(cpuInfo));
-
-    cpuInfo* init_cpu = get_cpuInfo(); // initial cpu infomation
-
-    for (int i = 0; i < total_samples; i++){
-        usleep(tdelay); // wait between samples
-        cpuInfo* curr_cpuInfo = get_cpuInfo();
-        if (curr_cpuInfo == NULL){
-            fprintf(stderr, "Failed to get CPU information in process \n");
-            safe_close(&cpu_write_fd);
-            free(init_cpu);
-            free(curr_cpuInfo);
-            free_cpu_delta(cpu_delta);
-            exit(EXIT_FAILURE);
+int run_cpu_producer(CLAInfo* cla_info, producerOutput* out){
+    ///_|> descry: sampling loop for timestamped CPU utilization; allocation-free, delivers through out
+    ///_|> cla_info: pointer to parsed command-line arguments (samples, tdelay, adaptive bounds), type CLAInfo*
+    ///_|> out: where readings go and how intervals are waited, type producerOutput*
+    ///_|> returning: returns 0 when the run is complete or the output stopped it, -1 if /proc/stat could not be read
+    sampler_tuning_child();
+    // all snapshots live on this stack frame, the sampling loop never allocates
+    cpuInfo before, after, curr_cpuInfo;
+    cpuDelta cpu_delta = {&before, &after};
+    long long prev_fetch = now_mono_ns(); // the rates are per second of time between two reads
+    if (fill_cpuInfo(&after) == -1) return -1; // initial cpu infomation
+
+    AdaptiveSampler sampler;
+    adaptive_init(&sampler, cla_info->adapt_min_us, cla_info->adapt_max_us, cla_info->tdelay);
+    int interval = cla_info->adaptive ? sampler.interval_us : cla_info->tdelay;
+
+    for (int i = 0; keep_sampling(cla_info, i, interval); i++){
+        cpuSample sample;
+        long long tick_ns;
+        sample.timing.jitter_ns = pause_and_measure_jitter(out, interval, &tick_ns);
+        if (sample.timing.jitter_ns == -1) return 0;
+        long long fetch_start = now_mono_ns();
+        int fetched = fill_cpuInfo(&curr_cpuInfo);
+        sample.timing.fetch_ns = (int)(now_mono_ns() - fetch_start);
+        sample.timestamp_ns = (tick_ns > 0) ? tick_ns : fetch_start;
+        if (fetched == -1) return -1;
+        advance_delta(&cpu_delta, &curr_cpuInfo);
+
+        sample.cpu_utiliz = calcu_cpu_utiliz(&cpu_delta);
+        calcu_sched_info(&cpu_delta, fetch_start - prev_fetch, &sample.sched);
+        prev_fetch = fetch_start;
+        fill_usage(&sample.timing, out->usage_scope);
+        if (out->emit(out->ctx, &sample, sizeof(cpuSample)) == -1) return 0;
+        if (cla_info->adaptive){
+            interval = adaptive_next_interval(&sampler, sample.cpu_utiliz, 100.0);
         }
-        // for first iteration, use initial state
-        if (i == 0){
-            memcpy(cpu_delta->before, init_cpu, sizeof(cpuInfo));
-            memcpy(cpu_delta->after, curr_cpuInfo, sizeof(cpuInfo));
-        }else{
-            update_delta(cpu_delta, curr_cpuInfo);
+    }
+    return 0;
+}
+
+int run_numa_producer(CLAInfo* cla_info, producerOutput* out){
+    ///_|> descry: sampling loop for per-node NUMA readings (--numa), one numaSample per --tdelay;
+    ///_|>         allocation-free after the collector is set up
+    ///_|> cla_info: pointer to parsed command-line arguments (samples, tdelay), type CLAInfo*
+    ///_|> out: where readings go and how intervals are waited, type producerOutput*
+    ///_|> returning: returns 0 when the run is complete or the output stopped it, -1 if the node files could not be read
+    sampler_tuning_child();
+    numaCollector collector;
+    if (numa_collector_init(&collector) == -1) return -1;
+    int status = 0;
+    // the panel has one column per sample, so --adaptive does not change this loop
+    for (int i = 0; cla_info->samples < 0 || i < cla_info->samples; i++){
+        numaSample sample;
+        long long tick_ns;
+        if (pause_and_measure_jitter(out, cla_info->tdelay, &tick_ns) == -1) break;
+        long long fetch_start = now_mono_ns();
+        if (numa_collector_sample(&collector, &sample) == -1){
+            status = -1;
+            break;
         }
+        sample.timestamp_ns = (tick_ns > 0) ? tick_ns : fetch_start;
+        if (out->emit(out->ctx, &sample, sizeof(numaSample)) == -1) break;
+    }
+    numa_collector_close(&collector);
+    return status;
+}
 
-        float curr_cpu_utiliz = calcu_cpu_utiliz(cpu_delta);
-        // write utilization value to pipe
-        if (write(cpu_write_fd, &curr_cpu_utiliz, sizeof(float)) == -1){
-            perror("write cpu_utiliz to pipe failed");
-            safe_close(&cpu_write_fd);
-            free(init_cpu);
-            free(curr_cpuInfo);
-            free_cpu_delta(cpu_delta);
-            exit(EXIT_FAILURE);
+int run_irq_producer(CLAInfo* cla_info, producerOutput* out){
+    ///_|> descry: sampling loop for interrupt hot spots (--irq), one irqSample per --tdelay;
+    ///_|>         allocation-free after the collector is set up
+    ///_|> cla_info: pointer to parsed command-line arguments (samples, tdelay), type CLAInfo*
+    ///_|> out: where readings go and how intervals are waited, type producerOutput*
+    ///_|> returning: returns 0 when the run is complete or the output stopped it, -1 if the files could not be read
+    sampler_tuning_child();
+    irqCollector collector;
+    if (irq_collector_init(&collector) == -1) return -1;
+    int status = 0;
+    for (int i = 0; cla_info->samples < 0 || i < cla_info->samples; i++){
+        irqSample sample;
+        long long tick_ns;
+        if (pause_and_measure_jitter(out, cla_info->tdelay, &tick_ns) == -1) break;
+        long long fetch_start = now_mono_ns();
+        if (irq_collector_sample(&collector, &sample) == -1){
+            status = -1;
+            break;
+        }
+        sample.timestamp_ns = (tick_ns > 0) ? tick_ns : fetch_start;
+        if (out->emit(out->ctx, &sample, sizeof(irqSample)) == -1) break;
+    }
+    irq_collector_close(&collector);
+    return status;
+}
+
+int run_tick_producer(CLAInfo* cla_info, producerOutput* mem_out, producerOutput* cpu_out){
+    ///_|> descry: one sampling loop for memory and CPU (--batch-io): every tick reads all sources in one
+    ///_|>         batch (io_uring, or pread as fallback) and then runs the parsers on the filled buffers
+    ///_|> cla_info: pointer to parsed command-line arguments (graph flags, samples, tdelay, batch_io), type CLAInfo*
+    ///_|> mem_out / cpu_out: outputs of the memory and CPU readings, type producerOutput*
+    ///_|> returning: returns 0 when the run is complete or an output stopped it, -1 if a source could not be read
+    sampler_tuning_child();
+    bool if_memory = cla_info->graph_flag[0];
+    bool if_cpu = cla_info->graph_flag[1];
+    producerOutput* pacing = if_cpu ? cpu_out : mem_out; // both outputs wait the same way
+    procFile stat_file = PROC_FILE_INIT("/proc/stat");
+    procFile meminfo_file = PROC_FILE_INIT("/proc/meminfo");
+    procFile loadavg_file = PROC_FILE_INIT("/proc/loadavg");
+    procFile vmstat_file = PROC_FILE_INIT("/proc/vmstat");
+    BatchReader reader;
+    batch_reader_init(&reader, cla_info->batch_io == BATCH_IO_URING);
+    int stat_src = if_cpu ? batch_reader_add(&reader, &stat_file, TICK_STAT_BUF_SIZE) : -1;
+    // the load averages are optional, a fixture root may not have them
+    int loadavg_src = (if_cpu && proc_file_fd(&loadavg_file) != -1) ? \
+                      batch_reader_add(&reader, &loadavg_file, TICK_LOADAVG_BUF_SIZE) : -1;
+    int meminfo_src = if_memory ? batch_reader_add(&reader, &meminfo_file, TICK_MEMINFO_BUF_SIZE) : -1;
+    bool if_vmstat = if_memory && cla_info->vmstat;
+    int vmstat_src = if_vmstat ? batch_reader_add(&reader, &vmstat_file, VMSTAT_BUF_SIZE) : -1;
+
+    int status = 0;
+    cpuInfo before, after, curr_cpuInfo;
+    cpuDelta cpu_delta = {&before, &after};
+    vmstatTable vmstat_table;
+    vmstatCounters vm_before, vm_after;
+    long long prev_fetch = now_mono_ns();
+    if ((if_cpu && stat_src == -1) || (if_memory && meminfo_src == -1) || (if_vmstat && vmstat_src == -1)) status = -1;
+    // initial cpu and vmstat infomation
+    if (status == 0 && (if_cpu || if_vmstat) && batch_reader_read_all(&reader) == -1) status = -1;
+    if (status == 0 && if_cpu){
+        if (batch_reader_text(&reader, stat_src) == NULL \
+            || parse_cpuInfo(batch_reader_text(&reader, stat_src), &after) == -1) status = -1;
+        parse_loadavg(batch_reader_text(&reader, loadavg_src), &after);
+    }
+    if (status == 0 && if_vmstat){
+        const char* text = batch_reader_text(&reader, vmstat_src);
+        if (text == NULL || vmstat_table_build(&vmstat_table, text) == -1) status = -1;
+        else parse_vmstat(&vmstat_table, text, &vm_after);
+    }
+
+    AdaptiveSampler mem_sampler, cpu_sampler;
+    adaptive_init(&mem_sampler, cla_info->adapt_min_us, cla_info->adapt_max_us, cla_info->tdelay);
+    adaptive_init(&cpu_sampler, cla_info->adapt_min_us, cla_info->adapt_max_us, cla_info->tdelay);
+    int interval = cla_info->adaptive ? cpu_sampler.interval_us : cla_info->tdelay;
+
+    for (int i = 0; status == 0 && keep_sampling(cla_info, i, interval); i++){
+        sampleTiming timing;
+        long long tick_ns;
+        timing.jitter_ns = pause_and_measure_jitter(pacing, interval, &tick_ns);
+        if (timing.jitter_ns == -1) break;
+        long long fetch_start = now_mono_ns();
+        int read = batch_reader_read_all(&reader);
+        timing.fetch_ns = (int)(now_mono_ns() - fetch_start);
+        // both metrics of a tick carry the same timestamp
+        long long timestamp = (tick_ns > 0) ? tick_ns : fetch_start;
+        if (read == -1){
+            status = -1;
+            break;
+        }
+        if (if_memory){
+            memSample sample;
+            sample.timestamp_ns = timestamp;
+            sample.timing = timing;
+            const char* text = batch_reader_text(&reader, meminfo_src);
+            if (text == NULL || parse_MemoryInfo(text, &sample.mem) == -1){
+                status = -1;
+                break;
+            }
+            clear_vmstat_info(&sample.vm);
+            if (if_vmstat){
+                const char* vmstat_text = batch_reader_text(&reader, vmstat_src);
+                if (vmstat_text == NULL){
+                    status = -1;
+                    break;
+                }
+                vm_before = vm_after;
+                parse_vmstat(&vmstat_table, vmstat_text, &vm_after);
+                calcu_vmstat_rates(&vm_before, &vm_after, fetch_start - prev_fetch, &sample.vm);
+            }
+            fill_usage(&sample.timing, mem_out->usage_scope);
+            if (mem_out->emit(mem_out->ctx, &sample, sizeof(memSample)) == -1) break;
+            if (cla_info->adaptive) adaptive_next_interval(&mem_sampler, sample.mem.used_memory, sample.mem.total_memory);
+        }
+        if (if_cpu){
+            cpuSample sample;
+            sample.timestamp_ns = timestamp;
+            sample.timing = timing;
+            const char* text = batch_reader_text(&reader, stat_src);
+            if (text == NULL || parse_cpuInfo(text, &curr_cpuInfo) == -1){
+                status = -1;
+                break;
+            }
+            parse_loadavg(batch_reader_text(&reader, loadavg_src), &curr_cpuInfo);
+            advance_delta(&cpu_delta, &curr_cpuInfo);
+            sample.cpu_utiliz = calcu_cpu_utiliz(&cpu_delta);
+            calcu_sched_info(&cpu_delta, fetch_start - prev_fetch, &sample.sched);
+            fill_usage(&sample.timing, cpu_out->usage_scope);
+            if (cpu_out->emit(cpu_out->ctx, &sample, sizeof(cpuSample)) == -1) break;
+            if (cla_info->adaptive) adaptive_next_interval(&cpu_sampler, sample.cpu_utiliz, 100.0);
+        }
+        prev_fetch = fetch_start;
+        // one tick serves both metrics: follow whichever currently needs the shorter interval
+        if (cla_info->adaptive){
+            interval = (if_memory && (!if_cpu || mem_sampler.interval_us < cpu_sampler.interval_us)) ? \
+                       mem_sampler.interval_us : cpu_sampler.interval_us;
         }
-        free(curr_cpuInfo);
     }
-    safe_close(&cpu_write_fd); // close write-end after done
-    free(init_cpu);
-    free_cpu_delta(cpu_delta);
+    batch_reader_close(&reader);
+    proc_file_close(&stat_file);
+    proc_file_close(&meminfo_file);
+    proc_file_close(&loadavg_file);
+    proc_file_close(&vmstat_file);
+    return status;
+}
+
+typedef struct {
+    int sample_fd;
+    int tick_fd;
+}childPipes;
+///_|> descry: Pipes of a utilization child, the ctx of its producerOutput
+///_|> members:
+///_|>     - sample_fd: write-end of the pipe carrying readings to the coordinator, type int
+///_|>     - tick_fd: read-end of the coordinator's tick pipe, -1 when the child paces itself (--adaptive), type int
+
+static int pipe_emit(void* ctx, const void* sample, size_t size){
+    ///_|> descry: producerOutput.emit of the child processes: writes the sample to the pipe, exits on failure
+    ///_|> ctx: the child's pipes, type childPipes*
+    ///_|> sample / size: sample to write and its size, type const void* / size_t
+    ///_|> returning: returns 0
+    childPipes* pipes = (childPipes*)ctx;
+    if (write(pipes->sample_fd, sample, size) == -1){
+        perror("write sample to pipe failed");
+        safe_close(&pipes->sample_fd);
+        exit(EXIT_FAILURE);
+    }
+    return 0;
+}
+
+static long long pipe_pause_us(void* ctx, int interval_us){
+    ///_|> descry: producerOutput.pause_us of the child processes: waits for the coordinator's next tick,
+    ///_|>         or sleeps the interval when the child paces itself
+    ///_|> ctx: the child's pipes, type childPipes*
+    ///_|> interval_us: interval to sleep in microseconds when there is no tick pipe, type int
+    ///_|> returning: returns the tick's timestamp, 0 after a plain sleep, -1 once the coordinator stopped ticking
+    childPipes* pipes = (childPipes*)ctx;
+    if (pipes->tick_fd == -1){
+        usleep(interval_us); // wait between samples
+        return 0;
+    }
+    long long tick_ns;
+    if (read_full(pipes->tick_fd, &tick_ns, sizeof(tick_ns)) != sizeof(tick_ns)) return -1;
+    return tick_ns;
+}
+
+void child_memory_writer(CLAInfo* cla_info, int mem_write_fd, int tick_read_fd){
+    ///_|> descry: child process that fetches timestamped memory usage samples and writes them to a pipe
+    ///_|> cla_info: pointer to parsed command-line arguments (samples, tdelay, adaptive bounds), type CLAInfo*
+    ///_|> mem_write_fd: write-end fd for memory pipe, type int
+    ///_|> tick_read_fd: read-end of the coordinator's tick pipe, -1 to pace itself, type int
+    ///_|> returning: this function does not return; it exits the process
+    childPipes pipes = {mem_write_fd, tick_read_fd};
+    producerOutput out = {pipe_emit, pipe_pause_us, &pipes, RUSAGE_SELF};
+    if (run_memory_producer(cla_info, &out) == -1){
+        fprintf(stderr, "Failed to get memory information in child process \n");
+        safe_close(&pipes.sample_fd);
+        exit(EXIT_FAILURE);
+    }
+    safe_close(&pipes.sample_fd); // close write-end after done
+    safe_close(&pipes.tick_fd);
+    exit(EXIT_SUCCESS); // exit the process when done
+}
+
+void child_cpu_writer(CLAInfo* cla_info, int cpu_write_fd, int tick_read_fd){
+    ///_|> descry: child process that computes timestamped CPU utilization and writes results to a pipe
+    ///_|> cla_info: pointer to parsed command-line arguments (samples, tdelay, adaptive bounds), type CLAInfo*
+    ///_|> cpu_write_fd: write-end fd for CPU pipe, type int
+    ///_|> tick_read_fd: read-end of the coordinator's tick pipe, -1 to pace itself, type int
+    ///_|> returning: this function does not return; it exits the process
+    childPipes pipes = {cpu_write_fd, tick_read_fd};
+    producerOutput out = {pipe_emit, pipe_pause_us, &pipes, RUSAGE_SELF};
+    if (run_cpu_producer(cla_info, &out) == -1){
+        fprintf(stderr, "Failed to get CPU information in process \n");
+        safe_close(&pipes.sample_fd);
+        exit(EXIT_FAILURE);
+    }
+    safe_close(&pipes.sample_fd); // close write-end after done
+    safe_close(&pipes.tick_fd);
     exit(EXIT_SUCCESS);  // exit the process when done
 }
 
-ssize_t parent_memory_reader(int mem_read_fd, MemoryInfo* mem_info){
-    ///_|> descry: reads one memory usage sample from the memory pipe into provided struct
+ssize_t parent_memory_reader(int mem_read_fd, memSample* mem_sample){
+    ///_|> descry: reads one timestamped memory usage sample from the memory pipe into provided struct
     ///_|> mem_read_fd: read-end fd of the memory pipe, type int
-    ///_|> mem_info: pointer to a MemoryInfo struct to populate, type MemoryInfo*
+    ///_|> mem_sample: pointer to a memSample struct to populate, type memSample*
     ///_|> returning: number of bytes read, or -1 for signal, or exit when error
-    ssize_t read_memory = read(mem_read_fd, mem_info, sizeof(MemoryInfo));
+    ssize_t read_memory = read_full(mem_read_fd, mem_sample, sizeof(memSample));
     if (read_memory == -1){
         // check if interrupted by signal (i.e SIGINT), avoid exit
         if (check_sigint()) return -1;
@@ -95,12 +395,12 @@ ssize_t parent_memory_reader(int mem_read_fd, MemoryInfo* mem_info){
     return read_memory;
 } 
 
-ssize_t parent_cpu_reader(int cpu_read_fd, float* cpu_utilize){
-    ///_|> descry: reads one CPU utilization sample from the CPU pipe into a float
+ssize_t parent_cpu_reader(int cpu_read_fd, cpuSample* cpu_sample){
+    ///_|> descry: reads one timestamped CPU utilization sample from the CPU pipe
     ///_|> cpu_read_fd: read-end fd of the CPU pipe, type int
-    ///_|> cpu_utilize: pointer to a float to store CPU utilization, type float*
+    ///_|> cpu_sample: pointer to a cpuSample struct to populate, type cpuSample*
     ///_|> returning: number of bytes read, or -1 for signal, or exit when error
-    ssize_t read_cpu = read(cpu_read_fd, cpu_utilize, sizeof(float));
+    ssize_t read_cpu = read_full(cpu_read_fd, cpu_sample, sizeof(cpuSample));
     if (read_cpu == -1){
         // check if interrupted by signal (i.e SIGINT), avoid exit
         if (check_sigint()) return -1;
@@ -111,82 +411,176 @@ ssize_t parent_cpu_reader(int cpu_read_fd, float* cpu_utilize){
     return read_cpu; 
 }
 
-void child_max_freq_writer(int max_freq_write_fd){
-    ///_|> descry: child process that writes maximum CPU frequency to a pipe
-    ///_|> max_freq_write_fd: write-end fd for frequency pipe, type int
-    ///_|> returning: this function does not return; it exits the process
-    float max_freq = get_max_freq();
-    if (max_freq < 0){
-        fprintf(stderr, "get max_freq failed in children \n");
-        safe_close(&max_freq_write_fd);
-        exit(EXIT_FAILURE);
+static void utilization_writer(int write_to_parent_fd, UtilizInfo* utitiz_info, int mem_read_fd, int cpu_read_fd){
+    ///_|> descry: writes one combined utilization struct to the main process, exits on failure
+    ///_|> write_to_parent_fd: write-end fd to the main process, type int
+    ///_|> utitiz_info: combined sample to send, type UtilizInfo*
+    ///_|> mem_read_fd: memory pipe read-end, closed on failure, type int
+    ///_|> cpu_read_fd: CPU pipe read-end, closed on failure, type int
+    ///_|> returning: this function does not return anything
+    // usage of the coordinator itself plus what its producers reported with their latest readings
+    sampleTiming own;
+    fill_usage(&own, RUSAGE_SELF);
+    utitiz_info->producers_cpu_us = own.cpu_time_us + utitiz_info->cpu_timing.cpu_time_us + \
+                                    utitiz_info->mem_timing.cpu_time_us;
+    utitiz_info->producers_max_rss_kb = own.max_rss_kb;
+    if (utitiz_info->cpu_timing.max_rss_kb > utitiz_info->producers_max_rss_kb){
+        utitiz_info->producers_max_rss_kb = utitiz_info->cpu_timing.max_rss_kb;
     }
-
-    if (write(max_freq_write_fd, &max_freq, sizeof(float)) == -1){
-        perror("write max_freq to pipe failed");
-        safe_close(&max_freq_write_fd);
+    if (utitiz_info->mem_timing.max_rss_kb > utitiz_info->producers_max_rss_kb){
+        utitiz_info->producers_max_rss_kb = utitiz_info->mem_timing.max_rss_kb;
+    }
+    if (write(write_to_parent_fd, utitiz_info, sizeof(UtilizInfo)) == -1){
+        perror("fail to write utilization infomation to parent");
+        safe_close(&mem_read_fd);
+        safe_close(&cpu_read_fd);
+        safe_close(&write_to_parent_fd);
         exit(EXIT_FAILURE);
     }
-    safe_close(&max_freq_write_fd); // close write-end after done
-    exit(EXIT_SUCCESS);  // exit the process when done
+    // mark the stage timings as consumed so the next struct only carries fresh measurements
+    utitiz_info->cpu_timing.fetch_ns = -1;
+    utitiz_info->cpu_timing.jitter_ns = -1;
+    utitiz_info->mem_timing.fetch_ns = -1;
+    utitiz_info->mem_timing.jitter_ns = -1;
 }
 
-void child_core_count_writer(int core_count_write_fd){
-    ///_|> descry: child process that writes core count to a pipe
-    ///_|> core_count_write_fd: write-end fd for core count pipe, type int
-    ///_|> returning: this function does not return; it exits the process
-    int core_count = get_cores_num();
-    if (core_count < 0){
-        fprintf(stderr, "get core_count failed in children process \n");
-        safe_close(&core_count_write_fd);
-        exit(EXIT_FAILURE);
-    }
-    if (write(core_count_write_fd, &core_count, sizeof(int)) == -1){
-        perror("write core count to pipe failed");
-        safe_close(&core_count_write_fd);
-        exit(EXIT_FAILURE);
-    }
-    safe_close(&core_count_write_fd); // close write-end after done
-    exit(EXIT_SUCCESS); // exit the process when done
+static void sleep_until_ns(long long deadline_ns){
+    ///_|> descry: sleeps until an absolute CLOCK_MONOTONIC time, so a tick schedule does not drift
+    ///_|> deadline_ns: wake-up time in nanoseconds, type long long
+    ///_|> returning: this function does not return anything
+    struct timespec deadline;
+    deadline.tv_sec = deadline_ns / 1000000000LL;
+    deadline.tv_nsec = deadline_ns % 1000000000LL;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR){}
 }
 
-void parent_max_freq_reader(int max_freq_read_fd, float* max_freq){
-    ///_|> descry: parent process reads the maximum frequency value from pipe
-    ///_|> max_freq_read_fd: read-end fd for frequency pipe, type int
-    ///_|> max_freq: pointer to float to store the received frequency, type float*
+static void send_tick(int tick_fd, long long tick_ns){
+    ///_|> descry: wakes one child for the current tick, exits if the child is gone
+    ///_|> tick_fd: write-end of the child's tick pipe, -1 when the metric is disabled, type int
+    ///_|> tick_ns: timestamp shared by every reading of the tick, type long long
     ///_|> returning: this function does not return anything
-    if (read(max_freq_read_fd, max_freq, sizeof(float)) == -1){
-        perror("read max_freq from pipe failed");
-        safe_close(&max_freq_read_fd);
+    if (tick_fd == -1) return;
+    if (write(tick_fd, &tick_ns, sizeof(tick_ns)) == -1){
+        perror("write tick to utilization child failed");
         exit(EXIT_FAILURE);
     }
-    safe_close(&max_freq_read_fd); // close read-end after done
 }
 
-void parent_core_count_reader(int core_count_read_fd, int* core_count){
-    ///_|> descry: parent process reads the number of CPU cores from pipe
-    ///_|> core_count_read_fd: read-end fd for core count pipe, type int
-    ///_|> core_count: pointer to int to store received core count, type int*
+static void pair_fixed_samples(CLAInfo* cla_info, int mem_read_fd, int cpu_read_fd, int* mem_tick_fd, \
+int* cpu_tick_fd, int write_to_parent_fd, UtilizInfo* utitiz_info){
+    ///_|> descry: fixed-interval mode: drives one tick every --tdelay on an absolute schedule, wakes every
+    ///_|>         enabled child with the tick's timestamp and pairs the readings taken for that tick
+    ///_|> cla_info: pointer to parsed command-line arguments (graph flags, samples, tdelay), type CLAInfo*
+    ///_|> mem_read_fd / cpu_read_fd: read-ends of the children's sample pipes, type int
+    ///_|> mem_tick_fd / cpu_tick_fd: write-ends of the children's tick pipes, closed when the run ends, type int*
+    ///_|> write_to_parent_fd: write-end fd to the main process, type int
+    ///_|> utitiz_info: struct reused for every combined sample, type UtilizInfo*
     ///_|> returning: this function does not return anything
-    if (read(core_count_read_fd, core_count, sizeof(int)) == -1){
-        perror("read core count from pipe failed");
-        safe_close(&core_count_read_fd);
-        exit(EXIT_FAILURE);
+    bool if_memory = cla_info->graph_flag[0];
+    bool if_cpu = cla_info->graph_flag[1];
+    long long period_ns = (long long)cla_info->tdelay * 1000LL;
+    long long next_tick = now_mono_ns();
+    memSample mem_sample;
+    cpuSample cpu_sample;
+    for (int i = 0; keep_sampling(cla_info, i, cla_info->tdelay); i++){
+        next_tick += period_ns;
+        sleep_until_ns(next_tick);
+        long long tick_ns = now_mono_ns();
+        send_tick(*mem_tick_fd, tick_ns);
+        send_tick(*cpu_tick_fd, tick_ns);
+
+        ssize_t read_memory = 0;
+        ssize_t read_cpu = 0;
+        // -1 means a signal interrupted the read, the reading of this tick is still coming
+        if (if_memory){
+            do { read_memory = parent_memory_reader(mem_read_fd, &mem_sample); } while (read_memory < 0);
+        }
+        if (if_cpu){
+            do { read_cpu = parent_cpu_reader(cpu_read_fd, &cpu_sample); } while (read_cpu < 0);
+        }
+        // a child finished early (it failed, or its sample count is done)
+        if ((if_memory && read_memory == 0) || (if_cpu && read_cpu == 0)) break;
+
+        utitiz_info->timestamp_ns = tick_ns;
+        utitiz_info->skew_ns = -1;
+        if (read_memory > 0){
+            utitiz_info->mem_utiliz = mem_sample.mem;
+            utitiz_info->vm = mem_sample.vm;
+            utitiz_info->mem_timing = mem_sample.timing;
+        }
+        if (read_cpu > 0){
+            utitiz_info->cpu_utiliz = cpu_sample.cpu_utiliz;
+            utitiz_info->sched = cpu_sample.sched;
+            utitiz_info->cpu_timing = cpu_sample.timing;
+        }
+        // both readings carry the tick's timestamp; how far apart they were really taken is the
+        // difference of the children's wake-up delays
+        if (read_memory > 0 && read_cpu > 0){
+            int skew = mem_sample.timing.jitter_ns - cpu_sample.timing.jitter_ns;
+            utitiz_info->skew_ns = (skew < 0) ? -skew : skew;
+        }
+        // write utilization information to upper parent process main process
+        utilization_writer(write_to_parent_fd, utitiz_info, mem_read_fd, cpu_read_fd);
     }
-    safe_close(&core_count_read_fd); // close read-end after done
+    // no further ticks: the children see EOF and exit
+    safe_close(mem_tick_fd);
+    safe_close(cpu_tick_fd);
 }
 
-void core_info_writer(int core_info_write_fd, coreInfo* core_info){
-    ///_|> descry: writes a coreInfo struct to parent process through a pipe
-    ///_|> core_info_write_fd: write-end fd, type int
-    ///_|> core_info: pointer to the coreInfo struct to send, type coreInfo*
+static void merge_adaptive_samples(bool if_memory, bool if_cpu, int mem_read_fd, int cpu_read_fd, \
+int write_to_parent_fd, UtilizInfo* utitiz_info){
+    ///_|> descry: adaptive mode: children sample at different rates, so every reading is forwarded as soon
+    ///_|>         as it arrives, combined with the latest reading of the other metric
+    ///_|> if_memory / if_cpu: which children are running, type bool
+    ///_|> mem_read_fd / cpu_read_fd: read-ends of the children's pipes, type int
+    ///_|> write_to_parent_fd: write-end fd to the main process, type int
+    ///_|> utitiz_info: struct holding the latest value of each metric, type UtilizInfo*
     ///_|> returning: this function does not return anything
-    if (write(core_info_write_fd, core_info, sizeof(coreInfo)) == -1){
-        perror("fail to write core infomation to parent main");
-        safe_close(&core_info_write_fd);
-        exit(EXIT_FAILURE);
+    bool mem_open = if_memory;
+    bool cpu_open = if_cpu;
+    bool mem_seen = !if_memory;
+    bool cpu_seen = !if_cpu;
+    while (mem_open || cpu_open){
+        struct pollfd pfds[2];
+        pfds[0].fd = mem_open ? mem_read_fd : -1;
+        pfds[0].events = POLLIN;
+        pfds[1].fd = cpu_open ? cpu_read_fd : -1;
+        pfds[1].events = POLLIN;
+        if (poll(pfds, 2, -1) == -1){
+            if (errno == EINTR) continue;
+            perror("poll in utilization coordinator failed");
+            exit(EXIT_FAILURE);
+        }
+        long long newest = -1;
+        if (pfds[0].revents & (POLLIN | POLLHUP)){
+            memSample mem_sample;
+            ssize_t got = parent_memory_reader(mem_read_fd, &mem_sample);
+            if (got == 0) mem_open = false;
+            if (got > 0){
+                utitiz_info->mem_utiliz = mem_sample.mem;
+                utitiz_info->vm = mem_sample.vm;
+                utitiz_info->mem_timing = mem_sample.timing;
+                newest = mem_sample.timestamp_ns;
+                mem_seen = true;
+            }
+        }
+        if (pfds[1].revents & (POLLIN | POLLHUP)){
+            cpuSample cpu_sample;
+            ssize_t got = parent_cpu_reader(cpu_read_fd, &cpu_sample);
+            if (got == 0) cpu_open = false;
+            if (got > 0){
+                utitiz_info->cpu_utiliz = cpu_sample.cpu_utiliz;
+                utitiz_info->sched = cpu_sample.sched;
+                utitiz_info->cpu_timing = cpu_sample.timing;
+                if (cpu_sample.timestamp_ns > newest) newest = cpu_sample.timestamp_ns;
+                cpu_seen = true;
+            }
+        }
+        // wait until every enabled metric has a value before forwarding anything
+        if (newest < 0 || !mem_seen || !cpu_seen) continue;
+        utitiz_info->timestamp_ns = newest;
+        utilization_writer(write_to_parent_fd, utitiz_info, mem_read_fd, cpu_read_fd);
     }
-    safe_close(&core_info_write_fd); // close write-end after done
 }
 
 void fetch_utilization_with_pipe(CLAInfo* cla_info, int write_to_parent_fd){
@@ -194,13 +588,15 @@ void fetch_utilization_with_pipe(CLAInfo* cla_info, int write_to_parent_fd){
     ///_|> cla_info: pointer to parsed command-line arguments controlling sampling, type CLAInfo*
     ///_|> write_to_parent_fd: write-end fd used to send data to parent process, type int
     ///_|> returning: this function does not return; it exits after completion or failure
-    int total_samples = cla_info->samples;
-    int tdelay = cla_info->tdelay;
+    sampler_tuning_child(); // this process pairs and times the readings
     bool if_memory = cla_info->graph_flag[0];
     bool if_cpu = cla_info->graph_flag[1];
     // initialize fd with -1
     int mem_fd[2] = {-1, -1}; // memory pipe: [0] = read-end, [1] = write-end
     int cpu_fd[2] = {-1, -1}; // cpu pipe
+    // fixed mode: the coordinator ticks both children through these, [1] stays with the coordinator
+    int mem_tick_fd[2] = {-1, -1};
+    int cpu_tick_fd[2] = {-1, -1};
 
     // initialize memory and utlization information struct
     MemoryInfo mem_info;
@@ -208,7 +604,14 @@ void fetch_utilization_with_pipe(CLAInfo* cla_info, int write_to_parent_fd){
     mem_info.used_memory = -1;
     UtilizInfo utitiz_info;
     utitiz_info.cpu_utiliz = -1;
+    clear_sched_info(&utitiz_info.sched);
     utitiz_info.mem_utiliz = mem_info;
+    clear_vmstat_info(&utitiz_info.vm);
+    utitiz_info.timestamp_ns = 0;
+    utitiz_info.skew_ns = -1;
+    utitiz_info.anomaly = 0;
+    memset(&utitiz_info.cpu_timing, 0, sizeof(sampleTiming));
+    memset(&utitiz_info.mem_timing, 0, sizeof(sampleTiming));
     // create pipes
     if (pipe(mem_fd) == -1){
         perror("pipe for memory created failed");
@@ -218,6 +621,10 @@ void fetch_utilization_with_pipe(CLAInfo* cla_info, int write_to_parent_fd){
         perror("pipe for cpu created failed");
         exit_failure_with_two_pipe_close(mem_fd, cpu_fd);
     }
+    if (!cla_info->adaptive && ((if_memory && pipe(mem_tick_fd) == -1) || (if_cpu && pipe(cpu_tick_fd) == -1))){
+        perror("tick pipe for utilization children created failed");
+        exit_failure_with_two_pipe_close(mem_fd, cpu_fd);
+    }
 
     // skip if both CPU and memory are disabled
     if (!if_memory && !if_cpu)return;
@@ -231,7 +638,10 @@ void fetch_utilization_with_pipe(CLAInfo* cla_info, int write_to_parent_fd){
             safe_close(&cpu_fd[0]);
             safe_close(&cpu_fd[1]);
             safe_close(&mem_fd[0]);
-            child_memory_writer(total_samples, tdelay, mem_fd[1]);
+            safe_close(&mem_tick_fd[1]);
+            safe_close(&cpu_tick_fd[0]);
+            safe_close(&cpu_tick_fd[1]);
+            child_memory_writer(cla_info, mem_fd[1], mem_tick_fd[0]);
         }
         else if (mem_pid < 0){
             perror("fork failed for memory");
@@ -248,7 +658,10 @@ void fetch_utilization_with_pipe(CLAInfo* cla_info, int write_to_parent_fd){
             safe_close(&mem_fd[0]);
             safe_close(&mem_fd[1]);
             safe_close(&cpu_fd[0]);
-            child_cpu_writer(total_samples, tdelay, cpu_fd[1]);
+            safe_close(&cpu_tick_fd[1]);
+            safe_close(&mem_tick_fd[0]);
+            safe_close(&mem_tick_fd[1]);
+            child_cpu_writer(cla_info, cpu_fd[1], cpu_tick_fd[0]);
         }
         else if (cpu_pid < 0){
             perror("fork failed for cpu");
@@ -257,33 +670,15 @@ void fetch_utilization_with_pipe(CLAInfo* cla_info, int write_to_parent_fd){
     }
 
     // parent process
-    ssize_t read_memory = 0;
-    ssize_t read_cpu = 0;
-
     safe_close(&mem_fd[1]);
     safe_close(&cpu_fd[1]);
-    while(true){
-        // read from memory and cpu pipes
-        if (if_memory){
-            read_memory = parent_memory_reader(mem_fd[0], &utitiz_info.mem_utiliz);
-        }
-        if (if_cpu){
-            read_cpu = parent_cpu_reader(cpu_fd[0], &utitiz_info.cpu_utiliz);
-        }
-
-        // break on EOF
-        if (read_memory == 0 && read_cpu == 0) break;
-        // // skip this iteration on  SIGINT received
-        if (read_memory < 0 || read_cpu < 0)continue;
-
-        // write utilization information to upper parent process main process
-        if (write(write_to_parent_fd, &utitiz_info, sizeof(UtilizInfo)) == -1){
-            perror("fail to write utilization infomation to parent");
-            safe_close(&mem_fd[0]);
-            safe_close(&cpu_fd[0]);
-            safe_close(&write_to_parent_fd);
-            exit(EXIT_FAILURE);
-        }
+    safe_close(&mem_tick_fd[0]);
+    safe_close(&cpu_tick_fd[0]);
+    if (cla_info->adaptive){
+        merge_adaptive_samples(if_memory, if_cpu, mem_fd[0], cpu_fd[0], write_to_parent_fd, &utitiz_info);
+    }else{
+        pair_fixed_samples(cla_info, mem_fd[0], cpu_fd[0], &mem_tick_fd[1], &cpu_tick_fd[1], write_to_parent_fd, \
+                           &utitiz_info);
     }
     // cleanup
     safe_close(&write_to_parent_fd);
@@ -302,75 +697,34 @@ void fetch_utilization_with_pipe(CLAInfo* cla_info, int write_to_parent_fd){
     exit(EXIT_SUCCESS); // exit the process when done
 }
 
-void fetch_core_info_with_pipe(int write_fd_to_parent){
-    ///_|> descry: launches two child processes to fetch max frequency and core count concurrently,
-    ///_|>         then sends the combined coreInfo struct to the parent process
-    ///_|> write_fd_to_parent: write-end fd to send coreInfo to parent, type int
-    ///_|> returning: this function does not return; it exits after completion or error
-    // initialize fd with -1
-    int max_freq_fd[2] = {-1, -1}; // pipe for max frequency
-    int core_count_fd[2] = {-1, -1};  // core count
-    // create pipes
-    if (pipe(max_freq_fd) == -1 || pipe(core_count_fd) == -1){
-        perror("pipe for core_info created failed");
-        exit(EXIT_FAILURE);
-    }
-
-    coreInfo core_info;
-    core_info.cores_num = -1;
-    core_info.max_freq = -1;
-
-    pid_t max_freq_pid = fork();
-    if (max_freq_pid == 0){
-        // child process to get max frequency
-        safe_close(&write_fd_to_parent);
-        safe_close(&core_count_fd[0]);
-        safe_close(&core_count_fd[1]);
-        safe_close(&max_freq_fd[0]);
-        child_max_freq_writer(max_freq_fd[1]);
-    }
-    else if (max_freq_pid < 0){
-        perror("fork failed for max frequency");
-        exit_failure_with_two_pipe_close(core_count_fd, max_freq_fd);
-    }
-
-    pid_t core_count_pid = fork();
-    if (core_count_pid == 0){
-        // child process to get core count
-        safe_close(&write_fd_to_parent);
-        safe_close(&max_freq_fd[0]);
-        safe_close(&max_freq_fd[1]);
-        safe_close(&core_count_fd[0]);
-        child_core_count_writer(core_count_fd[1]);
-    }
-    else if (core_count_pid < 0){
-        perror("fork failed for core count");
-        exit_failure_with_two_pipe_close(core_count_fd, max_freq_fd);
-    }
-    // parent process: read both values from respective pipes
-    safe_close(&max_freq_fd[1]);
-    parent_max_freq_reader(max_freq_fd[0], &core_info.max_freq);
-    safe_close(&core_count_fd[1]);
-    parent_core_count_reader(core_count_fd[0], &core_info.cores_num);
-
-    // send core info to main parent process
-    core_info_writer(write_fd_to_parent, &core_info);
-
-    // wait for both child processes
-    if (wait_for_children(max_freq_pid) == -1){
-        perror("child process of get max frequency exited abnormally.");
+void fetch_numa_with_pipe(CLAInfo* cla_info, int write_fd_to_parent){
+    ///_|> descry: child process that samples every NUMA node and writes numaSamples to the main process
+    ///_|> cla_info: pointer to parsed command-line arguments (samples, tdelay), type CLAInfo*
+    ///_|> write_fd_to_parent: write-end fd to send numaSample to parent, type int
+    ///_|> returning: this function does not return; it exits the process
+    childPipes pipes = {write_fd_to_parent, -1}; // not paired with anything: paces itself
+    producerOutput out = {pipe_emit, pipe_pause_us, &pipes, RUSAGE_SELF};
+    if (run_numa_producer(cla_info, &out) == -1){
+        fprintf(stderr, "Failed to get NUMA node information in child process \n");
+        safe_close(&pipes.sample_fd);
         exit(EXIT_FAILURE);
     }
+    safe_close(&pipes.sample_fd); // close write-end after done
+    exit(EXIT_SUCCESS); // exit the process when done
+}
 
-    if (wait_for_children(core_count_pid) == -1){
-        perror("child process of get core count exited abnormally.");
+void fetch_irq_with_pipe(CLAInfo* cla_info, int write_fd_to_parent){
+    ///_|> descry: child process that samples /proc/interrupts and /proc/softirqs and writes irqSamples to the main process
+    ///_|> cla_info: pointer to parsed command-line arguments (samples, tdelay), type CLAInfo*
+    ///_|> write_fd_to_parent: write-end fd to send irqSample to parent, type int
+    ///_|> returning: this function does not return; it exits the process
+    childPipes pipes = {write_fd_to_parent, -1}; // not paired with anything: paces itself
+    producerOutput out = {pipe_emit, pipe_pause_us, &pipes, RUSAGE_SELF};
+    if (run_irq_producer(cla_info, &out) == -1){
+        fprintf(stderr, "Failed to get interrupt information in child process \n");
+        safe_close(&pipes.sample_fd);
         exit(EXIT_FAILURE);
     }
-
-    exit(EXIT_SUCCESS);  // exit the process when done     
+    safe_close(&pipes.sample_fd); // close write-end after done
+    exit(EXIT_SUCCESS); // exit the process when done
 }
-
-
-
-
-
@@ -11,28 +11,129 @@
 #include "CLA.h"
 #include "pipeTool.h"
 #include "signalHandler.h"
+#include "adaptiveSampler.h"
+#include "timeTool.h"
+#include "selfStats.h"
+#include "batchReader.h"
+#include "numa.h"
+#include "interrupts.h"
+#include "samplerTuning.h"
 
 #ifndef SYSINFO_PRODUCER_HEADER
 #define SYSINFO_PRODUCER_HEADER
 /*
 This module serves as the producer in this system monitoring tool.
 It is responsible for spawning child processes to collect real-time system 
-information such as memory usage, CPU utilization, and core statistics.
+information such as memory usage, CPU utilization, NUMA and interrupt activity.
+The static core count and frequency need no producer, see hwCache.
 These values are sampled over time and passed back to the main process 
 via pipe-based inter-process communication (IPC). The collected data is 
 then consumed by the display .
+The sampling loops themselves (run_memory_producer / run_cpu_producer / run_numa_producer /
+run_irq_producer) only see a producerOutput, 
+so the same code feeds a pipe in a child process or an in-memory queue on a worker thread 
+(--engine=threads, see threadEngine).
+In fixed-interval mode the coordinator owns the clock: every --tdelay it stamps one tick and sends it
+down a tick pipe to each child, so the memory and CPU readings of a tick share one timestamp and the
+pair never drifts apart; the remaining skew between the two reads is measured per sample.
 */
+typedef struct {
+    int fetch_ns;
+    int jitter_ns;
+    long long cpu_time_us;
+    long max_rss_kb;
+}sampleTiming;
+///_|> descry: Self-measurements a producer ships with every reading (--self-stats)
+///_|> members:
+///_|>     - fetch_ns: time spent collecting the reading in nanoseconds, -1 if already reported, type int
+///_|>     - jitter_ns: how late the producer woke up compared to its schedule in ns, -1 if already reported, type int
+///_|>     - cpu_time_us: user+system CPU time used by the producer so far in microseconds, type long long
+///_|>     - max_rss_kb: peak RSS of the producer in KB, type long
+
 typedef struct utiization_info{
     float cpu_utiliz;
+    schedInfo sched;
     MemoryInfo mem_utiliz;
+    vmstatInfo vm;
+    long long timestamp_ns;
+    sampleTiming cpu_timing;
+    sampleTiming mem_timing;
+    long long producers_cpu_us;
+    long producers_max_rss_kb;
+    int anomaly;
+    int skew_ns;
 }UtilizInfo;
 //_|> descry: Combines both memory and CPU usage information into a single struct
 ///_|> members:
 ///_|>     - cpu_utiliz: current CPU usage in percentage, type float
+///_|>     - sched: scheduler signals read with the CPU sample, all -1 when the CPU graph is off, type schedInfo
 ///_|>     - mem_utiliz: MemoryInfo struct containing total and used memory in GB, type MemoryInfo
+///_|>     - vm: paging and reclaim rates read with the memory sample, all -1 without --vmstat, type vmstatInfo
+///_|>     - timestamp_ns: monotonic time of the newest reading in this struct in nanoseconds, type long long
+///_|>     - cpu_timing / mem_timing: self-measurements of the CPU and memory producers, type sampleTiming
+///_|>     - producers_cpu_us: CPU time of the coordinator and its producers so far in microseconds, type long long
+///_|>     - producers_max_rss_kb: peak RSS of the largest of those processes in KB, type long
+///_|>     - anomaly: AnomalyFlag bits set by the consumer or daemon with --anomaly, 0 otherwise, type int
+///_|>     - skew_ns: how far apart the paired CPU and memory readings were actually taken, -1 if not paired, type int
+
+typedef struct {
+    long long timestamp_ns;
+    MemoryInfo mem;
+    vmstatInfo vm;
+    sampleTiming timing;
+}memSample;
+///_|> descry: One timestamped memory reading sent from the memory child to the coordinator
+///_|> members:
+///_|>     - timestamp_ns: monotonic time the reading was taken in nanoseconds, type long long
+///_|>     - mem: memory usage in GB, type MemoryInfo
+///_|>     - vm: paging and reclaim rates of the same tick (--vmstat), all -1 otherwise, type vmstatInfo
+///_|>     - timing: self-measurements of the memory producer, type sampleTiming
+
+typedef struct {
+    long long timestamp_ns;
+    float cpu_utiliz;
+    schedInfo sched;
+    sampleTiming timing;
+}cpuSample;
+///_|> descry: One timestamped CPU reading sent from the CPU child to the coordinator
+///_|> members:
+///_|>     - timestamp_ns: monotonic time the reading was taken in nanoseconds, type long long
+///_|>     - cpu_utiliz: CPU utilization in percent, type float
+///_|>     - sched: context switch, fork and interrupt rates, run-queue counts and load averages, type schedInfo
+///_|>     - timing: self-measurements of the CPU producer, type sampleTiming
+
+typedef struct {
+    int (*emit)(void* ctx, const void* sample, size_t size);
+    long long (*pause_us)(void* ctx, int interval_us);
+    void* ctx;
+    int usage_scope;
+}producerOutput;
+///_|> descry: Where a sampling loop sends its readings and how it waits between them
+///_|> members:
+///_|>     - emit: delivers one memSample/cpuSample, returns -1 to stop the loop, type function pointer
+///_|>     - pause_us: waits one interval in microseconds (or for the next shared tick), returns -1 to stop the loop,
+///_|>                 otherwise the tick's monotonic timestamp, or 0 if it simply waited, type function pointer
+///_|>     - ctx: first argument of emit and pause_us, type void*
+///_|>     - usage_scope: getrusage() scope reported in sampleTiming (RUSAGE_SELF, or RUSAGE_THREAD for workers), type int
+
+int run_memory_producer(CLAInfo* cla_info, producerOutput* out);
+
+int run_cpu_producer(CLAInfo* cla_info, producerOutput* out);
+
+#define TICK_STAT_BUF_SIZE CPU_STAT_BUF_SIZE // the scheduler counters follow the per-CPU lines
+#define TICK_LOADAVG_BUF_SIZE CPU_LOADAVG_BUF_SIZE
+#define TICK_MEMINFO_BUF_SIZE 8192
+
+int run_tick_producer(CLAInfo* cla_info, producerOutput* mem_out, producerOutput* cpu_out);
+
+int run_numa_producer(CLAInfo* cla_info, producerOutput* out);
+
+int run_irq_producer(CLAInfo* cla_info, producerOutput* out);
 
 void fetch_utilization_with_pipe(CLAInfo* cla_info, int write_to_parent_fd);
 
-void fetch_core_info_with_pipe(int write_fd_to_parent);
+void fetch_numa_with_pipe(CLAInfo* cla_info, int write_fd_to_parent);
+
+void fetch_irq_with_pipe(CLAInfo* cla_info, int write_fd_to_parent);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,244 @@
+#define _DEFAULT_SOURCE
+#include "sysInfoViewer.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+
+static int connect_daemon(const char* path){
+    ///_|> descry: connects to the daemon socket
+    ///_|> path: filesystem path of the daemon socket, type const char*
+    ///_|> returning: returns the connected fd, or -1 on failure
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1){
+        perror("socket for viewer failed");
+        return -1;
+    }
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1){
+        fprintf(stderr, "Failed to attach to daemon at %s: %s\n", path, strerror(errno));
+        safe_close(&fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void push_window(float* window, unsigned char* marks, int* count, int total, float value, unsigned char mark){
+    ///_|> descry: appends a value and its anomaly mark to a sliding window, shifting out the oldest when full
+    ///_|> window: array of total values, type float*
+    ///_|> marks: array of total anomaly marks kept in step with window, type unsigned char*
+    ///_|> count: pointer to the number of stored values, type int*
+    ///_|> total: capacity of the window, type int
+    ///_|> value: value to append, type float
+    ///_|> mark: non-zero if the daemon flagged the value as anomalous, type unsigned char
+    ///_|> returning: this function does not return anything
+    if (*count == total){
+        memmove(window, window + 1, sizeof(float) * (total - 1));
+        memmove(marks, marks + 1, total - 1);
+        (*count)--;
+    }
+    marks[*count] = mark;
+    window[(*count)++] = value;
+}
+
+int run_viewer(CLAInfo* cla){
+    ///_|> descry: renders samples published by a daemon until the daemon stops or the user quits
+    ///_|> cla: pointer to parsed command-line arguments (graphs, window size, socket path), type CLAInfo*
+    ///_|> returning: returns 0 when the daemon closed the stream, ALERT_EXIT_FIRED instead if an --alert rule
+    ///_|>            fired meanwhile, 1 on error or user exit
+    int fd = connect_daemon(cla->socket_path);
+    if (fd == -1) return 1;
+
+    int total_samples = cla->samples;
+    float* memory_samples = (float*)malloc(sizeof(float) * total_samples);
+    float* cpu_samples = (float*)malloc(sizeof(float) * total_samples);
+    unsigned char* marks = (unsigned char*)calloc(2 * total_samples, sizeof(unsigned char));
+    if (!memory_samples || !cpu_samples || !marks){
+        perror("Memory allocation failed for viewer");
+        free(memory_samples);
+        free(cpu_samples);
+        free(marks);
+        safe_close(&fd);
+        return 1;
+    }
+    unsigned char* memory_marks = marks;
+    unsigned char* cpu_marks = marks + total_samples;
+
+    printf("\033[2J");
+    printf("\033[1;1H");
+    printf("Attached to %s, showing last %d samples\n\n", cla->socket_path, total_samples);
+    fflush(stdout);
+
+    int mem_count = 0;
+    int cpu_count = 0;
+    bool have_core = false;
+    coreInfo core_info;
+    bool have_seq = false;
+    unsigned int last_seq = 0;
+    unsigned long missed = 0;
+    int status = 0;
+
+    while (true){
+        if (prompt_for_int_signal()){
+            status = 1;
+            break;
+        }
+        StreamRecord rec;
+        ssize_t got = read_full(fd, &rec, sizeof(StreamRecord));
+        if (got == 0){
+            printf("Daemon closed the stream.\n");
+            break;
+        }
+        if (got == -1){
+            if (errno == EINTR && check_sigint()) continue;
+            perror("read from daemon failed");
+            status = 1;
+            break;
+        }
+
+        if (rec.type == STREAM_CORE){
+            core_info = rec.data.core;
+            have_core = true;
+        }
+        else if (rec.type == STREAM_UTILIZ){
+            // sequence gaps mean the daemon dropped samples because this viewer was too slow
+            if (have_seq && rec.seq != last_seq + 1) missed += rec.seq - last_seq - 1;
+            have_seq = true;
+            last_seq = rec.seq;
+            UtilizInfo* info = &rec.data.utiliz;
+            // --alert rules of the viewer, on the daemon's monotonic sample times
+            alert_evaluate(info->cpu_utiliz, info->mem_utiliz.used_memory, info->mem_utiliz.total_memory, \
+                           info->timestamp_ns);
+            push_window(memory_samples, memory_marks, &mem_count, total_samples, info->mem_utiliz.used_memory, \
+                        (info->anomaly & ANOMALY_MEM) != 0);
+            push_window(cpu_samples, cpu_marks, &cpu_count, total_samples, info->cpu_utiliz, \
+                        (info->anomaly & ANOMALY_CPU) != 0);
+            if (missed > 0){
+                printf("\033[2;1H\033[2KDropped samples (slow viewer): %lu", missed);
+            }
+            render_utilization_charts(cla, memory_samples, cpu_samples, memory_marks, cpu_marks, mem_count, \
+                                      info->mem_utiliz.total_memory, &info->sched, &info->vm);
+        }
+        else if (rec.type == STREAM_SELFSTATS){
+            if (cla->self_stats){
+                SelfStatsSummary* st = &rec.data.self_stats;
+                printf("\033[2;1H\033[2KDaemon: cpu %.2fs + producers %.2fs, rss %ldKB, fetch_cpu p99 %.1fus, jitter p99 %.1fus", \
+                       st->self_cpu_us / 1e6, st->producers_cpu_us / 1e6, st->self_max_rss_kb, \
+                       st->stages[STAGE_FETCH_CPU].p99_ns / 1e3, st->stages[STAGE_TICK_JITTER].p99_ns / 1e3);
+                fflush(stdout);
+            }
+            continue;
+        }
+        else{
+            continue; // unknown record from a newer daemon
+        }
+
+        if (cla->graph_flag[2] && have_core){
+            if (!cla->graph_flag[0] && !cla->graph_flag[1]) printf("\033[3;1H");
+            draw_all_core(&core_info);
+        }
+        fflush(stdout);
+    }
+
+    free(memory_samples);
+    free(cpu_samples);
+    free(marks);
+    safe_close(&fd);
+    alert_reap_hooks();
+    // health-check scripts attached to a daemon: exits with 2 if any rule fired, like a local run
+    if (status == 0 && alert_any_fired()) status = ALERT_EXIT_FIRED;
+    return status;
+}
+
+static void print_aggregate_status(const aggMerger* merger, const aggBucket* bucket){
+    ///_|> descry: prints the fleet-wide values of a bucket and the source health on the second line
+    ///_|> merger: running aggregator, type const aggMerger*
+    ///_|> bucket: bucket just closed, type const aggBucket*
+    ///_|> returning: this function does not return anything
+    unsigned long long late = 0;
+    int missing = 0;
+    int done = 0;
+    for (int s = 0; s < merger->count; s++){
+        late += merger->sources[s].late;
+        if (merger->sources[s].state == AGG_SOURCE_MISSING) missing++;
+        if (merger->sources[s].state == AGG_SOURCE_DONE) done++;
+    }
+    printf("\033[2;1H\033[2K%d/%d sources  cpu mean %.1f%% max %.1f%% p%.0f %.1f%%  mem %.2f/%.2f GB max %.2f p%.0f %.2f" \
+           "  late %llu  missing %d  ended %d", bucket->reporting, bucket->sources, bucket->cpu_mean, bucket->cpu_max, \
+           AGG_PERCENTILE, bucket->cpu_pct, bucket->mem_used_sum, bucket->mem_total_sum, bucket->mem_used_max, \
+           AGG_PERCENTILE, bucket->mem_used_pct, late, missing, done);
+}
+
+int run_aggregate_viewer(CLAInfo* cla){
+    ///_|> descry: renders the merged streams of --aggregate until every source has ended or the user quits
+    ///_|> cla: pointer to parsed command-line arguments (sources, bucket width, lateness, window size), type CLAInfo*
+    ///_|> returning: returns 0 when every source has ended, 1 on error or user exit
+    aggMerger* merger = (aggMerger*)malloc(sizeof(aggMerger));
+    if (merger == NULL){
+        perror("Memory allocation failed for aggregator");
+        return 1;
+    }
+    long long bucket_ns = cla->tdelay * 1000LL;
+    long long late_ns = (cla->aggregate_late_ms >= 0) ? cla->aggregate_late_ms * 1000000LL : 2 * bucket_ns;
+    if (aggregator_open(merger, cla->aggregate_spec, bucket_ns, late_ns) == -1){
+        free(merger);
+        return 1;
+    }
+
+    int total_samples = cla->samples;
+    float* memory_samples = (float*)malloc(sizeof(float) * total_samples);
+    float* cpu_samples = (float*)malloc(sizeof(float) * total_samples);
+    unsigned char* marks = (unsigned char*)calloc(2 * total_samples, sizeof(unsigned char));
+    if (!memory_samples || !cpu_samples || !marks){
+        perror("Memory allocation failed for aggregator");
+        free(memory_samples);
+        free(cpu_samples);
+        free(marks);
+        aggregator_close(merger);
+        free(merger);
+        return 1;
+    }
+
+    printf("\033[2J");
+    printf("\033[1;1H");
+    printf("Aggregating %d sources in %.3f s buckets (late after %.3f s), showing last %d\n\n", merger->count, \
+           bucket_ns / 1e9, late_ns / 1e9, total_samples);
+    fflush(stdout);
+
+    int mem_count = 0;
+    int cpu_count = 0;
+    int status = 0;
+    while (true){
+        if (prompt_for_int_signal()){
+            status = 1;
+            break;
+        }
+        aggBucket bucket;
+        // short waits keep the quit prompt responsive while every source is silent
+        int got = aggregator_next(merger, &bucket, 200);
+        if (got == -1){
+            printf("All sources ended.\n");
+            break;
+        }
+        if (got == 0) continue;
+        push_window(memory_samples, marks, &mem_count, total_samples, bucket.mem_used_sum, 0);
+        push_window(cpu_samples, marks + total_samples, &cpu_count, total_samples, bucket.cpu_mean, 0);
+        print_aggregate_status(merger, &bucket);
+        render_utilization_charts(cla, memory_samples, cpu_samples, NULL, NULL, mem_count, bucket.mem_total_sum, \
+                                  NULL, NULL);
+        fflush(stdout);
+    }
+
+    for (int s = 0; s < merger->count; s++){
+        const aggSource* src = &merger->sources[s];
+        printf("%s: %llu samples merged, %llu late%s\n", src->path, src->merged, src->late, \
+               (src->state == AGG_SOURCE_MISSING) ? ", never connected" : "");
+    }
+    free(memory_samples);
+    free(cpu_samples);
+    free(marks);
+    aggregator_close(merger);
+    free(merger);
+    return status;
+}
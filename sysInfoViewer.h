@@ -0,0 +1,32 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdbool.h>
+
+#include "CLA.h"
+#include "core.h"
+#include "streamProtocol.h"
+#include "sysInfoConsumer.h"
+#include "pipeTool.h"
+#include "signalHandler.h"
+#include "aggregator.h"
+
+#ifndef SYSINFO_VIEWER_HEADER
+#define SYSINFO_VIEWER_HEADER
+
+/*
+This module implements --attach mode: a thin client that connects to a running daemon and 
+only renders. It keeps a sliding window of the last --samples values and redraws the 
+selected charts on every received record; it never reads /proc itself.
+It also implements --aggregate mode, which renders the same charts for a whole fleet: every closed
+bucket of the aggregator adds the fleet's used memory (against its total) and mean CPU utilization,
+and a status line shows sum, mean, max and percentile across the sources and which ones are late.
+*/
+
+int run_viewer(CLAInfo* cla);
+
+int run_aggregate_viewer(CLAInfo* cla);
+
+#endif
@@ -0,0 +1,562 @@
+#define _GNU_SOURCE
+#include "threadEngine.h"
+#include <signal.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <fcntl.h>
+
+static void deadline_after_us(struct timespec* deadline, long long interval_us){
+    ///_|> descry: computes an absolute CLOCK_MONOTONIC deadline for pthread_cond_timedwait
+    ///_|> deadline: timespec to fill, type struct timespec*
+    ///_|> interval_us: time from now in microseconds, type long long
+    ///_|> returning: this function does not return anything
+    long long at = now_mono_ns() + interval_us * 1000LL;
+    deadline->tv_sec = at / 1000000000LL;
+    deadline->tv_nsec = at % 1000000000LL;
+}
+
+static void wake_consumer(ThreadEngine* engine){
+    ///_|> descry: makes the wake pipe readable so a consumer polling it looks at the queues again
+    ///_|> engine: the engine, type ThreadEngine*
+    ///_|> returning: this function does not return anything
+    char byte = 1;
+    // a full pipe already holds a pending wake-up, dropping this one loses nothing
+    if (write(engine->wake_fd[1], &byte, 1) == -1 && errno != EAGAIN){
+        perror("write to engine wake pipe failed");
+    }
+}
+
+static void deadline_at_ns(struct timespec* deadline, long long at_ns){
+    ///_|> descry: converts an absolute CLOCK_MONOTONIC time for pthread_cond_timedwait
+    ///_|> deadline: timespec to fill, type struct timespec*
+    ///_|> at_ns: time in nanoseconds, type long long
+    ///_|> returning: this function does not return anything
+    deadline->tv_sec = at_ns / 1000000000LL;
+    deadline->tv_nsec = at_ns % 1000000000LL;
+}
+
+static long long engine_pause_us(void* ctx, int interval_us){
+    ///_|> descry: producerOutput.pause_us of the self-paced workers (NUMA, interrupts, --adaptive): waits one
+    ///_|>         interval unless the engine is stopped
+    ///_|> ctx: the worker, type engineWorker*
+    ///_|> interval_us: interval to wait in microseconds, type int
+    ///_|> returning: returns 0 after a full interval, -1 if the engine is stopping
+    ThreadEngine* engine = ((engineWorker*)ctx)->engine;
+    struct timespec deadline;
+    deadline_after_us(&deadline, interval_us);
+    pthread_mutex_lock(&engine->lock);
+    while (!engine->stopping){
+        if (pthread_cond_timedwait(&engine->changed, &engine->lock, &deadline) == ETIMEDOUT) break;
+    }
+    long long status = engine->stopping ? -1 : 0;
+    pthread_mutex_unlock(&engine->lock);
+    return status;
+}
+
+static long long engine_tick_pause(void* ctx, int interval_us){
+    ///_|> descry: producerOutput.pause_us of the memory, CPU and tick workers in fixed mode: waits for the
+    ///_|>         engine's next tick instead of sleeping on its own
+    ///_|> ctx: the worker, type engineWorker*
+    ///_|> interval_us: unused, the ticker keeps the interval, type int
+    ///_|> returning: returns the tick's timestamp, -1 if the engine is stopping
+    (void)interval_us;
+    engineWorker* worker = (engineWorker*)ctx;
+    ThreadEngine* engine = worker->engine;
+    pthread_mutex_lock(&engine->lock);
+    while (!engine->stopping && engine->tick_seq == worker->seen_tick){
+        pthread_cond_wait(&engine->changed, &engine->lock);
+    }
+    long long tick_ns = -1;
+    if (!engine->stopping){
+        // the ticker never runs more than one tick ahead of a running worker
+        worker->seen_tick = engine->tick_seq;
+        tick_ns = engine->tick_ns;
+        pthread_cond_broadcast(&engine->changed); // the ticker may be waiting for this worker
+    }
+    pthread_mutex_unlock(&engine->lock);
+    return tick_ns;
+}
+
+static bool tick_taken(ThreadEngine* engine){
+    ///_|> descry: checks whether every running tick worker has taken the current tick (lock held)
+    ///_|> engine: the engine, type ThreadEngine*
+    ///_|> returning: returns true when the next tick may be published
+    for (int i = 0; i < ENGINE_WORKERS; i++){
+        engineWorker* worker = &engine->worker_ctx[i];
+        if (worker->on_tick && !worker->done && worker->seen_tick != engine->tick_seq) return false;
+    }
+    return true;
+}
+
+static bool tick_workers_done(ThreadEngine* engine){
+    ///_|> descry: checks whether every tick worker has finished its sampling loop (lock held)
+    ///_|> engine: the engine, type ThreadEngine*
+    ///_|> returning: returns true once no worker reads on the ticks any more
+    for (int i = 0; i < ENGINE_WORKERS; i++){
+        if (engine->worker_ctx[i].on_tick && !engine->worker_ctx[i].done) return false;
+    }
+    return true;
+}
+
+static void* ticker_thread(void* arg){
+    ///_|> descry: fixed-interval clock of the engine: publishes one tick every --tdelay on an absolute
+    ///_|>         CLOCK_MONOTONIC schedule, the counterpart of pair_fixed_samples in the process engine
+    ///_|> arg: the engine, type ThreadEngine*
+    ///_|> returning: returns NULL
+    ThreadEngine* engine = (ThreadEngine*)arg;
+    long long period_ns = (long long)engine->cla->tdelay * 1000LL;
+    long long next_tick = now_mono_ns();
+    pthread_mutex_lock(&engine->lock);
+    while (!engine->stopping && !tick_workers_done(engine)){
+        // a worker still reading the current tick holds the next one back, like a child the coordinator waits for
+        if (!tick_taken(engine)){
+            pthread_cond_wait(&engine->changed, &engine->lock);
+            continue;
+        }
+        next_tick += period_ns;
+        struct timespec deadline;
+        deadline_at_ns(&deadline, next_tick);
+        while (!engine->stopping && now_mono_ns() < next_tick){
+            pthread_cond_timedwait(&engine->changed, &engine->lock, &deadline);
+        }
+        if (engine->stopping) break;
+        engine->tick_ns = now_mono_ns();
+        engine->tick_seq++;
+        pthread_cond_broadcast(&engine->changed);
+    }
+    pthread_mutex_unlock(&engine->lock);
+    return NULL;
+}
+
+static void finish_worker(engineWorker* worker){
+    ///_|> descry: marks a worker's sampling loop as returned, so the ticker stops waiting for it
+    ///_|> worker: the finished worker, type engineWorker*
+    ///_|> returning: this function does not return anything
+    ThreadEngine* engine = worker->engine;
+    pthread_mutex_lock(&engine->lock);
+    worker->done = true;
+    pthread_cond_broadcast(&engine->changed);
+    pthread_mutex_unlock(&engine->lock);
+}
+
+static int engine_push(ThreadEngine* engine, engineRing* ring, void* slots, const void* sample, size_t size){
+    ///_|> descry: appends a sample to a bounded queue, waiting while it is full
+    ///_|> engine: the engine, type ThreadEngine*
+    ///_|> ring / slots: queue index and its slot array, type engineRing* / void*
+    ///_|> sample / size: sample to copy and its size, type const void* / size_t
+    ///_|> returning: returns 0 when queued, -1 if the engine is stopping
+    pthread_mutex_lock(&engine->lock);
+    while (ring->count == ENGINE_QUEUE_CAPACITY && !engine->stopping){
+        pthread_cond_wait(&engine->changed, &engine->lock);
+    }
+    if (engine->stopping){
+        pthread_mutex_unlock(&engine->lock);
+        return -1;
+    }
+    int tail = (ring->head + ring->count) % ENGINE_QUEUE_CAPACITY;
+    memcpy((char*)slots + (size_t)tail * size, sample, size);
+    ring->count++;
+    pthread_cond_broadcast(&engine->changed);
+    pthread_mutex_unlock(&engine->lock);
+    wake_consumer(engine);
+    return 0;
+}
+
+static int engine_emit_mem(void* ctx, const void* sample, size_t size){
+    ///_|> descry: producerOutput.emit of the memory worker
+    ///_|> ctx / sample / size: the worker, a memSample and its size, type void* / const void* / size_t
+    ///_|> returning: returns 0 when queued, -1 if the engine is stopping
+    ThreadEngine* engine = ((engineWorker*)ctx)->engine;
+    return engine_push(engine, &engine->mem_ring, engine->mem_slots, sample, size);
+}
+
+static int engine_emit_cpu(void* ctx, const void* sample, size_t size){
+    ///_|> descry: producerOutput.emit of the CPU worker
+    ///_|> ctx / sample / size: the worker, a cpuSample and its size, type void* / const void* / size_t
+    ///_|> returning: returns 0 when queued, -1 if the engine is stopping
+    ThreadEngine* engine = ((engineWorker*)ctx)->engine;
+    return engine_push(engine, &engine->cpu_ring, engine->cpu_slots, sample, size);
+}
+
+static int engine_emit_numa(void* ctx, const void* sample, size_t size){
+    ///_|> descry: producerOutput.emit of the NUMA worker
+    ///_|> ctx / sample / size: the worker, a numaSample and its size, type void* / const void* / size_t
+    ///_|> returning: returns 0 when queued, -1 if the engine is stopping
+    ThreadEngine* engine = ((engineWorker*)ctx)->engine;
+    return engine_push(engine, &engine->numa_ring, engine->numa_slots, sample, size);
+}
+
+static int engine_emit_irq(void* ctx, const void* sample, size_t size){
+    ///_|> descry: producerOutput.emit of the IRQ worker
+    ///_|> ctx / sample / size: the worker, an irqSample and its size, type void* / const void* / size_t
+    ///_|> returning: returns 0 when queued, -1 if the engine is stopping
+    ThreadEngine* engine = ((engineWorker*)ctx)->engine;
+    return engine_push(engine, &engine->irq_ring, engine->irq_slots, sample, size);
+}
+
+static void close_ring(ThreadEngine* engine, engineRing* ring){
+    ///_|> descry: marks a worker's queue as finished and wakes the consumer
+    ///_|> engine: the engine, type ThreadEngine*
+    ///_|> ring: queue of the finished worker, type engineRing*
+    ///_|> returning: this function does not return anything
+    pthread_mutex_lock(&engine->lock);
+    ring->closed = true;
+    pthread_cond_broadcast(&engine->changed);
+    pthread_mutex_unlock(&engine->lock);
+    wake_consumer(engine);
+}
+
+static void* memory_worker(void* arg){
+    ///_|> descry: worker thread running the memory sampling loop
+    ///_|> arg: the worker, type engineWorker*
+    ///_|> returning: returns NULL
+    engineWorker* worker = (engineWorker*)arg;
+    ThreadEngine* engine = worker->engine;
+    // fixed interval: wait for the engine's tick, --adaptive: sleep the worker's own interval
+    long long (*wait_tick)(void*, int) = worker->on_tick ? engine_tick_pause : engine_pause_us;
+    producerOutput out = {engine_emit_mem, wait_tick, worker, RUSAGE_THREAD};
+    if (run_memory_producer(engine->cla, &out) == -1){
+        fprintf(stderr, "Failed to get memory information in worker thread \n");
+    }
+    finish_worker(worker);
+    close_ring(engine, &engine->mem_ring);
+    return NULL;
+}
+
+static void* cpu_worker(void* arg){
+    ///_|> descry: worker thread running the CPU sampling loop
+    ///_|> arg: the worker, type engineWorker*
+    ///_|> returning: returns NULL
+    engineWorker* worker = (engineWorker*)arg;
+    ThreadEngine* engine = worker->engine;
+    long long (*wait_tick)(void*, int) = worker->on_tick ? engine_tick_pause : engine_pause_us;
+    producerOutput out = {engine_emit_cpu, wait_tick, worker, RUSAGE_THREAD};
+    if (run_cpu_producer(engine->cla, &out) == -1){
+        fprintf(stderr, "Failed to get CPU information in worker thread \n");
+    }
+    finish_worker(worker);
+    close_ring(engine, &engine->cpu_ring);
+    return NULL;
+}
+
+static void* tick_worker(void* arg){
+    ///_|> descry: worker thread of --batch-io: one loop reads memory and CPU sources as a single batch per tick
+    ///_|> arg: the worker, type engineWorker*
+    ///_|> returning: returns NULL
+    engineWorker* worker = (engineWorker*)arg;
+    ThreadEngine* engine = worker->engine;
+    long long (*wait_tick)(void*, int) = worker->on_tick ? engine_tick_pause : engine_pause_us;
+    producerOutput mem_out = {engine_emit_mem, wait_tick, worker, RUSAGE_THREAD};
+    producerOutput cpu_out = {engine_emit_cpu, wait_tick, worker, RUSAGE_THREAD};
+    if (run_tick_producer(engine->cla, &mem_out, &cpu_out) == -1){
+        fprintf(stderr, "Failed to read batched sources in worker thread \n");
+    }
+    finish_worker(worker);
+    close_ring(engine, &engine->mem_ring);
+    close_ring(engine, &engine->cpu_ring);
+    return NULL;
+}
+
+static void* numa_worker(void* arg){
+    ///_|> descry: worker thread running the per-node NUMA sampling loop (--numa)
+    ///_|> arg: the worker, type engineWorker*
+    ///_|> returning: returns NULL
+    engineWorker* worker = (engineWorker*)arg;
+    ThreadEngine* engine = worker->engine;
+    producerOutput out = {engine_emit_numa, engine_pause_us, worker, RUSAGE_THREAD};
+    if (run_numa_producer(engine->cla, &out) == -1){
+        fprintf(stderr, "Failed to get NUMA node information in worker thread \n");
+    }
+    close_ring(engine, &engine->numa_ring);
+    return NULL;
+}
+
+static void* irq_worker(void* arg){
+    ///_|> descry: worker thread running the interrupt hot-spot sampling loop (--irq)
+    ///_|> arg: the worker, type engineWorker*
+    ///_|> returning: returns NULL
+    engineWorker* worker = (engineWorker*)arg;
+    ThreadEngine* engine = worker->engine;
+    producerOutput out = {engine_emit_irq, engine_pause_us, worker, RUSAGE_THREAD};
+    if (run_irq_producer(engine->cla, &out) == -1){
+        fprintf(stderr, "Failed to get interrupt information in worker thread \n");
+    }
+    close_ring(engine, &engine->irq_ring);
+    return NULL;
+}
+
+int thread_engine_start(ThreadEngine* engine, CLAInfo* cla){
+    ///_|> descry: initializes the engine and starts one worker per enabled graph, with SIGINT blocked in them
+    ///_|> engine: engine to initialize, type ThreadEngine*
+    ///_|> cla: run configuration (graph flags, samples, tdelay, adaptive), type CLAInfo*
+    ///_|> returning: returns 0 on success, -1 if a thread could not be created (started ones are joined)
+    memset(engine, 0, sizeof(ThreadEngine));
+    engine->cla = cla;
+    // non-blocking on both ends: workers never stall on a slow consumer, the consumer drains without blocking
+    if (pipe2(engine->wake_fd, O_NONBLOCK | O_CLOEXEC) == -1){
+        perror("pipe for engine wake-ups failed");
+        return -1;
+    }
+    pthread_mutex_init(&engine->lock, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC); // deadlines come from now_mono_ns()
+    pthread_cond_init(&engine->changed, &attr);
+    pthread_condattr_destroy(&attr);
+
+    // a disabled metric counts as an already finished queue
+    engine->mem_ring.closed = !cla->graph_flag[0];
+    engine->cpu_ring.closed = !cla->graph_flag[1];
+    engine->numa_ring.closed = !cla->graph_flag[3];
+    engine->irq_ring.closed = !cla->graph_flag[4];
+    engine->mem_seen = !cla->graph_flag[0];
+    engine->cpu_seen = !cla->graph_flag[1];
+    engine->latest.cpu_utiliz = -1;
+    clear_sched_info(&engine->latest.sched);
+    clear_vmstat_info(&engine->latest.vm);
+    engine->latest.mem_utiliz.total_memory = -1;
+    engine->latest.mem_utiliz.used_memory = -1;
+
+    // workers inherit the signal mask: only the consumer thread sees Ctrl+C
+    sigset_t block_set, old_set;
+    sigemptyset(&block_set);
+    sigaddset(&block_set, SIGINT);
+    pthread_sigmask(SIG_BLOCK, &block_set, &old_set);
+
+    void* (*routines[ENGINE_WORKERS])(void*) = {memory_worker, cpu_worker, numa_worker, irq_worker};
+    bool wanted[ENGINE_WORKERS] = {cla->graph_flag[0], cla->graph_flag[1], cla->graph_flag[3], cla->graph_flag[4]};
+    // --batch-io: a single tick worker (in slot 0) samples memory and CPU together
+    if (cla->batch_io != BATCH_IO_OFF && (wanted[0] || wanted[1])){
+        routines[0] = tick_worker;
+        wanted[0] = true;
+        wanted[1] = false;
+    }
+    // fixed interval: memory and CPU (slots 0 and 1) read on the engine's ticks, NUMA and interrupts pace themselves
+    for (int i = 0; i < ENGINE_WORKERS; i++){
+        engine->worker_ctx[i].engine = engine;
+        engine->worker_ctx[i].on_tick = wanted[i] && i < 2 && !cla->adaptive;
+    }
+    int status = 0;
+    for (int i = 0; i < ENGINE_WORKERS; i++){
+        if (!wanted[i]) continue;
+        if (pthread_create(&engine->workers[i], NULL, routines[i], &engine->worker_ctx[i]) != 0){
+            perror("pthread_create for producer worker failed");
+            engine->worker_ctx[i].on_tick = false;
+            status = -1;
+            break;
+        }
+        engine->started[i] = true;
+    }
+    if (status == 0 && !cla->adaptive && (wanted[0] || wanted[1])){
+        if (pthread_create(&engine->ticker, NULL, ticker_thread, engine) != 0){
+            perror("pthread_create for engine ticker failed");
+            status = -1;
+        }
+        engine->ticker_started = (status == 0);
+    }
+    pthread_sigmask(SIG_SETMASK, &old_set, NULL);
+    if (status == -1) thread_engine_stop(engine);
+    return status;
+}
+
+static void take_mem(ThreadEngine* engine){
+    ///_|> descry: pops the oldest memory reading into engine->latest (lock held)
+    ///_|> engine: the engine, type ThreadEngine*
+    ///_|> returning: this function does not return anything
+    memSample* sample = &engine->mem_slots[engine->mem_ring.head];
+    engine->latest.mem_utiliz = sample->mem;
+    engine->latest.vm = sample->vm;
+    engine->latest.mem_timing = sample->timing;
+    if (sample->timestamp_ns > engine->latest.timestamp_ns) engine->latest.timestamp_ns = sample->timestamp_ns;
+    engine->mem_ring.head = (engine->mem_ring.head + 1) % ENGINE_QUEUE_CAPACITY;
+    engine->mem_ring.count--;
+    engine->mem_seen = true;
+}
+
+static void take_cpu(ThreadEngine* engine){
+    ///_|> descry: pops the oldest CPU reading into engine->latest (lock held)
+    ///_|> engine: the engine, type ThreadEngine*
+    ///_|> returning: this function does not return anything
+    cpuSample* sample = &engine->cpu_slots[engine->cpu_ring.head];
+    engine->latest.cpu_utiliz = sample->cpu_utiliz;
+    engine->latest.sched = sample->sched;
+    engine->latest.cpu_timing = sample->timing;
+    if (sample->timestamp_ns > engine->latest.timestamp_ns) engine->latest.timestamp_ns = sample->timestamp_ns;
+    engine->cpu_ring.head = (engine->cpu_ring.head + 1) % ENGINE_QUEUE_CAPACITY;
+    engine->cpu_ring.count--;
+    engine->cpu_seen = true;
+}
+
+static ssize_t next_utiliz(ThreadEngine* engine, UtilizInfo* info, bool wait){
+    ///_|> descry: takes the next combined utilization sample. Fixed mode pairs the i-th memory and CPU
+    ///_|>         readings, which belong to the same engine tick; --adaptive forwards every reading with the
+    ///_|>         latest other one
+    ///_|> engine: running engine, type ThreadEngine*
+    ///_|> info: receives the sample, type UtilizInfo*
+    ///_|> wait: block until a sample is ready instead of failing with EAGAIN, type bool
+    ///_|> returning: returns sizeof(UtilizInfo) for a sample, 0 once all workers finished, and -1 when
+    ///_|>            SIGINT arrived while waiting or, without wait, when no sample is ready (errno EAGAIN)
+    pthread_mutex_lock(&engine->lock);
+    while (true){
+        bool mem_done = engine->mem_ring.closed && engine->mem_ring.count == 0;
+        bool cpu_done = engine->cpu_ring.closed && engine->cpu_ring.count == 0;
+        if (mem_done && cpu_done){
+            pthread_mutex_unlock(&engine->lock);
+            return 0;
+        }
+        bool mem_ready = engine->mem_ring.count > 0;
+        bool cpu_ready = engine->cpu_ring.count > 0;
+        bool take = engine->cla->adaptive ? (mem_ready || cpu_ready) : \
+                    ((mem_ready || mem_done) && (cpu_ready || cpu_done));
+        if (take){
+            engine->latest.timestamp_ns = 0;
+            engine->latest.skew_ns = -1;
+            // fixed mode: both readings carry their tick's timestamp; how far apart they were really taken
+            // is the difference of the workers' wake-up delays, as in pair_fixed_samples
+            if (!engine->cla->adaptive && mem_ready && cpu_ready){
+                int skew = engine->mem_slots[engine->mem_ring.head].timing.jitter_ns - \
+                           engine->cpu_slots[engine->cpu_ring.head].timing.jitter_ns;
+                engine->latest.skew_ns = (skew < 0) ? -skew : skew;
+            }
+            if (mem_ready) take_mem(engine);
+            if (cpu_ready) take_cpu(engine);
+            pthread_cond_broadcast(&engine->changed); // room for blocked workers
+            // wait until every enabled metric has a value before forwarding anything
+            if (engine->mem_seen && engine->cpu_seen) break;
+            continue;
+        }
+        if (!wait){
+            pthread_mutex_unlock(&engine->lock);
+            errno = EAGAIN;
+            return -1;
+        }
+        if (check_sigint()){
+            pthread_mutex_unlock(&engine->lock);
+            return -1;
+        }
+        struct timespec deadline;
+        deadline_after_us(&deadline, ENGINE_SIGINT_POLL_MS * 1000LL);
+        pthread_cond_timedwait(&engine->changed, &engine->lock, &deadline);
+    }
+    // workers share the process: their thread CPU times add up, RSS is the process peak
+    UtilizInfo* latest = &engine->latest;
+    latest->producers_cpu_us = latest->cpu_timing.cpu_time_us + latest->mem_timing.cpu_time_us;
+    latest->producers_max_rss_kb = (latest->cpu_timing.max_rss_kb > latest->mem_timing.max_rss_kb) ? \
+                                   latest->cpu_timing.max_rss_kb : latest->mem_timing.max_rss_kb;
+    *info = *latest;
+    // mark the stage timings as consumed so the next sample only carries fresh measurements
+    latest->cpu_timing.fetch_ns = -1;
+    latest->cpu_timing.jitter_ns = -1;
+    latest->mem_timing.fetch_ns = -1;
+    latest->mem_timing.jitter_ns = -1;
+    pthread_mutex_unlock(&engine->lock);
+    return (ssize_t)sizeof(UtilizInfo);
+}
+
+ssize_t thread_engine_next_utiliz(ThreadEngine* engine, UtilizInfo* info){
+    ///_|> descry: consumer side: waits for the next combined utilization sample
+    ///_|> engine: running engine, type ThreadEngine*
+    ///_|> info: receives the sample, type UtilizInfo*
+    ///_|> returning: returns sizeof(UtilizInfo) for a sample, 0 once all workers finished, and -1 when
+    ///_|>            SIGINT arrived while waiting (same contract as read() on the process engine's pipe)
+    return next_utiliz(engine, info, true);
+}
+
+ssize_t thread_engine_try_utiliz(ThreadEngine* engine, UtilizInfo* info){
+    ///_|> descry: consumer side: takes the next combined utilization sample if one is ready
+    ///_|> engine: running engine, type ThreadEngine*
+    ///_|> info: receives the sample, type UtilizInfo*
+    ///_|> returning: returns sizeof(UtilizInfo) for a sample, 0 once all workers finished, and -1 with
+    ///_|>            errno EAGAIN if nothing is ready (same contract as read() on a non-blocking pipe)
+    return next_utiliz(engine, info, false);
+}
+
+ssize_t thread_engine_try_numa(ThreadEngine* engine, numaSample* sample){
+    ///_|> descry: consumer side: takes the oldest queued NUMA reading if there is one
+    ///_|> engine: running engine, type ThreadEngine*
+    ///_|> sample: receives the reading, type numaSample*
+    ///_|> returning: returns sizeof(numaSample) for a reading, 0 once the NUMA worker finished (or is disabled),
+    ///_|>            and -1 with errno EAGAIN if nothing is queued
+    pthread_mutex_lock(&engine->lock);
+    engineRing* ring = &engine->numa_ring;
+    ssize_t status;
+    if (ring->count > 0){
+        *sample = engine->numa_slots[ring->head];
+        ring->head = (ring->head + 1) % ENGINE_QUEUE_CAPACITY;
+        ring->count--;
+        pthread_cond_broadcast(&engine->changed); // room for a blocked worker
+        status = (ssize_t)sizeof(numaSample);
+    }else if (ring->closed){
+        status = 0;
+    }else{
+        errno = EAGAIN;
+        status = -1;
+    }
+    pthread_mutex_unlock(&engine->lock);
+    return status;
+}
+
+ssize_t thread_engine_try_irq(ThreadEngine* engine, irqSample* sample){
+    ///_|> descry: consumer side: takes the oldest queued interrupt reading if there is one
+    ///_|> engine: running engine, type ThreadEngine*
+    ///_|> sample: receives the reading, type irqSample*
+    ///_|> returning: returns sizeof(irqSample) for a reading, 0 once the IRQ worker finished (or is disabled),
+    ///_|>            and -1 with errno EAGAIN if nothing is queued
+    pthread_mutex_lock(&engine->lock);
+    engineRing* ring = &engine->irq_ring;
+    ssize_t status;
+    if (ring->count > 0){
+        *sample = engine->irq_slots[ring->head];
+        ring->head = (ring->head + 1) % ENGINE_QUEUE_CAPACITY;
+        ring->count--;
+        pthread_cond_broadcast(&engine->changed); // room for a blocked worker
+        status = (ssize_t)sizeof(irqSample);
+    }else if (ring->closed){
+        status = 0;
+    }else{
+        errno = EAGAIN;
+        status = -1;
+    }
+    pthread_mutex_unlock(&engine->lock);
+    return status;
+}
+
+int thread_engine_wake_fd(ThreadEngine* engine){
+    ///_|> descry: fd that becomes readable whenever a worker queued a sample or finished;
+    ///_|>         a consumer polling it calls thread_engine_drain_wake() before it looks at the queues
+    ///_|> engine: running engine, type ThreadEngine*
+    ///_|> returning: returns the read end of the wake pipe
+    return engine->wake_fd[0];
+}
+
+void thread_engine_drain_wake(ThreadEngine* engine){
+    ///_|> descry: empties the wake pipe; wake-ups written after this call stay pending for the next poll
+    ///_|> engine: running engine, type ThreadEngine*
+    ///_|> returning: this function does not return anything
+    char bytes[64];
+    while (read(engine->wake_fd[0], bytes, sizeof(bytes)) > 0){}
+}
+
+void thread_engine_stop(ThreadEngine* engine){
+    ///_|> descry: asks every worker to stop, wakes the waiting ones and joins them
+    ///_|> engine: engine to shut down, type ThreadEngine*
+    ///_|> returning: this function does not return anything
+    pthread_mutex_lock(&engine->lock);
+    engine->stopping = true;
+    pthread_cond_broadcast(&engine->changed);
+    pthread_mutex_unlock(&engine->lock);
+    for (int i = 0; i < ENGINE_WORKERS; i++){
+        if (engine->started[i]){
+            pthread_join(engine->workers[i], NULL);
+            engine->started[i] = false;
+        }
+    }
+    if (engine->ticker_started){
+        pthread_join(engine->ticker, NULL);
+        engine->ticker_started = false;
+    }
+    pthread_cond_destroy(&engine->changed);
+    pthread_mutex_destroy(&engine->lock);
+    close(engine->wake_fd[0]);
+    close(engine->wake_fd[1]);
+}
@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "sysInfoProducer.h"
+
+#ifndef THREAD_ENGINE_HEADER
+#define THREAD_ENGINE_HEADER
+
+/*
+This module is the --engine=threads alternative to the forked producer processes. The memory, CPU,
+NUMA and interrupt collectors run on worker threads of the main process and hand their readings over through
+bounded in-memory queues guarded by one mutex; the consumer pairs (or, with --adaptive, merges) them
+into the same UtilizInfo the process engine sends over its pipe. Workers block SIGINT so Ctrl+C is
+handled by the consumer, and thread_engine_stop() wakes and joins them. With --batch-io one tick
+worker replaces the memory and CPU workers and reads both metrics' sources as one batch.
+In fixed-interval mode the engine owns the clock like the process engine's coordinator: a ticker
+thread publishes one tick every --tdelay on an absolute CLOCK_MONOTONIC schedule, the memory and CPU
+workers read on that tick and stamp their readings with its timestamp, and the next tick waits until
+every running worker has taken the current one, so the i-th readings always belong to the same tick.
+Every push and close is also signalled on a non-blocking wake pipe, so the consumer can
+poll the engine together with other fds instead of waiting on the condition variable.
+*/
+
+#define ENGINE_QUEUE_CAPACITY 64
+#define ENGINE_SIGINT_POLL_MS 100 // how often a waiting consumer checks for Ctrl+C
+#define ENGINE_WORKERS 4 // memory (or tick), CPU, NUMA, interrupts; the cores panel needs no worker
+
+typedef struct {
+    int head;
+    int count;
+    bool closed;
+}engineRing;
+///_|> descry: Index of one bounded sample queue; the slots live in ThreadEngine
+///_|> members:
+///_|>     - head: slot of the oldest queued sample, type int
+///_|>     - count: number of queued samples, type int
+///_|>     - closed: the producing worker finished (or is disabled), type bool
+
+struct ThreadEngine;
+
+typedef struct {
+    struct ThreadEngine* engine;
+    bool on_tick;
+    bool done;
+    unsigned long long seen_tick;
+}engineWorker;
+///_|> descry: Per-worker context handed to the sampling loop as producerOutput.ctx
+///_|> members:
+///_|>     - engine: the engine the worker belongs to, type struct ThreadEngine*
+///_|>     - on_tick: the worker reads on the engine's ticks (memory, CPU or tick worker in fixed mode), type bool
+///_|>     - done: the worker's sampling loop returned, the ticker no longer waits for it, type bool
+///_|>     - seen_tick: number of the last tick the worker took, type unsigned long long
+
+typedef struct ThreadEngine {
+    CLAInfo* cla;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    bool stopping;
+    memSample mem_slots[ENGINE_QUEUE_CAPACITY];
+    engineRing mem_ring;
+    cpuSample cpu_slots[ENGINE_QUEUE_CAPACITY];
+    engineRing cpu_ring;
+    UtilizInfo latest;
+    bool mem_seen;
+    bool cpu_seen;
+    numaSample numa_slots[ENGINE_QUEUE_CAPACITY];
+    engineRing numa_ring;
+    irqSample irq_slots[ENGINE_QUEUE_CAPACITY];
+    engineRing irq_ring;
+    pthread_t workers[ENGINE_WORKERS];
+    bool started[ENGINE_WORKERS];
+    engineWorker worker_ctx[ENGINE_WORKERS];
+    pthread_t ticker;
+    bool ticker_started;
+    unsigned long long tick_seq;
+    long long tick_ns;
+    int wake_fd[2];
+}ThreadEngine;
+///_|> descry: State shared by the worker threads and the consumer
+///_|> members:
+///_|>     - cla: run configuration, type CLAInfo*
+///_|>     - lock / changed: guard every field below; changed is broadcast on any push, pop, close or stop,
+///_|>                       type pthread_mutex_t / pthread_cond_t
+///_|>     - stopping: set by thread_engine_stop, workers return as soon as they see it, type bool
+///_|>     - mem_slots / mem_ring: bounded queue of memory readings, type memSample[] / engineRing
+///_|>     - cpu_slots / cpu_ring: bounded queue of CPU readings, type cpuSample[] / engineRing
+///_|>     - latest / mem_seen / cpu_seen: latest value of each metric for --adaptive merging, type UtilizInfo / bool
+///_|>     - numa_slots / numa_ring: bounded queue of per-node readings (--numa), type numaSample[] / engineRing
+///_|>     - irq_slots / irq_ring: bounded queue of interrupt readings (--irq), type irqSample[] / engineRing
+///_|>     - workers / started: memory (or tick), CPU, NUMA and interrupt threads and whether each was
+///_|>                          created, type pthread_t[] / bool[]
+///_|>     - worker_ctx: context of each worker slot, type engineWorker[]
+///_|>     - ticker / ticker_started: thread driving the fixed-interval ticks and whether it was created,
+///_|>                                type pthread_t / bool
+///_|>     - tick_seq / tick_ns: number and CLOCK_MONOTONIC timestamp of the newest tick, 0 before the first,
+///_|>                           type unsigned long long / long long
+///_|>     - wake_fd: non-blocking pipe written after every change a consumer may be waiting for, type int[2]
+
+int thread_engine_start(ThreadEngine* engine, CLAInfo* cla);
+
+ssize_t thread_engine_next_utiliz(ThreadEngine* engine, UtilizInfo* info);
+
+ssize_t thread_engine_try_utiliz(ThreadEngine* engine, UtilizInfo* info);
+
+ssize_t thread_engine_try_numa(ThreadEngine* engine, numaSample* sample);
+
+ssize_t thread_engine_try_irq(ThreadEngine* engine, irqSample* sample);
+
+int thread_engine_wake_fd(ThreadEngine* engine);
+
+void thread_engine_drain_wake(ThreadEngine* engine);
+
+void thread_engine_stop(ThreadEngine* engine);
+
+#endif
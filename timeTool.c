@@ -0,0 +1,17 @@
+#include "timeTool.h"
+
+long long now_mono_ns(){
+    ///_|> descry: reads the monotonic clock
+    ///_|> returning: returns current CLOCK_MONOTONIC time in nanoseconds, type long long
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+long long now_wall_ns(){
+    ///_|> descry: reads the wall clock
+    ///_|> returning: returns current CLOCK_REALTIME time in nanoseconds since epoch, type long long
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
@@ -0,0 +1,18 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <time.h>
+
+#ifndef TIME_TOOL_HEADER
+#define TIME_TOOL_HEADER
+
+/*
+This module contains small clock helpers shared by the producers, the consumer and the daemon.
+Monotonic time is used to measure intervals between samples, wall-clock time is used 
+when samples leave the process (e.g. published to daemon clients).
+*/
+
+long long now_mono_ns();
+
+long long now_wall_ns();
+
+#endif
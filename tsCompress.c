@@ -0,0 +1,350 @@
+#include "tsCompress.h"
+
+static FILE* record_file = NULL;
+static char record_path[256];
+static bool record_failed = false;
+static tsEncoder record_enc;
+
+static void put_bits(tsEncoder* enc, uint64_t value, int n){
+    ///_|> descry: appends the n low bits of value to the stream, most significant first
+    ///_|> enc: encoder, type tsEncoder*
+    ///_|> value: bits to append, type uint64_t
+    ///_|> n: number of bits, 1 .. 64, type int
+    ///_|> returning: this function does not return anything
+    while (n > 0){
+        size_t byte = enc->bits >> 3;
+        int used = (int)(enc->bits & 7);
+        int room = 8 - used;
+        int take = (n < room) ? n : room;
+        unsigned char chunk = (unsigned char)((value >> (n - take)) & ((1u << take) - 1));
+        if (used == 0) enc->buf[byte] = 0;
+        enc->buf[byte] |= (unsigned char)(chunk << (room - take));
+        enc->bits += take;
+        n -= take;
+    }
+}
+
+static uint64_t get_bits(const unsigned char* stream, size_t* pos, int n){
+    ///_|> descry: reads n bits at *pos with one unaligned 8-byte load (the stream is padded for it)
+    ///_|> stream: block bit stream, type const unsigned char*
+    ///_|> pos: bit position, advanced by n, type size_t*
+    ///_|> n: number of bits, 1 .. 56, type int
+    ///_|> returning: returns the bits as an unsigned value
+    uint64_t word;
+    memcpy(&word, stream + (*pos >> 3), sizeof(word));
+    word = __builtin_bswap64(word);
+    uint64_t value = (word << (*pos & 7)) >> (64 - n);
+    *pos += n;
+    return value;
+}
+
+static int64_t sign_extend(uint64_t value, int n){
+    ///_|> descry: interprets the n low bits of value as a two's complement number
+    ///_|> value: bits read from the stream, type uint64_t
+    ///_|> n: width of the field, type int
+    ///_|> returning: returns the signed value
+    return (int64_t)(value << (64 - n)) >> (64 - n);
+}
+
+static uint32_t float_bits(float value){
+    ///_|> descry: gives the IEEE-754 bit pattern of a float
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bits_float(uint32_t bits){
+    ///_|> descry: gives the float of an IEEE-754 bit pattern
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void ts_encoder_reset(tsEncoder* enc){
+    ///_|> descry: starts a new, empty block
+    ///_|> enc: encoder, type tsEncoder*
+    ///_|> returning: this function does not return anything
+    enc->bits = 0;
+    enc->count = 0;
+    enc->first_ts = 0;
+    enc->prev_ts = 0;
+    enc->prev_delta = 0;
+    for (int s = 0; s < TS_SERIES; s++){
+        enc->prev_value[s] = 0;
+        enc->prev_lead[s] = 0;
+        enc->prev_len[s] = 0;
+    }
+}
+
+static void put_timestamp(tsEncoder* enc, long long ts_us){
+    ///_|> descry: appends a timestamp as the difference between its delta and the previous delta
+    ///_|> enc: encoder with at least one sample, type tsEncoder*
+    ///_|> ts_us: timestamp in microseconds, type long long
+    ///_|> returning: this function does not return anything
+    long long delta = ts_us - enc->prev_ts;
+    long long dod = delta - enc->prev_delta;
+    if (dod == 0){
+        put_bits(enc, 0x0, 1);
+    }else if (dod >= -64 && dod < 64){
+        put_bits(enc, 0x2, 2);
+        put_bits(enc, (uint64_t)dod, 7);
+    }else if (dod >= -512 && dod < 512){
+        put_bits(enc, 0x6, 3);
+        put_bits(enc, (uint64_t)dod, 10);
+    }else if (dod >= -524288 && dod < 524288){
+        put_bits(enc, 0xe, 4);
+        put_bits(enc, (uint64_t)dod, 20);
+    }else{
+        put_bits(enc, 0xf, 4);
+        put_bits(enc, (uint64_t)dod, 64);
+    }
+    enc->prev_delta = delta;
+    enc->prev_ts = ts_us;
+}
+
+static void put_value(tsEncoder* enc, int series, float value){
+    ///_|> descry: appends a value as the meaningful bits of its XOR with the series' previous value
+    ///_|> enc: encoder with at least one sample, type tsEncoder*
+    ///_|> series: one of TsSeries, type int
+    ///_|> value: new value, type float
+    ///_|> returning: this function does not return anything
+    uint32_t bits = float_bits(value);
+    uint32_t xor = bits ^ enc->prev_value[series];
+    enc->prev_value[series] = bits;
+    if (xor == 0){
+        put_bits(enc, 0x0, 1);
+        return;
+    }
+    int lead = __builtin_clz(xor);
+    int trail = __builtin_ctz(xor);
+    int prev_lead = enc->prev_lead[series];
+    int prev_len = enc->prev_len[series];
+    if (prev_len > 0 && lead >= prev_lead && 32 - trail <= prev_lead + prev_len){
+        // fits the previous window: control bits 10, then the window's bits
+        put_bits(enc, 0x2, 2);
+        put_bits(enc, xor >> (32 - prev_lead - prev_len), prev_len);
+        return;
+    }
+    int len = 32 - lead - trail;
+    put_bits(enc, 0x3, 2);
+    put_bits(enc, (uint64_t)lead, 5);
+    put_bits(enc, (uint64_t)(len - 1), 5);
+    put_bits(enc, xor >> trail, len);
+    enc->prev_lead[series] = lead;
+    enc->prev_len[series] = len;
+}
+
+void ts_encoder_add(tsEncoder* enc, const tsPoint* point){
+    ///_|> descry: appends one sample to the block; the caller writes the block out once ts_encoder_full()
+    ///_|> enc: encoder that is not full, type tsEncoder*
+    ///_|> point: sample to append, type const tsPoint*
+    ///_|> returning: this function does not return anything
+    if (enc->count == 0){
+        // the first sample of a block is stored verbatim, so the block decodes on its own
+        put_bits(enc, (uint64_t)point->ts_us, 64);
+        for (int s = 0; s < TS_SERIES; s++){
+            enc->prev_value[s] = float_bits(point->values[s]);
+            put_bits(enc, enc->prev_value[s], 32);
+        }
+        enc->first_ts = point->ts_us;
+        enc->prev_ts = point->ts_us;
+        enc->prev_delta = 0;
+    }else{
+        put_timestamp(enc, point->ts_us);
+        for (int s = 0; s < TS_SERIES; s++) put_value(enc, s, point->values[s]);
+    }
+    enc->count++;
+}
+
+bool ts_encoder_full(const tsEncoder* enc){
+    ///_|> descry: tells whether the block holds TS_BLOCK_SAMPLES samples
+    ///_|> enc: encoder, type const tsEncoder*
+    ///_|> returning: returns true if no further sample may be added before ts_encoder_write
+    return enc->count >= TS_BLOCK_SAMPLES;
+}
+
+int ts_encoder_write(tsEncoder* enc, FILE* file){
+    ///_|> descry: writes the block (header and padded stream) to a file and starts a new block
+    ///_|> enc: encoder, nothing is written while it is empty, type tsEncoder*
+    ///_|> file: output file, type FILE*
+    ///_|> returning: returns 0 on success, -1 if the write failed
+    if (enc->count == 0) return 0;
+    size_t used = (enc->bits + 7) >> 3;
+    size_t nbytes = used + TS_BLOCK_PAD;
+    memset(enc->buf + used, 0, nbytes - used);
+    tsBlockHeader header;
+    header.magic = TS_BLOCK_MAGIC;
+    header.count = (uint32_t)enc->count;
+    header.nbytes = (uint32_t)nbytes;
+    header.reserved = 0;
+    header.first_ts_us = enc->first_ts;
+    header.last_ts_us = enc->prev_ts;
+    int status = 0;
+    if (fwrite(&header, sizeof(header), 1, file) != 1 || fwrite(enc->buf, 1, nbytes, file) != nbytes){
+        status = -1;
+    }
+    ts_encoder_reset(enc);
+    return status;
+}
+
+int ts_decode_block(const tsBlockHeader* header, const unsigned char* stream, tsPoint* out){
+    ///_|> descry: decodes every sample of one block
+    ///_|> header: header of the block, type const tsBlockHeader*
+    ///_|> stream: the block's header->nbytes bytes of bit stream, type const unsigned char*
+    ///_|> out: room for header->count samples, type tsPoint*
+    ///_|> returning: returns the number of samples decoded, -1 if the block is malformed
+    if (header->magic != TS_BLOCK_MAGIC || header->count == 0 || header->count > TS_BLOCK_SAMPLES || \
+        header->nbytes <= TS_BLOCK_PAD || header->nbytes > TS_BLOCK_BYTES){
+        return -1;
+    }
+    size_t limit = (size_t)(header->nbytes - TS_BLOCK_PAD) * 8;
+    size_t pos = 0;
+    uint32_t value[TS_SERIES];
+    int lead[TS_SERIES] = {0};
+    int len[TS_SERIES] = {0};
+
+    long long ts = (long long)((get_bits(stream, &pos, 32) << 32) | get_bits(stream, &pos, 32));
+    for (int s = 0; s < TS_SERIES; s++){
+        value[s] = (uint32_t)get_bits(stream, &pos, 32);
+        out[0].values[s] = bits_float(value[s]);
+    }
+    out[0].ts_us = ts;
+    long long delta = 0;
+    for (uint32_t i = 1; i < header->count; i++){
+        // a sample reads at most TS_SAMPLE_MAX_BITS, so checking once per sample keeps every load
+        // inside the padding even for a corrupt stream
+        if (pos > limit) return -1;
+        long long dod;
+        if (get_bits(stream, &pos, 1) == 0){
+            dod = 0;
+        }else if (get_bits(stream, &pos, 1) == 0){
+            dod = sign_extend(get_bits(stream, &pos, 7), 7);
+        }else if (get_bits(stream, &pos, 1) == 0){
+            dod = sign_extend(get_bits(stream, &pos, 10), 10);
+        }else if (get_bits(stream, &pos, 1) == 0){
+            dod = sign_extend(get_bits(stream, &pos, 20), 20);
+        }else{
+            dod = (long long)((get_bits(stream, &pos, 32) << 32) | get_bits(stream, &pos, 32));
+        }
+        delta += dod;
+        ts += delta;
+        out[i].ts_us = ts;
+
+        for (int s = 0; s < TS_SERIES; s++){
+            if (get_bits(stream, &pos, 1) != 0){
+                if (get_bits(stream, &pos, 1) != 0){
+                    lead[s] = (int)get_bits(stream, &pos, 5);
+                    len[s] = (int)get_bits(stream, &pos, 5) + 1;
+                }else if (len[s] == 0){
+                    return -1; // window reused before one was set
+                }
+                uint32_t xor = (uint32_t)get_bits(stream, &pos, len[s]);
+                value[s] ^= xor << (32 - lead[s] - len[s]);
+            }
+            out[i].values[s] = bits_float(value[s]);
+        }
+    }
+    return (pos > limit) ? -1 : (int)header->count;
+}
+
+int ts_read_block(FILE* file, tsBlockHeader* header, unsigned char* stream){
+    ///_|> descry: reads the next block of a recording
+    ///_|> file: recording opened for reading, type FILE*
+    ///_|> header: receives the block header, type tsBlockHeader*
+    ///_|> stream: room for TS_BLOCK_BYTES bytes of bit stream, type unsigned char*
+    ///_|> returning: returns 1 if a block was read, 0 at the end of the file, -1 on a malformed or cut block
+    size_t got = fread(header, 1, sizeof(tsBlockHeader), file);
+    if (got == 0) return 0;
+    if (got != sizeof(tsBlockHeader) || header->magic != TS_BLOCK_MAGIC || header->nbytes > TS_BLOCK_BYTES){
+        return -1;
+    }
+    if (fread(stream, 1, header->nbytes, file) != header->nbytes) return -1;
+    return 1;
+}
+
+void ts_record_set_path(const char* path){
+    ///_|> descry: enables recording to a file (--record=FILE); it is opened by the first recorded sample
+    ///_|> path: recording to append blocks to, NULL or "" to disable, type const char*
+    ///_|> returning: this function does not return anything
+    if (path == NULL || path[0] == '\0'){
+        record_path[0] = '\0';
+        return;
+    }
+    snprintf(record_path, sizeof(record_path), "%s", path);
+}
+
+void ts_record_sample(float cpu_utiliz, float used_memory, float total_memory, long long wall_ns){
+    ///_|> descry: adds one sample to the recording, writing a block out whenever one fills up
+    ///_|> cpu_utiliz: CPU utilization in percent, type float
+    ///_|> used_memory / total_memory: memory in GB, type float
+    ///_|> wall_ns: wall-clock time the sample was taken in nanoseconds, type long long
+    ///_|> returning: this function does not return anything
+    if (record_path[0] == '\0' || record_failed) return;
+    if (record_file == NULL){
+        // opened by the consuming process only, after the producers have been forked
+        record_file = fopen(record_path, "ab");
+        if (record_file == NULL){
+            perror(record_path);
+            record_failed = true;
+            return;
+        }
+        ts_encoder_reset(&record_enc);
+        atexit(ts_record_close);
+    }
+    tsPoint point;
+    point.ts_us = wall_ns / 1000;
+    point.values[TS_CPU] = cpu_utiliz;
+    point.values[TS_MEM_USED] = used_memory;
+    point.values[TS_MEM_TOTAL] = total_memory;
+    ts_encoder_add(&record_enc, &point);
+    if (ts_encoder_full(&record_enc) && ts_encoder_write(&record_enc, record_file) == -1){
+        perror("write to recording failed");
+        record_failed = true;
+    }
+}
+
+void ts_record_close(){
+    ///_|> descry: writes the last partial block and closes the recording; registered with atexit
+    ///_|> returning: this function does not return anything
+    if (record_file == NULL) return;
+    if (!record_failed && ts_encoder_write(&record_enc, record_file) == -1){
+        perror("write to recording failed");
+    }
+    fclose(record_file);
+    record_file = NULL;
+}
+
+int ts_dump_file(const char* path, FILE* out){
+    ///_|> descry: decodes a recording block by block and prints it as CSV (--dump-record=FILE)
+    ///_|> path: recording to read, type const char*
+    ///_|> out: stream receiving the CSV, type FILE*
+    ///_|> returning: returns 0 on success, 1 if the file cannot be read or holds a malformed block
+    FILE* file = fopen(path, "rb");
+    if (file == NULL){
+        perror(path);
+        return 1;
+    }
+    static unsigned char stream[TS_BLOCK_BYTES];
+    static tsPoint points[TS_BLOCK_SAMPLES];
+    tsBlockHeader header;
+    int status = 0;
+    unsigned long blocks = 0;
+    fprintf(out, "wall_us,cpu_percent,mem_used_gb,mem_total_gb\n");
+    while (true){
+        int got = ts_read_block(file, &header, stream);
+        if (got == 0) break;
+        int count = (got == 1) ? ts_decode_block(&header, stream, points) : -1;
+        if (count == -1){
+            fprintf(stderr, "%s: malformed block %lu, stopping\n", path, blocks);
+            status = 1;
+            break;
+        }
+        for (int i = 0; i < count; i++){
+            fprintf(out, "%lld,%.2f,%.3f,%.3f\n", points[i].ts_us, points[i].values[TS_CPU], \
+                    points[i].values[TS_MEM_USED], points[i].values[TS_MEM_TOTAL]);
+        }
+        blocks++;
+    }
+    fclose(file);
+    return status;
+}
@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef TS_COMPRESS_HEADER
+#define TS_COMPRESS_HEADER
+
+/*
+This module stores recorded utilization samples in a compressed time-series format (--record=FILE)
+and decodes them again (--dump-record=FILE). Samples are grouped into self-contained blocks of up to
+TS_BLOCK_SAMPLES; each block is a tsBlockHeader followed by a bit stream in which
+  - timestamps (wall clock, microseconds) are stored as delta-of-delta in 1/9/13/24/68-bit buckets,
+  - every float series (cpu, mem used, mem total) is XORed with its previous value and only the
+    meaningful bits are kept, reusing the previous leading/trailing-zero window when it fits,
+as in Facebook's Gorilla paper, adapted to 32-bit floats. A block decodes without any other block,
+so a file can be appended to, truncated at a block boundary or replayed one block at a time.
+Like selfStats, the recorder is module-level state of the consuming process; it opens the file on
+the first recorded sample and flushes the last partial block at exit.
+*/
+
+#define TS_BLOCK_MAGIC 0x31425354u // "TSB1" in a little-endian file
+#define TS_BLOCK_SAMPLES 1024
+#define TS_SERIES 3
+#define TS_SAMPLE_MAX_BITS (68 + TS_SERIES * 44) // worst case: escaped timestamp, new window per value
+#define TS_BLOCK_PAD 40 // zero bytes after the stream: one sample's worst case plus an 8-byte load
+#define TS_BLOCK_BYTES (TS_BLOCK_SAMPLES * TS_SAMPLE_MAX_BITS / 8 + 16 + TS_BLOCK_PAD)
+
+typedef enum {
+    TS_CPU = 0,
+    TS_MEM_USED = 1,
+    TS_MEM_TOTAL = 2
+}TsSeries;
+///_|> descry: Index of each float series in tsPoint.values
+///_|> members:
+///_|>     - TS_CPU: CPU utilization in percent
+///_|>     - TS_MEM_USED: used memory in GB
+///_|>     - TS_MEM_TOTAL: total memory in GB
+
+typedef struct {
+    long long ts_us;
+    float values[TS_SERIES];
+}tsPoint;
+///_|> descry: One recorded sample
+///_|> members:
+///_|>     - ts_us: wall-clock time the sample was taken, microseconds since the epoch, type long long
+///_|>     - values: the float series indexed by TsSeries, type float[]
+
+typedef struct {
+    uint32_t magic;
+    uint32_t count;
+    uint32_t nbytes;
+    uint32_t reserved;
+    int64_t first_ts_us;
+    int64_t last_ts_us;
+}tsBlockHeader;
+///_|> descry: Header written in front of every block
+///_|> members:
+///_|>     - magic: TS_BLOCK_MAGIC, type uint32_t
+///_|>     - count: number of samples in the block, type uint32_t
+///_|>     - nbytes: size of the bit stream that follows, including TS_BLOCK_PAD, type uint32_t
+///_|>     - reserved: zero, type uint32_t
+///_|>     - first_ts_us / last_ts_us: time range of the block, for seeking without decoding, type int64_t
+
+typedef struct {
+    unsigned char buf[TS_BLOCK_BYTES];
+    size_t bits;
+    int count;
+    long long first_ts;
+    long long prev_ts;
+    long long prev_delta;
+    uint32_t prev_value[TS_SERIES];
+    int prev_lead[TS_SERIES];
+    int prev_len[TS_SERIES];
+}tsEncoder;
+///_|> descry: Block being encoded
+///_|> members:
+///_|>     - buf / bits: bit stream written so far, most significant bit first, type unsigned char[] / size_t
+///_|>     - count: samples in the block, type int
+///_|>     - first_ts / prev_ts / prev_delta: timestamp state for delta-of-delta, type long long
+///_|>     - prev_value: bit pattern of each series' previous value, type uint32_t[]
+///_|>     - prev_lead / prev_len: previous meaningful-bit window of each series, len 0 before the first,
+///_|>                             type int[]
+
+void ts_encoder_reset(tsEncoder* enc);
+
+void ts_encoder_add(tsEncoder* enc, const tsPoint* point);
+
+bool ts_encoder_full(const tsEncoder* enc);
+
+int ts_encoder_write(tsEncoder* enc, FILE* file);
+
+int ts_decode_block(const tsBlockHeader* header, const unsigned char* stream, tsPoint* out);
+
+int ts_read_block(FILE* file, tsBlockHeader* header, unsigned char* stream);
+
+void ts_record_set_path(const char* path);
+
+void ts_record_sample(float cpu_utiliz, float used_memory, float total_memory, long long wall_ns);
+
+void ts_record_close();
+
+int ts_dump_file(const char* path, FILE* out);
+
+#endif
@@ -0,0 +1,197 @@
+#include "vmstat.h"
+#include "arena.h"
+#include "procParse.h"
+
+static const vmstatRule vmstat_rules[] = {
+    {"pgfault", false, VMSTAT_PGFAULT},
+    {"pgmajfault", false, VMSTAT_PGMAJFAULT},
+    {"pswpin", false, VMSTAT_PSWPIN},
+    {"pswpout", false, VMSTAT_PSWPOUT},
+    // counts throttling events, not pages; the anon/file lines split the same pages a second way
+    {"pgscan_direct_throttle", false, -1},
+    {"pgscan_anon", false, -1},
+    {"pgscan_file", false, -1},
+    {"pgsteal_anon", false, -1},
+    {"pgsteal_file", false, -1},
+    // old kernels have one line per zone: pgscan_direct_normal, pgscan_kswapd_dma32, ...
+    {"pgscan_direct", true, VMSTAT_SCAN_DIRECT},
+    {"pgscan_", true, VMSTAT_SCAN_BACKGROUND},
+    {"pgsteal_direct", true, VMSTAT_STEAL_DIRECT},
+    {"pgsteal_", true, VMSTAT_STEAL_BACKGROUND},
+    {"thp_fault_alloc", false, VMSTAT_THP_ALLOC},
+    {"thp_collapse_alloc", false, VMSTAT_THP_ALLOC},
+    {"thp_file_alloc", false, VMSTAT_THP_ALLOC},
+    {"thp_fault_fallback", false, VMSTAT_THP_FALLBACK},
+    {"thp_collapse_alloc_failed", false, VMSTAT_THP_FALLBACK},
+    {"thp_file_fallback", false, VMSTAT_THP_FALLBACK},
+    {"thp_split_page", false, VMSTAT_THP_SPLIT},
+};
+///_|> descry: What --vmstat selects; the first rule matching a name decides its group
+
+#define VMSTAT_RULE_COUNT ((int)(sizeof(vmstat_rules) / sizeof(vmstat_rules[0])))
+
+static unsigned int hash_key(const char* key, int len, unsigned int seed){
+    ///_|> descry: seeded hash of a name from its length and its first and last eight bytes; the table
+    ///_|>         build checks that these tell the selected names apart
+    ///_|> key / len: the name, not NUL-terminated, and its length, type const char* / int
+    ///_|> seed: seed searched by vmstat_table_build, type unsigned int
+    ///_|> returning: returns the hash, to be masked with the table size
+    unsigned long long head = 0;
+    unsigned long long tail = 0;
+    memcpy(&head, key, (len < 8) ? (size_t)len : 8);
+    if (len > 8) memcpy(&tail, key + len - 8, 8);
+    unsigned long long h = (head ^ (tail * 0x9e3779b97f4a7c15ULL) ^ (unsigned long long)len) * \
+                           (0xff51afd7ed558ccdULL + 2ULL * seed); // odd multiplier for every seed
+    return (unsigned int)(h >> 32);
+}
+
+static int match_rule(const char* key, int len){
+    ///_|> descry: finds the group of a /proc/vmstat name
+    ///_|> key / len: the name and its length, type const char* / int
+    ///_|> returning: returns the VmstatGroup, -1 if the name is not selected
+    for (int r = 0; r < VMSTAT_RULE_COUNT; r++){
+        int rule_len = (int)strlen(vmstat_rules[r].name);
+        if (len < rule_len || (!vmstat_rules[r].prefix && len != rule_len)) continue;
+        if (memcmp(key, vmstat_rules[r].name, rule_len) == 0) return vmstat_rules[r].group;
+    }
+    return -1;
+}
+
+static bool place_keys(vmstatTable* table, const vmstatSlot* keys, int key_count){
+    ///_|> descry: fills the table under its current seed and mask
+    ///_|> table: table to fill, type vmstatTable*
+    ///_|> keys / key_count: selected names, type const vmstatSlot* / int
+    ///_|> returning: returns true if every name got its own slot
+    memset(table->slots, 0, sizeof(vmstatSlot) * (table->mask + 1));
+    for (int k = 0; k < key_count; k++){
+        vmstatSlot* slot = &table->slots[hash_key(keys[k].key, keys[k].key_len, table->seed) & table->mask];
+        if (slot->key_len != 0) return false;
+        *slot = keys[k];
+    }
+    return true;
+}
+
+int vmstat_table_build(vmstatTable* table, const char* vmstat_text){
+    ///_|> descry: selects the names of /proc/vmstat matching vmstat_rules and builds a perfect hash table of
+    ///_|>         them: the smallest table of at least four slots per name for which a seed without
+    ///_|>         collisions is found within VMSTAT_SEED_TRIES
+    ///_|> table: table to build, type vmstatTable*
+    ///_|> vmstat_text: NUL-terminated contents of /proc/vmstat, type const char*
+    ///_|> returning: returns the number of selected names, -1 if none was found or no seed works
+    vmstatSlot keys[VMSTAT_MAX_KEYS];
+    int key_count = 0;
+    for (const char* line = vmstat_text; *line != '\0'; ){
+        const char* space = strchr(line, ' ');
+        const char* end = strchr(line, '\n');
+        if (space == NULL) break;
+        int len = (int)(space - line);
+        int group = match_rule(line, len);
+        if (group >= 0 && len < VMSTAT_KEY_LEN && key_count < VMSTAT_MAX_KEYS){
+            memcpy(keys[key_count].key, line, len);
+            keys[key_count].key[len] = '\0';
+            keys[key_count].key_len = len;
+            keys[key_count].group = group;
+            key_count++;
+        }
+        if (end == NULL) break;
+        line = end + 1;
+    }
+    memset(table, 0, sizeof(vmstatTable));
+    if (key_count == 0){
+        fprintf(stderr, "No paging or reclaim counters found in /proc/vmstat\n");
+        return -1;
+    }
+    table->key_count = key_count;
+    unsigned int size = 1;
+    while (size < 4u * (unsigned int)key_count) size <<= 1;
+    for (; size <= VMSTAT_TABLE_SIZE; size <<= 1){
+        table->mask = size - 1;
+        for (unsigned int seed = 1; seed <= VMSTAT_SEED_TRIES; seed++){
+            table->seed = seed;
+            if (place_keys(table, keys, key_count)) return key_count;
+        }
+    }
+    fprintf(stderr, "No collision-free hash seed for %d /proc/vmstat names\n", key_count);
+    return -1;
+}
+
+void parse_vmstat(const vmstatTable* table, const char* vmstat_text, vmstatCounters* counters){
+    ///_|> descry: sums the selected counters of /proc/vmstat by group; one hash and at most one compare
+    ///_|>         per line, the values of other lines are skipped
+    ///_|> table: table built by vmstat_table_build, type const vmstatTable*
+    ///_|> vmstat_text: NUL-terminated contents of /proc/vmstat, type const char*
+    ///_|> counters: receives the sums, type vmstatCounters*
+    ///_|> returning: this function does not return anything
+    memset(counters, 0, sizeof(vmstatCounters));
+    for (const char* line = vmstat_text; *line != '\0'; ){
+        const char* space = strchr(line, ' ');
+        if (space == NULL) break;
+        int len = (int)(space - line);
+        const vmstatSlot* slot = &table->slots[hash_key(line, len, table->seed) & table->mask];
+        if (slot->key_len == len && memcmp(slot->key, line, len) == 0){
+            unsigned long long value;
+            if (procparse_u64(space + 1, &value) != NULL) counters->value[slot->group] += value;
+        }
+        const char* end = strchr(space, '\n');
+        if (end == NULL) break;
+        line = end + 1;
+    }
+}
+
+int vmstat_collector_init(vmstatCollector* collector){
+    ///_|> descry: opens /proc/vmstat, takes the read buffer and builds the table from the file as it is now
+    ///_|> collector: collector to initialize in place, type vmstatCollector*
+    ///_|> returning: returns the number of selected names, -1 if the file cannot be read or has none of them
+    collector->file = (procFile)PROC_FILE_INIT("/proc/vmstat");
+    collector->buf = arena_alloc(VMSTAT_BUF_SIZE);
+    if (collector->buf == NULL) return -1;
+    if (proc_file_read(&collector->file, collector->buf, VMSTAT_BUF_SIZE) <= 0){
+        perror("Failed to read /proc/vmstat");
+        return -1;
+    }
+    return vmstat_table_build(&collector->table, collector->buf);
+}
+
+int fill_vmstatCounters(vmstatCollector* collector, vmstatCounters* counters){
+    ///_|> descry: reads /proc/vmstat through the kept descriptor and sums the selected counters; performs
+    ///_|>         no heap allocation
+    ///_|> collector: initialized collector, type vmstatCollector*
+    ///_|> counters: receives the sums, type vmstatCounters*
+    ///_|> returning: returns 0 on success, -1 if the file cannot be read
+    if (proc_file_read(&collector->file, collector->buf, VMSTAT_BUF_SIZE) <= 0){
+        perror("Failed to read /proc/vmstat");
+        return -1;
+    }
+    parse_vmstat(&collector->table, collector->buf, counters);
+    return 0;
+}
+
+void vmstat_collector_close(vmstatCollector* collector){
+    ///_|> descry: closes the descriptor; the buffer stays in the arena
+    ///_|> collector: collector to close, type vmstatCollector*
+    ///_|> returning: this function does not return anything
+    proc_file_close(&collector->file);
+}
+
+void clear_vmstat_info(vmstatInfo* info){
+    ///_|> descry: marks every rate as unknown
+    ///_|> info: struct to reset, type vmstatInfo*
+    ///_|> returning: this function does not return anything
+    for (int g = 0; g < VMSTAT_GROUPS; g++) info->rate[g] = -1;
+}
+
+void calcu_vmstat_rates(const vmstatCounters* before, const vmstatCounters* after, long long interval_ns, \
+vmstatInfo* info){
+    ///_|> descry: per-second rates of every group between two snapshots
+    ///_|> before / after: snapshots of the previous and the current read, type const vmstatCounters*
+    ///_|> interval_ns: time between the two reads in nanoseconds, type long long
+    ///_|> info: receives the rates, -1 for a counter that went backwards, type vmstatInfo*
+    ///_|> returning: this function does not return anything
+    for (int g = 0; g < VMSTAT_GROUPS; g++){
+        if (interval_ns <= 0 || after->value[g] < before->value[g]){
+            info->rate[g] = -1;
+            continue;
+        }
+        info->rate[g] = (float)((double)(after->value[g] - before->value[g]) * 1e9 / (double)interval_ns);
+    }
+}
@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "procRoot.h"
+
+#ifndef VMSTAT_HEADER
+#define VMSTAT_HEADER
+
+/*
+This module reports paging and reclaim rates from /proc/vmstat (--vmstat): page faults, major faults,
+swap-in/out, pages scanned and stolen by background and direct reclaim, and THP allocations and
+fallbacks, the usual causes of latency spikes while memory use itself looks fine.
+/proc/vmstat has about two hundred "name value" lines and their set is fixed when the kernel boots,
+but it differs between kernels (pgscan_kswapd_normal on old ones, pgscan_proactive on new ones). So the
+selection is a list of rules (exact names and prefixes, vmstatRule) that vmstat_table_build matches
+once against the file as it is, and the matching names go into a perfect hash table: the seed is
+searched until every selected name has its own slot. Every tick a line costs one hash of its name and
+at most one compare, and lines that are not selected are dropped without looking at their value.
+The memory producer reads the file in the same tick as its memory reading, so the rates (vmstatInfo)
+travel with it to the memory chart, also to --attach viewers.
+*/
+
+#define VMSTAT_BUF_SIZE 16384
+#define VMSTAT_KEY_LEN 40
+#define VMSTAT_MAX_KEYS 64 // selected names, the table has at least four slots per name
+#define VMSTAT_TABLE_SIZE 512
+#define VMSTAT_SEED_TRIES 4096
+
+typedef enum {
+    VMSTAT_PGFAULT = 0,
+    VMSTAT_PGMAJFAULT,
+    VMSTAT_PSWPIN,
+    VMSTAT_PSWPOUT,
+    VMSTAT_SCAN_BACKGROUND,
+    VMSTAT_SCAN_DIRECT,
+    VMSTAT_STEAL_BACKGROUND,
+    VMSTAT_STEAL_DIRECT,
+    VMSTAT_THP_ALLOC,
+    VMSTAT_THP_FALLBACK,
+    VMSTAT_THP_SPLIT,
+    VMSTAT_GROUPS
+}VmstatGroup;
+///_|> descry: Counters reported by --vmstat; several /proc/vmstat names can add up into one group
+///_|> members:
+///_|>     - VMSTAT_PGFAULT / VMSTAT_PGMAJFAULT: all page faults and those that needed I/O
+///_|>     - VMSTAT_PSWPIN / VMSTAT_PSWPOUT: pages swapped in and out
+///_|>     - VMSTAT_SCAN_BACKGROUND / VMSTAT_SCAN_DIRECT: pages scanned by kswapd, khugepaged and proactive
+///_|>       reclaim, and by allocating tasks themselves (direct reclaim stalls the allocation)
+///_|>     - VMSTAT_STEAL_BACKGROUND / VMSTAT_STEAL_DIRECT: pages reclaimed by the same two
+///_|>     - VMSTAT_THP_ALLOC / VMSTAT_THP_FALLBACK / VMSTAT_THP_SPLIT: huge pages allocated on fault or by
+///_|>       collapse, allocations that fell back to small pages, and huge pages split
+
+typedef struct {
+    const char* name;
+    bool prefix;
+    int group;
+}vmstatRule;
+///_|> descry: One selection rule, matched against the names of /proc/vmstat when the table is built
+///_|> members:
+///_|>     - name: full name, or the start of the names it selects, type const char*
+///_|>     - prefix: whether name is a prefix, type bool
+///_|>     - group: VmstatGroup the selected names add up into, -1 to drop them, type int
+
+typedef struct {
+    char key[VMSTAT_KEY_LEN];
+    int key_len;
+    int group;
+}vmstatSlot;
+///_|> descry: One slot of the perfect hash table
+///_|> members:
+///_|>     - key / key_len: selected /proc/vmstat name, key_len 0 for an empty slot, type char[] / int
+///_|>     - group: VmstatGroup its value is added to, type int
+
+typedef struct {
+    unsigned int seed;
+    unsigned int mask;
+    int key_count;
+    vmstatSlot slots[VMSTAT_TABLE_SIZE];
+}vmstatTable;
+///_|> descry: Perfect hash table of the selected names, built once at start-up
+///_|> members:
+///_|>     - seed: hash seed under which no two selected names share a slot, type unsigned int
+///_|>     - mask: table size minus one, the size is a power of two up to VMSTAT_TABLE_SIZE, type unsigned int
+///_|>     - key_count: number of selected names, type int
+///_|>     - slots: the table, type vmstatSlot[]
+
+typedef struct {
+    unsigned long long value[VMSTAT_GROUPS];
+}vmstatCounters;
+///_|> descry: One snapshot of the selected counters, summed by group
+///_|> members:
+///_|>     - value: counter of every VmstatGroup since boot, type unsigned long long[]
+
+typedef struct {
+    float rate[VMSTAT_GROUPS];
+}vmstatInfo;
+///_|> descry: Paging and reclaim rates of one sampling interval, sent with the memory reading
+///_|> members:
+///_|>     - rate: events (pages, faults) per second of every VmstatGroup, all -1 when --vmstat is off or on
+///_|>             the first reading, type float[]
+
+typedef struct {
+    procFile file;
+    char* buf;
+    vmstatTable table;
+}vmstatCollector;
+///_|> descry: /proc/vmstat kept open across ticks, its arena read buffer and the table of the selected names
+///_|> members:
+///_|>     - file / buf: cached file and its VMSTAT_BUF_SIZE read buffer, type procFile / char*
+///_|>     - table: perfect hash table built by vmstat_collector_init, type vmstatTable
+
+int vmstat_table_build(vmstatTable* table, const char* vmstat_text);
+
+void parse_vmstat(const vmstatTable* table, const char* vmstat_text, vmstatCounters* counters);
+
+int vmstat_collector_init(vmstatCollector* collector);
+
+int fill_vmstatCounters(vmstatCollector* collector, vmstatCounters* counters);
+
+void vmstat_collector_close(vmstatCollector* collector);
+
+void clear_vmstat_info(vmstatInfo* info);
+
+void calcu_vmstat_rates(const vmstatCounters* before, const vmstatCounters* after, long long interval_ns, \
+vmstatInfo* info);
+
+#endif